@@ -57,6 +57,7 @@ static Button_t btn_s1, btn_s2, btn_joy_sel;
 static Joystick_t joystick;
 static Accelerometer_t accel;
 static Envelope_t envelope;
+static const ADSR_Profile_t piano = {480, 9600, 700, 4800};
 
 //=============================================================================
 // APPLICATION STATE
@@ -109,7 +110,7 @@ int main(void) {
     // Initialize audio
     Audio_Init(SAMPLE_RATE_HZ);
     Audio_SetWaveform(WAVE_SINE);
-    Envelope_Init(&envelope, &ADSR_PIANO);
+    Envelope_Init(&envelope, &piano);
     
     // Initialize peripherals
     SysTick_Init();
@@ -313,9 +314,12 @@ void TIMG7_IRQHandler(void) {
     sample = Filter_LowPass(sample);
     sample = Filter_SoftClip(sample, 1600);
     
-    // Convert to PWM
-    uint16_t pwm_val = Audio_SampleToPWM(sample, 2048, 4095);
-    DL_TimerG_setCaptureCompareValue(PWM_AUDIO_INST, pwm_val, DL_TIMER_CC_0_INDEX);
+    // Convert to PWM (period 4096, centre 2048)
+    int32_t pwm_val = 2048 + sample * 2;
+    if (pwm_val < 0) pwm_val = 0;
+    if (pwm_val > 4095) pwm_val = 4095;
+    DL_TimerG_setCaptureCompareValue(PWM_AUDIO_INST, (uint32_t)pwm_val,
+                                     DL_TIMER_CC_0_INDEX);
 }
 
 //=============================================================================
@@ -0,0 +1,29 @@
+/*
+ * flash_layout.h
+ *
+ * MSPM0G3507 main flash map, shared by main.c and the linker command file
+ * (mspm0g3507.cmd includes it through the TI linker's preprocessor, so
+ * plain numbers only: no casts, no C).
+ *
+ *   0x00000 - 0x1EBFF  application (the linker's FLASH region)
+ *   0x1EC00 - 0x1EFFF  compiled sound bank (tools/host/bank_tool compile)
+ *   0x1F000 - 0x1FFFF  settings log (lib/storage/flash_kv, 4 sectors)
+ *
+ * main.c checks the sizes against flash_kv.h and DriverLib at compile time.
+ */
+#ifndef FLASH_LAYOUT_H_
+#define FLASH_LAYOUT_H_
+
+#define FLASH_BASE             0x00000000
+#define FLASH_SIZE             0x00020000  // 128 KB
+
+#define SETTINGS_FLASH_SIZE    0x00001000  // FLASH_KV_REGION_SIZE
+#define SETTINGS_FLASH_ADDRESS 0x0001F000  // Last four 1 KB sectors
+
+#define BANK_BLOB_SIZE         0x00000400  // One sector
+#define BANK_BLOB_ADDRESS      0x0001EC00  // Sector below the settings
+
+// Code and constants end where the reserved sectors begin
+#define APP_FLASH_SIZE         BANK_BLOB_ADDRESS
+
+#endif /* FLASH_LAYOUT_H_ */
@@ -15,6 +15,7 @@
 #include <string.h>
 #include "ti_msp_dl_config.h"
 #include "main.h"
+#include "lib/perf/perf_zone.h"
 
 //=============================================================================
 // ST7735S COMMANDS
@@ -391,6 +392,7 @@ void LCD_Init(void) {
 }
 
 void LCD_FillScreen(uint16_t color) {
+    PERF_BEGIN(LCD_FILL);
     LCD_SetWindow(0, 0, LCD_WIDTH - 1, LCD_HEIGHT - 1);
 
     uint8_t color_high = color >> 8;
@@ -408,6 +410,7 @@ void LCD_FillScreen(uint16_t color) {
     }
     
     LCD_CS_HIGH();
+    PERF_END(LCD_FILL);
 }
 
 void LCD_DrawPixel(uint16_t x, uint16_t y, uint16_t color) {
@@ -0,0 +1,85 @@
+/**
+ * @file audio_biquad.c
+ * @brief Biquad Filter Implementation
+ */
+
+#include "audio_biquad.h"
+
+#if BIQUAD_USE_MATHACL
+#include "ti_msp_dl_config.h"
+#endif
+
+//=============================================================================
+// MULTIPLY
+//=============================================================================
+
+// Q31 product: MATHACL MPY_32 on target, 64-bit multiply on host
+static inline int32_t Biquad_Mul(int32_t a, int32_t b) {
+#if BIQUAD_USE_MATHACL
+    static const DL_MathACL_operationConfig config = {
+        .opType = DL_MATHACL_OP_TYPE_MPY_32,
+        .qType = DL_MATHACL_Q_TYPE_Q31,
+        .opSign = DL_MATHACL_OPSIGN_SIGNED
+    };
+
+    DL_MathACL_configOperation(MATHACL, &config, a, b);
+    DL_MathACL_waitForOperation(MATHACL);
+    return (int32_t)DL_MathACL_getResultOne(MATHACL);
+#else
+    return (int32_t)(((int64_t)a * b) >> 31);
+#endif
+}
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+/**
+ * Butterworth low-pass, fc = 15 kHz
+ * Coefficients calculated for fs = 48 kHz
+ */
+void BiquadFilter_Init(BiquadFilter_t *filter) {
+    // Clear state
+    filter->x1 = 0;
+    filter->x2 = 0;
+    filter->y1 = 0;
+    filter->y2 = 0;
+    
+    // Butterworth coefficients (Q15 format, scaled by 32768)
+    // fc = 15 kHz, fs = 48 kHz
+    filter->b0 = 16384;   // 0.5 * 32768
+    filter->b1 = 32768;   // 1.0 * 32768
+    filter->b2 = 16384;   // 0.5 * 32768
+    filter->a1 = -10486;  // -0.32 * 32768 (approx)
+    filter->a2 = 6554;    // 0.2 * 32768 (approx)
+}
+
+/*
+ * Direct Form II Transposed structure for numerical stability
+ */
+int16_t BiquadFilter_Process(BiquadFilter_t *filter, int16_t input) {
+    // Convert input to Q15
+    int32_t x0 = (int32_t)input << 15;
+    
+    // Calculate feedforward
+    // w0 = x0 - a1*y1 - a2*y2
+    int32_t w0 = x0;
+    w0 -= Biquad_Mul(filter->a1, filter->y1) >> 15;
+    w0 -= Biquad_Mul(filter->a2, filter->y2) >> 15;
+    
+    // Calculate output
+    // y0 = b0*w0 + b1*w1 + b2*w2
+    int32_t y0 = 0;
+    y0 += Biquad_Mul(filter->b0, w0) >> 15;
+    y0 += Biquad_Mul(filter->b1, filter->x1) >> 15;
+    y0 += Biquad_Mul(filter->b2, filter->x2) >> 15;
+    
+    // Update state
+    filter->x2 = filter->x1;
+    filter->x1 = w0;
+    filter->y2 = filter->y1;
+    filter->y1 = y0;
+    
+    // Convert back to 16-bit
+    return (int16_t)(y0 >> 15);
+}
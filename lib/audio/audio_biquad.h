@@ -0,0 +1,55 @@
+/**
+ * @file audio_biquad.h
+ * @brief Biquad Filter (MATHACL multiplies on target)
+ * @version 1.0.0
+ *
+ * Fixed-point biquad for the anti-aliasing stage. On the MSPM0G3507 each
+ * product goes through the MATHACL MPY_32 unit (Q31); host builds use the
+ * same arithmetic in C so the filter can be tested and benchmarked there.
+ *
+ * Usage:
+ *   BiquadFilter_t aa;
+ *   BiquadFilter_Init(&aa);
+ *   int16_t y = BiquadFilter_Process(&aa, x);
+ */
+
+#ifndef AUDIO_BIQUAD_H_
+#define AUDIO_BIQUAD_H_
+
+#include <stdint.h>
+
+#ifndef BIQUAD_USE_MATHACL
+#if defined(__linux__)
+#define BIQUAD_USE_MATHACL 0
+#else
+#define BIQUAD_USE_MATHACL 1
+#endif
+#endif
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    int32_t x1, x2;
+    int32_t y1, y2;
+    int32_t b0, b1, b2;
+    int32_t a1, a2;
+} BiquadFilter_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize as the 48 kHz Butterworth low-pass (fc = 15 kHz)
+ */
+void BiquadFilter_Init(BiquadFilter_t *filter);
+
+/**
+ * @brief Process one sample
+ * @param input Input sample (16-bit)
+ * @return Filtered output sample (16-bit)
+ */
+int16_t BiquadFilter_Process(BiquadFilter_t *filter, int16_t input);
+
+#endif /* AUDIO_BIQUAD_H_ */
@@ -0,0 +1,95 @@
+/**
+ * @file audio_dac.c
+ * @brief DAC12 Output Conditioning Implementation
+ */
+
+#include "audio_dac.h"
+
+//=============================================================================
+// INTERNAL CONSTANTS
+//=============================================================================
+
+#define DAC_SHIFT      4       // 16-bit mix -> 12-bit DAC
+#define DC_POLE_SHIFT  8       // R = 1 - 2^-8: corner ~10 Hz at 16 kHz
+#define ERR_LIMIT      64      // Clamp shaper error when the DAC clips
+#define LFSR_SEED      0xACE1u
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void DacStage_Init(DacStage_t *dac, uint8_t opa_gain, DacShape_t shape) {
+    if (opa_gain == 0) opa_gain = 1;
+
+    dac->shape = shape;
+    dac->scale = (int16_t)(32767 / opa_gain);
+    dac->lfsr = LFSR_SEED;
+
+    DacStage_Reset(dac);
+}
+
+void DacStage_Reset(DacStage_t *dac) {
+    dac->dc_x1 = 0;
+    dac->dc_y1 = 0;
+    dac->err1 = 0;
+    dac->err2 = 0;
+}
+
+void DacStage_ProcessBlock(DacStage_t *dac, const int16_t *in, uint16_t *out,
+                           uint16_t n) {
+    // Work on locals; write state back once per block
+    int32_t x1 = dac->dc_x1;
+    int32_t y1 = dac->dc_y1;
+    int32_t e1 = dac->err1;
+    int32_t e2 = dac->err2;
+    uint32_t lfsr = dac->lfsr;
+    int32_t scale = dac->scale;
+    DacShape_t shape = dac->shape;
+
+    for (uint16_t i = 0; i < n; i++) {
+        // 1. DC blocker: y = x - x[n-1] + R * y[n-1] (shift/add only)
+        int32_t x = in[i];
+        y1 += (x - x1) * (1 << DC_POLE_SHIFT) - (y1 >> DC_POLE_SHIFT);
+        x1 = x;
+        int32_t v = y1 >> DC_POLE_SHIFT;
+
+        // 2. OPA gain compensation
+        v = (v * scale) >> 15;
+
+        // 3. Noise shaping: subtract filtered past error
+        if (shape == DAC_SHAPE_2ND_ORDER) {
+            v -= 2 * e1 - e2;
+        } else if (shape == DAC_SHAPE_1ST_ORDER) {
+            v -= e1;
+        }
+
+        // 4. TPDF dither: difference of two uniform 4-bit values (+/-1 LSB)
+        int32_t w = v;
+        if (shape != DAC_SHAPE_NONE) {
+            lfsr ^= lfsr << 13;
+            lfsr ^= lfsr >> 17;
+            lfsr ^= lfsr << 5;
+            w += (int32_t)(lfsr & 0xF) - (int32_t)((lfsr >> 4) & 0xF);
+        }
+
+        // 5. Quantise to 12 bits (round) and clip to the DAC range
+        int32_t q = (w + (1 << (DAC_SHIFT - 1))) >> DAC_SHIFT;
+        if (q > DAC12_MAX - DAC12_MIDPOINT) q = DAC12_MAX - DAC12_MIDPOINT;
+        if (q < -DAC12_MIDPOINT) q = -DAC12_MIDPOINT;
+
+        // 6. Error seen by the shaper (bounded so clipping cannot run away)
+        int32_t e = q * (1 << DAC_SHIFT) - v;
+        if (e > ERR_LIMIT) e = ERR_LIMIT;
+        if (e < -ERR_LIMIT) e = -ERR_LIMIT;
+        e2 = e1;
+        e1 = e;
+
+        out[i] = (uint16_t)(q + DAC12_MIDPOINT);
+    }
+
+    dac->dc_x1 = (int16_t)x1;
+    dac->dc_y1 = y1;
+    dac->err1 = (int16_t)e1;
+    dac->err2 = (int16_t)e2;
+    dac->lfsr = lfsr;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file audio_dac.h
+ * @brief DAC12 Output Conditioning (DC Blocker, Dither, Noise Shaping)
+ * @version 1.0.0
+ *
+ * One fused block kernel from the internal 16-bit mix to DAC12 codes:
+ *   DC blocker -> OPA gain compensation -> TPDF dither (LFSR) ->
+ *   error-feedback noise shaping -> 12-bit quantisation -> 0-4095 codes
+ *
+ * Second-order shaping moves the 12-bit quantisation noise towards fs/2.
+ * At 16 kHz this lowers the noise floor below ~2.5 kHz (where most of the
+ * signal energy sits) and raises it near 8 kHz, where the output filter and
+ * speaker roll off.
+ *
+ * Usage:
+ *   DacStage_t dac;
+ *   DacStage_Init(&dac, 2, DAC_SHAPE_2ND_ORDER);  // 2x OPA gain
+ *
+ *   // Once per block:
+ *   DacStage_ProcessBlock(&dac, mix, dac_codes, 32);
+ */
+
+#ifndef AUDIO_DAC_H_
+#define AUDIO_DAC_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DAC12_MIDPOINT 2048
+#define DAC12_MAX      4095
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Quantiser mode
+ */
+typedef enum {
+    DAC_SHAPE_NONE = 0,    ///< Plain rounding to 12 bits (no dither)
+    DAC_SHAPE_DITHER,      ///< TPDF dither, flat noise
+    DAC_SHAPE_1ST_ORDER,   ///< TPDF dither + (1 - z^-1) error feedback
+    DAC_SHAPE_2ND_ORDER    ///< TPDF dither + (1 - z^-1)^2 error feedback
+} DacShape_t;
+
+/**
+ * @brief Output stage state
+ */
+typedef struct {
+    DacShape_t shape;      ///< Quantiser mode
+    int16_t scale;         ///< OPA gain compensation, Q15
+    int16_t dc_x1;         ///< DC blocker: previous input
+    int32_t dc_y1;         ///< DC blocker: previous output, Q8
+    int16_t err1;          ///< Quantisation error, n-1 (16-bit units)
+    int16_t err2;          ///< Quantisation error, n-2
+    uint32_t lfsr;         ///< Dither noise generator state
+} DacStage_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize output stage
+ * @param dac Pointer to output stage
+ * @param opa_gain Gain of the OPA after the DAC (1 or 2)
+ * @param shape Quantiser mode
+ */
+void DacStage_Init(DacStage_t *dac, uint8_t opa_gain, DacShape_t shape);
+
+/**
+ * @brief Clear filter and noise-shaper history
+ * @param dac Pointer to output stage
+ */
+void DacStage_Reset(DacStage_t *dac);
+
+/**
+ * @brief Condition one block and write DAC12 codes
+ * @param dac Pointer to output stage
+ * @param in 16-bit mix (full scale = +/-32767)
+ * @param out DAC12 codes (0-4095, right aligned)
+ * @param n Number of samples
+ */
+void DacStage_ProcessBlock(DacStage_t *dac, const int16_t *in, uint16_t *out,
+                           uint16_t n);
+
+#endif /* AUDIO_DAC_H_ */
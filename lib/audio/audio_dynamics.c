@@ -0,0 +1,198 @@
+/**
+ * @file audio_dynamics.c
+ * @brief Master-Bus Compressor / Limiter Implementation
+ */
+
+#include "audio_dynamics.h"
+
+//=============================================================================
+// LOG-DOMAIN TABLES
+//=============================================================================
+
+// log2(1 + i/32) in Q8
+static const uint16_t log2_table[33] = {
+    0,   11,  22,  33,  44,  54,  63,  73,  82,  92,  100,
+    109, 118, 126, 134, 142, 150, 157, 165, 172, 179, 186,
+    193, 200, 207, 213, 220, 226, 232, 238, 244, 250, 256
+};
+
+// 2^(-i/32) in Q15
+static const uint16_t exp2_table[33] = {
+    32768, 32066, 31379, 30706, 30048, 29405, 28774, 28158, 27554,
+    26964, 26386, 25821, 25268, 24726, 24196, 23678, 23170, 22674,
+    22188, 21713, 21247, 20792, 20347, 19911, 19484, 19066, 18658,
+    18258, 17867, 17484, 17109, 16743, 16384
+};
+
+#define LOG2_FULL_SCALE (15 << 8)    // log2(32768) in Q8
+#define LOG2_SILENCE    (-(32 << 8)) // Level reported for digital silence
+#define BUS_LIMIT       ((1 << 18) - 1)
+
+//=============================================================================
+// INTERNAL HELPERS
+//=============================================================================
+
+/**
+ * @brief log2(x) in Q8 (Cortex-M0+ has no CLZ, so normalise by halving)
+ */
+static int32_t log2_q8(uint32_t x) {
+    if (x == 0) return LOG2_SILENCE;
+
+    int32_t e = 31;
+    if (!(x & 0xFFFF0000u)) { x <<= 16; e -= 16; }
+    if (!(x & 0xFF000000u)) { x <<= 8;  e -= 8; }
+    if (!(x & 0xF0000000u)) { x <<= 4;  e -= 4; }
+    if (!(x & 0xC0000000u)) { x <<= 2;  e -= 2; }
+    if (!(x & 0x80000000u)) { x <<= 1;  e -= 1; }
+
+    // Bits 30..26 select the segment, bits 25..18 interpolate
+    uint32_t idx = (x >> 26) & 31;
+    int32_t frac = (int32_t)((x >> 18) & 0xFF);
+    int32_t y0 = log2_table[idx];
+    int32_t y = y0 + (((log2_table[idx + 1] - y0) * frac) >> 8);
+
+    return (e << 8) + y;
+}
+
+/**
+ * @brief 2^(-r) for r in log2 Q8 (r >= 0), result in Q15
+ */
+static int32_t exp2_neg_q15(int32_t r) {
+    if (r <= 0) return 32768;
+
+    int32_t ip = r >> 8;
+    if (ip >= 16) return 0;
+
+    int32_t f = r & 0xFF;
+    int32_t idx = f >> 3;
+    int32_t g0 = exp2_table[idx];
+    int32_t g = g0 + (((exp2_table[idx + 1] - g0) * (f & 7)) >> 3);
+
+    return g >> ip;
+}
+
+/**
+ * @brief dB to log2 Q8 (256 / 6.0206 = 42.52 = 10885 / 256)
+ */
+static int16_t db_to_log2_q8(int16_t db) {
+    return (int16_t)(((int32_t)db * 10885) >> 8);
+}
+
+/**
+ * @brief One-pole smoothing coefficient per block, Q15
+ *
+ * Approximates 1 - exp(-N / T) by N / (T + N). Runs at init only.
+ */
+static uint16_t block_coefficient(uint16_t time_ms, uint16_t sample_rate_hz,
+                                  uint16_t block_size) {
+    uint32_t t = ((uint32_t)time_ms * sample_rate_hz) / 1000;
+    uint32_t coef = ((uint32_t)block_size << 15) / (t + block_size);
+    if (coef > 32767) coef = 32767;
+    return (uint16_t)coef;
+}
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void Dynamics_Init(Dynamics_t *dyn, const DynamicsProfile_t *profile,
+                   uint16_t sample_rate_hz, uint16_t block_size,
+                   int16_t ceiling) {
+    if (block_size == 0) block_size = 1;
+
+    dyn->threshold = db_to_log2_q8(profile->threshold_db);
+    dyn->knee = db_to_log2_q8(profile->knee_db);
+    dyn->slope = (profile->ratio == 0) ? 256 : (uint16_t)(256 - 256 / profile->ratio);
+    dyn->attack = block_coefficient(profile->attack_ms, sample_rate_hz, block_size);
+    dyn->release = block_coefficient(profile->release_ms, sample_rate_hz, block_size);
+    dyn->ceiling = ceiling;
+    dyn->detect = profile->detect;
+
+    Dynamics_Reset(dyn);
+}
+
+void Dynamics_Reset(Dynamics_t *dyn) {
+    dyn->reduction = 0;
+    dyn->gain = 32768;
+    dyn->level = LOG2_SILENCE;
+}
+
+void Dynamics_ProcessBlock(Dynamics_t *dyn, const int32_t *in, int16_t *out,
+                           uint16_t n) {
+    if (n == 0) return;
+
+    // 1. Level detection (log2 Q8 relative to 16-bit full scale)
+    int32_t level;
+    if (dyn->detect == DYN_DETECT_RMS) {
+        // Sum of (x/4)^2 fits 32 bits per sample, 64 bits per block
+        uint64_t sum = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            int32_t x = in[i];
+            uint32_t a = (uint32_t)(x < 0 ? -x : x);
+            if (a > BUS_LIMIT) a = BUS_LIMIT;
+            a >>= 2;
+            sum += a * a;
+        }
+        int32_t log_sum = (sum >> 32) ? log2_q8((uint32_t)(sum >> 32)) + (32 << 8)
+                                      : log2_q8((uint32_t)sum);
+        // rms = 4 * sqrt(sum / n)
+        level = (2 << 8) + ((log_sum - log2_q8(n)) >> 1);
+    } else {
+        uint32_t peak = 0;
+        for (uint16_t i = 0; i < n; i++) {
+            int32_t x = in[i];
+            uint32_t a = (uint32_t)(x < 0 ? -x : x);
+            if (a > peak) peak = a;
+        }
+        level = log2_q8(peak);
+    }
+    if (level > LOG2_SILENCE) level -= LOG2_FULL_SCALE;
+    dyn->level = (int16_t)level;
+
+    // 2. Gain computer (soft knee)
+    int32_t over = level - dyn->threshold;
+    int32_t knee = dyn->knee;
+    int32_t target;
+    if (knee <= 0 || 2 * over >= knee) {
+        target = (over > 0) ? (over * dyn->slope) >> 8 : 0;
+    } else if (2 * over <= -knee) {
+        target = 0;
+    } else {
+        // Quadratic blend across the knee: slope * (over + k/2)^2 / (2k)
+        int32_t t = over + knee / 2;
+        target = ((t * t / (2 * knee)) * dyn->slope) >> 8;
+    }
+
+    // 3. Attack / release smoothing of the reduction (log2 Q16)
+    int32_t diff = (target << 8) - dyn->reduction;
+    uint16_t coef = (diff > 0) ? dyn->attack : dyn->release;
+    dyn->reduction += (int32_t)(((int64_t)diff * coef) >> 15);
+    if (dyn->reduction < 0) dyn->reduction = 0;
+
+    // 4. Ramp linear gain across the block
+    int32_t gain_end = exp2_neg_q15(dyn->reduction >> 8);
+    int32_t gain = dyn->gain;
+    int32_t step = (gain_end - gain) / (int32_t)n;
+    int32_t ceiling = dyn->ceiling;
+
+    for (uint16_t i = 0; i < n; i++) {
+        gain += step;
+
+        int32_t x = in[i];
+        if (x > BUS_LIMIT) x = BUS_LIMIT;
+        if (x < -BUS_LIMIT) x = -BUS_LIMIT;
+
+        // (x / 4) * Q15 gain fits 32 bits for |x| < 2^18
+        int32_t y = ((x >> 2) * gain) >> 13;
+        if (y > ceiling) y = ceiling;
+        if (y < -ceiling) y = -ceiling;
+        out[i] = (int16_t)y;
+    }
+
+    dyn->gain = gain_end;
+}
+
+uint16_t Dynamics_GetReductionDb10(const Dynamics_t *dyn) {
+    // log2 Q8 -> dB * 10: 60.206 / 256 = 15413 / 65536
+    return (uint16_t)(((dyn->reduction >> 8) * 15413) >> 16);
+}
@@ -0,0 +1,104 @@
+/**
+ * @file audio_dynamics.h
+ * @brief Master-Bus Compressor / Limiter
+ * @version 1.0.0
+ *
+ * Soft-knee compressor for the 32-bit master bus. Level detection and the
+ * gain computer run once per block in the log2 domain (small LUTs, fixed
+ * point); the resulting gain is ramped linearly across the block, so there
+ * are no divides per sample.
+ *
+ * Usage:
+ *   Dynamics_t limiter;
+ *   DynamicsProfile_t profile = {-3, 6, 0, 1, 150, DYN_DETECT_PEAK};
+ *   Dynamics_Init(&limiter, &profile, 16000, 32, 32767);
+ *
+ *   // Once per block:
+ *   Dynamics_ProcessBlock(&limiter, bus, out, 32);
+ */
+
+#ifndef AUDIO_DYNAMICS_H_
+#define AUDIO_DYNAMICS_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Level detector
+ */
+typedef enum {
+    DYN_DETECT_PEAK = 0,   ///< Block peak (transparent limiting)
+    DYN_DETECT_RMS         ///< Block RMS (smoother compression)
+} DynamicsDetect_t;
+
+/**
+ * @brief Compressor settings in user units
+ */
+typedef struct {
+    int8_t threshold_db;   ///< Threshold relative to 16-bit full scale (<= 0)
+    uint8_t knee_db;       ///< Soft knee width (0 = hard knee)
+    uint8_t ratio;         ///< Ratio N:1 (0 = infinite, limiter)
+    uint16_t attack_ms;    ///< Gain reduction attack time
+    uint16_t release_ms;   ///< Gain reduction release time
+    DynamicsDetect_t detect;
+} DynamicsProfile_t;
+
+/**
+ * @brief Compressor state (levels are log2 Q8: 256 = 6.02 dB)
+ */
+typedef struct {
+    int16_t threshold;     ///< Threshold, log2 Q8 relative to full scale
+    int16_t knee;          ///< Knee width, log2 Q8
+    uint16_t slope;        ///< 1 - 1/ratio, Q8 (256 = limiter)
+    uint16_t attack;       ///< Smoothing coefficient per block, Q15
+    uint16_t release;      ///< Smoothing coefficient per block, Q15
+    int16_t ceiling;       ///< Output clamp (safety clip)
+    DynamicsDetect_t detect;
+    int32_t reduction;     ///< Smoothed gain reduction, log2 Q16 (>= 0)
+    int32_t gain;          ///< Linear gain at end of last block, Q15
+    int16_t level;         ///< Last detected level, log2 Q8 (meter)
+} Dynamics_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize compressor
+ * @param dyn Pointer to compressor structure
+ * @param profile Settings (threshold, knee, ratio, attack, release)
+ * @param sample_rate_hz Sample rate
+ * @param block_size Samples per call to Dynamics_ProcessBlock
+ * @param ceiling Output clamp (e.g. 32767)
+ */
+void Dynamics_Init(Dynamics_t *dyn, const DynamicsProfile_t *profile,
+                   uint16_t sample_rate_hz, uint16_t block_size,
+                   int16_t ceiling);
+
+/**
+ * @brief Reset gain reduction to 0 dB
+ * @param dyn Pointer to compressor structure
+ */
+void Dynamics_Reset(Dynamics_t *dyn);
+
+/**
+ * @brief Compress one block of the master bus
+ * @param dyn Pointer to compressor structure
+ * @param in 32-bit bus samples (16-bit full scale, up to 18 dB over)
+ * @param out 16-bit output samples
+ * @param n Number of samples
+ */
+void Dynamics_ProcessBlock(Dynamics_t *dyn, const int32_t *in, int16_t *out,
+                           uint16_t n);
+
+/**
+ * @brief Get current gain reduction
+ * @param dyn Pointer to compressor structure
+ * @return Gain reduction in tenths of a dB (e.g. 35 = 3.5 dB)
+ */
+uint16_t Dynamics_GetReductionDb10(const Dynamics_t *dyn);
+
+#endif /* AUDIO_DYNAMICS_H_ */
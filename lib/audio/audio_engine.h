@@ -22,6 +22,5 @@ void Audio_SetFrequency(uint32_t frequency_hz);
 void Audio_SetWaveform(Waveform_t waveform);
 int16_t Audio_GenerateWaveform(uint8_t index, Waveform_t waveform);
 const int16_t* Audio_GetSineTable(void);
-uint16_t Audio_SampleToPWM(int16_t sample, uint16_t center, uint16_t max);
 
 #endif /* AUDIO_ENGINE_H_ */
\ No newline at end of file
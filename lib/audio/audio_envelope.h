@@ -60,25 +60,6 @@ typedef struct {
     const ADSR_Profile_t *profile;  ///< ADSR profile
 } Envelope_t;
 
-//=============================================================================
-// PREDEFINED ADSR PROFILES
-//=============================================================================
-
-// Piano-like: Fast attack, medium decay
-extern const ADSR_Profile_t ADSR_PIANO;
-
-// Organ-like: Instant attack, no decay
-extern const ADSR_Profile_t ADSR_ORGAN;
-
-// Strings-like: Slow attack, long sustain
-extern const ADSR_Profile_t ADSR_STRINGS;
-
-// Bass-like: Medium attack, short decay
-extern const ADSR_Profile_t ADSR_BASS;
-
-// Lead-like: Fast attack, long sustain
-extern const ADSR_Profile_t ADSR_LEAD;
-
 //=============================================================================
 // PUBLIC API
 //=============================================================================
@@ -108,6 +89,16 @@ void Envelope_NoteOff(Envelope_t *env);
  */
 void Envelope_Process(Envelope_t *env);
 
+/**
+ * @brief Process several samples at once (control rate, e.g. once per block)
+ * @param env Pointer to envelope structure
+ * @param samples Samples to advance
+ *
+ * Same curve as Envelope_Process at the block edges; a stage that ends
+ * inside the block starts the next one at the following call.
+ */
+void Envelope_Advance(Envelope_t *env, uint16_t samples);
+
 /**
  * @brief Get current amplitude (0-1000)
  * @param env Pointer to envelope structure
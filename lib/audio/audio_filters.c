@@ -4,6 +4,7 @@
  */
 
 #include "audio_filters.h"
+#include "audio_engine.h"
 
 //=============================================================================
 // INTERNAL STATE
@@ -11,6 +12,53 @@
 static int16_t prev_sample = 0;
 static int16_t prev_input = 0;
 
+//=============================================================================
+// WAVESHAPER CURVES (65 points over -1.0 .. +1.0, Q15)
+//=============================================================================
+
+// tanh(2x) / tanh(2)
+static const int16_t shape_tanh[SHAPE_TABLE_SIZE + 1] = {
+    -32767, -32608, -32428, -32225, -31997, -31741, -31452, -31129,
+    -30766, -30359, -29905, -29398, -28833, -28205, -27508, -26737,
+    -25886, -24951, -23926, -22806, -21589, -20271, -18851, -17329,
+    -15707, -13989, -12180, -10289, -8325,  -6299,  -4227,  -2122,
+    0,      2122,   4227,   6299,   8325,   10289,  12180,  13989,
+    15707,  17329,  18851,  20271,  21589,  22806,  23926,  24951,
+    25886,  26737,  27508,  28205,  28833,  29398,  29905,  30359,
+    30766,  31129,  31452,  31741,  31997,  32225,  32428,  32608,
+    32767
+};
+
+// Linear up to 0.6, then folds back towards zero
+static const int16_t shape_foldback[SHAPE_TABLE_SIZE + 1] = {
+    -10922, -12629, -14336, -16042, -17749, -19455, -21162, -22869,
+    -24575, -26282, -27988, -29695, -31402, -32426, -30719, -29012,
+    -27306, -25599, -23893, -22186, -20479, -18773, -17066, -15360,
+    -13653, -11946, -10240, -8533,  -6826,  -5120,  -3413,  -1707,
+    0,      1707,   3413,   5120,   6826,   8533,   10240,  11946,
+    13653,  15360,  17066,  18773,  20479,  22186,  23893,  25599,
+    27306,  29012,  30719,  32426,  31402,  29695,  27988,  26282,
+    24575,  22869,  21162,  19455,  17749,  16042,  14336,  12629,
+    10922
+};
+
+// Exponential, softer on the positive half (like Filter_SoftClip)
+static const int16_t shape_tube[SHAPE_TABLE_SIZE + 1] = {
+    -27852, -27820, -27783, -27739, -27688, -27628, -27558, -27477,
+    -27381, -27270, -27140, -26987, -26809, -26600, -26357, -26072,
+    -25739, -25350, -24895, -24363, -23741, -23013, -22163, -21169,
+    -20007, -18648, -17060, -15203, -13032, -10493, -7526,  -4056,
+    0,      3086,   5896,   8454,   10783,  12904,  14836,  16594,
+    18195,  19653,  20980,  22188,  23289,  24290,  25203,  26033,
+    26789,  27478,  28105,  28676,  29196,  29669,  30100,  30492,
+    30849,  31175,  31471,  31740,  31986,  32209,  32413,  32598,
+    32767
+};
+
+static const int16_t *const shape_curves[SHAPE_COUNT] = {
+    shape_tanh, shape_foldback, shape_tube
+};
+
 //=============================================================================
 // FILTERS
 //=============================================================================
@@ -82,16 +130,86 @@ int16_t Filter_GainWithFreqCompensation(int16_t sample, uint8_t gain, uint32_t f
 }
 
 //=============================================================================
-// UTILITIES
+// BLOCK EFFECTS
 //=============================================================================
 
-uint16_t Audio_SampleToPWM(int16_t sample, uint16_t pwm_center, uint16_t pwm_max) {
-    // Scale sample to PWM range
-    int32_t val = pwm_center + (sample * 2);
-    
-    // Clamp to valid range
-    if (val < 0) val = 0;
-    if (val > pwm_max) val = pwm_max;
-    
-    return (uint16_t)val;
+void Waveshaper_Init(Waveshaper_t *ws, WaveshapeCurve_t curve,
+                     uint16_t drive, int16_t level) {
+    if (curve >= SHAPE_COUNT) curve = SHAPE_TANH;
+    ws->curve = shape_curves[curve];
+    ws->drive = drive;
+    ws->level = level;
+}
+
+void Waveshaper_ProcessBlock(Waveshaper_t *ws, int16_t *buf, uint16_t n) {
+    const int16_t *curve = ws->curve;
+    int32_t drive = ws->drive;
+    int32_t level = ws->level;
+
+    for (uint16_t i = 0; i < n; i++) {
+        // Drive and saturate to 16 bits
+        int32_t x = ((int32_t)buf[i] * drive) >> 8;
+        if (x > 32767) x = 32767;
+        if (x < -32768) x = -32768;
+
+        // Top 6 bits select the segment, low 10 bits interpolate
+        uint32_t u = (uint32_t)(x + 32768);
+        uint32_t idx = u >> 10;
+        int32_t frac = (int32_t)(u & 0x3FF);
+        int32_t y0 = curve[idx];
+        int32_t y = y0 + (((curve[idx + 1] - y0) * frac) >> 10);
+
+        buf[i] = (int16_t)((y * level) >> 15);
+    }
+}
+
+void Bitcrusher_Init(Bitcrusher_t *bc, uint8_t bits, uint32_t rate) {
+    if (bits < 1) bits = 1;
+    if (bits > 16) bits = 16;
+    if (rate > 0x10000) rate = 0x10000;  // At most one new sample per sample
+    bc->mask = (int16_t)(0xFFFF << (16 - bits));
+    bc->rate = rate;
+    bc->phase = 0xFFFF;  // Capture the first sample immediately
+    bc->held = 0;
+}
+
+void Bitcrusher_ProcessBlock(Bitcrusher_t *bc, int16_t *buf, uint16_t n) {
+    uint32_t phase = bc->phase;
+    int16_t held = bc->held;
+
+    for (uint16_t i = 0; i < n; i++) {
+        // Sample-and-hold: take a new sample each time the phase wraps
+        phase += bc->rate;
+        if (phase > 0xFFFF) {
+            phase &= 0xFFFF;
+            held = (int16_t)(buf[i] & bc->mask);
+        }
+        buf[i] = held;
+    }
+
+    bc->phase = (uint16_t)phase;
+    bc->held = held;
+}
+
+void Tremolo_Init(Tremolo_t *trem, uint16_t rate, uint8_t depth) {
+    if (depth > 100) depth = 100;
+    trem->phase = 0;
+    trem->rate = rate;
+    trem->depth = depth;
+}
+
+void Tremolo_ProcessBlock(Tremolo_t *trem, int16_t *buf, uint16_t n) {
+    const int16_t *sine = Audio_GetSineTable();
+    uint16_t phase = trem->phase;
+    int32_t depth = trem->depth;
+
+    for (uint16_t i = 0; i < n; i++) {
+        // Gain = 1 + lfo/1000 * depth/100, in Q15 (21475 / 65536 = 0.32768)
+        int32_t lfo = sine[phase >> 8];
+        int32_t gain = 32768 + ((lfo * depth * 21475) >> 16);
+        buf[i] = (int16_t)(((int32_t)buf[i] * gain) >> 15);
+        phase += trem->rate;
+    }
+
+    trem->phase = phase;
 }
@@ -8,6 +8,11 @@
  * Usage:
  *   int16_t filtered = Filter_LowPass(sample);
  *   int16_t clipped = Filter_SoftClip(sample, 1600);
+ *
+ *   // Block effects (no divides per sample):
+ *   Waveshaper_t ws;
+ *   Waveshaper_Init(&ws, SHAPE_TANH, 16 << 8, 2048);  // 12-bit in/out
+ *   Waveshaper_ProcessBlock(&ws, buffer, 32);
  */
 
 #ifndef AUDIO_FILTERS_H_
@@ -15,6 +20,51 @@
 
 #include <stdint.h>
 
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Waveshaper transfer curves
+ */
+typedef enum {
+    SHAPE_TANH = 0,     ///< Symmetric soft saturation (odd harmonics)
+    SHAPE_FOLDBACK,     ///< Wave folding above 60% of full scale
+    SHAPE_TUBE,         ///< Asymmetric tube-style curve (even harmonics)
+    SHAPE_COUNT
+} WaveshapeCurve_t;
+
+/**
+ * @brief LUT waveshaper state
+ */
+typedef struct {
+    const int16_t *curve;   ///< Transfer curve (SHAPE_TABLE_SIZE + 1 points)
+    uint16_t drive;         ///< Input gain, Q8 (256 = unity)
+    int16_t level;          ///< Output level, Q15 (32767 = unity)
+} Waveshaper_t;
+
+/**
+ * @brief Sample-rate / bit-depth reducer state
+ */
+typedef struct {
+    uint32_t rate;          ///< Hold rate, Q16 (0x10000 = every sample)
+    uint16_t phase;         ///< Hold phase accumulator
+    int16_t mask;           ///< Bit mask applied to held samples
+    int16_t held;           ///< Currently held sample
+} Bitcrusher_t;
+
+/**
+ * @brief Amplitude LFO (tremolo) state
+ */
+typedef struct {
+    uint16_t phase;         ///< LFO phase (top 8 bits index the sine table)
+    uint16_t rate;          ///< Phase increment per sample
+    uint8_t depth;          ///< Modulation depth (0-100 %)
+} Tremolo_t;
+
+/** Number of segments in a waveshaper curve (indexed by top 6 bits) */
+#define SHAPE_TABLE_SIZE 64
+
 //=============================================================================
 // PUBLIC API - FILTERS
 //=============================================================================
@@ -75,17 +125,58 @@ int16_t Filter_HardClip(int16_t sample, int16_t limit);
  */
 int16_t Filter_GainWithFreqCompensation(int16_t sample, uint8_t gain, uint32_t frequency_hz);
 
-//=============================================================================
-// PUBLIC API - UTILITIES
-//=============================================================================
+/**
+ * @brief Initialize LUT waveshaper
+ * @param ws Pointer to waveshaper structure
+ * @param curve Transfer curve
+ * @param drive Input gain, Q8 (256 = unity, 16 << 8 drives 12-bit to full scale)
+ * @param level Output level, Q15 (2048 maps full scale back to 12-bit)
+ */
+void Waveshaper_Init(Waveshaper_t *ws, WaveshapeCurve_t curve,
+                     uint16_t drive, int16_t level);
+
+/**
+ * @brief Shape a block of samples in place
+ * @param ws Pointer to waveshaper structure
+ * @param buf Sample buffer
+ * @param n Number of samples
+ *
+ * Input is scaled by drive, saturated to 16 bits and looked up in the
+ * curve by its top 6 bits, with linear interpolation on the lower 10.
+ */
+void Waveshaper_ProcessBlock(Waveshaper_t *ws, int16_t *buf, uint16_t n);
+
+/**
+ * @brief Initialize bitcrusher
+ * @param bc Pointer to bitcrusher structure
+ * @param bits Bits kept out of 16 (1-16, 16 = no reduction)
+ * @param rate Hold rate, Q16 (0x10000 = full rate, 0x4000 = 1/4 rate;
+ *             higher values are limited to 0x10000)
+ */
+void Bitcrusher_Init(Bitcrusher_t *bc, uint8_t bits, uint32_t rate);
+
+/**
+ * @brief Crush a block of samples in place
+ * @param bc Pointer to bitcrusher structure
+ * @param buf Sample buffer
+ * @param n Number of samples
+ */
+void Bitcrusher_ProcessBlock(Bitcrusher_t *bc, int16_t *buf, uint16_t n);
+
+/**
+ * @brief Initialize tremolo
+ * @param trem Pointer to tremolo structure
+ * @param rate LFO phase increment per sample (67 = ~16 Hz at 16 kHz)
+ * @param depth Modulation depth (0-100 %)
+ */
+void Tremolo_Init(Tremolo_t *trem, uint16_t rate, uint8_t depth);
 
 /**
- * @brief Scale sample to PWM range
- * @param sample Audio sample (-2000 to +2000)
- * @param pwm_center PWM center value (e.g., 2048)
- * @param pwm_max Maximum PWM value (e.g., 4095)
- * @return PWM value (0 to pwm_max)
+ * @brief Apply tremolo to a block of samples in place
+ * @param trem Pointer to tremolo structure
+ * @param buf Sample buffer
+ * @param n Number of samples
  */
-uint16_t Audio_SampleToPWM(int16_t sample, uint16_t pwm_center, uint16_t pwm_max);
+void Tremolo_ProcessBlock(Tremolo_t *trem, int16_t *buf, uint16_t n);
 
 #endif /* AUDIO_FILTERS_H_ */
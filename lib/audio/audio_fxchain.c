@@ -0,0 +1,130 @@
+/**
+ * @file audio_fxchain.c
+ * @brief Insert-Effects Chain Implementation
+ */
+
+#include "audio_fxchain.h"
+#include "audio_filters.h"
+#include <stddef.h>
+
+//=============================================================================
+// EFFECT ADAPTERS
+//=============================================================================
+
+static void fx_waveshaper_process(void *state, int16_t *buf, uint16_t n) {
+    Waveshaper_ProcessBlock((Waveshaper_t *)state, buf, n);
+}
+
+static void fx_bitcrusher_process(void *state, int16_t *buf, uint16_t n) {
+    Bitcrusher_ProcessBlock((Bitcrusher_t *)state, buf, n);
+}
+
+static void fx_bitcrusher_reset(void *state) {
+    Bitcrusher_t *bc = (Bitcrusher_t *)state;
+    bc->phase = 0xFFFF;
+    bc->held = 0;
+}
+
+static void fx_tremolo_process(void *state, int16_t *buf, uint16_t n) {
+    Tremolo_ProcessBlock((Tremolo_t *)state, buf, n);
+}
+
+static void fx_tremolo_reset(void *state) {
+    ((Tremolo_t *)state)->phase = 0;
+}
+
+const FxType_t FX_WAVESHAPER = {"DRIVE", fx_waveshaper_process, NULL};
+const FxType_t FX_BITCRUSHER = {"CRUSH", fx_bitcrusher_process, fx_bitcrusher_reset};
+const FxType_t FX_TREMOLO = {"TREM", fx_tremolo_process, fx_tremolo_reset};
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void FxChain_Init(FxChain_t *chain, FxClock_t clock) {
+    chain->clock = clock;
+    chain->budget = 0;
+    FxChain_Clear(chain);
+}
+
+void FxChain_Clear(FxChain_t *chain) {
+    chain->count = 0;
+    chain->cycles = 0;
+    chain->skipped = 0;
+}
+
+int8_t FxChain_Add(FxChain_t *chain, const FxType_t *type, void *state) {
+    if (chain->count >= FX_CHAIN_MAX_SLOTS || type == NULL) {
+        return -1;
+    }
+
+    FxSlot_t *slot = &chain->slots[chain->count];
+    slot->type = type;
+    slot->state = state;
+    slot->bypass = false;
+    slot->cycles = 0;
+    slot->cycles_max = 0;
+    if (type->reset) type->reset(state);
+
+    return (int8_t)chain->count++;
+}
+
+int8_t FxChain_Find(FxChain_t *chain, const void *state) {
+    for (uint8_t i = 0; i < chain->count; i++) {
+        if (chain->slots[i].state == state) return (int8_t)i;
+    }
+    return -1;
+}
+
+void FxChain_SetBypass(FxChain_t *chain, int8_t slot, bool bypass) {
+    if (slot < 0 || slot >= chain->count) return;
+    chain->slots[slot].bypass = bypass;
+}
+
+void FxChain_SetBudget(FxChain_t *chain, uint32_t cycles) {
+    chain->budget = cycles;
+}
+
+void FxChain_Reset(FxChain_t *chain) {
+    for (uint8_t i = 0; i < chain->count; i++) {
+        FxSlot_t *slot = &chain->slots[i];
+        if (slot->type->reset) slot->type->reset(slot->state);
+        slot->cycles = 0;
+        slot->cycles_max = 0;
+    }
+    chain->cycles = 0;
+    chain->skipped = 0;
+}
+
+void FxChain_Process(FxChain_t *chain, int16_t *buf, uint16_t n) {
+    uint32_t total = 0;
+
+    for (uint8_t i = 0; i < chain->count; i++) {
+        FxSlot_t *slot = &chain->slots[i];
+
+        if (slot->bypass) {
+            slot->cycles = 0;
+            continue;
+        }
+        if (chain->budget != 0 && total >= chain->budget) {
+            // Over budget: drop the rest of the chain for this block
+            slot->cycles = 0;
+            chain->skipped++;
+            continue;
+        }
+
+        if (chain->clock) {
+            uint32_t start = chain->clock();
+            slot->type->process(slot->state, buf, n);
+            uint32_t spent = chain->clock() - start;  // Wraps correctly
+
+            slot->cycles = spent;
+            if (spent > slot->cycles_max) slot->cycles_max = spent;
+            total += spent;
+        } else {
+            slot->type->process(slot->state, buf, n);
+        }
+    }
+
+    chain->cycles = total;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file audio_fxchain.h
+ * @brief Ordered Insert-Effects Chain with Cycle Accounting
+ * @version 1.0.0
+ *
+ * Runs a list of block effects in order. Each slot can be bypassed and
+ * reset, and the chain measures cycles per effect per block using a
+ * free-running counter supplied by the application.
+ *
+ * Usage:
+ *   FxChain_t chain;
+ *   Waveshaper_t drive;
+ *   FxChain_Init(&chain, Cycles_Now);
+ *   FxChain_Add(&chain, &FX_WAVESHAPER, &drive);
+ *   FxChain_SetBudget(&chain, 40000);   // cycles per block (0 = no cap)
+ *
+ *   // Once per audio block:
+ *   FxChain_Process(&chain, buffer, 32);
+ */
+
+#ifndef AUDIO_FXCHAIN_H_
+#define AUDIO_FXCHAIN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define FX_CHAIN_MAX_SLOTS 4
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Effect type (callbacks shared by all instances of an effect)
+ */
+typedef struct {
+    const char *name;                                       ///< Short name
+    void (*process)(void *state, int16_t *buf, uint16_t n); ///< In-place block
+    void (*reset)(void *state);                             ///< Clear history (may be NULL)
+} FxType_t;
+
+/**
+ * @brief One effect instance in the chain
+ */
+typedef struct {
+    const FxType_t *type;   ///< Effect callbacks
+    void *state;            ///< Effect state (e.g. Waveshaper_t *)
+    bool bypass;            ///< Skip this effect
+    uint32_t cycles;        ///< Cycles spent in the last block
+    uint32_t cycles_max;    ///< Worst block seen since last reset
+} FxSlot_t;
+
+/**
+ * @brief Free-running up-counter (wraps at 2^32)
+ */
+typedef uint32_t (*FxClock_t)(void);
+
+/**
+ * @brief Effects chain
+ */
+typedef struct {
+    FxSlot_t slots[FX_CHAIN_MAX_SLOTS];
+    uint8_t count;              ///< Slots in use
+    FxClock_t clock;            ///< Cycle counter (NULL = no accounting)
+    uint32_t budget;            ///< Max cycles per block (0 = unlimited)
+    uint32_t cycles;            ///< Total cycles in the last block
+    uint32_t skipped;           ///< Effects skipped because of the budget
+} FxChain_t;
+
+//=============================================================================
+// EFFECT TYPES (wrap the audio_filters.h block effects)
+//=============================================================================
+extern const FxType_t FX_WAVESHAPER;   ///< State: Waveshaper_t
+extern const FxType_t FX_BITCRUSHER;   ///< State: Bitcrusher_t
+extern const FxType_t FX_TREMOLO;      ///< State: Tremolo_t
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize an empty chain
+ * @param chain Pointer to chain structure
+ * @param clock Cycle counter used for accounting (may be NULL)
+ */
+void FxChain_Init(FxChain_t *chain, FxClock_t clock);
+
+/**
+ * @brief Remove all effects (keeps clock and budget)
+ * @param chain Pointer to chain structure
+ */
+void FxChain_Clear(FxChain_t *chain);
+
+/**
+ * @brief Append an effect to the end of the chain
+ * @param chain Pointer to chain structure
+ * @param type Effect type
+ * @param state Effect state
+ * @return Slot index, or -1 if the chain is full
+ */
+int8_t FxChain_Add(FxChain_t *chain, const FxType_t *type, void *state);
+
+/**
+ * @brief Find the first slot holding a given effect state
+ * @param chain Pointer to chain structure
+ * @param state Effect state to look for
+ * @return Slot index, or -1 if not in the chain
+ */
+int8_t FxChain_Find(FxChain_t *chain, const void *state);
+
+/**
+ * @brief Bypass or re-enable one slot
+ * @param chain Pointer to chain structure
+ * @param slot Slot index (ignored if out of range)
+ * @param bypass true to skip the effect
+ */
+void FxChain_SetBypass(FxChain_t *chain, int8_t slot, bool bypass);
+
+/**
+ * @brief Set cycle budget per block
+ * @param chain Pointer to chain structure
+ * @param cycles Max cycles per block, 0 = unlimited
+ *
+ * Once a block has used the budget, the remaining effects are skipped
+ * for that block and counted in chain->skipped.
+ */
+void FxChain_SetBudget(FxChain_t *chain, uint32_t cycles);
+
+/**
+ * @brief Reset every effect and clear the cycle statistics
+ * @param chain Pointer to chain structure
+ */
+void FxChain_Reset(FxChain_t *chain);
+
+/**
+ * @brief Run the chain over one block, in place
+ * @param chain Pointer to chain structure
+ * @param buf Sample buffer
+ * @param n Number of samples
+ */
+void FxChain_Process(FxChain_t *chain, int16_t *buf, uint16_t n);
+
+#endif /* AUDIO_FXCHAIN_H_ */
@@ -0,0 +1,231 @@
+/**
+ * @file audio_mixer.c
+ * @brief Voice Mixer Implementation
+ */
+
+#include "audio_mixer.h"
+#include <stddef.h>
+#include <string.h>
+
+//=============================================================================
+// TABLES
+//=============================================================================
+
+// sin(i/16 * 90 deg) in Q15, for the equal-power pan law
+static const uint16_t pan_table[17] = {
+    0,     3212,  6393,  9512,  12539, 15446, 18204, 20787, 23170,
+    25329, 27245, 28898, 30273, 31356, 32137, 32609, 32767
+};
+
+// 1/sqrt(voices) in Q15
+static const uint16_t headroom_table[8] = {
+    32768, 23170, 18919, 16384, 14654, 13377, 12385, 11585
+};
+
+#define BUS_LIMIT ((1 << 18) - 1)
+
+//=============================================================================
+// INTERNAL HELPERS
+//=============================================================================
+
+static int32_t mul_q15(int32_t a, int32_t b) {
+    return (a * b) >> 15;
+}
+
+/**
+ * @brief Equal-power pan gain for one side, Q15
+ * @param pos 0 (silent) .. 128 (full), clamped
+ */
+static int32_t pan_gain(int32_t pos) {
+    if (pos <= 0) return pan_table[0];
+    int32_t idx = pos >> 3;
+    if (idx >= 16) return pan_table[16];
+    int32_t g0 = pan_table[idx];
+    return g0 + (((pan_table[idx + 1] - g0) * (pos & 7)) >> 3);
+}
+
+/**
+ * @brief Fold fader, trim, pan and group levels into the channel gains
+ */
+static void mixer_update_channel(Mixer_t *mix, MixerChannel_t *c) {
+    const MixerGroup_t *grp = &mix->group[c->group];
+    int32_t level = mul_q15(c->gain, mix->trim);
+
+    int32_t dry = mul_q15(level, grp->dry);
+    if (mix->layout == MIXER_STEREO) {
+        // 0 .. 128: +63 is hard right, like MIDI pan 127
+        int32_t pos = (c->pan >= 63) ? 128 : (int32_t)c->pan + 64;
+        c->gain_l = mul_q15(dry, pan_gain(128 - pos));
+        c->gain_r = mul_q15(dry, pan_gain(pos));
+    } else {
+        c->gain_l = dry;
+        c->gain_r = 0;
+    }
+
+    for (uint8_t s = 0; s < MIXER_MAX_SENDS; s++) {
+        c->gain_send[s] = mul_q15(level, grp->send[s]);
+    }
+}
+
+static void mixer_update_all(Mixer_t *mix) {
+    for (uint8_t ch = 0; ch < MIXER_MAX_CHANNELS; ch++) {
+        mixer_update_channel(mix, &mix->channel[ch]);
+    }
+}
+
+static void mix_into(int32_t *bus, const int16_t *in, int32_t gain,
+                     uint16_t n) {
+    // 12-bit scale in, 16-bit scale out: (x * Q15) >> 15 << 4
+    for (uint16_t i = 0; i < n; i++) {
+        bus[i] += ((int32_t)in[i] * gain) >> 11;
+    }
+}
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void Mixer_Init(Mixer_t *mix, MixerLayout_t layout) {
+    memset(mix, 0, sizeof(Mixer_t));
+    mix->layout = layout;
+    mix->trim = MIXER_UNITY;
+    mix->master = MIXER_UNITY;
+    mix->master_target = MIXER_UNITY;
+
+    for (uint8_t g = 0; g < MIXER_MAX_GROUPS; g++) {
+        mix->group[g].dry = MIXER_UNITY;
+    }
+    for (uint8_t s = 0; s < MIXER_MAX_SENDS; s++) {
+        mix->ret[s] = MIXER_UNITY;
+    }
+}
+
+void Mixer_SetChannel(Mixer_t *mix, uint8_t ch, uint16_t gain, int8_t pan,
+                      uint8_t group) {
+    if (ch >= MIXER_MAX_CHANNELS || group >= MIXER_MAX_GROUPS) return;
+
+    MixerChannel_t *c = &mix->channel[ch];
+    c->gain = gain;
+    c->pan = (pan < -64) ? -64 : (pan > 63) ? 63 : pan;
+    c->group = group;
+    mixer_update_channel(mix, c);
+}
+
+void Mixer_SetGroupDry(Mixer_t *mix, uint8_t group, uint16_t level) {
+    if (group >= MIXER_MAX_GROUPS) return;
+    mix->group[group].dry = level;
+    mixer_update_all(mix);
+}
+
+void Mixer_SetGroupSend(Mixer_t *mix, uint8_t group, uint8_t send,
+                        uint16_t level) {
+    if (group >= MIXER_MAX_GROUPS || send >= MIXER_MAX_SENDS) return;
+    mix->group[group].send[send] = level;
+    mixer_update_all(mix);
+}
+
+void Mixer_SetReturn(Mixer_t *mix, uint8_t send, uint16_t level) {
+    if (send >= MIXER_MAX_SENDS) return;
+    mix->ret[send] = level;
+}
+
+void Mixer_SetHeadroom(Mixer_t *mix, uint8_t voices) {
+    if (voices == 0) voices = 1;
+    if (voices > 8) voices = 8;
+
+    uint16_t trim = headroom_table[voices - 1];
+    if (trim == mix->trim) return;
+    mix->trim = trim;
+    mixer_update_all(mix);
+}
+
+void Mixer_SetMaster(Mixer_t *mix, uint16_t gain) {
+    mix->master_target = gain;
+}
+
+void Mixer_BeginBlock(Mixer_t *mix, uint16_t n) {
+    if (n > MIXER_BLOCK_MAX) n = MIXER_BLOCK_MAX;
+    mix->n = n;
+
+    memset(mix->bus_l, 0, n * sizeof(int32_t));
+    if (mix->layout == MIXER_STEREO) {
+        memset(mix->bus_r, 0, n * sizeof(int32_t));
+    }
+    for (uint8_t s = 0; s < MIXER_MAX_SENDS; s++) {
+        memset(mix->send[s], 0, n * sizeof(int32_t));
+    }
+}
+
+void Mixer_AddVoice(Mixer_t *mix, uint8_t ch, const int16_t *in, uint16_t n) {
+    if (ch >= MIXER_MAX_CHANNELS) return;
+    if (n > mix->n) n = mix->n;
+
+    const MixerChannel_t *c = &mix->channel[ch];
+    if (c->gain_l != 0) mix_into(mix->bus_l, in, c->gain_l, n);
+    if (c->gain_r != 0) mix_into(mix->bus_r, in, c->gain_r, n);
+
+    for (uint8_t s = 0; s < MIXER_MAX_SENDS; s++) {
+        if (c->gain_send[s] != 0) mix_into(mix->send[s], in, c->gain_send[s], n);
+    }
+}
+
+void Mixer_GetSend(Mixer_t *mix, uint8_t send, int16_t *out, uint16_t n) {
+    if (send >= MIXER_MAX_SENDS) return;
+    if (n > mix->n) n = mix->n;
+
+    const int32_t *bus = mix->send[send];
+    for (uint16_t i = 0; i < n; i++) {
+        int32_t x = bus[i] >> 4;
+        if (x > 32767) x = 32767;
+        if (x < -32768) x = -32768;
+        out[i] = (int16_t)x;
+    }
+}
+
+void Mixer_AddReturn(Mixer_t *mix, uint8_t send, const int16_t *in,
+                     uint16_t n) {
+    if (send >= MIXER_MAX_SENDS) return;
+    if (n > mix->n) n = mix->n;
+
+    int32_t level = mix->ret[send];
+    if (level == 0) return;
+
+    if (mix->layout == MIXER_STEREO) {
+        int32_t centre = mul_q15(level, pan_gain(64));
+        mix_into(mix->bus_l, in, centre, n);
+        mix_into(mix->bus_r, in, centre, n);
+    } else {
+        mix_into(mix->bus_l, in, level, n);
+    }
+}
+
+void Mixer_Render(Mixer_t *mix, const uint16_t *env, int32_t *out_l,
+                  int32_t *out_r, uint16_t n) {
+    if (n > mix->n) n = mix->n;
+    if (n == 0) return;
+
+    // Master gain: one divide per block, linear ramp across it
+    int32_t gain = mix->master;
+    int32_t step = (mix->master_target - gain) / (int32_t)n;
+    uint8_t sides = (mix->layout == MIXER_STEREO && out_r != NULL) ? 2 : 1;
+
+    for (uint8_t side = 0; side < sides; side++) {
+        const int32_t *bus = side ? mix->bus_r : mix->bus_l;
+        int32_t *out = side ? out_r : out_l;
+        int32_t g = gain;
+
+        for (uint16_t i = 0; i < n; i++) {
+            g += step;
+            int32_t gi = env ? (g * env[i]) >> 15 : g;
+
+            int32_t x = bus[i];
+            if (x > BUS_LIMIT) x = BUS_LIMIT;
+            if (x < -BUS_LIMIT) x = -BUS_LIMIT;
+
+            // (x / 8) * gain (<= 2^16) fits 32 bits for |x| < 2^18
+            out[i] = ((x >> 3) * gi) >> 12;
+        }
+    }
+
+    mix->master = mix->master_target;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file audio_mixer.h
+ * @brief Voice Mixer with Groups, Effect Sends and Master Gain
+ * @version 1.0.0
+ *
+ * Voices (12-bit scale, +/-2048) are summed onto 32-bit buses at 16-bit
+ * scale (x16), so nothing is divided by the voice count and nothing clips
+ * before the master limiter. Gain, pan, headroom trim and send levels are
+ * folded into one pre-scaled multiplier per channel and destination when a
+ * setting changes; the per-sample work is one multiply-add per destination.
+ *
+ * Each channel belongs to a group. A group has a dry level and a level per
+ * effect send; the application processes a send block and mixes it back
+ * in as a return. The master gain is ramped once per block.
+ *
+ * Usage:
+ *   Mixer_t mixer;
+ *   Mixer_Init(&mixer, MIXER_MONO);
+ *   Mixer_SetChannel(&mixer, 0, MIXER_UNITY, 0, 0);
+ *   Mixer_SetGroupSend(&mixer, 0, 0, MIXER_UNITY);
+ *
+ *   // Once per block:
+ *   Mixer_BeginBlock(&mixer, 32);
+ *   Mixer_AddVoice(&mixer, 0, voice0, 32);
+ *   Mixer_GetSend(&mixer, 0, fx, 32);
+ *   FxChain_Process(&chain, fx, 32);
+ *   Mixer_AddReturn(&mixer, 0, fx, 32);
+ *   Mixer_Render(&mixer, envelope, bus, NULL, 32);
+ */
+
+#ifndef AUDIO_MIXER_H_
+#define AUDIO_MIXER_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef MIXER_BLOCK_MAX
+#define MIXER_BLOCK_MAX 32     // Largest block passed to the mixer
+#endif
+#ifndef MIXER_MAX_CHANNELS
+#define MIXER_MAX_CHANNELS 4      // Raise for more multi-timbral parts
+#endif
+#define MIXER_MAX_GROUPS   2
+#define MIXER_MAX_SENDS    2
+
+#define MIXER_UNITY 32768      // 0 dB in Q15
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Output layout
+ */
+typedef enum {
+    MIXER_MONO = 0,        ///< One bus, pan ignored (DAC12 path)
+    MIXER_STEREO           ///< Left/right buses, equal-power pan
+} MixerLayout_t;
+
+/**
+ * @brief Channel settings and pre-scaled gains
+ */
+typedef struct {
+    uint16_t gain;                        ///< Fader, Q15 (MIXER_UNITY = 0 dB)
+    int8_t pan;                           ///< -64 left, 0 centre, +63 right
+    uint8_t group;                        ///< Voice group
+    int32_t gain_l;                       ///< Dry gain, left or mono, Q15
+    int32_t gain_r;                       ///< Dry gain, right, Q15
+    int32_t gain_send[MIXER_MAX_SENDS];   ///< Send gains, Q15 (0 = skip)
+} MixerChannel_t;
+
+/**
+ * @brief Group routing levels
+ */
+typedef struct {
+    uint16_t dry;                         ///< Level to the master bus, Q15
+    uint16_t send[MIXER_MAX_SENDS];       ///< Level to each send, Q15
+} MixerGroup_t;
+
+/**
+ * @brief Mixer state and block buses
+ */
+typedef struct {
+    MixerLayout_t layout;
+    MixerChannel_t channel[MIXER_MAX_CHANNELS];
+    MixerGroup_t group[MIXER_MAX_GROUPS];
+    uint16_t ret[MIXER_MAX_SENDS];        ///< Return levels, Q15
+    uint16_t trim;                        ///< Headroom trim per channel, Q15
+    int32_t master;                       ///< Master gain at end of last block, Q15
+    int32_t master_target;                ///< Master gain for the next block, Q15
+    uint16_t n;                           ///< Samples in the current block
+    int32_t bus_l[MIXER_BLOCK_MAX];       ///< Master bus (left or mono)
+    int32_t bus_r[MIXER_BLOCK_MAX];       ///< Master bus (right)
+    int32_t send[MIXER_MAX_SENDS][MIXER_BLOCK_MAX];
+} Mixer_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize mixer (channels silent, groups dry at 0 dB, returns at 0 dB)
+ * @param mix Pointer to mixer
+ * @param layout MIXER_MONO or MIXER_STEREO
+ */
+void Mixer_Init(Mixer_t *mix, MixerLayout_t layout);
+
+/**
+ * @brief Set channel fader, pan and group
+ * @param mix Pointer to mixer
+ * @param ch Channel index
+ * @param gain Fader, Q15 (MIXER_UNITY = 0 dB, max +6 dB)
+ * @param pan -64 (hard left) to +63 (hard right), clamped
+ * @param group Voice group
+ */
+void Mixer_SetChannel(Mixer_t *mix, uint8_t ch, uint16_t gain, int8_t pan,
+                      uint8_t group);
+
+/**
+ * @brief Set a group's level to the master bus
+ * @param mix Pointer to mixer
+ * @param group Voice group
+ * @param level Q15
+ */
+void Mixer_SetGroupDry(Mixer_t *mix, uint8_t group, uint16_t level);
+
+/**
+ * @brief Set a group's level to an effect send
+ * @param mix Pointer to mixer
+ * @param group Voice group
+ * @param send Send index
+ * @param level Q15 (0 = not routed)
+ */
+void Mixer_SetGroupSend(Mixer_t *mix, uint8_t group, uint8_t send,
+                        uint16_t level);
+
+/**
+ * @brief Set the level an effect return is mixed back at
+ * @param mix Pointer to mixer
+ * @param send Send index
+ * @param level Q15
+ */
+void Mixer_SetReturn(Mixer_t *mix, uint8_t send, uint16_t level);
+
+/**
+ * @brief Trim every channel for a number of simultaneous voices
+ * @param mix Pointer to mixer
+ * @param voices Voices sounding together (trim = 1/sqrt(voices))
+ *
+ * Keeps the summed RMS level roughly constant from one voice to a chord;
+ * peaks above full scale are left to the master limiter.
+ */
+void Mixer_SetHeadroom(Mixer_t *mix, uint8_t voices);
+
+/**
+ * @brief Set master gain (applied from the next block, ramped)
+ * @param mix Pointer to mixer
+ * @param gain Q15 (MIXER_UNITY = 0 dB, max +6 dB)
+ */
+void Mixer_SetMaster(Mixer_t *mix, uint16_t gain);
+
+/**
+ * @brief Clear the buses for a new block
+ * @param mix Pointer to mixer
+ * @param n Block length (clamped to MIXER_BLOCK_MAX)
+ */
+void Mixer_BeginBlock(Mixer_t *mix, uint16_t n);
+
+/**
+ * @brief Mix one voice block into the master bus and its group's sends
+ * @param mix Pointer to mixer
+ * @param ch Channel index
+ * @param in Voice samples (12-bit scale)
+ * @param n Number of samples
+ */
+void Mixer_AddVoice(Mixer_t *mix, uint8_t ch, const int16_t *in, uint16_t n);
+
+/**
+ * @brief Read a send bus for effect processing
+ * @param mix Pointer to mixer
+ * @param send Send index
+ * @param out Send samples (12-bit scale, saturated to 16 bits)
+ * @param n Number of samples
+ */
+void Mixer_GetSend(Mixer_t *mix, uint8_t send, int16_t *out, uint16_t n);
+
+/**
+ * @brief Mix a processed send back into the master bus (centre)
+ * @param mix Pointer to mixer
+ * @param send Send index (selects the return level)
+ * @param in Processed samples (12-bit scale)
+ * @param n Number of samples
+ */
+void Mixer_AddReturn(Mixer_t *mix, uint8_t send, const int16_t *in,
+                     uint16_t n);
+
+/**
+ * @brief Apply master gain and write the block
+ * @param mix Pointer to mixer
+ * @param env Per-sample gain, Q15 (e.g. amplitude envelope), or NULL
+ * @param out_l Left or mono output (32-bit, 16-bit scale)
+ * @param out_r Right output, or NULL (ignored for MIXER_MONO)
+ * @param n Number of samples
+ */
+void Mixer_Render(Mixer_t *mix, const uint16_t *env, int32_t *out_l,
+                  int32_t *out_r, uint16_t n);
+
+#endif /* AUDIO_MIXER_H_ */
@@ -0,0 +1,110 @@
+/**
+ * @file param_queue.h
+ * @brief Wait-Free Single-Producer/Single-Consumer Parameter Queue
+ * @version 1.0.0
+ *
+ * Carries typed parameter changes (an id and a 32-bit value) from the
+ * control context (main loop) to the audio context, which applies them at
+ * a block boundary. Exactly one context pushes and exactly one pops; each
+ * side writes only its own index, so neither ever waits or masks
+ * interrupts. Push and pop are a few loads and stores (C11 acquire/release,
+ * a DMB on the Cortex-M0+). The same code is correct between two threads
+ * on the host (tools/host/param_stress.c).
+ *
+ * A full queue refuses the message and counts it. Size it so that the
+ * producer cannot get PARAM_QUEUE_SIZE messages ahead of one block.
+ *
+ * Header-only: everything is static inline.
+ *
+ * Usage:
+ *   static ParamQueue_t q;
+ *   ParamQueue_Init(&q);
+ *
+ *   ParamQueue_Push(&q, PARAM_VOLUME, 80);   // Producer
+ *
+ *   ParamMsg_t msg;                          // Consumer, once per block
+ *   while (ParamQueue_Pop(&q, &msg))
+ *       apply(msg.id, msg.value);
+ */
+
+#ifndef PARAM_QUEUE_H_
+#define PARAM_QUEUE_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef PARAM_QUEUE_SIZE
+#define PARAM_QUEUE_SIZE 32        // Messages, power of two
+#endif
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    uint8_t id;                ///< Parameter (defined by the user)
+    int32_t value;
+} ParamMsg_t;
+
+typedef struct {
+    ParamMsg_t msgs[PARAM_QUEUE_SIZE];
+    atomic_uint_least16_t head;    ///< Next slot to write (producer)
+    atomic_uint_least16_t tail;    ///< Next slot to read (consumer)
+    uint16_t overflows;            ///< Messages refused, full (producer)
+} ParamQueue_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Empty the queue (while neither side is using it)
+ */
+static inline void ParamQueue_Init(ParamQueue_t *q) {
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    q->overflows = 0;
+}
+
+/**
+ * @brief Append a message (producer only)
+ * @return false if the queue was full (the message is dropped)
+ */
+static inline bool ParamQueue_Push(ParamQueue_t *q, uint8_t id,
+                                   int32_t value) {
+    uint16_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    uint16_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+    if ((uint16_t)(head - tail) >= PARAM_QUEUE_SIZE) {
+        q->overflows++;
+        return false;
+    }
+    ParamMsg_t *m = &q->msgs[head & (PARAM_QUEUE_SIZE - 1)];
+    m->id = id;
+    m->value = value;
+    // Publish: the slot is written before the consumer can see it
+    atomic_store_explicit(&q->head, (uint16_t)(head + 1),
+                          memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Take the oldest message (consumer only)
+ * @return false if the queue is empty
+ */
+static inline bool ParamQueue_Pop(ParamQueue_t *q, ParamMsg_t *msg) {
+    uint16_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    uint16_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (head == tail) return false;
+    *msg = q->msgs[tail & (PARAM_QUEUE_SIZE - 1)];
+    // Release: the slot is read before the producer can reuse it
+    atomic_store_explicit(&q->tail, (uint16_t)(tail + 1),
+                          memory_order_release);
+    return true;
+}
+
+#endif /* PARAM_QUEUE_H_ */
@@ -0,0 +1,1634 @@
+/**
+ * @file synth.c
+ * @brief Synth Engine Implementation
+ */
+
+#include "synth.h"
+#include "audio_filters.h"
+#include "audio_mixer.h"
+#include "audio_dynamics.h"
+#include "param_queue.h"
+#include "synth_parts.h"
+#include "../midi/midi_clock.h"
+#include "../midi/midi_msg.h"
+#include "../perf/perf_zone.h"
+#include "../perf/trace.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define PORTAMENTO_SPEED 25
+#define FREQ_MIN_HZ 20
+#define FREQ_MAX_HZ 8000
+#define ACCEL_Y_NEUTRAL 2849
+#define OCTAVE_UNPOSTED INT8_MIN // Control side: next tilt zone is sent
+#define MIDI_HELD_MAX 8          // Held MIDI notes remembered for legato
+#define MIDI_BEND_SEMITONES 2    // Pitch bend range, each way
+#define ARP_CLOCKS_PER_STEP 6    // Sixteenths
+#define EPIC_CLOCKS_PER_STEP (4 * MIDI_CLOCK_PPQN) // One 4/4 bar (2 s at 120 BPM)
+
+// Mixer: oscillator voices on channels 0-2 (group 0); send 0 feeds the
+// insert chain. Chords are trimmed by 1/sqrt(voices), peaks go to the limiter.
+#define MIX_CHORD_VOICES SYNTH_CHORD_VOICES
+#define MIX_GROUP_SYNTH 0
+#define MIX_SEND_FX 0
+
+// Master bus: voices sum on 32 bits, the limiter keeps the DAC clean
+static const DynamicsProfile_t MASTER_LIMITER = {
+    .threshold_db = -1, // dBFS (16-bit bus)
+    .knee_db = 6,
+    .ratio = 0,         // Limiter
+    .attack_ms = 1,
+    .release_ms = 150,
+    .detect = DYN_DETECT_PEAK};
+
+//=============================================================================
+// MUSICAL TABLES
+//=============================================================================
+static const int8_t SCALE_INTERVALS[SCALE_COUNT][8] = {
+    {0, 2, 4, 5, 7, 9, 11, 12},  {0, 2, 3, 5, 7, 8, 10, 12},
+    {0, 2, 4, 7, 9, 12, 12, 12}, {0, 3, 5, 7, 10, 12, 12, 12},
+    {0, 3, 5, 6, 7, 10, 12, 12}, {0, 2, 3, 5, 7, 9, 10, 12}};
+
+static const uint16_t ROOT_FREQUENCIES[KEY_COUNT] = {262, 294, 330, 349,
+                                                     392, 440, 494};
+
+// Chord intervals from root (semitones) - MAJOR MODE
+// Root = MIDI note 60 (C4), all intervals calculated from there
+static const int8_t HARMONIC_INTERVALS_MAJOR[HARM_COUNT][4] = {
+    // Low register
+    {-1, 2, 6, -1},      // vii_low - B dim below (B-D-F)
+    {-2, 1, 5, -1},      // vi_low  - A minor below (A-C-E)
+    {-5, -1, 2, -1},     // V_low   - G major below (G-B-D)
+    {-7, -3, 0, -1},     // IV_low  - F major below (F-A-C)
+    
+    // Mid-low register (base chords)
+    {0, 4, 7, -1},       // I       - C major (C-E-G)
+    {2, 5, 9, -1},       // ii      - D minor (D-F-A)
+    {4, 7, 11, -1},      // iii     - E minor (E-G-B)
+    {5, 9, 12, -1},      // IV      - F major (F-A-C)
+    {7, 11, 14, -1},     // V       - G major (G-B-D)
+    {9, 12, 16, -1},     // vi      - A minor (A-C-E)
+    {11, 14, 17, -1},    // vii     - B dim (B-D-F)
+    
+    // Mid-high register (extended)
+    {12, 16, 19, -1},    // I_oct   - C major octave up
+    {7, 11, 14, 17},     // V7      - G7 (G-B-D-F)
+    {2, 5, 9, 12},       // ii7     - Dm7 (D-F-A-C)
+    {9, 12, 16, 19},     // vi7     - Am7 (A-C-E-G)
+    {5, 9, 12, 16},      // IVmaj7  - Fmaj7 (F-A-C-E)
+    
+    // High register
+    {16, 19, 24, -1},    // I_inv   - C/E high (E-G-C)
+    {14, 17, 21, -1},    // ii_high - D minor high
+    {17, 21, 24, -1},    // IV_high - F major high
+    {19, 23, 26, -1},    // V_high  - G major high
+    
+    // Very high register
+    {24, 28, 31, -1},    // I_2oct  - C major 2 octaves up
+    {31, 35, 38, -1},    // V_2oct  - G major 2 octaves up
+    {29, 33, 36, -1},    // IV_2oct - F major 2 octaves up
+    {36, 40, 43, -1}     // I_3oct  - C major 3 octaves up
+};
+
+// Chord intervals from root (semitones) - MINOR MODE
+static const int8_t HARMONIC_INTERVALS_MINOR[HARM_COUNT][4] = {
+    // Low register
+    {-1, 2, 6, -1},      // vii_low - B dim below
+    {-4, -1, 3, -1},     // VI_low  - Ab major below
+    {-5, -1, 2, -1},     // V_low   - G major below
+    {-7, -4, 0, -1},     // iv_low  - F minor below
+    
+    // Mid-low register
+    {0, 3, 7, -1},       // i       - C minor (C-Eb-G)
+    {2, 5, 8, -1},       // ii°     - D dim (D-F-Ab)
+    {3, 7, 10, -1},      // III     - Eb major (Eb-G-Bb)
+    {5, 8, 12, -1},      // iv      - F minor (F-Ab-C)
+    {7, 11, 14, -1},     // V       - G major (G-B-D) - harmonic minor!
+    {8, 12, 15, -1},     // VI      - Ab major (Ab-C-Eb)
+    {11, 14, 17, -1},    // vii°    - B dim (B-D-F)
+    
+    // Mid-high register
+    {12, 15, 19, -1},    // i_oct   - C minor octave up
+    {7, 11, 14, 17},     // V7      - G7 (G-B-D-F)
+    {2, 5, 8, 12},       // ii°7    - Dm7b5 (D-F-Ab-C)
+    {8, 12, 15, 19},     // VI7     - Abmaj7 (Ab-C-Eb-G)
+    {5, 8, 12, 15},      // iv7     - Fm7 (F-Ab-C-Eb)
+    
+    // High register
+    {15, 19, 24, -1},    // i_inv   - Cm/Eb high
+    {14, 17, 20, -1},    // ii_high - D dim high
+    {17, 20, 24, -1},    // iv_high - F minor high
+    {19, 23, 26, -1},    // V_high  - G major high
+    
+    // Very high register
+    {24, 27, 31, -1},    // i_2oct  - C minor 2 octaves up
+    {31, 35, 38, -1},    // V_2oct  - G major 2 octaves up
+    {29, 32, 36, -1},    // iv_2oct - F minor 2 octaves up
+    {36, 39, 43, -1}     // i_3oct  - C minor 3 octaves up
+};
+
+static const int8_t CHORD_INTERVALS[CHORD_MODE_COUNT][3] = {
+    {0, 0, 0}, {0, 4, 7}, {0, 3, 7}};
+
+//=============================================================================
+// INSTRUMENTS AND PRESETS
+//=============================================================================
+static const SynthBank_t FACTORY_BANK = {{
+    // PIANO: Quick attack, moderate decay, bright
+    {"PIANO", {40, 1200, 650, 600}, WAVE_TRIANGLE, 2, 0, 0, 0},
+    
+    // ORGAN: Instant attack, sustained, rich harmonics
+    {"ORGAN", {0, 0, 1000, 200}, WAVE_SINE, 3, 25, 0, 0},
+    
+    // STRINGS: Very slow attack, long sustain, warm vibrato
+    {"STRINGS", {3200, 4000, 900, 5000}, WAVE_SAWTOOTH, 1, 20, 15, 0},
+    
+    // BASS: Fast attack, punchy, deep and resonant
+    {"BASS", {80, 400, 950, 600}, WAVE_SINE, 0, 0, 0, 0},
+    
+    // LEAD: Sharp attack, bright square wave, aggressive vibrato, tube drive
+    {"LEAD", {20, 800, 900, 1200}, WAVE_SQUARE, 2, 40, 8, 24}
+}, {
+    {"CLASSIC", INSTRUMENT_PIANO, false, CHORD_OFF, ARP_OFF,
+     {EFFECT_TREMOLO, EFFECT_DRIVE}},
+    {"AMBIENT", INSTRUMENT_STRINGS, true, CHORD_MAJOR, ARP_OFF,
+     {EFFECT_TREMOLO, EFFECT_DRIVE}},
+    {"SEQUENCE", INSTRUMENT_LEAD, true, CHORD_MINOR, ARP_UP,
+     {EFFECT_TREMOLO, EFFECT_DRIVE}}}};
+
+// The bank in use: the table above, a copy in RAM (Synth_SetBank) or a
+// compiled image in flash (Synth_MapBank). Switched in the audio context.
+static SynthBank_t bank_copy;
+static const SynthBank_t *bank_in_use = &FACTORY_BANK;
+const InstrumentProfile_t *INSTRUMENTS = FACTORY_BANK.instruments;
+const Preset_t *PRESETS = FACTORY_BANK.presets;
+
+//=============================================================================
+// PITCH BEND TABLE (from v27)
+//=============================================================================
+static const uint32_t PITCH_BEND_TABLE[25] = {
+    32768, 34675, 36781,  38967,  41285,  43742,  46341, 49091, 51998,
+    55041, 58255, 61644,  65536,  69433,  73533,  77841, 82366, 87111,
+    92123, 97549, 103397, 109681, 116411, 123596, 131072};
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+static SynthPlatform_t platform;
+static Envelope_t envelope;
+static EnvelopeState_t traced_env_state = ENV_IDLE;
+
+static ScaleState_t scale_state = {KEY_C, SCALE_MAJOR, 3, 262};
+static MusicalMode_t current_mode = MODE_MAJOR;
+static HarmonicFunction_t current_harmony = HARM_I;
+static Instrument_t current_instrument = INSTRUMENT_PIANO;
+static uint8_t current_preset = 0;
+static bool effects_enabled = true;
+static ChordMode_t chord_mode = CHORD_OFF;
+static Arpeggiator_t arpeggiator = {0};
+static uint8_t volume = 80;
+static bool playing = true;
+
+// Epic Organ Mode (inspired by 70s progressive rock)
+static bool epic_mode_active = false;
+static uint8_t epic_sequence_step = 0;
+static MidiClock_t transport; // Arpeggiator and sequencer steps
+static Parts_t parts;         // Multi-timbral parts (MIDI channels)
+
+static uint32_t base_frequency_hz = 440;
+static uint32_t target_frequency_hz = 440;
+static uint32_t current_frequency_hz = 440;
+static uint32_t pitch_hz = 440; // After the octave bend
+static int8_t current_octave_shift = 0;
+static uint32_t wheel_ratio = 65536; // MIDI pitch bend, Q16
+
+// Phase accumulators (v27)
+static uint32_t g_phase = 0;
+static uint32_t g_phase_increment = 118111601;
+static uint32_t g_chord_phases[3] = {0};
+static uint32_t g_chord_increments[3] = {118111601, 118111601, 118111601};
+
+static uint16_t vibrato_phase = 0;
+
+// Insert effects (12-bit in/out), run as a chain once per block
+static Tremolo_t g_tremolo;
+static Waveshaper_t g_drive_shaper;
+static Bitcrusher_t g_crusher;
+static FxChain_t g_fx_chain;
+static Mixer_t g_mixer;
+static bool g_mix_fx_routed = false;
+static Dynamics_t g_master_dyn;
+
+static const struct {
+  const FxType_t *type;
+  void *state;
+} EFFECT_SLOTS[EFFECT_COUNT] = {
+    [EFFECT_TREMOLO] = {&FX_TREMOLO, &g_tremolo},
+    [EFFECT_DRIVE] = {&FX_WAVESHAPER, &g_drive_shaper},
+    [EFFECT_CRUSH] = {&FX_BITCRUSHER, &g_crusher},
+};
+
+// Telemetry
+static uint32_t samples_generated = 0;
+static uint32_t fx_cycles = 0;
+static uint16_t limiter_gr_db10 = 0;
+
+// MIDI input (audio context): held notes, the sounding one last
+static uint8_t midi_held[MIDI_HELD_MAX];
+static uint8_t midi_held_count = 0;
+static bool midi_sustain = false;
+static bool midi_sustained = false; // Released while the pedal was down
+static bool midi_applied = false;   // Publish at the next block
+
+static int16_t scope_buffer[SYNTH_SCOPE_SIZE] = {0};
+static uint8_t scope_write_index = 0;
+
+//=============================================================================
+// CONFIGURATION SNAPSHOT (double-buffered, sequence counted)
+//=============================================================================
+// The variables above are the audio context's working copy; a preset or
+// epic switch changes them one at a time. Publish_Config copies the result
+// into the idle half of config_bank and then bumps config_seq, which flips
+// live_config. The renderer takes live_config once per block, so it never
+// sees half a switch; other contexts read through Read_Config, which
+// retries if a publish overtook it. Publishing happens after Apply_Params
+// and after an epic step, so within one block the buffer the renderer
+// holds is never the one being written.
+typedef struct {
+  Instrument_t instrument;
+  uint8_t preset;
+  bool effects_enabled;
+  ChordMode_t chord_mode;
+  ArpMode_t arp_mode;
+  MusicalKey_t key;
+  MusicalMode_t mode;
+  HarmonicFunction_t harmony;
+  int8_t octave_shift;
+  bool epic_active;
+  uint8_t volume;
+  bool playing;
+} SynthConfig_t;
+
+static SynthConfig_t config_bank[2];
+static const SynthConfig_t *live_config = &config_bank[0];
+static atomic_uint_least32_t config_seq;    // Odd/even selects the half
+
+//=============================================================================
+// PARAMETER QUEUE (control context -> audio context)
+//=============================================================================
+// The public setters, buttons and controls only post messages; the block
+// renderer applies them before it renders, so every variable above is
+// written by the audio context alone. The control side keeps just what it
+// needs to decide what to post.
+typedef enum {
+  PARAM_NOTE = 0,      // 1 = note on, 0 = note off
+  PARAM_PLAYING,
+  PARAM_VOLUME,
+  PARAM_KEY,
+  PARAM_MODE,
+  PARAM_HARMONY,
+  PARAM_INSTRUMENT,
+  PARAM_PRESET,
+  PARAM_EFFECTS,
+  PARAM_CHORD_MODE,
+  PARAM_ARP_MODE,
+  PARAM_NEXT_SCALE,
+  PARAM_BUTTON,        // button << 8 | press (S1 and S2 toggles)
+  PARAM_EPIC,          // 1 = start, 0 = stop
+  PARAM_RESET,
+  PARAM_JOY_KEY,       // -1, 0, +1 (0 only re-tunes)
+  PARAM_JOY_VOLUME,
+  PARAM_TILT_HARMONY,  // Accelerometer X position (0 to HARM_COUNT-1)
+  PARAM_TILT_OCTAVE,   // Accelerometer Y zone (semitones)
+  PARAM_TEMPO,         // BPM
+  PARAM_PART           // part << 16 | SynthPartParam_t << 8 | (uint8_t)value
+} SynthParamId_t;
+
+static ParamQueue_t param_queue;
+static bool epic_requested = false;               // Control side
+static int8_t posted_octave_shift = OCTAVE_UNPOSTED; // Control side
+
+//=============================================================================
+// PROTOTYPES
+//=============================================================================
+static void Post(SynthParamId_t id, int32_t value);
+static bool Apply_Params(void);
+static void Publish_Config(void);
+static void Read_Config(SynthConfig_t *config);
+static void Note_On(void);
+static void Set_Instrument(Instrument_t instrument);
+static void Set_Mode(MusicalMode_t mode);
+static void Set_Playing(bool on);
+static bool Toggle_Epic(void);
+static void Reset_Engine(void);
+static void Process_Arpeggiator(ArpMode_t mode, bool clock);
+static void Process_Epic_Mode(bool clock);
+static void Process_Portamento(void);
+static void Generate_Audio_Sample(const SynthConfig_t *cfg, int16_t *voices);
+static void Load_Preset_Effects(const Preset_t *preset);
+static void Apply_Instrument_Effects(const InstrumentProfile_t *inst);
+static void Set_Mix_Routing(bool fx);
+static void Update_Phase_Increment(void);
+static void Generate_Chord_Sample(const InstrumentProfile_t *inst,
+                                  uint32_t *phases, uint32_t *increments,
+                                  int16_t *voices);
+static uint16_t Calculate_Scale_Frequency(MusicalKey_t key, ScaleType_t scale,
+                                          uint8_t position,
+                                          int8_t octave_shift);
+static uint16_t Calculate_Harmonic_Frequency(MusicalKey_t key, MusicalMode_t mode,
+                                             HarmonicFunction_t harmony, int8_t octave_shift);
+
+static void Notify(SynthEvent_t event, int32_t value) {
+  if (platform.on_event)
+    platform.on_event(event, value);
+}
+
+// Master clock out (render loop, once per clock)
+static void Send_Clock(uint8_t byte) {
+  Notify(SYNTH_EVENT_MIDI_CLOCK, byte);
+}
+
+//=============================================================================
+// MUSICAL CONTROLS
+//=============================================================================
+// Control context: turns the controls into messages (the audio context
+// ignores them while epic mode is running)
+static void Process_Musical_Controls(Joystick_t *joy, const Accelerometer_t *acc) {
+  // 1. Key selection (JOY_X) - Now selects musical key
+  if (joy->x_changed) {
+    int32_t step = 0;
+    if (joy->raw_x < 1000)
+      step = -1; // Left - previous key
+    else if (joy->raw_x > 3000)
+      step = 1;  // Right - next key
+    Post(PARAM_JOY_KEY, step);
+  }
+
+  // 2. Volume (JOY_Y) - Unchanged
+  if (joy->y_changed) {
+    Post(PARAM_JOY_VOLUME, Joystick_GetVolume(joy));
+  }
+
+  // 3. Harmonic progression (ACCEL_X) - 24 positions for smooth control!
+  if (acc->x_changed) {
+    // Map accelerometer X (0-4095) to harmonic functions (0-23)
+    // This gives smooth semitone-based progressions across full tilt range
+    uint8_t harm_pos = (uint8_t)((acc->x * HARM_COUNT) / 4096);
+    if (harm_pos >= HARM_COUNT) harm_pos = HARM_COUNT - 1;
+    Post(PARAM_TILT_HARMONY, harm_pos);
+  }
+}
+
+// Audio context: the same controls, applied
+static void Apply_Musical_Control(SynthParamId_t id, int32_t value) {
+  // Skip manual controls if epic mode is running
+  if (epic_mode_active) return;
+
+  if (id == PARAM_JOY_KEY) {
+    if (value < 0) {
+      if (scale_state.current_key > 0)
+        scale_state.current_key--;
+      else
+        scale_state.current_key = (MusicalKey_t)(KEY_COUNT - 1);
+    } else if (value > 0) {
+      if (scale_state.current_key < (KEY_COUNT - 1))
+        scale_state.current_key++;
+      else
+        scale_state.current_key = (MusicalKey_t)0;
+    }
+
+    // Update frequency based on current harmony
+    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+    target_frequency_hz = scale_state.current_note_freq;
+    Update_Phase_Increment();
+  } else if (id == PARAM_JOY_VOLUME) {
+    volume = (uint8_t)value;
+  } else if (id == PARAM_TILT_HARMONY) {
+    bool harmony_changed = ((HarmonicFunction_t)value != current_harmony);
+    current_harmony = (HarmonicFunction_t)value;
+
+    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+    if (harmony_changed)
+      Trace_Event(TRACE_HARMONY, current_harmony, scale_state.current_note_freq);
+    target_frequency_hz = scale_state.current_note_freq;
+    Update_Phase_Increment();
+  }
+}
+
+//==================================================================
+// ACCELROMETER
+//===================================================================
+// Control context: posts the octave zone when it changes
+static void Process_Accelerometer(const Accelerometer_t *acc) {
+  int16_t ay = acc->y;
+  int16_t deviation = ay - ACCEL_Y_NEUTRAL;
+
+  // Vi definerer terskler for hver oktav (ca. 400 enheter mellom hver)
+  const int16_t LIMIT_1 = 500;  // Første oktav
+  const int16_t LIMIT_2 = 1000; // Andre oktav
+
+  int8_t new_octave_shift = 0;
+
+  // Sjekk tilt-soner for flere oktaver
+  if (deviation > LIMIT_2) {
+    new_octave_shift = 24; // Mye tilt forover -> To oktaver opp
+  } else if (deviation > LIMIT_1) {
+    new_octave_shift = 12; // Litt tilt forover -> En oktav opp
+  } else if (deviation < -LIMIT_2) {
+    new_octave_shift = -24; // Mye tilt bakover -> To oktaver ned
+  } else if (deviation < -LIMIT_1) {
+    new_octave_shift = -12; // Litt tilt bakover -> En oktav ned
+  } else {
+    new_octave_shift = 0; // Flatt brett -> Normal
+  }
+
+  if (new_octave_shift != posted_octave_shift) {
+    posted_octave_shift = new_octave_shift;
+    Post(PARAM_TILT_OCTAVE, new_octave_shift);
+  }
+}
+
+// Audio context
+static void Apply_Octave_Tilt(int8_t new_octave_shift) {
+  // Skip manual controls if epic mode is running
+  if (epic_mode_active) return;
+
+  // Bare oppdater hvis vi faktisk har skiftet sone
+  if (current_octave_shift != new_octave_shift) {
+    current_octave_shift = new_octave_shift;
+
+    scale_state.current_note_freq = Calculate_Scale_Frequency(
+        scale_state.current_key, scale_state.current_scale,
+        scale_state.scale_position, current_octave_shift);
+
+    target_frequency_hz = scale_state.current_note_freq;
+    Update_Phase_Increment();
+
+    // Lys-indikasjon for å se hvor du er
+    Notify(SYNTH_EVENT_OCTAVE, (current_octave_shift > 0) - (current_octave_shift < 0));
+  }
+}
+
+static void Process_Portamento(void) {
+  if (current_frequency_hz < target_frequency_hz) {
+    current_frequency_hz += PORTAMENTO_SPEED;
+    if (current_frequency_hz > target_frequency_hz)
+      current_frequency_hz = target_frequency_hz;
+  } else if (current_frequency_hz > target_frequency_hz) {
+    current_frequency_hz -= PORTAMENTO_SPEED;
+    if (current_frequency_hz < target_frequency_hz)
+      current_frequency_hz = target_frequency_hz;
+  }
+  if (current_frequency_hz != base_frequency_hz) {
+    base_frequency_hz = current_frequency_hz;
+    // Note: We DON'T call Audio_SetFrequency() - we manage phase manually!
+    Update_Phase_Increment();
+  }
+}
+
+//=============================================================================
+// HELPER FUNCTIONS
+//=============================================================================
+static uint16_t Calculate_Scale_Frequency(MusicalKey_t key, ScaleType_t scale,
+                                          uint8_t position,
+                                          int8_t octave_shift) {
+  uint16_t root_freq = ROOT_FREQUENCIES[key];
+  int8_t interval = SCALE_INTERVALS[scale][position];
+  int8_t total_semitones = interval + octave_shift;
+
+  const uint16_t semitone_ratio[25] = {1000, 1059, 1122, 1189, 1260, 1335, 1414,
+                                       1498, 1587, 1682, 1782, 1888, 2000, 2119,
+                                       2245, 2378, 2520, 2670, 2828, 2997, 3175,
+                                       3364, 3564, 3775, 4000};
+
+  int8_t idx = total_semitones + 12;
+  if (idx < 0)
+    idx = 0;
+  if (idx > 24)
+    idx = 24;
+
+  uint32_t freq = ((uint32_t)root_freq * semitone_ratio[idx]) / 1000;
+  if (freq < 100)
+    freq = 100;
+  if (freq > 2000)
+    freq = 2000;
+
+  return (uint16_t)freq;
+}
+
+static uint16_t Calculate_Harmonic_Frequency(MusicalKey_t key, MusicalMode_t mode,
+                                             HarmonicFunction_t harmony, int8_t octave_shift) {
+  uint16_t root_freq = ROOT_FREQUENCIES[key];
+
+  // Get chord intervals based on mode
+  const int8_t* intervals = (mode == MODE_MAJOR) ?
+      HARMONIC_INTERVALS_MAJOR[harmony] :
+      HARMONIC_INTERVALS_MINOR[harmony];
+
+  // Use root note of the chord
+  int8_t semitone = intervals[0] + octave_shift;
+
+  // Use same calculation as original
+  const uint16_t semitone_ratio[25] = {
+      1000, 1059, 1122, 1189, 1260, 1335, 1414, 1498, 1587, 1682, 1782, 1888, 2000,
+      2119, 2245, 2378, 2520, 2670, 2828, 2997, 3175, 3364, 3564, 3775, 4000};
+
+  int8_t idx = semitone + 12;
+  if (idx < 0) idx = 0;
+  if (idx > 24) idx = 24;
+
+  uint32_t freq = ((uint32_t)root_freq * semitone_ratio[idx]) / 1000;
+  if (freq < 100) freq = 100;
+  if (freq > 2000) freq = 2000;
+
+  return (uint16_t)freq;
+}
+
+static void Next_Scale(void) {
+  scale_state.current_scale =
+      (ScaleType_t)((scale_state.current_scale + 1) % SCALE_COUNT);
+  scale_state.current_note_freq = Calculate_Scale_Frequency(
+      scale_state.current_key, scale_state.current_scale,
+      scale_state.scale_position, current_octave_shift);
+  target_frequency_hz = scale_state.current_note_freq;
+}
+
+static void Set_Instrument(Instrument_t instrument) {
+  if (instrument >= INSTRUMENT_COUNT)
+    return;
+  current_instrument = instrument;
+  Envelope_Init(&envelope,
+                &INSTRUMENTS[current_instrument].adsr); // Library API
+  Apply_Instrument_Effects(&INSTRUMENTS[current_instrument]);
+  Note_On();
+}
+
+static void Set_Preset(uint8_t preset_index) {
+  if (preset_index >= SYNTH_PRESET_COUNT)
+    return;
+  current_preset = preset_index;
+  const Preset_t *preset = &PRESETS[current_preset];
+  current_instrument = preset->instrument;
+  effects_enabled = preset->effects_enabled;
+  chord_mode = preset->chord_mode;
+  arpeggiator.mode = preset->arp_mode;
+  Envelope_Init(&envelope,
+                &INSTRUMENTS[current_instrument].adsr); // Library API
+  Load_Preset_Effects(preset);
+  Note_On();
+}
+
+static void Note_On(void) {
+  Envelope_NoteOn(&envelope); // Library API
+}
+
+//=============================================================================
+// ARPEGGIATOR
+//=============================================================================
+static void Process_Arpeggiator(ArpMode_t mode, bool clock) {
+  if (mode == ARP_OFF || !clock)
+    return;
+
+  if (transport.position % arpeggiator.clocks_per_step == 0) {
+    Note_On();
+    arpeggiator.current_step = (arpeggiator.current_step + 1) % 8;
+  }
+}
+
+//=============================================================================
+// CELTIC MODE - Greensleeves (Traditional, Public Domain)
+//=============================================================================
+// Based on the iconic English/Irish traditional melody from 16th century
+// Chord progression: Am - C - G - Am - E - Am - C - G - Am - E - Am
+// This is authentic traditional music - no copyright restrictions!
+static const struct {
+  MusicalKey_t key;
+  HarmonicFunction_t harmony;
+  MusicalMode_t mode;
+  int8_t octave_shift;
+} EPIC_SEQUENCE[] = {
+    // Verse 1: "Alas my love, you do me wrong..."
+    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (home)
+    {KEY_A, HARM_iii, MODE_MINOR, 0},    // C major (relative major)
+    {KEY_A, HARM_V, MODE_MINOR, 0},      // G major (bVII)
+    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (return)
+    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (dominant - harmonic minor!)
+    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (resolve)
+    
+    // Verse 2: "To cast me off discourteously..."
+    {KEY_A, HARM_iii, MODE_MINOR, 0},    // C major
+    {KEY_A, HARM_V, MODE_MINOR, 0},      // G major (bVII)
+    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am
+    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (dominant)
+    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (resolve)
+    
+    // Chorus: "Greensleeves was all my joy..."
+    {KEY_A, HARM_iii, MODE_MINOR, 5},    // C major (up a 4th - lift!)
+    {KEY_A, HARM_V, MODE_MINOR, 5},      // G major (stay up)
+    {KEY_A, HARM_I, MODE_MINOR, 5},      // Am (high point)
+    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (back down)
+    {KEY_A, HARM_I, MODE_MINOR, 0}       // Am (final home)
+};
+
+#define EPIC_SEQUENCE_LENGTH (sizeof(EPIC_SEQUENCE) / sizeof(EPIC_SEQUENCE[0]))
+
+static void Process_Epic_Mode(bool clock) {
+  if (!epic_mode_active || !clock) return;
+  
+  if (transport.position % EPIC_CLOCKS_PER_STEP == 0) {
+    epic_sequence_step = (epic_sequence_step + 1) % EPIC_SEQUENCE_LENGTH;
+    
+    // Visual feedback: Toggle between blue and green at each step
+    Notify(SYNTH_EVENT_EPIC_STEP, epic_sequence_step);
+    
+    // Update harmony from sequence
+    scale_state.current_key = EPIC_SEQUENCE[epic_sequence_step].key;
+    current_harmony = EPIC_SEQUENCE[epic_sequence_step].harmony;
+    current_mode = EPIC_SEQUENCE[epic_sequence_step].mode;
+    current_octave_shift = EPIC_SEQUENCE[epic_sequence_step].octave_shift;
+    
+    // Calculate new frequency
+    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+    target_frequency_hz = scale_state.current_note_freq;
+    Update_Phase_Increment();
+    Trace_Event(TRACE_HARMONY, current_harmony, scale_state.current_note_freq);
+    Publish_Config();
+    
+    // Trigger note on for each change
+    Note_On();
+  }
+}
+
+static bool Toggle_Epic(void) {
+  epic_mode_active = !epic_mode_active;
+  
+  if (epic_mode_active) {
+    // Enable epic mode with strings sound (Celtic fiddle-like)
+    current_instrument = INSTRUMENT_STRINGS;
+    effects_enabled = true;
+    chord_mode = CHORD_OFF; // Single notes for clarity
+    arpeggiator.mode = ARP_OFF;
+    
+    // Start from beginning (the next step falls on the next bar line)
+    epic_sequence_step = 0;
+    
+    // Set initial state
+    scale_state.current_key = EPIC_SEQUENCE[0].key;
+    current_harmony = EPIC_SEQUENCE[0].harmony;
+    current_mode = EPIC_SEQUENCE[0].mode;
+    current_octave_shift = EPIC_SEQUENCE[0].octave_shift;
+    
+    // Update envelope for strings
+    Envelope_Init(&envelope, &INSTRUMENTS[INSTRUMENT_STRINGS].adsr);
+    Apply_Instrument_Effects(&INSTRUMENTS[INSTRUMENT_STRINGS]);
+    
+    // Calculate first note
+    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+    target_frequency_hz = scale_state.current_note_freq;
+    Update_Phase_Increment();
+    
+    Note_On();
+  } else {
+    // Return to normal operation
+    current_octave_shift = 0;
+  }
+  return epic_mode_active;
+}
+
+//=============================================================================
+// BLOCK RENDERER
+//=============================================================================
+static void Load_Preset_Effects(const Preset_t *preset) {
+  FxChain_Clear(&g_fx_chain);
+  for (uint8_t i = 0; i < FX_CHAIN_MAX_SLOTS; i++) {
+    EffectId_t id = preset->effects[i];
+    if (id == EFFECT_NONE || id >= EFFECT_COUNT)
+      continue;
+    FxChain_Add(&g_fx_chain, EFFECT_SLOTS[id].type, EFFECT_SLOTS[id].state);
+  }
+  Apply_Instrument_Effects(&INSTRUMENTS[current_instrument]);
+}
+
+static void Apply_Instrument_Effects(const InstrumentProfile_t *inst) {
+  g_tremolo.depth = inst->tremolo_depth;
+  g_drive_shaper.drive = (uint16_t)inst->drive << 8;
+
+  FxChain_SetBypass(&g_fx_chain, FxChain_Find(&g_fx_chain, &g_tremolo),
+                    inst->tremolo_depth == 0);
+  FxChain_SetBypass(&g_fx_chain, FxChain_Find(&g_fx_chain, &g_drive_shaper),
+                    inst->drive == 0);
+}
+
+/**
+ * @brief Route the synth group dry or through the effects send
+ * @param fx true = 100% through the insert chain (send), false = dry
+ */
+static void Set_Mix_Routing(bool fx) {
+  Mixer_SetGroupDry(&g_mixer, MIX_GROUP_SYNTH, fx ? 0 : MIXER_UNITY);
+  Mixer_SetGroupSend(&g_mixer, MIX_GROUP_SYNTH, MIX_SEND_FX,
+                     fx ? MIXER_UNITY : 0);
+  g_mix_fx_routed = fx;
+}
+
+/*
+ * Oscillators run per sample into one buffer per voice. The mixer sums the
+ * voices; the insert chain runs once over the effects send (before envelope
+ * and volume, like the old inline effects did). As then, only the single
+ * oscillator goes through it: chord voices stay dry.
+ */
+void Synth_RenderBlock(int16_t *mix, uint16_t n) {
+  int16_t voice_buf[MIX_CHORD_VOICES][SYNTH_BLOCK_SIZE];
+  int16_t buf[SYNTH_BLOCK_SIZE];
+  uint16_t env[SYNTH_BLOCK_SIZE];
+  int32_t bus[SYNTH_BLOCK_SIZE];
+
+  if (n > SYNTH_BLOCK_SIZE)
+    n = SYNTH_BLOCK_SIZE;
+
+  // Parameter changes land on the block boundary, all at once
+  if (Apply_Params() || midi_applied) {
+    midi_applied = false;
+    Publish_Config();
+  }
+  const SynthConfig_t *cfg = live_config;
+
+  // Routing and headroom follow the UI state, checked once per block
+  uint8_t voices = (cfg->chord_mode == CHORD_OFF) ? 1 : MIX_CHORD_VOICES;
+  bool fx = cfg->effects_enabled && cfg->chord_mode == CHORD_OFF;
+  Mixer_SetHeadroom(&g_mixer, voices);
+  if (fx != g_mix_fx_routed)
+    Set_Mix_Routing(fx);
+
+  for (uint16_t i = 0; i < n; i++) {
+    int16_t v[MIX_CHORD_VOICES] = {0};
+
+    if (g_phase_increment == 0)
+      g_phase_increment = 118111601;
+
+    Envelope_Process(&envelope); // Library API
+    // Field read, not Envelope_GetState(): a call per sample for the trace
+    if (envelope.state != traced_env_state) {
+      traced_env_state = envelope.state;
+      Trace_Event(TRACE_ENV_STATE, traced_env_state, 0);
+    }
+    bool clock = MidiClock_Advance(&transport);
+    Process_Arpeggiator(cfg->arp_mode, clock);
+    Process_Epic_Mode(clock);
+    Process_Portamento();
+
+    vibrato_phase += 82;
+
+    uint16_t amp = Envelope_GetAmplitude(&envelope); // Library API, 0-1000
+    if (!cfg->playing || cfg->volume == 0 || amp == 0) {
+      // MUTE: Keep phase running, output midpoint
+      g_phase += g_phase_increment;
+      amp = 0;
+    } else {
+      PERF_BEGIN(AUDIO_SAMPLE);
+      Generate_Audio_Sample(cfg, v);
+      PERF_END(AUDIO_SAMPLE);
+    }
+    for (uint8_t k = 0; k < MIX_CHORD_VOICES; k++)
+      voice_buf[k][i] = v[k];
+    env[i] = (uint16_t)(((uint32_t)amp * 33554u) >> 10); // Q15
+    samples_generated++;
+  }
+
+  // Mix voices onto the 32-bit bus (and the effects send)
+  Mixer_BeginBlock(&g_mixer, n);
+  for (uint8_t k = 0; k < voices; k++)
+    Mixer_AddVoice(&g_mixer, k, voice_buf[k], n);
+
+  // Insert effects on the send, returned at unity
+  if (g_mix_fx_routed) {
+    Mixer_GetSend(&g_mixer, MIX_SEND_FX, buf, n);
+    FxChain_Process(&g_fx_chain, buf, n);
+    Mixer_AddReturn(&g_mixer, MIX_SEND_FX, buf, n);
+    fx_cycles = g_fx_chain.cycles;
+  }
+
+  // ✅ CORRECT ORDER: Envelope (per sample) and volume (master, per block)
+  // after the insert chain. 20972 / 64 maps volume 0-100 to Q15.
+  Mixer_SetMaster(&g_mixer, (uint16_t)((cfg->volume * 20972u) >> 6));
+  Mixer_Render(&g_mixer, env, bus, NULL, n);
+
+  // Multi-timbral parts, dry, under the same volume
+  Parts_Render(&parts, bus, n, (uint16_t)((cfg->volume * 20972u) >> 6));
+
+  // Master limiter (control rate per block, gain ramped per sample)
+  Dynamics_ProcessBlock(&g_master_dyn, bus, mix, n);
+  limiter_gr_db10 = Dynamics_GetReductionDb10(&g_master_dyn);
+}
+
+static void Generate_Audio_Sample(const SynthConfig_t *cfg, int16_t *voices) {
+  const InstrumentProfile_t *inst = &INSTRUMENTS[cfg->instrument];
+
+  if (cfg->chord_mode != CHORD_OFF) {
+    Generate_Chord_Sample(inst, g_chord_phases, g_chord_increments, voices);
+  } else {
+    int16_t sample;
+    uint32_t modulated_phase = g_phase;
+
+    // Vibrato (pitch modulation stays in the oscillator)
+    if (cfg->effects_enabled && inst->vibrato_depth > 0) {
+      uint8_t vib_index = vibrato_phase >> 8;
+      const int16_t *sine = Audio_GetSineTable(); // Library API
+      int16_t vibrato_lfo = sine[vib_index];
+      int32_t phase_offset = ((int32_t)vibrato_lfo * inst->vibrato_depth *
+                              (int32_t)g_phase_increment) /
+                             100000;
+      modulated_phase = g_phase + phase_offset;
+    }
+
+    uint8_t index = (uint8_t)((modulated_phase >> 24) & 0xFF);
+    
+    // Use MATHACL hardware for sine, library for others
+    if (inst->waveform == WAVE_SINE) {
+        // Perfect hardware-accelerated sine!
+        sample = platform.sine ? platform.sine(modulated_phase)
+                               : Audio_GetSineTable()[index];
+    } else {
+        // Use library for square/saw/triangle
+        sample = Audio_GenerateWaveform(index, inst->waveform);
+    }
+
+    // Harmonics
+    if (inst->num_harmonics >= 1) {
+      uint8_t h1_index = (index << 1) & 0xFF;
+      int16_t harmonic1 =
+          Audio_GenerateWaveform(h1_index, inst->waveform); // Library API
+      sample = (sample * 2 + harmonic1) / 3;
+    }
+
+    static uint8_t scope_decimate_counter = 0;
+    if (++scope_decimate_counter >= 40) {
+      scope_decimate_counter = 0;
+      scope_buffer[scope_write_index++] = sample;
+      if (scope_write_index >= SYNTH_SCOPE_SIZE)
+        scope_write_index = 0;
+    }
+
+    g_phase += g_phase_increment;
+    voices[0] = sample;
+  }
+}
+
+//==============================================================================
+// CHORD GENERATION
+//==============================================================================
+static void Generate_Chord_Sample(const InstrumentProfile_t *inst,
+                                  uint32_t *phases, uint32_t *increments,
+                                  int16_t *voices) {
+  // One output per voice; the mixer applies gain and headroom
+  for (uint8_t v = 0; v < MIX_CHORD_VOICES; v++) {
+    uint8_t index = (uint8_t)((phases[v] >> 24) & 0xFF);
+    int16_t sample = Audio_GenerateWaveform(index, inst->waveform); // Library API
+
+    if (inst->num_harmonics >= 1) {
+      uint8_t h_index = (index << 1) & 0xFF;
+      int16_t harmonic =
+          Audio_GenerateWaveform(h_index, inst->waveform); // Library API
+      sample = (sample * 2 + harmonic) / 3;
+    }
+
+    voices[v] = sample;
+    phases[v] += increments[v];
+  }
+}
+
+//=============================================================================
+// UPDATE PHASE INCREMENT (from v27 - uses global g_phase_increment)
+//=============================================================================
+static void Update_Phase_Increment(void) {
+  PERF_BEGIN(PHASE_INCREMENT);
+  if (base_frequency_hz == 0)
+    base_frequency_hz = 440;
+
+  int8_t table_index = current_octave_shift + 12;
+  if (table_index < 0)
+    table_index = 0;
+  if (table_index > 24)
+    table_index = 24;
+
+  uint32_t bend_ratio = PITCH_BEND_TABLE[table_index];
+  uint64_t bent_freq_64 = ((uint64_t)base_frequency_hz * bend_ratio) >> 16;
+  uint32_t bent_freq = (uint32_t)bent_freq_64;
+  if (wheel_ratio != 65536)
+    bent_freq = (uint32_t)(((uint64_t)bent_freq * wheel_ratio) >> 16);
+
+  if (bent_freq < FREQ_MIN_HZ)
+    bent_freq = FREQ_MIN_HZ;
+  if (bent_freq > FREQ_MAX_HZ)
+    bent_freq = FREQ_MAX_HZ;
+
+  if (bent_freq > 0 && bent_freq <= 8000) {
+    uint64_t temp = ((uint64_t)bent_freq << 32) / 16000ULL;
+    if (temp > 0 && temp <= 0xFFFFFFFF)
+      g_phase_increment = (uint32_t)temp;
+    else
+      g_phase_increment = 118111601;
+  } else {
+    g_phase_increment = 118111601;
+  }
+
+  if (g_phase_increment == 0)
+    g_phase_increment = 118111601;
+
+  pitch_hz = bent_freq;
+
+  // Update chord increments
+  if (chord_mode != CHORD_OFF) {
+    const int8_t *intervals = CHORD_INTERVALS[chord_mode];
+    for (uint8_t voice = 0; voice < 3; voice++) {
+      int8_t chord_table_index = table_index + intervals[voice];
+      if (chord_table_index < 0)
+        chord_table_index = 0;
+      if (chord_table_index > 24)
+        chord_table_index = 24;
+
+      uint32_t chord_ratio = PITCH_BEND_TABLE[chord_table_index];
+      uint64_t chord_freq_64 =
+          ((uint64_t)base_frequency_hz * chord_ratio) >> 16;
+      uint32_t chord_freq = (uint32_t)chord_freq_64;
+      if (wheel_ratio != 65536)
+        chord_freq = (uint32_t)(((uint64_t)chord_freq * wheel_ratio) >> 16);
+
+      if (chord_freq < FREQ_MIN_HZ)
+        chord_freq = FREQ_MIN_HZ;
+      if (chord_freq > FREQ_MAX_HZ)
+        chord_freq = FREQ_MAX_HZ;
+
+      if (chord_freq > 0 && chord_freq <= 8000) {
+        uint64_t chord_temp = ((uint64_t)chord_freq << 32) / 16000ULL;
+        if (chord_temp > 0 && chord_temp <= 0xFFFFFFFF)
+          g_chord_increments[voice] = (uint32_t)chord_temp;
+        else
+          g_chord_increments[voice] = g_phase_increment;
+      } else {
+        g_chord_increments[voice] = g_phase_increment;
+      }
+
+      if (g_chord_increments[voice] == 0)
+        g_chord_increments[voice] = g_phase_increment;
+    }
+  } else {
+    g_chord_increments[0] = g_phase_increment;
+    g_chord_increments[1] = g_phase_increment;
+    g_chord_increments[2] = g_phase_increment;
+  }
+  PERF_END(PHASE_INCREMENT);
+}
+
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void Synth_Init(const SynthPlatform_t *hw) {
+  static const SynthPlatform_t no_platform = {NULL, NULL, NULL};
+  platform = hw ? *hw : no_platform;
+  bank_in_use = &FACTORY_BANK;
+  INSTRUMENTS = FACTORY_BANK.instruments;
+  PRESETS = FACTORY_BANK.presets;
+
+  // Power-on state (Init may run more than once on the host)
+  scale_state = (ScaleState_t){KEY_C, SCALE_MAJOR, 3, 262};
+  current_mode = MODE_MAJOR;
+  current_harmony = HARM_I;
+  current_instrument = INSTRUMENT_PIANO;
+  current_preset = 0;
+  effects_enabled = true;
+  chord_mode = CHORD_OFF;
+  volume = 80;
+  playing = true;
+  epic_mode_active = false;
+  epic_sequence_step = 0;
+  g_phase = 0;
+  g_chord_phases[0] = g_chord_phases[1] = g_chord_phases[2] = 0;
+  vibrato_phase = 0;
+  g_mix_fx_routed = false;
+  samples_generated = 0;
+  fx_cycles = 0;
+  limiter_gr_db10 = 0;
+  scope_write_index = 0;
+  ParamQueue_Init(&param_queue);
+  epic_requested = false;
+  posted_octave_shift = OCTAVE_UNPOSTED;
+
+  // Initialiser Audio-motoren (Biblioteket tar seg av phase_increment)
+  Audio_Init(SYNTH_SAMPLE_RATE_HZ);
+  Audio_SetWaveform(INSTRUMENTS[current_instrument].waveform);
+  Audio_SetFrequency(440);
+
+  // Initialize audio (Library API)
+  Filter_Reset();
+  Envelope_Init(&envelope, &INSTRUMENTS[current_instrument].adsr);
+  Envelope_NoteOn(&envelope);
+
+  // Initialize frequencies
+  base_frequency_hz = 440;
+  target_frequency_hz = 440;
+  current_frequency_hz = 440;
+  current_octave_shift = 0;
+  wheel_ratio = 65536;
+  midi_held_count = 0;
+  midi_sustain = false;
+  midi_sustained = false;
+  midi_applied = false;
+  g_phase_increment = 118111601;
+  g_chord_increments[0] = g_phase_increment;
+  g_chord_increments[1] = g_phase_increment;
+  g_chord_increments[2] = g_phase_increment;
+  Update_Phase_Increment();
+
+  // Initialize arpeggiator
+  arpeggiator = (Arpeggiator_t){0};
+  arpeggiator.mode = ARP_OFF;
+  arpeggiator.clocks_per_step = ARP_CLOCKS_PER_STEP;
+  MidiClock_Init(&transport, SYNTH_SAMPLE_RATE_HZ, Send_Clock); // 120 BPM
+
+  // Initialize effects chain
+  Tremolo_Init(&g_tremolo, 67, 0);
+  Waveshaper_Init(&g_drive_shaper, SHAPE_TUBE, 16 << 8, 2048);
+  Bitcrusher_Init(&g_crusher, 14, 0x8000); // 10 bits of 12, 8 kHz hold
+  FxChain_Init(&g_fx_chain, platform.cycles);
+  FxChain_SetBudget(&g_fx_chain, SYNTH_FX_CYCLE_BUDGET);
+  Load_Preset_Effects(&PRESETS[current_preset]);
+  Mixer_Init(&g_mixer, MIXER_MONO);
+  Mixer_SetChannel(&g_mixer, 0, MIXER_UNITY, 0, MIX_GROUP_SYNTH);
+  Mixer_SetChannel(&g_mixer, 1, MIXER_UNITY, -32, MIX_GROUP_SYNTH);
+  Mixer_SetChannel(&g_mixer, 2, MIXER_UNITY, 32, MIX_GROUP_SYNTH);
+  Set_Mix_Routing(effects_enabled);
+  Dynamics_Init(&g_master_dyn, &MASTER_LIMITER, SYNTH_SAMPLE_RATE_HZ,
+                SYNTH_BLOCK_SIZE, 32767);
+  Parts_Init(&parts, platform.cycles);
+
+  atomic_init(&config_seq, 0);
+  live_config = &config_bank[0];
+  Publish_Config();
+}
+
+void Synth_ProcessControls(Joystick_t *joy, const Accelerometer_t *acc) {
+  PERF_BEGIN(MUSIC_CONTROLS);
+  Process_Musical_Controls(joy, acc);
+  PERF_END(MUSIC_CONTROLS);
+  Process_Accelerometer(acc);
+}
+
+void Synth_Button(SynthButton_t button, SynthPress_t press) {
+  if (button == SYNTH_BTN_JOY_SEL) {
+    if (press == SYNTH_PRESS_SHORT) {
+      Synth_ToggleEpic();
+    } else if (press == SYNTH_PRESS_LONG) {
+      Synth_Reset();
+    }
+  } else {
+    // S1/S2 toggle from the engine's state, so they are applied there
+    Post(PARAM_BUTTON, ((int32_t)button << 8) | press);
+  }
+}
+
+void Synth_NoteOn(void) {
+  Post(PARAM_NOTE, 1);
+}
+
+void Synth_NoteOff(void) {
+  Post(PARAM_NOTE, 0);
+}
+
+void Synth_SetPlaying(bool on) {
+  Post(PARAM_PLAYING, on);
+}
+
+void Synth_SetVolume(uint8_t vol) {
+  Post(PARAM_VOLUME, vol);
+}
+
+void Synth_SetKey(MusicalKey_t key) {
+  Post(PARAM_KEY, key);
+}
+
+void Synth_SetMode(MusicalMode_t mode) {
+  Post(PARAM_MODE, mode);
+}
+
+void Synth_SetHarmony(HarmonicFunction_t harmony) {
+  Post(PARAM_HARMONY, harmony);
+}
+
+void Synth_SetInstrument(Instrument_t instrument) {
+  Post(PARAM_INSTRUMENT, instrument);
+}
+
+void Synth_SetPreset(uint8_t preset_index) {
+  Post(PARAM_PRESET, preset_index);
+}
+
+void Synth_SetEffects(bool enabled) {
+  Post(PARAM_EFFECTS, enabled);
+}
+
+void Synth_SetChordMode(ChordMode_t mode) {
+  Post(PARAM_CHORD_MODE, mode);
+}
+
+void Synth_SetArpMode(ArpMode_t mode) {
+  Post(PARAM_ARP_MODE, mode);
+}
+
+void Synth_SetTempo(uint16_t bpm) {
+  Post(PARAM_TEMPO, bpm);
+}
+
+void Synth_SetPart(uint8_t part, SynthPartParam_t param, int16_t value) {
+  if (part >= SYNTH_PART_COUNT)
+    return;
+  Post(PARAM_PART, ((int32_t)part << 16) | ((int32_t)param << 8) |
+                       (uint8_t)value);
+}
+
+void Synth_NextScale(void) {
+  Post(PARAM_NEXT_SCALE, 0);
+}
+
+bool Synth_ToggleEpic(void) {
+  epic_requested = !epic_requested;
+  if (!epic_requested)
+    posted_octave_shift = OCTAVE_UNPOSTED; // Tilt takes over again
+  Post(PARAM_EPIC, epic_requested);
+  return epic_requested;
+}
+
+void Synth_Reset(void) {
+  epic_requested = false;
+  posted_octave_shift = OCTAVE_UNPOSTED;
+  Post(PARAM_RESET, 0);
+}
+
+//=============================================================================
+// PARAMETER QUEUE
+//=============================================================================
+static void Post(SynthParamId_t id, int32_t value) {
+  ParamQueue_Push(&param_queue, (uint8_t)id, value); // Counts overflows
+}
+
+static void Apply_Button(SynthButton_t button, SynthPress_t press) {
+  switch (button) {
+  case SYNTH_BTN_S1:
+    if (press == SYNTH_PRESS_SHORT) {
+      Set_Instrument(
+          (Instrument_t)((current_instrument + 1) % INSTRUMENT_COUNT));
+    } else if (press == SYNTH_PRESS_LONG) {
+      // Toggle between Major and Minor mode
+      Set_Mode((MusicalMode_t)((current_mode + 1) % MODE_COUNT));
+    } else if (press == SYNTH_PRESS_DOUBLE) {
+      effects_enabled = !effects_enabled;
+    }
+    break;
+
+  case SYNTH_BTN_S2:
+    if (press == SYNTH_PRESS_SHORT) {
+      Set_Playing(!playing);
+    } else if (press == SYNTH_PRESS_LONG) {
+      chord_mode = (ChordMode_t)((chord_mode + 1) % CHORD_MODE_COUNT);
+    } else if (press == SYNTH_PRESS_DOUBLE) {
+      arpeggiator.mode = (arpeggiator.mode == ARP_OFF) ? ARP_UP : ARP_OFF;
+    }
+    break;
+
+  case SYNTH_BTN_JOY_SEL:
+    break; // Posted as PARAM_EPIC / PARAM_RESET
+  }
+}
+
+static void Set_Playing(bool on) {
+  playing = on;
+  if (playing)
+    Note_On();
+  else
+    Envelope_NoteOff(&envelope); // Library API
+}
+
+static void Set_Key(MusicalKey_t key) {
+  if (key >= KEY_COUNT)
+    return;
+  scale_state.current_key = key;
+  scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+      scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+  target_frequency_hz = scale_state.current_note_freq;
+  Update_Phase_Increment();
+}
+
+static void Set_Mode(MusicalMode_t mode) {
+  if (mode >= MODE_COUNT)
+    return;
+  current_mode = mode;
+
+  // Update frequency for new mode
+  scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+      scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+  target_frequency_hz = scale_state.current_note_freq;
+  Update_Phase_Increment();
+}
+
+static void Set_Harmony(HarmonicFunction_t harmony) {
+  if (harmony >= HARM_COUNT)
+    return;
+  current_harmony = harmony;
+  scale_state.current_note_freq = Calculate_Harmonic_Frequency(
+      scale_state.current_key, current_mode, current_harmony, current_octave_shift);
+  target_frequency_hz = scale_state.current_note_freq;
+  Update_Phase_Increment();
+}
+
+static void Reset_Engine(void) {
+  epic_mode_active = false;
+  current_instrument = INSTRUMENT_PIANO;
+  current_preset = 0;
+  effects_enabled = true;
+  chord_mode = CHORD_OFF;
+  arpeggiator.mode = ARP_OFF;
+  scale_state.current_key = KEY_C;
+  scale_state.current_scale = SCALE_MAJOR;
+  Load_Preset_Effects(&PRESETS[0]);
+  Parts_AllSoundOff(&parts); // Part settings stay
+}
+
+// Audio context, start of every block: everything posted since the last one
+// (true if anything was applied)
+static bool Apply_Params(void) {
+  ParamMsg_t msg;
+  bool applied = false;
+
+  while (ParamQueue_Pop(&param_queue, &msg)) {
+    int32_t v = msg.value;
+    applied = true;
+
+    switch ((SynthParamId_t)msg.id) {
+    case PARAM_NOTE:
+      if (v)
+        Note_On();
+      else
+        Envelope_NoteOff(&envelope); // Library API
+      break;
+    case PARAM_PLAYING:
+      Set_Playing(v != 0);
+      break;
+    case PARAM_VOLUME:
+      volume = (v > 100) ? 100 : (uint8_t)v;
+      break;
+    case PARAM_KEY:
+      Set_Key((MusicalKey_t)v);
+      break;
+    case PARAM_MODE:
+      Set_Mode((MusicalMode_t)v);
+      break;
+    case PARAM_HARMONY:
+      Set_Harmony((HarmonicFunction_t)v);
+      break;
+    case PARAM_INSTRUMENT:
+      Set_Instrument((Instrument_t)v);
+      break;
+    case PARAM_PRESET:
+      Set_Preset((uint8_t)v);
+      break;
+    case PARAM_EFFECTS:
+      effects_enabled = (v != 0);
+      break;
+    case PARAM_CHORD_MODE:
+      if (v < CHORD_MODE_COUNT)
+        chord_mode = (ChordMode_t)v;
+      break;
+    case PARAM_ARP_MODE:
+      if (v < ARP_MODE_COUNT)
+        arpeggiator.mode = (ArpMode_t)v;
+      break;
+    case PARAM_NEXT_SCALE:
+      Next_Scale();
+      break;
+    case PARAM_BUTTON:
+      Apply_Button((SynthButton_t)(v >> 8), (SynthPress_t)(v & 0xFF));
+      break;
+    case PARAM_EPIC:
+      if ((v != 0) != epic_mode_active)
+        Toggle_Epic();
+      break;
+    case PARAM_RESET:
+      Reset_Engine();
+      break;
+    case PARAM_JOY_KEY:
+    case PARAM_JOY_VOLUME:
+    case PARAM_TILT_HARMONY:
+      Apply_Musical_Control((SynthParamId_t)msg.id, v);
+      break;
+    case PARAM_TILT_OCTAVE:
+      Apply_Octave_Tilt((int8_t)v);
+      break;
+    case PARAM_TEMPO:
+      MidiClock_SetTempo(&transport, (uint16_t)v);
+      break;
+    case PARAM_PART:
+      Parts_Set(&parts, (uint8_t)(v >> 16), (SynthPartParam_t)((v >> 8) & 0xFF),
+                (int8_t)(v & 0xFF));
+      break;
+    }
+  }
+  return applied;
+}
+
+//=============================================================================
+// MIDI INPUT (audio context)
+//=============================================================================
+static uint32_t Midi_Note_Hz(uint8_t note) {
+  uint32_t hz = MIDI_NoteToFreq(note);
+  if (hz < FREQ_MIN_HZ)
+    hz = FREQ_MIN_HZ;
+  if (hz > FREQ_MAX_HZ)
+    hz = FREQ_MAX_HZ;
+  return hz;
+}
+
+static void Midi_Forget(uint8_t note) {
+  uint8_t j = 0;
+  for (uint8_t i = 0; i < midi_held_count; i++) {
+    if (midi_held[i] != note)
+      midi_held[j++] = midi_held[i];
+  }
+  midi_held_count = j;
+}
+
+static void Midi_Note_On(uint8_t note) {
+  if (epic_mode_active)
+    return; // The sequence owns the pitch
+
+  Midi_Forget(note);
+  bool legato = midi_held_count != 0;
+  if (midi_held_count == MIDI_HELD_MAX)
+    Midi_Forget(midi_held[0]); // Oldest
+  midi_held[midi_held_count++] = note;
+  midi_sustained = false;
+
+  target_frequency_hz = Midi_Note_Hz(note);
+  if (!legato) {
+    // A new phrase starts on pitch; only legato notes glide
+    current_frequency_hz = target_frequency_hz;
+    Note_On();
+  }
+}
+
+static void Midi_Note_Off(uint8_t note) {
+  if (midi_held_count == 0)
+    return;
+
+  bool sounding = midi_held[midi_held_count - 1] == note;
+  Midi_Forget(note);
+  if (!sounding)
+    return;
+
+  if (midi_held_count != 0) {
+    target_frequency_hz = Midi_Note_Hz(midi_held[midi_held_count - 1]);
+  } else if (midi_sustain) {
+    midi_sustained = true;
+  } else {
+    Envelope_NoteOff(&envelope); // Library API
+  }
+}
+
+static void Midi_All_Off(void) {
+  midi_held_count = 0;
+  midi_sustained = false;
+  Envelope_NoteOff(&envelope); // Library API
+}
+
+// 0-16383, 8192 = centre: read between the semitone entries of the table
+static uint32_t Bend_Ratio(uint16_t value) {
+  int32_t pos = ((int32_t)value - 8192) * MIDI_BEND_SEMITONES + 12 * 8192;
+  uint8_t i = (uint8_t)(pos >> 13);
+  uint32_t frac = (uint32_t)pos & 8191;
+
+  return PITCH_BEND_TABLE[i] +
+         (((PITCH_BEND_TABLE[i + 1] - PITCH_BEND_TABLE[i]) * frac) >> 13);
+}
+
+static void Midi_Pitch_Bend(uint16_t value) {
+  wheel_ratio = Bend_Ratio(value);
+  Update_Phase_Increment();
+}
+
+static void Midi_Control(uint8_t controller, uint8_t value) {
+  switch (controller) {
+  case MIDI_CC_VOLUME:
+    volume = (uint8_t)((value * 100u) / 127u);
+    midi_applied = true;
+    break;
+  case MIDI_CC_SUSTAIN:
+    midi_sustain = value >= 64;
+    if (!midi_sustain && midi_sustained)
+      Midi_All_Off();
+    break;
+  case MIDI_CC_ALL_SOUND_OFF:
+  case MIDI_CC_ALL_NOTES_OFF:
+    Midi_All_Off();
+    break;
+  case MIDI_CC_RESET_CONTROLLERS:
+    midi_sustain = false;
+    if (midi_sustained)
+      Midi_All_Off();
+    Midi_Pitch_Bend(8192);
+    break;
+  default:
+    break;
+  }
+}
+
+void Synth_MidiRealTime(uint8_t byte) {
+  MidiClock_RealTime(&transport, byte);
+}
+
+// A channel message for a multi-timbral part
+static void Midi_Part(uint8_t part, uint8_t status, uint8_t data1,
+                      uint8_t data2) {
+  switch (status & 0xF0) {
+  case MIDI_NOTE_ON:
+    if (data2 != 0) {
+      Parts_NoteOn(&parts, part, data1, data2);
+      break;
+    }
+    /* fall through */
+  case MIDI_NOTE_OFF:
+    Parts_NoteOff(&parts, part, data1);
+    break;
+  case MIDI_CONTROL_CHANGE:
+    Parts_Control(&parts, part, data1, data2);
+    break;
+  case MIDI_PROGRAM_CHANGE:
+    Parts_Set(&parts, part, SYNTH_PART_INSTRUMENT, data1 % INSTRUMENT_COUNT);
+    break;
+  case MIDI_PITCH_BEND:
+    Parts_Bend(&parts, part,
+               Bend_Ratio((uint16_t)(((uint16_t)data2 << 7) | data1)));
+    break;
+  default:
+    break;
+  }
+}
+
+void Synth_MidiMessage(uint8_t status, uint8_t data1, uint8_t data2) {
+  data1 &= 0x7F;
+  data2 &= 0x7F;
+
+  int8_t part = Parts_Find(&parts, status & 0x0F);
+  if (part >= 0) {
+    Midi_Part((uint8_t)part, status, data1, data2);
+    return;
+  }
+
+  switch (status & 0xF0) {
+  case MIDI_NOTE_ON:
+    if (data2 != 0) {
+      Midi_Note_On(data1);
+      break;
+    }
+    // Velocity 0 is Note Off
+    /* fall through */
+  case MIDI_NOTE_OFF:
+    Midi_Note_Off(data1);
+    break;
+  case MIDI_CONTROL_CHANGE:
+    Midi_Control(data1, data2);
+    break;
+  case MIDI_PROGRAM_CHANGE:
+    Set_Instrument((Instrument_t)(data1 % INSTRUMENT_COUNT));
+    midi_applied = true;
+    break;
+  case MIDI_PITCH_BEND:
+    Midi_Pitch_Bend((uint16_t)(((uint16_t)data2 << 7) | data1));
+    break;
+  default:
+    break;
+  }
+}
+
+//=============================================================================
+// CONFIGURATION SNAPSHOT
+//=============================================================================
+// Audio context: fill the idle half, then flip
+static void Publish_Config(void) {
+  uint32_t seq = atomic_load_explicit(&config_seq, memory_order_relaxed) + 1;
+  SynthConfig_t *next = &config_bank[seq & 1];
+
+  next->instrument = current_instrument;
+  next->preset = current_preset;
+  next->effects_enabled = effects_enabled;
+  next->chord_mode = chord_mode;
+  next->arp_mode = arpeggiator.mode;
+  next->key = scale_state.current_key;
+  next->mode = current_mode;
+  next->harmony = current_harmony;
+  next->octave_shift = current_octave_shift;
+  next->epic_active = epic_mode_active;
+  next->volume = volume;
+  next->playing = playing;
+
+  // The half is complete before the sequence makes it current
+  atomic_store_explicit(&config_seq, seq, memory_order_release);
+  live_config = next;
+}
+
+// Any context: a copy that no publish overlapped
+static void Read_Config(SynthConfig_t *config) {
+  uint32_t seq;
+
+  do {
+    seq = atomic_load_explicit(&config_seq, memory_order_acquire);
+    *config = config_bank[seq & 1];
+    atomic_thread_fence(memory_order_acquire);
+  } while (atomic_load_explicit(&config_seq, memory_order_relaxed) != seq);
+}
+
+void Synth_GetStatus(SynthStatus_t *status) {
+  SynthConfig_t config;
+
+  // Configuration from the published snapshot: never half a preset
+  Read_Config(&config);
+  status->instrument = config.instrument;
+  status->preset = config.preset;
+  status->key = config.key;
+  status->mode = config.mode;
+  status->harmony = config.harmony;
+  status->octave_shift = config.octave_shift;
+  status->effects_enabled = config.effects_enabled;
+  status->chord_mode = config.chord_mode;
+  status->arp_mode = config.arp_mode;
+  status->epic_active = config.epic_active;
+  status->epic_step = epic_sequence_step;
+  status->volume = config.volume;
+  status->playing = config.playing;
+  status->frequency_hz = base_frequency_hz;
+  status->pitch_hz = pitch_hz;
+  status->phase_increment = g_phase_increment;
+  status->env_state = Envelope_GetState(&envelope);
+  status->env_amplitude = Envelope_GetAmplitude(&envelope);
+  status->samples_generated = samples_generated;
+  status->fx_cycles = fx_cycles;
+  status->limiter_gr_db10 = limiter_gr_db10;
+  status->param_overflows = param_queue.overflows;
+  status->tempo_bpm10 = MidiClock_GetTempo10(&transport);
+  status->clock_external = transport.external;
+}
+
+// Point the engine at another bank. The envelopes and the parts read their
+// instrument in place, so their pointers move to the same entry of the new
+// bank; the insert chain is rebuilt for the current preset.
+static void Use_Bank(const SynthBank_t *next) {
+  const InstrumentProfile_t *from = INSTRUMENTS;
+
+  bank_in_use = next;
+  INSTRUMENTS = next->instruments;
+  PRESETS = next->presets;
+  for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+    if (envelope.profile == &from[i].adsr)
+      envelope.profile = &INSTRUMENTS[i].adsr;
+  }
+  Parts_Rebind(&parts, from);
+  Load_Preset_Effects(&PRESETS[current_preset]);
+  midi_applied = true;
+}
+
+void Synth_GetBank(SynthBank_t *copy) {
+  *copy = *bank_in_use;
+}
+
+void Synth_SetBank(const SynthBank_t *next) {
+  bank_copy = *next;
+  Use_Bank(&bank_copy);
+}
+
+void Synth_MapBank(const SynthBank_t *bank) {
+  Use_Bank(bank);
+}
+
+void Synth_FactoryBank(void) {
+  Use_Bank(&FACTORY_BANK);
+}
+
+// Settings and counters are read unlocked: a field may be a block old
+void Synth_GetPartStatus(uint8_t part, SynthPartStatus_t *status) {
+  Parts_GetStatus(&parts, part, status);
+}
+
+void Synth_UpdatePartLoad(uint32_t now) {
+  Parts_UpdateLoad(&parts, now);
+}
+
+const int16_t *Synth_GetScope(void) {
+  return scope_buffer;
+}
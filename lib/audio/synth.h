@@ -1,8 +1,474 @@
+/**
+ * @file synth.h
+ * @brief Synth Engine (instruments, harmony, arpeggiator, block renderer)
+ * @version 1.0.0
+ *
+ * Everything that decides what the synth sounds like, without any
+ * hardware: musical state, presets, controls and the block renderer
+ * (oscillators -> mixer -> insert chain -> master limiter). The firmware
+ * feeds it ADC values and button events and sends the rendered blocks to
+ * an output backend; the host renderer (tools/host) drives the same code
+ * from a control script.
+ *
+ * The control calls (buttons, setters, Synth_ProcessControls) post
+ * messages to a parameter queue (param_queue.h); Synth_RenderBlock applies
+ * them at the start of the next block, and only the audio context writes
+ * engine state. The resulting configuration is published as a
+ * double-buffered, sequence-counted snapshot, so the renderer and
+ * Synth_GetStatus (any context) see a preset switch whole or not at all.
+ * Synth_GetStatus reflects a change after that block.
+ *
+ * Hardware services come in through SynthPlatform_t (MATHACL sine, cycle
+ * counter, LED feedback). All hooks are optional.
+ *
+ * Usage:
+ *   static const SynthPlatform_t hw = {MATHACL_Sine, Cycles_Now, On_Event};
+ *   Synth_Init(&hw);
+ *
+ *   // Main loop:
+ *   Synth_Button(SYNTH_BTN_S1, SYNTH_PRESS_SHORT);
+ *   Synth_ProcessControls(&joystick, &accel);
+ *
+ *   // Audio context, once per block:
+ *   Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+ */
+
 #ifndef SYNTH_H
 #define SYNTH_H
 
-// Her lister du opp alle funksjoner som andre filer får lov å bruke
-void Process_Arpeggiator(void); 
-void Process_Epic_Mode(void);
+#include <stdint.h>
+#include <stdbool.h>
+#include "audio_engine.h"
+#include "audio_envelope.h"
+#include "audio_fxchain.h"
+#include "../edumkii/edumkii_joystick.h"
+#include "../edumkii/edumkii_accel.h"
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define SYNTH_SAMPLE_RATE_HZ 16000
+#define SYNTH_BLOCK_SIZE     32      // 2 ms at 16 kHz
+#define SYNTH_CHORD_VOICES   3
+#define SYNTH_SCOPE_SIZE     64      // Decimated waveform for the display
+#define SYNTH_PRESET_COUNT   3
+#define SYNTH_NAME_SIZE      12      // Instrument and preset names, NUL included
+
+#ifndef SYNTH_FX_CYCLE_BUDGET
+#define SYNTH_FX_CYCLE_BUDGET (SYNTH_BLOCK_SIZE * 5000 / 4) // 25% of 80 MHz
+#endif
+
+#ifndef SYNTH_PART_COUNT
+#define SYNTH_PART_COUNT     4       // Multi-timbral parts (MIDI channels 2-5)
+#endif
+#ifndef SYNTH_POOL_VOICES
+#define SYNTH_POOL_VOICES    8       // Voices shared by the parts
+#endif
+#if SYNTH_PART_COUNT < 1 || SYNTH_PART_COUNT > 16
+#error "SYNTH_PART_COUNT must be 1-16"
+#endif
+
+//=============================================================================
+// MUSICAL TYPES
+//=============================================================================
+typedef enum {
+  SCALE_MAJOR = 0,
+  SCALE_MINOR,
+  SCALE_PENTATONIC_MAJOR,
+  SCALE_PENTATONIC_MINOR,
+  SCALE_BLUES,
+  SCALE_DORIAN,
+  SCALE_COUNT
+} ScaleType_t;
+
+typedef enum {
+  KEY_C = 0,
+  KEY_D,
+  KEY_E,
+  KEY_F,
+  KEY_G,
+  KEY_A,
+  KEY_B,
+  KEY_COUNT
+} MusicalKey_t;
+
+typedef struct {
+  MusicalKey_t current_key;
+  ScaleType_t current_scale;
+  uint8_t scale_position;
+  uint16_t current_note_freq;
+} ScaleState_t;
+
+typedef enum {
+  MODE_MAJOR = 0,
+  MODE_MINOR = 1,
+  MODE_COUNT = 2
+} MusicalMode_t;
+
+// Harmonic function: Extended harmony with 24 positions for smooth ACCEL_X control
+// Follows MIDI standard with semitone-based progressions
+// Organized for natural musical flow with octave variants
+typedef enum {
+  // Low register (-7 to -1 semitones from root)
+  HARM_vii_low = 0,   // -1 semitone (leading tone below)
+  HARM_vi_low,        // -2 semitones
+  HARM_V_low,         // -5 semitones (dominant below)
+  HARM_IV_low,        // -7 semitones (subdominant below)
+
+  // Mid-low register (base diatonic chords)
+  HARM_I = 4,         // 0 semitones - Root/Tonic ⭐
+  HARM_ii,            // +2 semitones - Supertonic
+  HARM_iii,           // +4 semitones - Mediant
+  HARM_IV,            // +5 semitones - Subdominant
+  HARM_V,             // +7 semitones - Dominant
+  HARM_vi,            // +9 semitones - Submediant
+  HARM_vii,           // +11 semitones - Leading tone
+
+  // Mid-high register (extended chords)
+  HARM_I_oct,         // +12 semitones - Tonic octave up
+  HARM_V7,            // +7 semitones - Dominant 7th
+  HARM_ii7,           // +2 semitones - Supertonic 7th
+  HARM_vi7,           // +9 semitones - Submediant 7th
+  HARM_IVmaj7,        // +5 semitones - Subdominant maj7
+
+  // High register (+12 to +19 semitones from root)
+  HARM_I_inv,         // +16 semitones - Tonic first inversion high
+  HARM_ii_high,       // +14 semitones
+  HARM_IV_high,       // +17 semitones
+  HARM_V_high,        // +19 semitones
+
+  // Very high register (+24 semitones = 2 octaves)
+  HARM_I_2oct,        // +24 semitones - Tonic 2 octaves up
+  HARM_V_2oct,        // +31 semitones - Dominant 2 octaves up
+  HARM_IV_2oct,       // +29 semitones - Subdominant 2 octaves up
+  HARM_I_3oct,        // +36 semitones - Tonic 3 octaves up
+
+  HARM_COUNT
+} HarmonicFunction_t;
+
+//=============================================================================
+// CHORD & ARPEGGIATOR
+//=============================================================================
+typedef enum {
+  CHORD_OFF = 0,
+  CHORD_MAJOR,
+  CHORD_MINOR,
+  CHORD_MODE_COUNT
+} ChordMode_t;
+
+typedef enum {
+  ARP_OFF = 0,
+  ARP_UP,
+  ARP_DOWN,
+  ARP_UP_DOWN,
+  ARP_RANDOM,
+  ARP_MODE_COUNT
+} ArpMode_t;
+
+typedef struct {
+  ArpMode_t mode;
+  uint8_t current_step;
+  uint8_t clocks_per_step;  ///< MIDI clocks (24 per beat): 6 = sixteenths
+} Arpeggiator_t;
+
+//=============================================================================
+// INSTRUMENTS
+//=============================================================================
+typedef enum {
+  INSTRUMENT_PIANO = 0,
+  INSTRUMENT_ORGAN,
+  INSTRUMENT_STRINGS,
+  INSTRUMENT_BASS,
+  INSTRUMENT_LEAD,
+  INSTRUMENT_COUNT
+} Instrument_t;
+
+// Instruments and presets have fixed-width fields only: a compiled bank
+// image (synth_bank.h) is these structs as they lie in flash.
+typedef struct {
+  char name[SYNTH_NAME_SIZE];
+  ADSR_Profile_t adsr;
+  uint8_t waveform;    // Waveform_t
+  uint8_t num_harmonics;
+  uint8_t vibrato_depth;
+  uint8_t tremolo_depth;
+  uint8_t drive;       // Waveshaper input gain (0 = off, 16 = unity)
+} InstrumentProfile_t;
+
+// Effects a preset can place in the insert chain (in order).
+// Parameters come from the current instrument; a slot whose instrument
+// parameter is 0 is bypassed.
+typedef enum {
+  EFFECT_NONE = 0,
+  EFFECT_TREMOLO, // depth = inst->tremolo_depth
+  EFFECT_DRIVE,   // gain = inst->drive
+  EFFECT_CRUSH,   // fixed lo-fi setting
+  EFFECT_COUNT
+} EffectId_t;
+
+typedef struct {
+  char name[SYNTH_NAME_SIZE];
+  uint8_t instrument;      // Instrument_t
+  uint8_t effects_enabled; // 0 or 1
+  uint8_t chord_mode;      // ChordMode_t
+  uint8_t arp_mode;        // ArpMode_t
+  uint8_t effects[FX_CHAIN_MAX_SLOTS]; // EffectId_t
+} Preset_t;
+
+/**
+ * @brief Sound bank: every instrument and preset (SysEx, flash, synth_bank.h)
+ */
+typedef struct {
+  InstrumentProfile_t instruments[INSTRUMENT_COUNT];
+  Preset_t presets[SYNTH_PRESET_COUNT];
+} SynthBank_t;
+
+// The bank in use (read-only; set by Synth_Init, Synth_SetBank and
+// Synth_MapBank, which may point them at a bank in flash)
+extern const InstrumentProfile_t *INSTRUMENTS;
+extern const Preset_t *PRESETS;
+
+//=============================================================================
+// PLATFORM AND CONTROL TYPES
+//=============================================================================
+
+/**
+ * @brief Things the engine reports to the platform
+ */
+typedef enum {
+  SYNTH_EVENT_EPIC_STEP = 0,  ///< Sequencer advanced (value = step)
+  SYNTH_EVENT_OCTAVE,         ///< Octave zone changed (value = -1, 0, +1)
+  SYNTH_EVENT_MIDI_CLOCK      ///< Master clock byte to send (value = 0xF8)
+} SynthEvent_t;
+
+/**
+ * @brief Hardware services (any hook may be NULL)
+ */
+typedef struct {
+  int16_t (*sine)(uint32_t phase);   ///< Sine, +/-1024 (NULL = wavetable)
+  uint32_t (*cycles)(void);          ///< Cycle counter for FX accounting
+  void (*on_event)(SynthEvent_t event, int32_t value); ///< Feedback (LEDs)
+} SynthPlatform_t;
+
+/**
+ * @brief Front-panel buttons
+ */
+typedef enum {
+  SYNTH_BTN_S1 = 0,
+  SYNTH_BTN_S2,
+  SYNTH_BTN_JOY_SEL
+} SynthButton_t;
+
+/**
+ * @brief Button gestures (same values as ButtonEvent_t)
+ */
+typedef enum {
+  SYNTH_PRESS_NONE = 0,
+  SYNTH_PRESS_SHORT,
+  SYNTH_PRESS_LONG,
+  SYNTH_PRESS_DOUBLE
+} SynthPress_t;
+
+/**
+ * @brief Snapshot for display, MIDI and telemetry
+ */
+typedef struct {
+  Instrument_t instrument;
+  uint8_t preset;
+  MusicalKey_t key;
+  MusicalMode_t mode;
+  HarmonicFunction_t harmony;
+  int8_t octave_shift;
+  bool effects_enabled;
+  ChordMode_t chord_mode;
+  ArpMode_t arp_mode;
+  bool epic_active;
+  uint8_t epic_step;
+  uint8_t volume;                   ///< 0-100
+  bool playing;
+  uint32_t frequency_hz;            ///< Current (gliding) note frequency
+  uint32_t pitch_hz;                ///< Oscillator frequency after octave shift
+  uint32_t phase_increment;
+  EnvelopeState_t env_state;
+  uint16_t env_amplitude;           ///< 0-1000
+  uint32_t samples_generated;
+  uint32_t fx_cycles;               ///< Insert chain cycles, last block
+  uint16_t limiter_gr_db10;         ///< Master limiter reduction (0.1 dB)
+  uint16_t param_overflows;         ///< Changes lost to a full queue
+  uint16_t tempo_bpm10;             ///< Transport tempo, 0.1 BPM
+  bool clock_external;              ///< Following received MIDI clock
+} SynthStatus_t;
+
+/**
+ * @brief Multi-timbral part settings (Synth_SetPart)
+ */
+typedef enum {
+  SYNTH_PART_CHANNEL = 0,  ///< MIDI channel 0-15, -1 = off
+  SYNTH_PART_INSTRUMENT,   ///< Instrument_t
+  SYNTH_PART_VOLUME,       ///< 0-127
+  SYNTH_PART_PAN,          ///< -64 left to +63 right
+  SYNTH_PART_VOICES,       ///< Voice limit, 1-SYNTH_POOL_VOICES
+  SYNTH_PART_PRIORITY      ///< 0-3, higher parts keep their voices
+} SynthPartParam_t;
+
+/**
+ * @brief One multi-timbral part, for display and telemetry
+ */
+typedef struct {
+  int8_t channel;                   ///< MIDI channel 0-15, -1 = off
+  Instrument_t instrument;
+  uint8_t volume;                   ///< 0-127
+  int8_t pan;
+  uint8_t voice_limit;
+  uint8_t priority;
+  uint8_t voices;                   ///< Sounding now
+  uint16_t stolen;                  ///< Voices taken by other parts
+  uint16_t dropped;                 ///< Notes with no voice to play on
+  uint32_t cycles_avg;              ///< Render cycles per block, last window
+  uint32_t cycles_max;              ///< Since Synth_Init
+  uint16_t load_pct10;              ///< Share of the CPU, 0.1 %
+} SynthPartStatus_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Initialize the engine (PIANO, CLASSIC effects, A4, volume 80, playing)
+ * @param hw Platform hooks (copied; may be NULL)
+ */
+void Synth_Init(const SynthPlatform_t *hw);
+
+/**
+ * @brief Render one block
+ * @param mix Output, 16-bit (master limiter output)
+ * @param n Number of samples (<= SYNTH_BLOCK_SIZE)
+ */
+void Synth_RenderBlock(int16_t *mix, uint16_t n);
+
+/**
+ * @brief Post a front-panel gesture (the firmware's button map)
+ */
+void Synth_Button(SynthButton_t button, SynthPress_t press);
+
+/**
+ * @brief Post joystick and accelerometer changes (key, volume, harmony, octave)
+ * @param joy Joystick after Joystick_Update()
+ * @param acc Accelerometer after Accel_Update()
+ */
+void Synth_ProcessControls(Joystick_t *joy, const Accelerometer_t *acc);
+
+void Synth_NoteOn(void);
+void Synth_NoteOff(void);
+void Synth_SetPlaying(bool playing);
+void Synth_SetVolume(uint8_t volume);
+void Synth_SetKey(MusicalKey_t key);
+void Synth_SetMode(MusicalMode_t mode);
+void Synth_SetHarmony(HarmonicFunction_t harmony);
+void Synth_SetInstrument(Instrument_t instrument);
+void Synth_SetPreset(uint8_t preset);
+void Synth_SetEffects(bool enabled);
+void Synth_SetChordMode(ChordMode_t mode);
+void Synth_SetArpMode(ArpMode_t mode);
+void Synth_SetTempo(uint16_t bpm);
+void Synth_NextScale(void);
+
+/**
+ * @brief Start or stop the Greensleeves sequence
+ * @return true if the sequence will be running after the next block
+ */
+bool Synth_ToggleEpic(void);
+
+/**
+ * @brief Back to PIANO / CLASSIC / C major (JOY_SEL long press)
+ */
+void Synth_Reset(void);
+
+/**
+ * @brief Change a multi-timbral part (applied at the next block)
+ * @param part 0 to SYNTH_PART_COUNT-1
+ */
+void Synth_SetPart(uint8_t part, SynthPartParam_t param, int16_t value);
+
+/**
+ * @brief Read one multi-timbral part
+ */
+void Synth_GetPartStatus(uint8_t part, SynthPartStatus_t *status);
+
+/**
+ * @brief Close the per-part load windows (call at 10 Hz, main loop)
+ * @param now Cycle counter (the SynthPlatform_t cycles hook)
+ */
+void Synth_UpdatePartLoad(uint32_t now);
+
+/**
+ * @brief Apply one received MIDI channel message
+ *
+ * Audio context only, just before Synth_RenderBlock: MIDI input is parsed
+ * there, so it changes engine state directly instead of posting, and
+ * lands on the next block boundary.
+ *
+ * A channel with a multi-timbral part (synth_parts.h; channels 2-5 by
+ * default) plays that part: polyphonic notes with velocity, CC 7/10/64/
+ * 120/121/123, Program Change and Pitch Bend per part. Every other
+ * channel plays the front-panel sound:
+ *   - Note On/Off: last note wins; releasing it glides back to a note
+ *     still held. Velocity is not used (one envelope level).
+ *   - CC 7 volume, 64 sustain, 120/123 all off, 121 reset controllers.
+ *   - Program Change: instrument (program modulo INSTRUMENT_COUNT).
+ *   - Pitch Bend: +/-2 semitones.
+ * Notes are ignored while the Greensleeves sequence runs.
+ */
+void Synth_MidiMessage(uint8_t status, uint8_t data1, uint8_t data2);
+
+/**
+ * @brief Apply a received real-time byte (audio context, like above)
+ *
+ * Start/Continue make the transport follow the incoming MIDI clock, Stop
+ * halts it; without clock for half a second it is master again, sending
+ * SYNTH_EVENT_MIDI_CLOCK at the Synth_SetTempo tempo. Arpeggiator steps
+ * (sixteenths) and Greensleeves steps (bars) fall on its clocks.
+ */
+void Synth_MidiRealTime(uint8_t byte);
+
+/**
+ * @brief Copy the bank in use
+ */
+void Synth_GetBank(SynthBank_t *bank);
+
+/**
+ * @brief Replace the bank (audio context, or before the audio starts)
+ *
+ * The current instrument and preset pick up the new values at once
+ * (envelope times, waveform, insert effects) without retriggering the
+ * note. The values must be in range: SynthBank_Decode and
+ * SynthBank_ParseFrame check them.
+ */
+void Synth_SetBank(const SynthBank_t *bank);
+
+/**
+ * @brief Play a bank where it lies, without a copy (audio context, or
+ * before the audio starts)
+ *
+ * For a compiled image in flash (SynthBank_Map checks it). The bank must
+ * stay valid until another one replaces it; the new values apply at once,
+ * as with Synth_SetBank.
+ */
+void Synth_MapBank(const SynthBank_t *bank);
+
+/**
+ * @brief Back to the built-in bank (audio context, like Synth_SetBank)
+ */
+void Synth_FactoryBank(void);
+
+/**
+ * @brief Read the engine state
+ */
+void Synth_GetStatus(SynthStatus_t *status);
+
+/**
+ * @brief Decimated oscillator output for the display (SYNTH_SCOPE_SIZE samples)
+ */
+const int16_t *Synth_GetScope(void);
 
-#endif
\ No newline at end of file
+#endif /* SYNTH_H */
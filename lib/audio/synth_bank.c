@@ -0,0 +1,347 @@
+/**
+ * @file synth_bank.c
+ * @brief Sound Bank Encoding Implementation
+ */
+
+#include "synth_bank.h"
+#include <string.h>
+
+#if BANK_PRESET_BYTES > BANK_INSTRUMENT_BYTES
+#error "record buffers are sized for an instrument"
+#endif
+
+// The image body is the structs themselves: pin their layout, so a change
+// to synth.h shows here and not as a bank that no longer maps
+_Static_assert(sizeof(InstrumentProfile_t) == SYNTH_NAME_SIZE + 14 &&
+               sizeof(Preset_t) == SYNTH_NAME_SIZE + 4 + FX_CHAIN_MAX_SLOTS,
+               "bank image layout changed: bump BANK_VERSION");
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+static const uint8_t BANK_MAGIC[4] = {'S', 'B', 'N', 'K'};
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), bitwise: runs on a store
+static uint16_t Crc16(const uint8_t *data, uint16_t n) {
+    uint16_t crc = 0xFFFF;
+    while (n--) {
+        crc ^= (uint16_t)(*data++ << 8);
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021)
+                                 : (uint16_t)(crc << 1);
+    }
+    return crc;
+}
+
+static uint8_t *Put_U16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    return p + 2;
+}
+
+static uint16_t Get_U16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void Put_Instrument(uint8_t *p, const InstrumentProfile_t *inst) {
+    strncpy((char *)p, inst->name, SYNTH_NAME_SIZE); // NUL-padded
+    p += SYNTH_NAME_SIZE;
+    p = Put_U16(p, inst->adsr.attack_samples);
+    p = Put_U16(p, inst->adsr.decay_samples);
+    p = Put_U16(p, inst->adsr.sustain_level);
+    p = Put_U16(p, inst->adsr.release_samples);
+    *p++ = inst->waveform;
+    *p++ = inst->num_harmonics;
+    *p++ = inst->vibrato_depth;
+    *p++ = inst->tremolo_depth;
+    *p = inst->drive;
+}
+
+static bool Get_Instrument(InstrumentProfile_t *inst, const uint8_t *p) {
+    InstrumentProfile_t in;
+
+    memcpy(in.name, p, SYNTH_NAME_SIZE);
+    in.name[SYNTH_NAME_SIZE - 1] = '\0';
+    p += SYNTH_NAME_SIZE;
+    in.adsr.attack_samples = Get_U16(p);
+    in.adsr.decay_samples = Get_U16(p + 2);
+    in.adsr.sustain_level = Get_U16(p + 4);
+    in.adsr.release_samples = Get_U16(p + 6);
+    p += 8;
+    if (in.adsr.sustain_level > 1000 || p[0] >= WAVE_COUNT || p[1] > 3)
+        return false;
+    in.waveform = p[0];
+    in.num_harmonics = p[1];
+    in.vibrato_depth = p[2];
+    in.tremolo_depth = p[3];
+    in.drive = p[4];
+    *inst = in;
+    return true;
+}
+
+static void Put_Preset(uint8_t *p, const Preset_t *preset) {
+    strncpy((char *)p, preset->name, SYNTH_NAME_SIZE);
+    p += SYNTH_NAME_SIZE;
+    *p++ = preset->instrument;
+    *p++ = preset->effects_enabled ? 1 : 0;
+    *p++ = preset->chord_mode;
+    *p++ = preset->arp_mode;
+    for (uint8_t i = 0; i < FX_CHAIN_MAX_SLOTS; i++)
+        *p++ = preset->effects[i];
+}
+
+static bool Get_Preset(Preset_t *preset, const uint8_t *p) {
+    Preset_t in;
+
+    memcpy(in.name, p, SYNTH_NAME_SIZE);
+    in.name[SYNTH_NAME_SIZE - 1] = '\0';
+    p += SYNTH_NAME_SIZE;
+    if (p[0] >= INSTRUMENT_COUNT || p[1] > 1 || p[2] >= CHORD_MODE_COUNT ||
+        p[3] >= ARP_MODE_COUNT)
+        return false;
+    in.instrument = p[0];
+    in.effects_enabled = p[1];
+    in.chord_mode = p[2];
+    in.arp_mode = p[3];
+    p += 4;
+    for (uint8_t i = 0; i < FX_CHAIN_MAX_SLOTS; i++) {
+        if (p[i] >= EFFECT_COUNT) return false;
+        in.effects[i] = p[i];
+    }
+    *preset = in;
+    return true;
+}
+
+static bool Named(const char *name) {
+    return memchr(name, '\0', SYNTH_NAME_SIZE) != NULL;
+}
+
+// The ranges Get_Instrument and Get_Preset apply to a record, on the
+// structs of an image
+static bool Check_Bank(const SynthBank_t *bank) {
+    for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+        const InstrumentProfile_t *in = &bank->instruments[i];
+        if (!Named(in->name) || in->adsr.sustain_level > 1000 ||
+            in->waveform >= WAVE_COUNT || in->num_harmonics > 3)
+            return false;
+    }
+    for (uint8_t i = 0; i < SYNTH_PRESET_COUNT; i++) {
+        const Preset_t *in = &bank->presets[i];
+        if (!Named(in->name) || in->instrument >= INSTRUMENT_COUNT ||
+            in->effects_enabled > 1 || in->chord_mode >= CHORD_MODE_COUNT ||
+            in->arp_mode >= ARP_MODE_COUNT)
+            return false;
+        for (uint8_t k = 0; k < FX_CHAIN_MAX_SLOTS; k++) {
+            if (in->effects[k] >= EFFECT_COUNT) return false;
+        }
+    }
+    return true;
+}
+
+// Header and CRC of a flash image
+static BankStatus_t Check_Image(const uint8_t *image, uint16_t length) {
+    if (length < BANK_HEADER_BYTES || memcmp(image, BANK_MAGIC, 4) != 0)
+        return BANK_ERR_CRC; // Erased or never written
+    if (image[4] != BANK_VERSION || image[5] != INSTRUMENT_COUNT ||
+        image[6] != SYNTH_PRESET_COUNT || image[7] != FX_CHAIN_MAX_SLOTS ||
+        Get_U16(image + 8) != sizeof(InstrumentProfile_t) ||
+        Get_U16(image + 10) != sizeof(Preset_t) ||
+        Get_U16(image + 12) != sizeof(SynthBank_t))
+        return BANK_ERR_VERSION;
+    if (length < BANK_HEADER_BYTES + sizeof(SynthBank_t) ||
+        Get_U16(image + 14) !=
+            Crc16(image + BANK_HEADER_BYTES, sizeof(SynthBank_t)))
+        return BANK_ERR_CRC;
+    return BANK_OK;
+}
+
+// F0 7D id ... : the three header bytes
+static uint8_t *Frame_Start(uint8_t *frame, uint8_t id) {
+    frame[0] = MIDI_SYSEX_START;
+    frame[1] = MIDI_SYSEX_ID_NONCOMMERCIAL;
+    frame[2] = id;
+    return frame + 3;
+}
+
+static uint16_t Record_Frame(uint8_t id, uint8_t index, const uint8_t *record,
+                             uint16_t bytes, uint8_t *frame) {
+    uint8_t *p = Frame_Start(frame, id);
+    uint8_t *body = p;
+
+    *p++ = index;
+    p = MIDI_Pack8(p, record, bytes);
+    uint8_t sum = 0;
+    for (uint8_t *q = body; q < p; q++) sum += *q;
+    *p++ = (uint8_t)(-sum & 0x7F);
+    *p++ = MIDI_SYSEX_END;
+    return (uint16_t)(p - frame);
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+uint16_t SynthBank_Encode(const SynthBank_t *bank, uint8_t *image) {
+    SynthBank_t body;
+
+    // Field by field into zeroed records: the padding bytes are defined,
+    // so the same bank always gives the same image
+    memset(&body, 0, sizeof(body));
+    for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+        const InstrumentProfile_t *in = &bank->instruments[i];
+        InstrumentProfile_t *out = &body.instruments[i];
+        strncpy(out->name, in->name, SYNTH_NAME_SIZE - 1); // NUL-padded
+        out->adsr = in->adsr;
+        out->waveform = in->waveform;
+        out->num_harmonics = in->num_harmonics;
+        out->vibrato_depth = in->vibrato_depth;
+        out->tremolo_depth = in->tremolo_depth;
+        out->drive = in->drive;
+    }
+    for (uint8_t i = 0; i < SYNTH_PRESET_COUNT; i++) {
+        const Preset_t *in = &bank->presets[i];
+        Preset_t *out = &body.presets[i];
+        strncpy(out->name, in->name, SYNTH_NAME_SIZE - 1);
+        out->instrument = in->instrument;
+        out->effects_enabled = in->effects_enabled ? 1 : 0;
+        out->chord_mode = in->chord_mode;
+        out->arp_mode = in->arp_mode;
+        memcpy(out->effects, in->effects, sizeof(out->effects));
+    }
+
+    memcpy(image + BANK_HEADER_BYTES, &body, sizeof(body));
+    memset(image + BANK_HEADER_BYTES + sizeof(body), 0xFF, // Erased flash
+           BANK_IMAGE_BYTES - BANK_HEADER_BYTES - sizeof(body));
+
+    memcpy(image, BANK_MAGIC, 4);
+    image[4] = BANK_VERSION;
+    image[5] = INSTRUMENT_COUNT;
+    image[6] = SYNTH_PRESET_COUNT;
+    image[7] = FX_CHAIN_MAX_SLOTS;
+    Put_U16(image + 8, sizeof(InstrumentProfile_t));
+    Put_U16(image + 10, sizeof(Preset_t));
+    Put_U16(image + 12, sizeof(SynthBank_t));
+    Put_U16(image + 14, Crc16(image + BANK_HEADER_BYTES, sizeof(SynthBank_t)));
+    return BANK_IMAGE_BYTES;
+}
+
+BankStatus_t SynthBank_Decode(SynthBank_t *bank, const uint8_t *image,
+                              uint16_t length) {
+    SynthBank_t in;
+    BankStatus_t status = Check_Image(image, length);
+
+    if (status != BANK_OK) return status;
+    memcpy(&in, image + BANK_HEADER_BYTES, sizeof(in));
+    if (!Check_Bank(&in)) return BANK_ERR_VALUE;
+    *bank = in;
+    return BANK_OK;
+}
+
+BankStatus_t SynthBank_Map(const SynthBank_t **bank, const uint8_t *image,
+                           uint16_t length) {
+    if ((uintptr_t)image % 4 != 0) return BANK_ERR_ALIGN;
+    BankStatus_t status = Check_Image(image, length);
+    if (status != BANK_OK) return status;
+
+    const SynthBank_t *in = (const SynthBank_t *)(image + BANK_HEADER_BYTES);
+    if (!Check_Bank(in)) return BANK_ERR_VALUE;
+    *bank = in;
+    return BANK_OK;
+}
+
+BankFrame_t SynthBank_ParseFrame(SynthBank_t *bank, const uint8_t *frame,
+                                 uint16_t length) {
+    BankFrame_t f = {0, 0, BANK_ERR_FRAME};
+
+    if (length < 4 || frame[0] != MIDI_SYSEX_START ||
+        frame[1] != MIDI_SYSEX_ID_NONCOMMERCIAL ||
+        frame[length - 1] != MIDI_SYSEX_END)
+        return f;
+
+    const uint8_t *body = frame + 3;
+    uint16_t n = (uint16_t)(length - 4); // Between id and F7
+    switch (frame[2]) {
+    case BANK_SYSEX_REQUEST:
+        f.id = frame[2];
+        if (n == 0) f.status = BANK_OK;
+        return f;
+    case BANK_SYSEX_COMMAND:
+        f.id = frame[2];
+        if (n == 1 && body[0] <= BANK_OP_FACTORY) {
+            f.arg = body[0];
+            f.status = BANK_OK;
+        }
+        return f;
+    case BANK_SYSEX_REPLY:
+        f.id = frame[2];
+        if (n == 2) {
+            f.arg = body[0];
+            f.status = (BankStatus_t)body[1];
+        }
+        return f;
+    case BANK_SYSEX_INSTRUMENT:
+    case BANK_SYSEX_PRESET:
+        break;
+    default:
+        return f; // Not a bank frame (id 0)
+    }
+
+    bool instrument = frame[2] == BANK_SYSEX_INSTRUMENT;
+    uint16_t bytes = instrument ? BANK_INSTRUMENT_BYTES : BANK_PRESET_BYTES;
+    uint8_t count = instrument ? INSTRUMENT_COUNT : SYNTH_PRESET_COUNT;
+    uint8_t record[BANK_INSTRUMENT_BYTES];
+    uint8_t sum = 0;
+
+    f.id = frame[2];
+    f.arg = body[0];
+    if (n != 2 + MIDI_PACKED_SIZE(bytes) || body[0] >= count) return f;
+    for (uint16_t i = 0; i < n; i++) sum += body[i];
+    if ((sum & 0x7F) != 0) return f;
+    MIDI_Unpack8(record, body + 1, MIDI_PACKED_SIZE(bytes));
+
+    bool ok = instrument ? Get_Instrument(&bank->instruments[body[0]], record)
+                         : Get_Preset(&bank->presets[body[0]], record);
+    f.status = ok ? BANK_OK : BANK_ERR_VALUE;
+    return f;
+}
+
+uint16_t SynthBank_DumpFrame(const SynthBank_t *bank, uint8_t *cursor,
+                             uint8_t *frame) {
+    uint8_t record[BANK_INSTRUMENT_BYTES];
+    uint8_t i = *cursor;
+
+    if (i < INSTRUMENT_COUNT) {
+        Put_Instrument(record, &bank->instruments[i]);
+        (*cursor)++;
+        return Record_Frame(BANK_SYSEX_INSTRUMENT, i, record,
+                            BANK_INSTRUMENT_BYTES, frame);
+    }
+    i -= INSTRUMENT_COUNT;
+    if (i < SYNTH_PRESET_COUNT) {
+        Put_Preset(record, &bank->presets[i]);
+        (*cursor)++;
+        return Record_Frame(BANK_SYSEX_PRESET, i, record, BANK_PRESET_BYTES,
+                            frame);
+    }
+    return 0;
+}
+
+uint16_t SynthBank_RequestFrame(uint8_t *frame) {
+    uint8_t *p = Frame_Start(frame, BANK_SYSEX_REQUEST);
+    *p++ = MIDI_SYSEX_END;
+    return (uint16_t)(p - frame);
+}
+
+uint16_t SynthBank_CommandFrame(uint8_t op, uint8_t *frame) {
+    uint8_t *p = Frame_Start(frame, BANK_SYSEX_COMMAND);
+    *p++ = op & 0x7F;
+    *p++ = MIDI_SYSEX_END;
+    return (uint16_t)(p - frame);
+}
+
+uint16_t SynthBank_ReplyFrame(uint8_t id, BankStatus_t status, uint8_t *frame) {
+    uint8_t *p = Frame_Start(frame, BANK_SYSEX_REPLY);
+    *p++ = id & 0x7F;
+    *p++ = (uint8_t)status & 0x7F;
+    *p++ = MIDI_SYSEX_END;
+    return (uint16_t)(p - frame);
+}
@@ -0,0 +1,157 @@
+/**
+ * @file synth_bank.h
+ * @brief Sound Bank Encoding: Flash Image and SysEx Bulk Dump/Load
+ * @version 1.0.0
+ *
+ * Turns a SynthBank_t (every instrument and preset) into bytes and back,
+ * with every value range-checked on the way in. No hardware and no engine
+ * state: the firmware keeps the bank in flash and exchanges it over MIDI,
+ * the host tool (tools/host/bank_tool) edits it as text and compiles the
+ * text into a flash image.
+ *
+ * Records (little-endian, names NUL-padded):
+ *   instrument  name[12] attack decay sustain release (u16, samples and
+ *               0-1000) waveform harmonics vibrato tremolo drive (u8)
+ *   preset      name[12] instrument effects_enabled chord_mode arp_mode
+ *               effects[FX_CHAIN_MAX_SLOTS] (u8)
+ *
+ * Flash image (16-byte header, then the bank):
+ *   "SBNK", version, instrument count, preset count, FX slots (u8),
+ *   sizeof InstrumentProfile_t, sizeof Preset_t, body bytes, CRC-16/CCITT
+ *   of the body (u16), then the SynthBank_t as the firmware lays it out
+ *   (little-endian, zero padding), padded with 0xFF to a multiple of 8
+ *   bytes (one flash word).
+ * The body needs no parsing: SynthBank_Map checks the header, the CRC and
+ * the value ranges once and hands back a pointer into the image, which
+ * Synth_MapBank plays in place. The sizes in the header turn an image
+ * from a build with another layout into BANK_ERR_VERSION.
+ *
+ * SysEx (non-commercial ID 0x7D; 0x01-0x08 are the telemetry reports):
+ *   F0 7D 10 F7                         Dump request: the device answers
+ *                                       with every record, then a reply
+ *   F0 7D 11 <index> <record> <sum> F7  Instrument record
+ *   F0 7D 12 <index> <record> <sum> F7  Preset record
+ *   F0 7D 13 <op> F7                    0 = store the bank in flash,
+ *                                       1 = back to the built-in bank
+ *   F0 7D 14 <id> <status> F7           Reply to frame <id> (BankStatus_t)
+ * <record> is the record packed 8-to-7 (MIDI_Pack8); <sum> makes the
+ * 7-bit sum of index, record and sum zero. A record frame replaces one
+ * entry of the bank in use at once; only 13/0 makes it survive a reset.
+ *
+ * Usage:
+ *   SynthBank_t bank;
+ *   Synth_GetBank(&bank);
+ *   BankFrame_t f = SynthBank_ParseFrame(&bank, frame, length);
+ *   if (f.id == BANK_SYSEX_INSTRUMENT && f.status == BANK_OK)
+ *       Synth_SetBank(&bank);
+ *
+ *   uint8_t image[BANK_IMAGE_BYTES];
+ *   SynthBank_Encode(&bank, image);               // To flash
+ *   if (SynthBank_Decode(&bank, flash, BANK_IMAGE_BYTES) == BANK_OK) ...
+ *
+ *   const SynthBank_t *blob;                      // Compiled, in flash
+ *   if (SynthBank_Map(&blob, flash, BANK_IMAGE_BYTES) == BANK_OK)
+ *       Synth_MapBank(blob);
+ */
+
+#ifndef SYNTH_BANK_H_
+#define SYNTH_BANK_H_
+
+#include <stdint.h>
+#include "synth.h"
+#include "../midi/midi_msg.h"
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define BANK_VERSION 2
+
+// SysEx records
+#define BANK_INSTRUMENT_BYTES (SYNTH_NAME_SIZE + 13)
+#define BANK_PRESET_BYTES     (SYNTH_NAME_SIZE + 4 + FX_CHAIN_MAX_SLOTS)
+// Flash image
+#define BANK_HEADER_BYTES     16
+#define BANK_IMAGE_BYTES      ((BANK_HEADER_BYTES + sizeof(SynthBank_t) + 7) & ~7)
+
+// Longest frame: F0 7D id index <instrument> sum F7
+#define BANK_FRAME_MAX        (6 + MIDI_PACKED_SIZE(BANK_INSTRUMENT_BYTES))
+
+#define BANK_SYSEX_REQUEST    0x10
+#define BANK_SYSEX_INSTRUMENT 0x11
+#define BANK_SYSEX_PRESET     0x12
+#define BANK_SYSEX_COMMAND    0x13
+#define BANK_SYSEX_REPLY      0x14
+
+#define BANK_OP_STORE   0
+#define BANK_OP_FACTORY 1
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef enum {
+    BANK_OK = 0,
+    BANK_ERR_FRAME,        ///< Wrong length, index or checksum
+    BANK_ERR_VALUE,        ///< A value out of range
+    BANK_ERR_VERSION,      ///< Image from another format or build
+    BANK_ERR_CRC,          ///< Image damaged (or erased flash)
+    BANK_ERR_FLASH,        ///< Erase or program failed
+    BANK_ERR_ALIGN         ///< Image not 4-byte aligned (cannot be mapped)
+} BankStatus_t;
+
+/**
+ * @brief What a received frame was
+ */
+typedef struct {
+    uint8_t id;            ///< BANK_SYSEX_*, or 0 if not a bank frame
+    uint8_t arg;           ///< Record index, op, or the id a reply answers
+    BankStatus_t status;   ///< Frame check, or the status a reply carries
+} BankFrame_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Flash image of a bank
+ * @param image BANK_IMAGE_BYTES
+ * @return BANK_IMAGE_BYTES
+ */
+uint16_t SynthBank_Encode(const SynthBank_t *bank, uint8_t *image);
+
+/**
+ * @brief Read a flash image (bank is untouched unless BANK_OK)
+ */
+BankStatus_t SynthBank_Decode(SynthBank_t *bank, const uint8_t *image,
+                              uint16_t length);
+
+/**
+ * @brief Use a flash image in place (zero-copy)
+ * @param bank Set to the bank inside image if BANK_OK, else untouched
+ * @param image 4-byte aligned; must outlive the bank's use
+ */
+BankStatus_t SynthBank_Map(const SynthBank_t **bank, const uint8_t *image,
+                           uint16_t length);
+
+/**
+ * @brief Check one received SysEx frame (F0 ... F7)
+ *
+ * A valid record frame is written into its entry of bank; anything else
+ * leaves bank alone.
+ */
+BankFrame_t SynthBank_ParseFrame(SynthBank_t *bank, const uint8_t *frame,
+                                 uint16_t length);
+
+/**
+ * @brief Next frame of a bulk dump (instruments, then presets)
+ * @param cursor 0 to start; advanced by each call
+ * @param frame BANK_FRAME_MAX bytes
+ * @return Frame length, 0 after the last record
+ */
+uint16_t SynthBank_DumpFrame(const SynthBank_t *bank, uint8_t *cursor,
+                             uint8_t *frame);
+
+uint16_t SynthBank_RequestFrame(uint8_t *frame);
+uint16_t SynthBank_CommandFrame(uint8_t op, uint8_t *frame);
+uint16_t SynthBank_ReplyFrame(uint8_t id, BankStatus_t status, uint8_t *frame);
+
+#endif /* SYNTH_BANK_H_ */
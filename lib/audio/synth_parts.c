@@ -0,0 +1,426 @@
+/**
+ * @file synth_parts.c
+ * @brief Multi-Timbral Parts Implementation
+ */
+
+#include "synth_parts.h"
+#include <stddef.h>
+#include <string.h>
+
+//=============================================================================
+// PRIVATE DATA
+//=============================================================================
+
+// Phase increments of the top octave (notes 108-119) at 16 kHz; lower
+// octaves shift right
+static const uint32_t TOP_OCTAVE[12] = {
+    1123673247, 1190490335, 1261280574, 1336280220, 1415739577, 1499923833,
+    1589113945, 1683607578, 1783720094, 1889785610, 2002158110, 2121212627
+};
+
+#define INCREMENT_MAX 0x7FFFFFFFu  // Nyquist
+
+// Part p takes PART_DEFAULTS[p % 4]: the bass keeps its voices, the pad
+// (long releases) gives them up first
+static const struct {
+    Instrument_t instrument;
+    uint8_t voice_limit;
+    uint8_t priority;
+} PART_DEFAULTS[4] = {
+    {INSTRUMENT_BASS,    2, 2},
+    {INSTRUMENT_STRINGS, 4, 0},
+    {INSTRUMENT_LEAD,    2, 1},
+    {INSTRUMENT_PIANO,   4, 1},
+};
+
+#define PART_LOAD_BUDGET (SYNTH_BLOCK_SIZE * 5000u) // One block at 80 MHz
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+static uint32_t Note_Increment(uint8_t note, uint32_t bend) {
+    uint8_t octave = note / 12;
+    uint32_t inc = TOP_OCTAVE[note % 12];
+
+    if (octave < 9)
+        inc >>= 9 - octave;
+    else if (octave > 9)
+        inc = INCREMENT_MAX; // 120-127 are above 8 kHz anyway
+
+    uint64_t bent = ((uint64_t)inc * bend) >> 16;
+    return bent > INCREMENT_MAX ? INCREMENT_MAX : (uint32_t)bent;
+}
+
+static void Update_Channel(Parts_t *parts, uint8_t p) {
+    const SynthPart_t *part = &parts->part[p];
+    // 258 maps 0-127 to Q15
+    Mixer_SetChannel(&parts->mixer, p, (uint16_t)(part->volume * 258u),
+                     part->pan, 0);
+}
+
+static void Free_Voice(Parts_t *parts, PartVoice_t *v) {
+    parts->part[v->part].voices--;
+    v->part = PART_NONE;
+}
+
+static bool Released(const PartVoice_t *v) {
+    return v->env.state == ENV_RELEASE || v->env.state == ENV_IDLE;
+}
+
+// true if a is the better voice to take than b
+static bool Better_Victim(const Parts_t *parts, const PartVoice_t *a,
+                          const PartVoice_t *b) {
+    if (Released(a) != Released(b))
+        return Released(a);
+    uint8_t pa = parts->part[a->part].priority;
+    uint8_t pb = parts->part[b->part].priority;
+    if (pa != pb)
+        return pa < pb;
+    return (int32_t)(a->age - b->age) < 0;
+}
+
+static PartVoice_t *Pick_Voice(Parts_t *parts, uint8_t p, uint8_t note) {
+    SynthPart_t *part = &parts->part[p];
+    PartVoice_t *best = NULL;
+
+    // Same note: retrigger it
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        PartVoice_t *v = &parts->voice[i];
+        if (v->part == p && v->note == note)
+            return v;
+    }
+
+    // At the limit: one of its own
+    if (part->voices >= part->voice_limit) {
+        for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+            PartVoice_t *v = &parts->voice[i];
+            if (v->part == p && (best == NULL || Better_Victim(parts, v, best)))
+                best = v;
+        }
+        return best;
+    }
+
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        if (parts->voice[i].part == PART_NONE)
+            return &parts->voice[i];
+    }
+
+    // Pool full: steal from a part that does not outrank this one
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        PartVoice_t *v = &parts->voice[i];
+        if (parts->part[v->part].priority > part->priority)
+            continue;
+        if (best == NULL || Better_Victim(parts, v, best))
+            best = v;
+    }
+    if (best != NULL && best->part != p)
+        parts->part[best->part].stolen++;
+    return best;
+}
+
+static void Release_Voice(const SynthPart_t *part, PartVoice_t *v) {
+    if (part->sustain) {
+        v->sustained = true;
+    } else {
+        v->sustained = false;
+        Envelope_NoteOff(&v->env);
+    }
+}
+
+static void Release_Sustained(Parts_t *parts, uint8_t p) {
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        PartVoice_t *v = &parts->voice[i];
+        if (v->part == p && v->sustained) {
+            v->sustained = false;
+            Envelope_NoteOff(&v->env);
+        }
+    }
+}
+
+// Voice block onto the part's sum: envelope at block rate, gain ramped
+static void Render_Voice(const SynthPart_t *part, PartVoice_t *v,
+                         int32_t *sum, uint16_t n) {
+    const InstrumentProfile_t *inst = part->instrument;
+
+    Envelope_Advance(&v->env, n);
+    // 0-1000 x velocity 0-127 to Q15 (1000 * 127 * 264 >> 10 = 32742)
+    int32_t target = ((int32_t)v->env.amplitude * v->velocity * 264) >> 10;
+    int32_t gain = v->gain;
+    int32_t step = (target - gain) / (int32_t)n;
+    uint32_t phase = v->phase;
+    uint32_t inc = v->increment;
+    Waveform_t wave = inst->waveform;
+    bool harmonic = inst->num_harmonics > 0;
+
+    for (uint16_t i = 0; i < n; i++) {
+        uint8_t index = (uint8_t)(phase >> 24);
+        int32_t s = Audio_GenerateWaveform(index, wave);
+        if (harmonic) {
+            // (2 x fundamental + octave) / 3
+            int32_t h = Audio_GenerateWaveform((uint8_t)(index << 1), wave);
+            s = ((s * 2 + h) * 21845) >> 16;
+        }
+        gain += step;
+        sum[i] += (s * gain) >> 15;
+        phase += inc;
+    }
+    v->phase = phase;
+    v->gain = target;
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+void Parts_Init(Parts_t *parts, uint32_t (*cycles)(void)) {
+    uint32_t now = cycles ? cycles() : 0;
+
+    parts->cycles = cycles;
+    parts->stamp = 0;
+    Mixer_Init(&parts->mixer, MIXER_MONO);
+    Mixer_SetHeadroom(&parts->mixer, 4); // Several voices per part
+
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++) {
+        SynthPart_t *part = &parts->part[p];
+        Instrument_t id = PART_DEFAULTS[p % 4].instrument;
+
+        part->instrument_id = id;
+        part->instrument = &INSTRUMENTS[id];
+        part->channel = (p + 1 < 16) ? (uint8_t)(p + 1) : PART_CHANNEL_OFF;
+        part->volume = 100;
+        part->pan = 0;
+        part->voice_limit = PART_DEFAULTS[p % 4].voice_limit;
+        if (part->voice_limit > SYNTH_POOL_VOICES)
+            part->voice_limit = SYNTH_POOL_VOICES;
+        part->priority = PART_DEFAULTS[p % 4].priority;
+        part->voices = 0;
+        part->sustain = false;
+        part->bend = 65536;
+        part->stolen = 0;
+        part->dropped = 0;
+        IsrLoad_Init(&part->load, PART_LOAD_BUDGET, now);
+        Update_Channel(parts, p);
+    }
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        memset(&parts->voice[i], 0, sizeof(PartVoice_t));
+        parts->voice[i].part = PART_NONE;
+    }
+}
+
+int8_t Parts_Find(const Parts_t *parts, uint8_t channel) {
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++) {
+        if (parts->part[p].channel == channel)
+            return (int8_t)p;
+    }
+    return -1;
+}
+
+void Parts_Set(Parts_t *parts, uint8_t p, SynthPartParam_t param,
+               int16_t value) {
+    if (p >= SYNTH_PART_COUNT) return;
+    SynthPart_t *part = &parts->part[p];
+
+    switch (param) {
+    case SYNTH_PART_CHANNEL:
+        part->channel = (value < 0 || value > 15) ? PART_CHANNEL_OFF
+                                                  : (uint8_t)value;
+        break;
+    case SYNTH_PART_INSTRUMENT:
+        if (value < 0 || value >= INSTRUMENT_COUNT) return;
+        // Sounding voices keep their envelope and take the new waveform
+        part->instrument_id = (Instrument_t)value;
+        part->instrument = &INSTRUMENTS[value];
+        break;
+    case SYNTH_PART_VOLUME:
+        part->volume = (value < 0) ? 0 : (value > 127) ? 127 : (uint8_t)value;
+        Update_Channel(parts, p);
+        break;
+    case SYNTH_PART_PAN:
+        part->pan = (value < -64) ? -64 : (value > 63) ? 63 : (int8_t)value;
+        Update_Channel(parts, p);
+        break;
+    case SYNTH_PART_VOICES:
+        // Applies from the next Note On
+        part->voice_limit = (value < 1) ? 1
+                          : (value > SYNTH_POOL_VOICES) ? SYNTH_POOL_VOICES
+                          : (uint8_t)value;
+        break;
+    case SYNTH_PART_PRIORITY:
+        part->priority = (value < 0) ? 0
+                       : (value > PART_PRIORITY_MAX) ? PART_PRIORITY_MAX
+                       : (uint8_t)value;
+        break;
+    }
+}
+
+void Parts_NoteOn(Parts_t *parts, uint8_t p, uint8_t note, uint8_t velocity) {
+    if (p >= SYNTH_PART_COUNT) return;
+    SynthPart_t *part = &parts->part[p];
+
+    PartVoice_t *v = Pick_Voice(parts, p, note);
+    if (v == NULL) {
+        part->dropped++;
+        return;
+    }
+    if (v->part != p) {
+        if (v->part != PART_NONE) Free_Voice(parts, v);
+        v->part = p;
+        part->voices++;
+    }
+
+    // Phase and gain carry over: the new note ramps from the old level
+    v->note = note;
+    v->velocity = velocity;
+    v->sustained = false;
+    v->increment = Note_Increment(note, part->bend);
+    v->age = ++parts->stamp;
+    Envelope_Init(&v->env, &part->instrument->adsr);
+    Envelope_NoteOn(&v->env);
+}
+
+void Parts_NoteOff(Parts_t *parts, uint8_t p, uint8_t note) {
+    if (p >= SYNTH_PART_COUNT) return;
+
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        PartVoice_t *v = &parts->voice[i];
+        if (v->part == p && v->note == note && v->env.note_on)
+            Release_Voice(&parts->part[p], v);
+    }
+}
+
+void Parts_Control(Parts_t *parts, uint8_t p, uint8_t controller,
+                   uint8_t value) {
+    if (p >= SYNTH_PART_COUNT) return;
+    SynthPart_t *part = &parts->part[p];
+
+    switch (controller) {
+    case 7:   // Volume
+        Parts_Set(parts, p, SYNTH_PART_VOLUME, value);
+        break;
+    case 10:  // Pan
+        Parts_Set(parts, p, SYNTH_PART_PAN, (int16_t)value - 64);
+        break;
+    case 64:  // Sustain
+        part->sustain = value >= 64;
+        if (!part->sustain)
+            Release_Sustained(parts, p);
+        break;
+    case 120: // All sound off: fade out over the next block
+        for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+            if (parts->voice[i].part == p)
+                Envelope_Reset(&parts->voice[i].env);
+        }
+        break;
+    case 121: // Reset controllers
+        part->sustain = false;
+        Release_Sustained(parts, p);
+        Parts_Bend(parts, p, 65536);
+        break;
+    case 123: // All notes off
+        part->sustain = false;
+        for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+            PartVoice_t *v = &parts->voice[i];
+            if (v->part == p) {
+                v->sustained = false;
+                Envelope_NoteOff(&v->env);
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+void Parts_Bend(Parts_t *parts, uint8_t p, uint32_t ratio) {
+    if (p >= SYNTH_PART_COUNT) return;
+    parts->part[p].bend = ratio;
+
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        PartVoice_t *v = &parts->voice[i];
+        if (v->part == p)
+            v->increment = Note_Increment(v->note, ratio);
+    }
+}
+
+void Parts_Rebind(Parts_t *parts, const InstrumentProfile_t *from) {
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++)
+        parts->part[p].instrument = &INSTRUMENTS[parts->part[p].instrument_id];
+    for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+        Envelope_t *env = &parts->voice[i].env;
+        for (uint8_t k = 0; k < INSTRUMENT_COUNT; k++) {
+            if (env->profile == &from[k].adsr)
+                env->profile = &INSTRUMENTS[k].adsr;
+        }
+    }
+}
+
+void Parts_AllSoundOff(Parts_t *parts) {
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++) {
+        parts->part[p].sustain = false;
+        Parts_Control(parts, p, 120, 0);
+    }
+}
+
+void Parts_Render(Parts_t *parts, int32_t *bus, uint16_t n, uint16_t master) {
+    int32_t sum[MIXER_BLOCK_MAX];
+    int16_t out[MIXER_BLOCK_MAX];
+    bool sounding = false;
+
+    if (n > MIXER_BLOCK_MAX) n = MIXER_BLOCK_MAX;
+    Mixer_SetMaster(&parts->mixer, master);
+    Mixer_BeginBlock(&parts->mixer, n);
+
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++) {
+        SynthPart_t *part = &parts->part[p];
+        if (part->voices == 0) continue;
+
+        if (parts->cycles) IsrLoad_Enter(&part->load, parts->cycles());
+        memset(sum, 0, n * sizeof(int32_t));
+        for (uint8_t i = 0; i < SYNTH_POOL_VOICES; i++) {
+            PartVoice_t *v = &parts->voice[i];
+            if (v->part != p) continue;
+            Render_Voice(part, v, sum, n);
+            if (v->env.state == ENV_IDLE && v->gain == 0)
+                Free_Voice(parts, v);
+        }
+        for (uint16_t i = 0; i < n; i++) {
+            int32_t x = sum[i];
+            if (x > 32767) x = 32767;
+            if (x < -32768) x = -32768;
+            out[i] = (int16_t)x;
+        }
+        Mixer_AddVoice(&parts->mixer, p, out, n);
+        if (parts->cycles) IsrLoad_Exit(&part->load, parts->cycles());
+        sounding = true;
+    }
+
+    // Nothing sounding: the bus is left untouched
+    if (!sounding) return;
+    Mixer_Render(&parts->mixer, NULL, sum, NULL, n);
+    for (uint16_t i = 0; i < n; i++)
+        bus[i] += sum[i];
+}
+
+void Parts_UpdateLoad(Parts_t *parts, uint32_t now) {
+    for (uint8_t p = 0; p < SYNTH_PART_COUNT; p++)
+        IsrLoad_Update(&parts->part[p].load, now);
+}
+
+void Parts_GetStatus(const Parts_t *parts, uint8_t p,
+                     SynthPartStatus_t *status) {
+    if (p >= SYNTH_PART_COUNT) return;
+    const SynthPart_t *part = &parts->part[p];
+
+    status->channel = part->channel == PART_CHANNEL_OFF ? -1
+                                                        : (int8_t)part->channel;
+    status->instrument = part->instrument_id;
+    status->volume = part->volume;
+    status->pan = part->pan;
+    status->voice_limit = part->voice_limit;
+    status->priority = part->priority;
+    status->voices = part->voices;
+    status->stolen = part->stolen;
+    status->dropped = part->dropped;
+    status->cycles_avg = part->load.avg_cycles;
+    status->cycles_max = part->load.max_cycles;
+    status->load_pct10 = part->load.load_pct10;
+}
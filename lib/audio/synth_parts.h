@@ -0,0 +1,170 @@
+/**
+ * @file synth_parts.h
+ * @brief Multi-Timbral Parts on a Shared Voice Pool
+ * @version 1.0.0
+ *
+ * SYNTH_PART_COUNT parts, each on its own MIDI channel with its own
+ * instrument, volume, pan, voice limit and priority. The parts play from
+ * one pool of SYNTH_POOL_VOICES voices. A Note On takes, in this order:
+ *   1. the part's own voice already on that note (retriggered),
+ *   2. at the part's voice limit: one of its own voices, released first,
+ *      then the oldest,
+ *   3. a free voice,
+ *   4. a voice of a part with the same or a lower priority: released
+ *      first, then the lowest priority, then the oldest.
+ * When every voice is held by a higher-priority part the note is dropped
+ * (and counted).
+ *
+ * A voice plays the instrument's waveform and harmonic through its own
+ * envelope, advanced once per block with the gain ramped across the
+ * block. A stolen voice ramps from its old level, so a steal does not
+ * click. Vibrato and the insert chain stay with the front-panel sound.
+ * Each part is a mixer channel (volume, and pan on a stereo layout); the
+ * part bus is added to the engine bus ahead of the master limiter.
+ *
+ * The render time of each part is measured with the platform cycle
+ * counter into an IsrLoad_t (one activation per block) for telemetry.
+ *
+ * Audio context only: the engine calls these from Synth_MidiMessage and
+ * Synth_RenderBlock.
+ *
+ * Usage:
+ *   static Parts_t parts;
+ *   Parts_Init(&parts, Cycles_Now);
+ *   int8_t p = Parts_Find(&parts, channel);
+ *   if (p >= 0) Parts_NoteOn(&parts, (uint8_t)p, 60, 100);
+ *   Parts_Render(&parts, bus, 32, MIXER_UNITY);  // Adds to the bus
+ */
+
+#ifndef SYNTH_PARTS_H_
+#define SYNTH_PARTS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "synth.h"
+#include "audio_mixer.h"
+#include "../perf/isr_load.h"
+
+#if SYNTH_PART_COUNT > MIXER_MAX_CHANNELS
+#error "SYNTH_PART_COUNT needs MIXER_MAX_CHANNELS >= SYNTH_PART_COUNT"
+#endif
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define PART_CHANNEL_OFF 0xFF  // Part listens to no channel
+#define PART_NONE        0xFF  // Voice is free
+#define PART_PRIORITY_MAX 3
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    const InstrumentProfile_t *instrument;
+    Instrument_t instrument_id;
+    uint8_t channel;           ///< MIDI channel 0-15, or PART_CHANNEL_OFF
+    uint8_t volume;            ///< 0-127 (CC 7)
+    int8_t pan;                ///< -64 left, 0 centre, +63 right (CC 10)
+    uint8_t voice_limit;       ///< Most voices the part may hold
+    uint8_t priority;          ///< 0-PART_PRIORITY_MAX, higher is kept
+    uint8_t voices;            ///< Voices it holds now
+    bool sustain;              ///< CC 64 down
+    uint32_t bend;             ///< Pitch bend ratio, Q16
+    uint16_t stolen;           ///< Voices taken by other parts
+    uint16_t dropped;          ///< Notes not played (no voice)
+    IsrLoad_t load;            ///< Render cycles per block
+} SynthPart_t;
+
+typedef struct {
+    Envelope_t env;
+    uint32_t phase;
+    uint32_t increment;        ///< Bend included
+    uint32_t age;              ///< Note On stamp (smaller is older)
+    int32_t gain;              ///< Level at the end of the last block, Q15
+    uint8_t part;              ///< Owner, or PART_NONE
+    uint8_t note;
+    uint8_t velocity;
+    bool sustained;            ///< Released while the sustain pedal was down
+} PartVoice_t;
+
+typedef struct {
+    SynthPart_t part[SYNTH_PART_COUNT];
+    PartVoice_t voice[SYNTH_POOL_VOICES];
+    Mixer_t mixer;             ///< One channel per part
+    uint32_t (*cycles)(void);  ///< Cycle counter (NULL = no load figures)
+    uint32_t stamp;            ///< Last Note On stamp
+} Parts_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Default parts, all voices free
+ *
+ * Part p listens on channel p + 1 (channel 1 and any channel no part
+ * takes stay with the front-panel sound): bass, strings, lead and piano,
+ * repeating from the fifth part.
+ * @param cycles Cycle counter for the per-part load (may be NULL)
+ */
+void Parts_Init(Parts_t *parts, uint32_t (*cycles)(void));
+
+/**
+ * @brief Part listening on a MIDI channel
+ * @return Part index, or -1
+ */
+int8_t Parts_Find(const Parts_t *parts, uint8_t channel);
+
+/**
+ * @brief Change one part setting (out-of-range values are clamped)
+ */
+void Parts_Set(Parts_t *parts, uint8_t part, SynthPartParam_t param,
+               int16_t value);
+
+void Parts_NoteOn(Parts_t *parts, uint8_t part, uint8_t note,
+                  uint8_t velocity);
+void Parts_NoteOff(Parts_t *parts, uint8_t part, uint8_t note);
+
+/**
+ * @brief CC 7 volume, 10 pan, 64 sustain, 120/123 all off, 121 reset
+ */
+void Parts_Control(Parts_t *parts, uint8_t part, uint8_t controller,
+                   uint8_t value);
+
+/**
+ * @brief Pitch bend ratio for the part's voices
+ * @param ratio Q16 (65536 = none)
+ */
+void Parts_Bend(Parts_t *parts, uint8_t part, uint32_t ratio);
+
+/**
+ * @brief Move the parts and their voices to the bank now in INSTRUMENTS
+ * @param from The instruments they played from (the previous bank)
+ */
+void Parts_Rebind(Parts_t *parts, const InstrumentProfile_t *from);
+
+/**
+ * @brief Silence every part (voices fade over one block)
+ */
+void Parts_AllSoundOff(Parts_t *parts);
+
+/**
+ * @brief Render the sounding parts and add them to the bus
+ * @param bus Engine bus (16-bit scale, 32-bit)
+ * @param n Number of samples (<= MIXER_BLOCK_MAX)
+ * @param master Master gain, Q15 (the engine volume)
+ */
+void Parts_Render(Parts_t *parts, int32_t *bus, uint16_t n, uint16_t master);
+
+/**
+ * @brief Close the load window of every part (10 Hz, like IsrLoad_Update)
+ */
+void Parts_UpdateLoad(Parts_t *parts, uint32_t now);
+
+/**
+ * @brief Settings and counters of one part
+ */
+void Parts_GetStatus(const Parts_t *parts, uint8_t part,
+                     SynthPartStatus_t *status);
+
+#endif /* SYNTH_PARTS_H_ */
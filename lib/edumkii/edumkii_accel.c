@@ -24,6 +24,8 @@ void Accel_Init(Accelerometer_t *accel, uint16_t deadzone) {
     accel->y_changed = false;
     accel->z_changed = false;
     accel->deadzone = deadzone;
+    accel->offset_x = 0;
+    accel->offset_y = 0;
     accel->_last_x = ACCEL_X_NEUTRAL;
     accel->_last_y = ACCEL_Y_NEUTRAL;
     accel->_last_z = 0;
@@ -31,6 +33,9 @@ void Accel_Init(Accelerometer_t *accel, uint16_t deadzone) {
 }
 
 void Accel_Update(Accelerometer_t *accel, int16_t raw_x, int16_t raw_y, int16_t raw_z) {
+    raw_x += accel->offset_x;
+    raw_y += accel->offset_y;
+
     // Initialize on first run
     if (accel->_first_run) {
         accel->_last_x = raw_x;
@@ -77,6 +82,11 @@ void Accel_Update(Accelerometer_t *accel, int16_t raw_x, int16_t raw_y, int16_t
     }
 }
 
+void Accel_Calibrate(Accelerometer_t *accel, int16_t raw_x, int16_t raw_y) {
+    accel->offset_x = ACCEL_X_NEUTRAL - raw_x;
+    accel->offset_y = ACCEL_Y_NEUTRAL - raw_y;
+}
+
 int8_t Accel_GetTilt(Accelerometer_t *accel) {
     int16_t deviation = accel->y - ACCEL_Y_NEUTRAL;
     
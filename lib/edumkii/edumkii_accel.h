@@ -16,6 +16,9 @@
  *   Accel_Update(&accel, gSynthState.accel_x, gSynthState.accel_y, gSynthState.accel_z);
  *   
  *   int8_t tilt = Accel_GetTilt(&accel);  // -1, 0, +1
+ *
+ *   // Board held level: this position becomes neutral
+ *   Accel_Calibrate(&accel, gSynthState.accel_x, gSynthState.accel_y);
  */
 
 #ifndef EDUMKII_ACCEL_H_
@@ -39,6 +42,8 @@ typedef struct {
     bool y_changed;       ///< True if Y moved outside deadzone
     bool z_changed;       ///< True if Z moved outside deadzone
     uint16_t deadzone;    ///< Deadzone size
+    int16_t offset_x;     ///< Calibration, added to raw X
+    int16_t offset_y;     ///< Calibration, added to raw Y
     
     // Internal state (don't modify directly)
     int16_t _last_x;
@@ -67,6 +72,17 @@ void Accel_Init(Accelerometer_t *accel, uint16_t deadzone);
  */
 void Accel_Update(Accelerometer_t *accel, int16_t raw_x, int16_t raw_y, int16_t raw_z);
 
+/**
+ * @brief Take the current position as level
+ * @param accel Pointer to accelerometer structure
+ * @param raw_x Raw X ADC value with the board level
+ * @param raw_y Raw Y ADC value with the board level
+ *
+ * Sets offset_x/offset_y so these readings map to neutral (2048, 2849).
+ * The offsets may also be set directly (restored from flash).
+ */
+void Accel_Calibrate(Accelerometer_t *accel, int16_t raw_x, int16_t raw_y);
+
 /**
  * @brief Get tilt direction (for octave shift)
  * @param accel Pointer to accelerometer structure
@@ -0,0 +1,199 @@
+/**
+ * @file midi_clock.c
+ * @brief MIDI Clock Transport Implementation
+ */
+
+#include "midi_clock.h"
+#include <stddef.h>
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+static int32_t Period_For(const MidiClock_t *clock, uint16_t bpm) {
+    return (int32_t)(((uint64_t)clock->sample_rate * 60u * MIDI_CLOCK_ONE) /
+                     ((uint32_t)bpm * MIDI_CLOCK_PPQN));
+}
+
+// Start or Continue: the next received clock is the next position
+static void Follow(MidiClock_t *clock) {
+    clock->last_seen = clock->time;
+    clock->external = true;
+    clock->running = true;
+    clock->ticks = 0;
+    clock->clocks = 0;
+    clock->pending = 0;
+    clock->phase = 0;
+}
+
+static int32_t Clamp_Period(const MidiClock_t *clock, int64_t period) {
+    if (period < clock->min_period) return clock->min_period;
+    if (period > clock->max_period) return clock->max_period;
+    return (int32_t)period;
+}
+
+static void Track_Period(MidiClock_t *clock) {
+    uint32_t samples = clock->time - clock->last_tick;
+    bool gap = !clock->have_tick ||
+               samples > 2u * (uint32_t)(clock->max_period / MIDI_CLOCK_ONE);
+
+    clock->last_tick = clock->time;
+    clock->have_tick = true;
+    if (gap) {
+        // First clock, or after a pause: the span starts over
+        clock->span_start = clock->time;
+        clock->span_ticks = 0;
+        return;
+    }
+
+    // Clocks are timed to a block at best, so one interval is a rough
+    // guess: the mean over the span so far sets the period until the first
+    // whole beat, then each beat moves it half way
+    clock->span_ticks++;
+    int64_t mean = (int64_t)(clock->time - clock->span_start) *
+                   MIDI_CLOCK_ONE / clock->span_ticks;
+    if (!clock->acquired) {
+        clock->measured = Clamp_Period(clock, mean);
+        clock->period = clock->measured;
+    }
+    if (clock->span_ticks == MIDI_CLOCK_PPQN) {
+        if (clock->acquired) {
+            int32_t step = (int32_t)(mean - clock->measured) / 2;
+            clock->measured = Clamp_Period(clock, clock->measured + step);
+            clock->period = Clamp_Period(clock, clock->period + step);
+        }
+        clock->acquired = true;
+        clock->span_start = clock->time;
+        clock->span_ticks = 0;
+    }
+}
+
+static void Track_Phase(MidiClock_t *clock) {
+    clock->ticks++;
+    if (clock->ticks == 1) {
+        // First clock after Start/Continue: it is the position
+        clock->clocks = 1;
+        clock->pending = 1;
+        clock->phase = 0;
+        return;
+    }
+
+    int32_t behind = (int32_t)(clock->ticks - clock->clocks);
+    if (behind >= 2) {
+        // Local clock lost: catch up now, in phase with this clock
+        clock->pending += (uint8_t)(behind > 24 ? 24 : behind);
+        clock->clocks = clock->ticks;
+        clock->phase = 0;
+        return;
+    }
+
+    // behind 0: the local clock fell 'phase' ago (early);
+    // behind 1: it falls in period - phase (late)
+    int32_t error = behind == 0 ? clock->phase : clock->phase - clock->period;
+    clock->phase -= error / 4;
+    clock->period = Clamp_Period(clock, clock->period + error / 32); // Ramps
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+void MidiClock_Init(MidiClock_t *clock, uint16_t sample_rate,
+                    void (*send)(uint8_t byte)) {
+    clock->sample_rate = sample_rate;
+    clock->min_period = Period_For(clock, MIDI_CLOCK_MAX_BPM);
+    clock->max_period = Period_For(clock, MIDI_CLOCK_MIN_BPM);
+    clock->period = Period_For(clock, MIDI_CLOCK_DEFAULT_BPM);
+    clock->measured = clock->period;
+    clock->phase = 0;
+    clock->position = 0;
+    clock->time = 0;
+    clock->last_tick = 0;
+    clock->last_seen = 0;
+    clock->span_start = 0;
+    clock->timeout = (uint32_t)sample_rate * MIDI_CLOCK_TIMEOUT_MS / 1000u;
+    clock->ticks = 0;
+    clock->clocks = 0;
+    clock->pending = 0;
+    clock->span_ticks = 0;
+    clock->acquired = false;
+    clock->running = true;
+    clock->external = false;
+    clock->have_tick = false;
+    clock->send = send;
+}
+
+void MidiClock_SetTempo(MidiClock_t *clock, uint16_t bpm) {
+    if (bpm < MIDI_CLOCK_MIN_BPM) bpm = MIDI_CLOCK_MIN_BPM;
+    if (bpm > MIDI_CLOCK_MAX_BPM) bpm = MIDI_CLOCK_MAX_BPM;
+    clock->period = Period_For(clock, bpm);
+    clock->measured = clock->period;
+    if (clock->phase > clock->period) clock->phase = clock->period;
+}
+
+uint16_t MidiClock_GetTempo10(const MidiClock_t *clock) {
+    uint64_t per_minute = (uint64_t)clock->sample_rate * 600u * MIDI_CLOCK_ONE;
+    uint64_t per_beat = (uint64_t)clock->measured * MIDI_CLOCK_PPQN;
+    return (uint16_t)((per_minute + per_beat / 2) / per_beat);
+}
+
+void MidiClock_RealTime(MidiClock_t *clock, uint8_t byte) {
+    switch (byte) {
+    case MIDI_CLOCK_START:
+        Follow(clock);
+        clock->position = UINT32_MAX; // The first clock is position 0
+        break;
+    case MIDI_CLOCK_CONT:
+        Follow(clock);
+        break;
+    case MIDI_CLOCK_STOP:
+        if (clock->external) clock->running = false;
+        break;
+    case MIDI_CLOCK_TICK:
+        // Clock alone (stopped master) keeps the tempo, not the position
+        if (!clock->external) break;
+        clock->last_seen = clock->time;
+        Track_Period(clock);
+        if (clock->running) Track_Phase(clock);
+        break;
+    default:
+        break;
+    }
+}
+
+bool MidiClock_AdvanceSlow(MidiClock_t *clock) {
+    if (clock->external && clock->time - clock->last_seen > clock->timeout) {
+        // Source gone: master again from here, at the last tempo. A
+        // stopped transport stays stopped (a source usually goes quiet
+        // after its Stop)
+        clock->period = clock->measured;
+        clock->external = false;
+        clock->pending = 0;
+        clock->phase = 0;
+    }
+    if (!clock->running) return false;
+
+    if (clock->pending) {
+        clock->pending--;
+        clock->position++;
+        return true;
+    }
+    if (!clock->external) {
+        clock->phase += MIDI_CLOCK_ONE;
+        if (clock->phase < clock->period) return false;
+        clock->phase -= clock->period;
+        clock->position++;
+        if (clock->send) clock->send(MIDI_CLOCK_TICK);
+        return true;
+    }
+    if (clock->ticks == 0) return false; // Waiting for the first clock
+
+    clock->phase += MIDI_CLOCK_ONE;
+    if (clock->phase < clock->period) return false;
+    if (clock->clocks > clock->ticks) {
+        clock->phase = clock->period; // One ahead: wait for the next clock
+        return false;
+    }
+    clock->phase -= clock->period;
+    clock->clocks++;
+    clock->position++;
+    return true;
+}
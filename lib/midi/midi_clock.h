@@ -0,0 +1,139 @@
+/**
+ * @file midi_clock.h
+ * @brief MIDI Clock Transport (master clock or tempo PLL slave)
+ * @version 1.0.0
+ *
+ * Keeps the musical position in MIDI clocks (24 per beat) against the
+ * sample clock. MidiClock_Advance runs once per rendered sample and
+ * returns true on the sample where a clock falls, so whatever steps on
+ * the clock (arpeggiator, sequencer) lands on that sample.
+ *
+ * Master (internal): the period comes from MidiClock_SetTempo and every
+ * clock is sent through the send hook (0xF8).
+ *
+ * Slave (external): 0xFA Start / 0xFB Continue switch to the incoming
+ * clock, 0xFC Stop halts the position. The tempo PLL works in samples:
+ *   - Period: the mean interval between received clocks, over the first
+ *     beat as it comes in; after that it moves half way to each whole
+ *     beat's mean (the block timing of one clock averages out over 24).
+ *     The local clock runs on it, trimmed by 1/32 of each phase error so
+ *     that it keeps up with tempo ramps.
+ *   - Phase: the local clock runs on the smoothed period between received
+ *     clocks; each received clock pulls it a quarter of the way to the
+ *     clock's time. The local clock never runs more than one clock ahead
+ *     of the received ones (it waits), and catches up at once if it
+ *     falls two behind.
+ * Received clocks are timed when they are parsed (once per block in the
+ * firmware); the PLL smooths that out like any other jitter. Without a
+ * clock for MIDI_CLOCK_TIMEOUT_MS the transport goes back to master at
+ * the last tempo, running or stopped as it was.
+ *
+ * Usage:
+ *   static MidiClock_t clock;
+ *   MidiClock_Init(&clock, 16000, Send_Byte);  // Master, 120 BPM, running
+ *   MidiClock_RealTime(&clock, byte);          // Received 0xF8-0xFC
+ *   if (MidiClock_Advance(&clock) && clock.position % 6 == 0) Step();
+ */
+
+#ifndef MIDI_CLOCK_H_
+#define MIDI_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define MIDI_CLOCK_PPQN        24     // Clocks per beat (MIDI 1.0)
+#define MIDI_CLOCK_DEFAULT_BPM 120
+#define MIDI_CLOCK_MIN_BPM     30
+#define MIDI_CLOCK_MAX_BPM     300
+
+#ifndef MIDI_CLOCK_TIMEOUT_MS
+#define MIDI_CLOCK_TIMEOUT_MS  500    // No clock: back to master
+#endif
+
+#define MIDI_CLOCK_TICK   0xF8
+#define MIDI_CLOCK_START  0xFA
+#define MIDI_CLOCK_CONT   0xFB
+#define MIDI_CLOCK_STOP   0xFC
+
+#define MIDI_CLOCK_ONE    65536       // One sample, Q16
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    int32_t period;            ///< Samples per clock, Q16 (PLL trimmed)
+    int32_t measured;          ///< Samples per clock, Q16, the tempo
+    int32_t phase;             ///< Samples since the last local clock, Q16
+    int32_t min_period;        ///< Q16, MIDI_CLOCK_MAX_BPM
+    int32_t max_period;        ///< Q16, MIDI_CLOCK_MIN_BPM
+    uint32_t position;         ///< Clock index of the last clock (0 = Start)
+    uint32_t time;             ///< Samples since init
+    uint32_t last_tick;        ///< time of the last received clock
+    uint32_t last_seen;        ///< time of the last Start/Continue/clock
+    uint32_t span_start;       ///< time the beat being measured began
+    uint32_t timeout;          ///< Samples without a clock before master
+    uint32_t ticks;            ///< Clocks received since Start/Continue
+    uint32_t clocks;           ///< Local clocks since Start/Continue
+    uint16_t sample_rate;
+    uint8_t pending;           ///< Clocks to hand out on the next sample
+    uint8_t span_ticks;        ///< Clocks in the beat being measured
+    bool acquired;             ///< A whole beat measured
+    bool running;
+    bool external;             ///< Following received clock
+    bool have_tick;            ///< last_tick is valid
+    void (*send)(uint8_t byte);///< Master output (NULL = silent)
+} MidiClock_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Master at MIDI_CLOCK_DEFAULT_BPM, running from position 0
+ * @param send Called with 0xF8 for every master clock (may be NULL)
+ */
+void MidiClock_Init(MidiClock_t *clock, uint16_t sample_rate,
+                    void (*send)(uint8_t byte));
+
+/**
+ * @brief Master tempo (clamped to MIDI_CLOCK_MIN_BPM..MIDI_CLOCK_MAX_BPM)
+ */
+void MidiClock_SetTempo(MidiClock_t *clock, uint16_t bpm);
+
+/**
+ * @brief Current tempo in 0.1 BPM (the smoothed estimate when external)
+ */
+uint16_t MidiClock_GetTempo10(const MidiClock_t *clock);
+
+/**
+ * @brief Take a received real-time byte (others are ignored)
+ */
+void MidiClock_RealTime(MidiClock_t *clock, uint8_t byte);
+
+/**
+ * @brief Slow path of MidiClock_Advance (pending, slave, timeout)
+ */
+bool MidiClock_AdvanceSlow(MidiClock_t *clock);
+
+/**
+ * @brief One sample
+ * @return true if a clock falls on it (clock->position is its index)
+ */
+static inline bool MidiClock_Advance(MidiClock_t *clock) {
+    clock->time++;
+    if (clock->external || clock->pending || !clock->running)
+        return MidiClock_AdvanceSlow(clock);
+
+    // Master: the common case stays inline
+    clock->phase += MIDI_CLOCK_ONE;
+    if (clock->phase < clock->period) return false;
+    clock->phase -= clock->period;
+    clock->position++;
+    if (clock->send) clock->send(MIDI_CLOCK_TICK);
+    return true;
+}
+
+#endif /* MIDI_CLOCK_H_ */
@@ -0,0 +1,151 @@
+/**
+ * @file midi_in.c
+ * @brief MIDI 1.0 Input Parser Implementation
+ */
+
+#include "midi_in.h"
+#include <stddef.h>
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+
+// Data bytes after a status byte (0xF0/0xF7 are handled apart)
+static uint8_t Data_Bytes(uint8_t status) {
+    switch (status & 0xF0) {
+    case 0xC0: // Program Change
+    case 0xD0: // Channel pressure
+        return 1;
+    case 0xF0:
+        if (status == 0xF1 || status == 0xF3) return 1; // MTC, song select
+        if (status == 0xF2) return 2;                   // Song position
+        return 0;                                       // F4-F6
+    default:
+        return 2;
+    }
+}
+
+static void Dispatch(MidiIn_t *in) {
+    MIDI_Message_t msg = {in->status, in->data[0], in->data[1],
+                          (uint8_t)(1 + in->needed)};
+
+    if (in->needed < 2) msg.data2 = 0;
+    if (in->needed < 1) msg.data1 = 0;
+    if ((msg.status & 0xF0) == MIDI_NOTE_ON && msg.data2 == 0) {
+        msg.status = MIDI_NOTE_OFF | (msg.status & 0x0F);
+        msg.data2 = 64;
+    }
+    in->messages++;
+    if (in->handlers.message) in->handlers.message(in->handlers.ctx, &msg);
+}
+
+static void Status(MidiIn_t *in, uint8_t byte) {
+    in->status = byte;
+    in->needed = Data_Bytes(byte);
+    in->count = 0;
+
+    if (byte >= 0xF0 && in->needed == 0) {
+        // F4/F5 are undefined; F6 (tune request) has no data
+        if (byte == 0xF6) Dispatch(in);
+        in->status = 0;
+    }
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void MidiIn_Init(MidiIn_t *in, const MidiInHandlers_t *handlers) {
+    static const MidiInHandlers_t none = {NULL, NULL, NULL, NULL};
+
+    in->status = 0;
+    in->needed = 0;
+    in->count = 0;
+    in->in_sysex = false;
+    in->sysex_overflow = false;
+    in->sysex_length = 0;
+    in->handlers = handlers ? *handlers : none;
+    in->bytes = 0;
+    in->messages = 0;
+    in->errors = 0;
+}
+
+void MidiIn_Parse(MidiIn_t *in, uint8_t byte) {
+    in->bytes++;
+
+    // Real-time: anywhere, changes nothing else
+    if (byte >= 0xF8) {
+        in->messages++;
+        if (in->handlers.realtime) in->handlers.realtime(in->handlers.ctx, byte);
+        return;
+    }
+
+    if (byte == MIDI_SYSEX_END) {
+        if (!in->in_sysex) {
+            in->errors++; // EOX without a frame
+            return;
+        }
+        in->in_sysex = false;
+        if (in->sysex_overflow || in->sysex_length >= MIDI_IN_SYSEX_MAX) {
+            in->errors++;
+            return;
+        }
+        in->sysex[in->sysex_length++] = byte;
+        in->messages++;
+        if (in->handlers.sysex)
+            in->handlers.sysex(in->handlers.ctx, in->sysex, in->sysex_length);
+        return;
+    }
+
+    if (byte & 0x80) {
+        if (in->in_sysex) {
+            in->errors++; // Frame cut off by a status byte
+            in->in_sysex = false;
+        }
+        if (byte == MIDI_SYSEX_START) {
+            in->status = 0; // Cancels running status
+            in->in_sysex = true;
+            in->sysex_overflow = false;
+            in->sysex[0] = byte;
+            in->sysex_length = 1;
+            return;
+        }
+        if (in->status != 0 && in->count != 0)
+            in->errors++; // Message cut off
+        Status(in, byte);
+        return;
+    }
+
+    // Data byte
+    if (in->in_sysex) {
+        if (in->sysex_length < MIDI_IN_SYSEX_MAX)
+            in->sysex[in->sysex_length++] = byte;
+        else
+            in->sysex_overflow = true;
+        return;
+    }
+    if (in->status == 0) {
+        in->errors++; // No status to run on
+        return;
+    }
+    in->data[in->count++] = byte;
+    if (in->count == in->needed) {
+        Dispatch(in);
+        in->count = 0;
+        if (in->status >= 0xF0) in->status = 0; // Common: no running status
+    }
+}
+
+uint16_t MidiIn_Process(MidiIn_t *in, MidiInRing_t *ring) {
+    uint16_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint16_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint16_t n = (uint16_t)(head - tail);
+
+    while (tail != head) {
+        MidiIn_Parse(in, ring->bytes[tail & (MIDI_IN_RING_SIZE - 1)]);
+        tail++;
+    }
+    // Release: the bytes are read before the interrupt can reuse them
+    atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    return n;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file midi_in.h
+ * @brief MIDI 1.0 Input (UART RX ring and byte-wise parser)
+ * @version 1.0.0
+ *
+ * The UART receive interrupt drains the RX FIFO into a byte ring (single
+ * producer, single consumer, no masking). The consumer feeds the bytes to
+ * a state-machine parser, which calls a handler per complete message:
+ *
+ *   - Channel messages (Note On/Off, CC, Program Change, Pitch Bend,
+ *     aftertouch) with running status. Note On with velocity 0 is handed
+ *     over as Note Off (velocity 64).
+ *   - Real-time bytes (0xF8-0xFF) are handed over at once, wherever they
+ *     arrive, even inside another message or a SysEx frame.
+ *   - SysEx frames (F0 ... F7) are collected and handed over whole, up to
+ *     MIDI_IN_SYSEX_MAX bytes. Longer frames are dropped and counted.
+ *   - System common messages (F1-F6) cancel running status; they are
+ *     handed over like channel messages.
+ *
+ * Stray data bytes, frames cut off by a status byte, and ring overruns
+ * are counted, never fatal: the parser resynchronises on the next status
+ * byte. tools/host/midi_fuzz feeds it random and recorded streams.
+ *
+ * Usage:
+ *   static MidiInRing_t rx;
+ *   static MidiIn_t midi_in;
+ *   static const MidiInHandlers_t handlers = {On_Message, On_RealTime,
+ *                                             On_SysEx, NULL};
+ *   MidiIn_RingInit(&rx);
+ *   MidiIn_Init(&midi_in, &handlers);
+ *
+ *   MidiIn_RingPut(&rx, DL_UART_receiveData(UART));   // RX interrupt
+ *   MidiIn_Process(&midi_in, &rx);                    // Consumer
+ */
+
+#ifndef MIDI_IN_H_
+#define MIDI_IN_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "midi_msg.h"
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef MIDI_IN_RING_SIZE
+#define MIDI_IN_RING_SIZE 512      // Bytes, power of two (5.5 ms at 921600)
+#endif
+
+#ifndef MIDI_IN_SYSEX_MAX
+#define MIDI_IN_SYSEX_MAX 256      // Longest SysEx frame kept, F0 and F7 included
+#endif
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Received bytes, from the RX interrupt to the parser
+ */
+typedef struct {
+    uint8_t bytes[MIDI_IN_RING_SIZE];
+    atomic_uint_least16_t head;    ///< Next slot to write (interrupt)
+    atomic_uint_least16_t tail;    ///< Next slot to read (parser)
+    volatile uint16_t overruns;    ///< Bytes lost, ring full (interrupt)
+} MidiInRing_t;
+
+/**
+ * @brief Called by the parser (NULL = ignore)
+ */
+typedef struct {
+    void (*message)(void *ctx, const MIDI_Message_t *msg); ///< Channel/common
+    void (*realtime)(void *ctx, uint8_t byte);             ///< 0xF8-0xFF
+    void (*sysex)(void *ctx, const uint8_t *frame, uint16_t length);
+    void *ctx;
+} MidiInHandlers_t;
+
+typedef struct {
+    uint8_t status;            ///< Message being collected, 0 = none
+    uint8_t needed;            ///< Data bytes it takes
+    uint8_t count;             ///< Data bytes so far
+    uint8_t data[2];
+    bool in_sysex;
+    bool sysex_overflow;
+    uint16_t sysex_length;
+    uint8_t sysex[MIDI_IN_SYSEX_MAX];
+    MidiInHandlers_t handlers;
+    uint32_t bytes;            ///< Bytes parsed
+    uint32_t messages;         ///< Messages handed over (all kinds)
+    uint16_t errors;           ///< Stray data, cut-off or oversized frames
+} MidiIn_t;
+
+//=============================================================================
+// RX RING
+//=============================================================================
+
+static inline void MidiIn_RingInit(MidiInRing_t *ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->overruns = 0;
+}
+
+/**
+ * @brief Store one received byte (producer: the RX interrupt)
+ */
+static inline void MidiIn_RingPut(MidiInRing_t *ring, uint8_t byte) {
+    uint16_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint16_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+
+    if ((uint16_t)(head - tail) >= MIDI_IN_RING_SIZE) {
+        ring->overruns++;
+        return;
+    }
+    ring->bytes[head & (MIDI_IN_RING_SIZE - 1)] = byte;
+    atomic_store_explicit(&ring->head, (uint16_t)(head + 1),
+                          memory_order_release);
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Reset the parser and take the handlers (copied; may be NULL)
+ */
+void MidiIn_Init(MidiIn_t *in, const MidiInHandlers_t *handlers);
+
+/**
+ * @brief Parse one byte
+ */
+void MidiIn_Parse(MidiIn_t *in, uint8_t byte);
+
+/**
+ * @brief Parse everything in the ring (consumer)
+ * @return Bytes parsed
+ */
+uint16_t MidiIn_Process(MidiIn_t *in, MidiInRing_t *ring);
+
+#endif /* MIDI_IN_H_ */
@@ -0,0 +1,183 @@
+/**
+ * @file midi_msg.h
+ * @brief MIDI Messages and Note/Frequency Conversion
+ * @version 1.0.0
+ *
+ * Status bytes, message builders and the 0-127 note frequency table.
+ * Header-only: everything is static inline, so the firmware and the host
+ * tools get the same code.
+ *
+ * MIDI Note 69 (A4) = 440 Hz (concert pitch)
+ * Formula: f = 440 * 2^((N - 69) / 12)
+ *
+ * Usage:
+ *   MIDI_Message_t msg;
+ *   MIDI_CreateNoteOn(0, MIDI_FreqToNote(440), 100, &msg);
+ *   uart_send(&msg.status, msg.length);   // status, data1[, data2]
+ */
+
+#ifndef MIDI_MSG_H_
+#define MIDI_MSG_H_
+
+#include <stdint.h>
+
+// MIDI Status Bytes
+#define MIDI_NOTE_OFF           0x80
+#define MIDI_NOTE_ON            0x90
+#define MIDI_CONTROL_CHANGE     0xB0
+#define MIDI_PROGRAM_CHANGE     0xC0
+#define MIDI_PITCH_BEND         0xE0
+#define MIDI_SYSEX_START        0xF0
+#define MIDI_SYSEX_END          0xF7
+
+// SysEx manufacturer ID for non-commercial use (device telemetry)
+#define MIDI_SYSEX_ID_NONCOMMERCIAL 0x7D
+
+// MIDI Control Change Numbers
+#define MIDI_CC_VOLUME          0x07
+#define MIDI_CC_SUSTAIN         0x40
+#define MIDI_CC_ALL_SOUND_OFF   0x78
+#define MIDI_CC_RESET_CONTROLLERS 0x79
+#define MIDI_CC_ALL_NOTES_OFF   0x7B
+
+// MIDI Message Structure
+typedef struct {
+    uint8_t status;
+    uint8_t data1;
+    uint8_t data2;
+    uint8_t length;
+} MIDI_Message_t;
+
+// MIDI Frequency Table (complete 0-127)
+static const uint16_t MIDI_FREQ_TABLE[128] = {
+    8, 9, 9, 10, 10, 11, 12, 12, 13, 14, 15, 15,
+    16, 17, 18, 19, 21, 22, 23, 25, 26, 28, 29, 31,
+    33, 35, 37, 39, 41, 44, 46, 49, 52, 55, 58, 62,
+    65, 69, 73, 78, 82, 87, 92, 98, 104, 110, 117, 123,
+    131, 139, 147, 156, 165, 175, 185, 196, 208, 220, 233, 247,
+    262, 277, 294, 311, 330, 349, 370, 392, 415, 440, 466, 494,
+    523, 554, 587, 622, 659, 698, 740, 784, 831, 880, 932, 988,
+    1047, 1109, 1175, 1245, 1319, 1397, 1480, 1568, 1661, 1760, 1865, 1976,
+    2093, 2217, 2349, 2489, 2637, 2794, 2960, 3136, 3322, 3520, 3729, 3951,
+    4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902,
+    8372, 8870, 9397, 9956, 10548, 11175, 11840, 12544
+};
+
+static inline uint16_t MIDI_NoteToFreq(uint8_t note) {
+    if (note > 127) note = 127;
+    return MIDI_FREQ_TABLE[note];
+}
+
+static inline uint8_t MIDI_FreqToNote(uint16_t freq) {
+    if (freq < 8) return 0;
+    if (freq > 12544) return 127;
+    
+    // Binary search
+    uint8_t low = 0, high = 127;
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        if (freq < MIDI_FREQ_TABLE[mid]) {
+            high = mid;
+        } else if (freq > MIDI_FREQ_TABLE[mid]) {
+            low = mid + 1;
+        } else {
+            return mid;
+        }
+    }
+    
+    if (low > 0) {
+        uint16_t diff_low = (freq >= MIDI_FREQ_TABLE[low]) ? 
+            (freq - MIDI_FREQ_TABLE[low]) : (MIDI_FREQ_TABLE[low] - freq);
+        uint16_t diff_prev = (freq >= MIDI_FREQ_TABLE[low-1]) ? 
+            (freq - MIDI_FREQ_TABLE[low-1]) : (MIDI_FREQ_TABLE[low-1] - freq);
+        if (diff_prev < diff_low) return low - 1;
+    }
+    return low;
+}
+
+static inline void MIDI_CreateNoteOn(uint8_t channel, uint8_t note, 
+                                     uint8_t velocity, MIDI_Message_t* msg) {
+    msg->status = MIDI_NOTE_ON | (channel & 0x0F);
+    msg->data1 = note & 0x7F;
+    msg->data2 = velocity & 0x7F;
+    msg->length = 3;
+}
+
+static inline void MIDI_CreateNoteOff(uint8_t channel, uint8_t note,
+                                      uint8_t velocity, MIDI_Message_t* msg) {
+    msg->status = MIDI_NOTE_OFF | (channel & 0x0F);
+    msg->data1 = note & 0x7F;
+    msg->data2 = velocity & 0x7F;
+    msg->length = 3;
+}
+
+static inline void MIDI_CreateControlChange(uint8_t channel, uint8_t controller,
+                                            uint8_t value, MIDI_Message_t* msg) {
+    msg->status = MIDI_CONTROL_CHANGE | (channel & 0x0F);
+    msg->data1 = controller & 0x7F;
+    msg->data2 = value & 0x7F;
+    msg->length = 3;
+}
+
+static inline void MIDI_CreateProgramChange(uint8_t channel, uint8_t program,
+                                            MIDI_Message_t* msg) {
+    msg->status = MIDI_PROGRAM_CHANGE | (channel & 0x0F);
+    msg->data1 = program & 0x7F;
+    msg->data2 = 0;
+    msg->length = 2;
+}
+
+// SysEx payload: low 21 bits of value as three 7-bit bytes, LSB first
+static inline uint8_t *MIDI_PackU21(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)(value & 0x7F);
+    dst[1] = (uint8_t)((value >> 7) & 0x7F);
+    dst[2] = (uint8_t)((value >> 14) & 0x7F);
+    return dst + 3;
+}
+
+// SysEx payload: 32-bit value as five 7-bit bytes, LSB first
+static inline uint8_t *MIDI_PackU32(uint8_t *dst, uint32_t value) {
+    for (uint8_t i = 0; i < 5; i++) {
+        dst[i] = (uint8_t)(value & 0x7F);
+        value >>= 7;
+    }
+    return dst + 5;
+}
+
+// Bytes in a SysEx payload of n 8-bit bytes packed by MIDI_Pack8
+#define MIDI_PACKED_SIZE(n) ((n) + ((n) + 6) / 7)
+
+// SysEx payload: 8-bit bytes in groups of up to seven, each group led by a
+// byte holding their top bits (bit i for byte i), then their low 7 bits
+static inline uint8_t *MIDI_Pack8(uint8_t *dst, const uint8_t *src,
+                                  uint16_t n) {
+    while (n) {
+        uint8_t count = n < 7 ? (uint8_t)n : 7;
+        uint8_t *msbs = dst++;
+        *msbs = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            *msbs |= (uint8_t)((src[i] >> 7) << i);
+            *dst++ = src[i] & 0x7F;
+        }
+        src += count;
+        n -= count;
+    }
+    return dst;
+}
+
+// Reverse of MIDI_Pack8: n packed bytes in, returns the bytes written
+static inline uint16_t MIDI_Unpack8(uint8_t *dst, const uint8_t *src,
+                                    uint16_t n) {
+    uint16_t out = 0;
+    while (n > 1) {
+        uint8_t count = n - 1 < 7 ? (uint8_t)(n - 1) : 7;
+        uint8_t msbs = src[0];
+        for (uint8_t i = 0; i < count; i++)
+            dst[out++] = (uint8_t)(src[1 + i] | (((msbs >> i) & 1) << 7));
+        src += count + 1;
+        n -= count + 1;
+    }
+    return out;
+}
+
+#endif /* MIDI_MSG_H_ */
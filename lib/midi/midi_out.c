@@ -0,0 +1,228 @@
+/**
+ * @file midi_out.c
+ * @brief Non-Blocking MIDI Output Queue Implementation
+ */
+
+#include "midi_out.h"
+#include <string.h>
+
+//=============================================================================
+// INTERRUPT MASK
+//=============================================================================
+#if defined(__linux__)
+// Host tools: one thread, nothing to mask
+static inline uint32_t Lock(void) { return 0; }
+static inline void Unlock(uint32_t primask) { (void)primask; }
+#else
+static inline uint32_t Lock(void) {
+    uint32_t primask;
+    __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask) : : "memory");
+    return primask;
+}
+
+static inline void Unlock(uint32_t primask) {
+    __asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+#endif
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+static bool No_Busy(void) {
+    return false;
+}
+
+static void No_Start(const uint8_t *data, uint16_t n) {
+    (void)data;
+    (void)n;
+}
+
+// Interrupts masked: a poll from a nested context must not start twice
+static void Kick(MidiOut_t *out) {
+    if (out->in_flight != 0) {
+        if (out->port.busy()) return;
+        out->tail += out->in_flight;
+        out->in_flight = 0;
+    }
+
+    uint16_t queued = (uint16_t)(out->head - out->tail);
+    if (queued == 0) return;
+
+    // One contiguous span; the wrapped rest goes in the next transfer
+    uint16_t offset = out->tail & (MIDI_OUT_RING_SIZE - 1);
+    uint16_t span = MIDI_OUT_RING_SIZE - offset;
+    if (span > queued) span = queued;
+    out->in_flight = span;
+    out->port.start(&out->ring[offset], span);
+}
+
+// Interrupts masked: copy in whole or not at all
+static bool Put(MidiOut_t *out, const uint8_t *data, uint16_t n) {
+    uint16_t head = out->head;
+    uint16_t queued = (uint16_t)(head - out->tail);
+
+    if (n > MIDI_OUT_RING_SIZE - queued) {
+        out->dropped++;
+        return false;
+    }
+
+    // At most two pieces around the end of the ring
+    uint16_t offset = head & (MIDI_OUT_RING_SIZE - 1);
+    uint16_t first = MIDI_OUT_RING_SIZE - offset;
+    if (first > n) first = n;
+    memcpy(&out->ring[offset], data, first);
+    memcpy(out->ring, data + first, n - first);
+    out->head = head + n;
+
+    queued += n;
+    if (queued > out->peak) out->peak = queued;
+    return true;
+}
+
+// Interrupts masked: one channel message, compressed
+static bool Put_Message(MidiOut_t *out, uint8_t status, uint8_t data1,
+                        uint8_t data2, uint8_t length) {
+    uint8_t bytes[3];
+    uint8_t n = 0;
+
+#if MIDI_OUT_NOTE_OFF_AS_ON
+    if ((status & 0xF0) == MIDI_NOTE_OFF && data2 == 64) {
+        status = MIDI_NOTE_ON | (status & 0x0F);
+        data2 = 0;
+    }
+#endif
+#if MIDI_OUT_RUNNING_STATUS
+    if (status == out->running_status) {
+        out->bytes_saved++;
+    } else {
+        bytes[n++] = status;
+    }
+#else
+    bytes[n++] = status;
+#endif
+    bytes[n++] = data1;
+    if (length == 3) bytes[n++] = data2;
+
+    if (!Put(out, bytes, n)) return false;
+    out->running_status = status;
+    return true;
+}
+
+static MidiCcSlot_t *Find_Controller(MidiOut_t *out, uint8_t status,
+                                     uint8_t controller) {
+    for (uint8_t i = 0; i < out->cc_slots; i++) {
+        if (out->cc[i].status == status && out->cc[i].controller == controller)
+            return &out->cc[i];
+    }
+    return NULL;
+}
+
+// Interrupts masked
+static void Send_Controller(MidiOut_t *out, MidiCcSlot_t *slot, uint32_t now) {
+    if (Put_Message(out, slot->status, slot->controller, slot->value, 3)) {
+        slot->sent = slot->value;
+        slot->ever_sent = true;
+        slot->pending = false;
+        slot->last_time = now;
+    }
+    // Refused: stays pending for the next flush
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void MidiOut_Init(MidiOut_t *out, const MidiOutPort_t *port) {
+    out->head = 0;
+    out->tail = 0;
+    out->in_flight = 0;
+    out->dropped = 0;
+    out->peak = 0;
+    out->running_status = 0;
+    out->cc_slots = 0;
+    out->bytes_saved = 0;
+    out->cc_coalesced = 0;
+    out->port.busy = (port && port->busy) ? port->busy : No_Busy;
+    out->port.start = (port && port->start) ? port->start : No_Start;
+}
+
+bool MidiOut_Write(MidiOut_t *out, const uint8_t *data, uint16_t n) {
+    uint32_t primask = Lock();
+    bool ok = Put(out, data, n);
+
+    // Anything but a lone real-time byte cancels running status
+    if (ok && !(n == 1 && data[0] >= 0xF8)) out->running_status = 0;
+    Kick(out);
+    Unlock(primask);
+    return ok;
+}
+
+bool MidiOut_Send(MidiOut_t *out, const MIDI_Message_t *msg) {
+    uint32_t primask = Lock();
+    bool ok = Put_Message(out, msg->status, msg->data1, msg->data2,
+                          msg->length);
+    Kick(out);
+    Unlock(primask);
+    return ok;
+}
+
+bool MidiOut_ThinController(MidiOut_t *out, uint8_t channel,
+                            uint8_t controller, uint16_t interval) {
+    uint8_t status = MIDI_CONTROL_CHANGE | (channel & 0x0F);
+    uint32_t primask = Lock();
+    MidiCcSlot_t *slot = Find_Controller(out, status, controller);
+
+    if (slot == NULL && out->cc_slots < MIDI_OUT_CC_SLOTS) {
+        slot = &out->cc[out->cc_slots++];
+        slot->status = status;
+        slot->controller = controller;
+        slot->pending = false;
+        slot->ever_sent = false;
+        slot->last_time = 0;
+    }
+    if (slot) slot->interval = interval;
+    Unlock(primask);
+    return slot != NULL;
+}
+
+void MidiOut_ControlChange(MidiOut_t *out, uint8_t channel, uint8_t controller,
+                           uint8_t value, uint32_t now) {
+    uint8_t status = MIDI_CONTROL_CHANGE | (channel & 0x0F);
+    uint32_t primask = Lock();
+    MidiCcSlot_t *slot = Find_Controller(out, status, controller);
+
+    if (slot == NULL) {
+        Put_Message(out, status, controller & 0x7F, value & 0x7F, 3);
+    } else {
+        if (slot->pending) out->cc_coalesced++; // Overwritten, never sent
+        slot->value = value & 0x7F;
+        slot->pending = !slot->ever_sent || slot->value != slot->sent;
+        if (slot->pending &&
+            (!slot->ever_sent || now - slot->last_time >= slot->interval))
+            Send_Controller(out, slot, now);
+    }
+    Kick(out);
+    Unlock(primask);
+}
+
+void MidiOut_FlushControllers(MidiOut_t *out, uint32_t now) {
+    uint32_t primask = Lock();
+
+    for (uint8_t i = 0; i < out->cc_slots; i++) {
+        MidiCcSlot_t *slot = &out->cc[i];
+        if (slot->pending && now - slot->last_time >= slot->interval)
+            Send_Controller(out, slot, now);
+    }
+    Kick(out);
+    Unlock(primask);
+}
+
+uint16_t MidiOut_Free(const MidiOut_t *out) {
+    return (uint16_t)(MIDI_OUT_RING_SIZE - (uint16_t)(out->head - out->tail));
+}
+
+void MidiOut_Poll(MidiOut_t *out) {
+    uint32_t primask = Lock();
+    Kick(out);
+    Unlock(primask);
+}
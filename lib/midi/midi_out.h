@@ -0,0 +1,164 @@
+/**
+ * @file midi_out.h
+ * @brief Non-Blocking MIDI Output Queue (byte ring drained by DMA)
+ * @version 1.0.0
+ *
+ * Every byte for the MIDI UART (messages, SysEx reports, trace frames) goes
+ * through one ring. A write copies the bytes and returns; the DMA channel
+ * moves them to the UART in the background, one contiguous span per
+ * transfer. No writer waits for the UART, so MIDI can be sent from the
+ * audio block renderer.
+ *
+ * Writes are all-or-nothing, so a message or frame is never split or
+ * interleaved with another. A write that does not fit is refused and
+ * counted. Writers in different contexts are serialised by masking
+ * interrupts around the copy (the Cortex-M0+ has no LDREX/STREX); the copy
+ * of a 51-byte frame is about 200 cycles.
+ *
+ * The hardware comes in through MidiOutPort_t (main.c: DMA_CH1, UART_AUDIO
+ * TX, single transfer mode). MidiOut_Poll starts the next span when the
+ * channel is idle. Writes poll too; the main loop and the block renderer
+ * call it so the last bytes leave without a new write.
+ *
+ * Channel messages are compressed on the way in:
+ *   - Running status: a status byte equal to the previous one is left out.
+ *     Any other write (a SysEx frame) cancels it, except a single
+ *     real-time byte, so the next message carries its status again.
+ *   - Note Off with the default release velocity (64) goes out as Note On
+ *     with velocity 0, so note on/off runs share one status.
+ *   - Thinned controllers (MidiOut_ThinController) are sent at most once
+ *     per interval, in the caller's clock ticks. Updates in between
+ *     overwrite each other and the last value goes out when the interval
+ *     is up (MidiOut_FlushControllers); a value equal to the last one sent
+ *     is not sent again.
+ *
+ * Usage:
+ *   static const MidiOutPort_t port = {Dma_Busy, Dma_Start};
+ *   static MidiOut_t midi_out;
+ *   MidiOut_Init(&midi_out, &port);
+ *   MidiOut_ThinController(&midi_out, 0, MIDI_CC_VOLUME, 3);
+ *
+ *   MidiOut_Send(&midi_out, &msg);              // Any context
+ *   MidiOut_ControlChange(&midi_out, 0, MIDI_CC_VOLUME, v, ticks);
+ *   MidiOut_Write(&midi_out, frame, length);
+ *   MidiOut_FlushControllers(&midi_out, ticks); // Per block
+ *   MidiOut_Poll(&midi_out);                    // Main loop / per block
+ */
+
+#ifndef MIDI_OUT_H_
+#define MIDI_OUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "midi_msg.h"
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef MIDI_OUT_RING_SIZE
+#define MIDI_OUT_RING_SIZE 256     // Bytes, power of two (2.8 ms at 921600)
+#endif
+
+#ifndef MIDI_OUT_RUNNING_STATUS
+#define MIDI_OUT_RUNNING_STATUS 1  // Leave out repeated status bytes
+#endif
+
+#ifndef MIDI_OUT_NOTE_OFF_AS_ON
+#define MIDI_OUT_NOTE_OFF_AS_ON 1  // Note Off (velocity 64) as Note On, 0
+#endif
+
+#define MIDI_OUT_CC_SLOTS 4        // Thinned controllers
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Transmit hardware (DMA channel to the UART TX register)
+ */
+typedef struct {
+    bool (*busy)(void);                             ///< Transfer in progress
+    void (*start)(const uint8_t *data, uint16_t n); ///< Begin a transfer
+} MidiOutPort_t;
+
+/**
+ * @brief One rate-limited controller
+ */
+typedef struct {
+    uint8_t status;            ///< 0xB0 | channel
+    uint8_t controller;
+    uint8_t sent;              ///< Last value sent
+    uint8_t value;             ///< Latest value (last wins)
+    bool pending;              ///< value not sent yet
+    bool ever_sent;
+    uint16_t interval;         ///< Ticks between messages
+    uint32_t last_time;        ///< Tick of the last message
+} MidiCcSlot_t;
+
+typedef struct {
+    uint8_t ring[MIDI_OUT_RING_SIZE];
+    volatile uint16_t head;       ///< Next byte to write (writers)
+    volatile uint16_t tail;       ///< Oldest byte not yet sent
+    volatile uint16_t in_flight;  ///< Bytes in the current transfer
+    volatile uint16_t dropped;    ///< Writes refused, ring full
+    uint16_t peak;                ///< Most bytes queued at once
+    uint8_t running_status;       ///< Status the receiver holds, 0 = none
+    uint8_t cc_slots;
+    MidiCcSlot_t cc[MIDI_OUT_CC_SLOTS];
+    uint32_t bytes_saved;         ///< Status bytes left out
+    uint32_t cc_coalesced;        ///< Controller updates never sent
+    MidiOutPort_t port;
+} MidiOut_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Empty the queue and take the port (copied)
+ */
+void MidiOut_Init(MidiOut_t *out, const MidiOutPort_t *port);
+
+/**
+ * @brief Queue raw bytes, e.g. a SysEx frame (any context, never waits)
+ * @return false if they did not fit (nothing is queued)
+ */
+bool MidiOut_Write(MidiOut_t *out, const uint8_t *data, uint16_t n);
+
+/**
+ * @brief Queue one channel message, compressed (any context)
+ * @return false if it did not fit
+ */
+bool MidiOut_Send(MidiOut_t *out, const MIDI_Message_t *msg);
+
+/**
+ * @brief Rate-limit a controller
+ * @param interval Minimum ticks between two messages for it
+ * @return false if all MIDI_OUT_CC_SLOTS are taken
+ */
+bool MidiOut_ThinController(MidiOut_t *out, uint8_t channel,
+                            uint8_t controller, uint16_t interval);
+
+/**
+ * @brief Send a controller value (thinned if registered, else at once)
+ * @param now Clock in the units of the intervals
+ */
+void MidiOut_ControlChange(MidiOut_t *out, uint8_t channel, uint8_t controller,
+                           uint8_t value, uint32_t now);
+
+/**
+ * @brief Send thinned controllers whose interval is up
+ */
+void MidiOut_FlushControllers(MidiOut_t *out, uint32_t now);
+
+/**
+ * @brief Bytes a write can take now
+ */
+uint16_t MidiOut_Free(const MidiOut_t *out);
+
+/**
+ * @brief Retire a finished transfer and start the next span
+ */
+void MidiOut_Poll(MidiOut_t *out);
+
+#endif /* MIDI_OUT_H_ */
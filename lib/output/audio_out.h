@@ -0,0 +1,174 @@
+/**
+ * @file audio_out.h
+ * @brief Audio Output Backend Interface
+ * @version 1.0.0
+ *
+ * One interface for every place rendered audio can go. The renderer hands
+ * each backend the 16-bit mix (limiter output); the backend converts it to
+ * its own format (DAC12 codes, PWM compare values, PCM bytes, WAV frames).
+ *
+ * Backends:
+ *   AUDIO_OUT_DAC12  DAC12 FIFO + DMA, hardware sample clock (simulated on Linux)
+ *   AUDIO_OUT_PWM    Timer PWM compare, one sample per sample-timer tick
+ *   AUDIO_OUT_UART   16-bit PCM over UART_AUDIO by DMA (uart_audio_player.py)
+ *   AUDIO_OUT_WAV    WAV file (Linux only)
+ *
+ * The backend is chosen at build time with AUDIO_OUT_BACKEND; AUDIO_OUT is
+ * the selected one.
+ *
+ * Usage:
+ *   static void on_space(void *user) { SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; }
+ *
+ *   AudioOutConfig_t cfg = {16000, 32, on_space, NULL, Cycles_Now, NULL};
+ *   AUDIO_OUT.open(&cfg);
+ *
+ *   // PendSV: render, then
+ *   AUDIO_OUT.submit_block(mix, 32);
+ *
+ *   // Backend clock interrupt (DAC0 for DAC12, TIMG7 otherwise):
+ *   AUDIO_OUT.service();
+ */
+
+#ifndef AUDIO_OUT_H_
+#define AUDIO_OUT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__linux__) && !defined(AUDIO_OUT_SIM)
+#define AUDIO_OUT_SIM 1
+#endif
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define AUDIO_BACKEND_DAC12 1
+#define AUDIO_BACKEND_PWM   2
+#define AUDIO_BACKEND_UART  3
+#define AUDIO_BACKEND_WAV   4
+
+#ifndef AUDIO_OUT_BACKEND
+#if AUDIO_OUT_SIM
+#define AUDIO_OUT_BACKEND AUDIO_BACKEND_WAV
+#else
+#define AUDIO_OUT_BACKEND AUDIO_BACKEND_DAC12
+#endif
+#endif
+
+#define AUDIO_OUT_BLOCK_MAX 64
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief Called when submit_block() has room (may run in an interrupt)
+ */
+typedef void (*AudioOutNotify_t)(void *user);
+
+/**
+ * @brief Backend settings
+ */
+typedef struct {
+    uint16_t sample_rate;          ///< Hz
+    uint16_t block_size;           ///< Samples per submit_block()
+    AudioOutNotify_t on_space;     ///< Renderer wake-up (NULL = poll)
+    void *user;                    ///< Passed to on_space
+    uint32_t (*clock)(void);       ///< Cycle counter for stats (may be NULL)
+    const char *path;              ///< Output file (WAV backend)
+} AudioOutConfig_t;
+
+/**
+ * @brief Throughput counters
+ */
+typedef struct {
+    uint32_t blocks;               ///< Blocks accepted
+    uint32_t samples;              ///< Samples accepted
+    uint32_t dropped;              ///< Blocks rejected or underruns
+    uint32_t bytes;                ///< Bytes written to the device or file
+    uint32_t cycles;               ///< Cycles in submit_block(), total
+    uint32_t cycles_max;           ///< Worst submit_block()
+} AudioOutStats_t;
+
+/**
+ * @brief Backend operations
+ */
+typedef struct {
+    const char *name;
+    bool (*open)(const AudioOutConfig_t *cfg);                 ///< Start output
+    bool (*submit_block)(const int16_t *mix, uint16_t n);      ///< false = no room
+    void (*mute)(bool mute);                                   ///< Output silence
+    void (*stats)(AudioOutStats_t *stats);                     ///< Read counters
+    void (*close)(void);                                       ///< Stop output
+    void (*service)(void);                                     ///< Clock interrupt
+} AudioOutBackend_t;
+
+//=============================================================================
+// BACKENDS
+//=============================================================================
+extern const AudioOutBackend_t AUDIO_OUT_DAC12;
+#if AUDIO_OUT_SIM
+extern const AudioOutBackend_t AUDIO_OUT_WAV;
+#else
+extern const AudioOutBackend_t AUDIO_OUT_PWM;
+extern const AudioOutBackend_t AUDIO_OUT_UART;
+#endif
+
+#if AUDIO_OUT_BACKEND == AUDIO_BACKEND_DAC12
+#define AUDIO_OUT AUDIO_OUT_DAC12
+#elif AUDIO_OUT_BACKEND == AUDIO_BACKEND_PWM
+#define AUDIO_OUT AUDIO_OUT_PWM
+#elif AUDIO_OUT_BACKEND == AUDIO_BACKEND_UART
+#define AUDIO_OUT AUDIO_OUT_UART
+#elif AUDIO_OUT_BACKEND == AUDIO_BACKEND_WAV
+#define AUDIO_OUT AUDIO_OUT_WAV
+#else
+#error "Unknown AUDIO_OUT_BACKEND"
+#endif
+
+#if AUDIO_OUT_SIM
+/**
+ * @brief Simulated DAC12 hardware (Linux): receive the played DAC codes
+ */
+void AudioOutDac12_SimSetSink(void (*sink)(void *ctx, const uint16_t *codes,
+                                           uint16_t n),
+                              void *ctx);
+
+/**
+ * @brief Simulated DAC12 hardware (Linux): play samples
+ * @return Samples played (stops early, after on_space, when a block frees)
+ */
+uint32_t AudioOutDac12_SimRun(uint32_t samples);
+#endif
+
+//=============================================================================
+// HELPERS FOR BACKENDS
+//=============================================================================
+
+/**
+ * @brief Start timing a submit_block() call
+ */
+static inline uint32_t AudioOut_StatsBegin(const AudioOutConfig_t *cfg) {
+    return (cfg && cfg->clock) ? cfg->clock() : 0;
+}
+
+/**
+ * @brief Account one submit_block() call
+ */
+static inline void AudioOut_StatsEnd(const AudioOutConfig_t *cfg,
+                                     AudioOutStats_t *stats, uint32_t start,
+                                     uint16_t n, bool accepted) {
+    if (accepted) {
+        stats->blocks++;
+        stats->samples += n;
+    } else {
+        stats->dropped++;
+    }
+    if (cfg && cfg->clock) {
+        uint32_t spent = cfg->clock() - start;
+        stats->cycles += spent;
+        if (spent > stats->cycles_max) stats->cycles_max = spent;
+    }
+}
+
+#endif /* AUDIO_OUT_H_ */
@@ -0,0 +1,139 @@
+/**
+ * @file audio_out_dac12.c
+ * @brief DAC12 Output Backend (FIFO + DMA, dithered 12-bit codes)
+ */
+
+#include "audio_out.h"
+#include "dac12_dma.h"
+#include "../audio/audio_dac.h"
+#include <string.h>
+
+#ifndef AUDIO_OUT_OPA_GAIN
+#define AUDIO_OUT_OPA_GAIN 2   // OPA after the DAC runs at 2x gain
+#endif
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+static DacDma_t dac_out;
+static DacStage_t dac_stage;
+static AudioOutConfig_t config;
+static AudioOutStats_t stats;
+static volatile bool muted;
+#if DAC12_DMA_SIM
+static DacDmaSink_t sim_sink;
+static void *sim_sink_ctx;
+#endif
+
+static void fill_silence(uint16_t *block, uint16_t n) {
+    for (uint16_t i = 0; i < n; i++) {
+        block[i] = DAC12_MIDPOINT;
+    }
+}
+
+//=============================================================================
+// BACKEND OPERATIONS
+//=============================================================================
+
+static bool dac12_open(const AudioOutConfig_t *cfg) {
+    config = *cfg;
+    memset(&stats, 0, sizeof(stats));
+    muted = false;
+
+    DacStage_Init(&dac_stage, AUDIO_OUT_OPA_GAIN, DAC_SHAPE_2ND_ORDER);
+
+    // The DAC sample time generator has fixed rates; anything else is
+    // clocked by the sample timer's event
+    DacDma_Init(&dac_out, cfg->block_size,
+                (cfg->sample_rate == 16000) ? DAC_DMA_TRIG_SAMPLE_TIMER
+                                            : DAC_DMA_TRIG_EVENT);
+#if DAC12_DMA_SIM
+    DacDma_SimSetSink(&dac_out, sim_sink, sim_sink_ctx);
+#endif
+
+    // Start on two silent blocks; the renderer takes over after the first
+    for (uint8_t b = 0; b < 2; b++) {
+        fill_silence(DacDma_GetFreeBlock(&dac_out), dac_out.block_size);
+        DacDma_CommitBlock(&dac_out);
+    }
+    DacDma_Start(&dac_out);
+    return true;
+}
+
+static bool dac12_submit_block(const int16_t *mix, uint16_t n) {
+    uint32_t start = AudioOut_StatsBegin(&config);
+    uint16_t *block = DacDma_GetFreeBlock(&dac_out);
+
+    if (block != NULL) {
+        if (n > dac_out.block_size) n = dac_out.block_size;
+        if (muted) {
+            fill_silence(block, n);
+        } else {
+            DacStage_ProcessBlock(&dac_stage, mix, block, n);
+        }
+        fill_silence(block + n, dac_out.block_size - n);
+        DacDma_CommitBlock(&dac_out);
+        stats.bytes += (uint32_t)dac_out.block_size * 2;
+    }
+
+    AudioOut_StatsEnd(&config, &stats, start, n, block != NULL);
+    return block != NULL;
+}
+
+static void dac12_mute(bool mute) {
+    muted = mute;
+    if (mute) DacStage_Reset(&dac_stage);
+}
+
+static void dac12_stats(AudioOutStats_t *out) {
+    *out = stats;
+    out->dropped += dac_out.underruns;
+}
+
+static void dac12_close(void) {
+    DacDma_Stop(&dac_out);
+}
+
+static void dac12_service(void) {
+#if DAC12_DMA_SIM
+    // Simulated block-done interrupts come from AudioOutDac12_SimRun()
+#else
+    if (DacDma_IRQHandler(&dac_out) && config.on_space) {
+        config.on_space(config.user);
+    }
+#endif
+}
+
+const AudioOutBackend_t AUDIO_OUT_DAC12 = {
+    "DAC12", dac12_open, dac12_submit_block, dac12_mute, dac12_stats,
+    dac12_close, dac12_service
+};
+
+//=============================================================================
+// SIMULATION
+//=============================================================================
+#if DAC12_DMA_SIM
+
+void AudioOutDac12_SimSetSink(void (*sink)(void *ctx, const uint16_t *codes,
+                                           uint16_t n),
+                              void *ctx) {
+    sim_sink = sink;
+    sim_sink_ctx = ctx;
+    DacDma_SimSetSink(&dac_out, sink, ctx);
+}
+
+uint32_t AudioOutDac12_SimRun(uint32_t samples) {
+    uint32_t played = 0;
+
+    while (played < samples && dac_out.running) {
+        played += DacDma_SimRun(&dac_out, samples - played);
+        if (DacDma_GetFreeBlock(&dac_out) != NULL) {
+            // Let the caller render before more time passes
+            if (config.on_space) config.on_space(config.user);
+            break;
+        }
+    }
+    return played;
+}
+
+#endif
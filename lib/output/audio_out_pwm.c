@@ -0,0 +1,132 @@
+/**
+ * @file audio_out_pwm.c
+ * @brief Timer PWM Output Backend (one compare value per sample tick)
+ *
+ * Needs a PWM timer named PWM_AUDIO in SysConfig (edge-aligned, period
+ * 4096 timer clocks, output on CC0) followed by an RC low-pass. The sample
+ * timer interrupt calls service(), which loads the next compare value.
+ */
+
+#include "audio_out.h"
+
+#if !AUDIO_OUT_SIM
+
+#include "ti_msp_dl_config.h"
+#include <string.h>
+
+#if AUDIO_OUT_BACKEND == AUDIO_BACKEND_PWM && !defined(PWM_AUDIO_INST)
+#error "AUDIO_BACKEND_PWM needs a PWM_AUDIO timer in SysConfig"
+#endif
+
+#define PWM_OUT_PERIOD   4096
+#define PWM_OUT_MIDPOINT (PWM_OUT_PERIOD / 2)
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+static uint16_t blocks[2][AUDIO_OUT_BLOCK_MAX];  // Ping-pong compare values
+static volatile bool ready[2];
+static volatile uint8_t write_block;
+static volatile uint8_t read_block;
+static volatile uint16_t read_pos;
+static AudioOutConfig_t config;
+static AudioOutStats_t stats;
+static volatile bool muted;
+static volatile bool started;                    // First block submitted
+
+//=============================================================================
+// BACKEND OPERATIONS
+//=============================================================================
+
+static bool pwm_open(const AudioOutConfig_t *cfg) {
+    config = *cfg;
+    if (config.block_size > AUDIO_OUT_BLOCK_MAX) {
+        config.block_size = AUDIO_OUT_BLOCK_MAX;
+    }
+    memset(&stats, 0, sizeof(stats));
+    ready[0] = ready[1] = false;
+    write_block = read_block = 0;
+    read_pos = 0;
+    muted = false;
+    started = false;
+#ifdef PWM_AUDIO_INST
+    DL_TimerG_setCaptureCompareValue(PWM_AUDIO_INST, PWM_OUT_MIDPOINT,
+                                     DL_TIMER_CC_0_INDEX);
+    DL_TimerG_startCounter(PWM_AUDIO_INST);
+#endif
+    return true;
+}
+
+static bool pwm_submit_block(const int16_t *mix, uint16_t n) {
+    uint32_t start = AudioOut_StatsBegin(&config);
+    uint8_t b = write_block;
+    bool accepted = !ready[b];
+
+    if (accepted) {
+        if (n > config.block_size) n = config.block_size;
+        for (uint16_t i = 0; i < config.block_size; i++) {
+            int32_t v = PWM_OUT_MIDPOINT;
+            if (i < n && !muted) v += mix[i] >> 4;
+            if (v < 0) v = 0;
+            if (v > PWM_OUT_PERIOD - 1) v = PWM_OUT_PERIOD - 1;
+            blocks[b][i] = (uint16_t)v;
+        }
+        ready[b] = true;
+        started = true;
+        write_block = b ^ 1;
+        stats.bytes += (uint32_t)config.block_size * 2;
+    }
+
+    AudioOut_StatsEnd(&config, &stats, start, n, accepted);
+    return accepted;
+}
+
+static void pwm_mute(bool mute) {
+    muted = mute;
+}
+
+static void pwm_stats(AudioOutStats_t *out) {
+    *out = stats;
+}
+
+static void pwm_close(void) {
+#ifdef PWM_AUDIO_INST
+    DL_TimerG_setCaptureCompareValue(PWM_AUDIO_INST, PWM_OUT_MIDPOINT,
+                                     DL_TIMER_CC_0_INDEX);
+#endif
+}
+
+/**
+ * Sample tick: load one compare value, release the block at its end.
+ * A missing block holds the midpoint and counts one underrun per block,
+ * except before the first one: the output idles at the midpoint until the
+ * renderer answers the first on_space.
+ */
+static void pwm_service(void) {
+    uint8_t b = read_block;
+    uint16_t v = ready[b] ? blocks[b][read_pos] : PWM_OUT_MIDPOINT;
+
+#ifdef PWM_AUDIO_INST
+    DL_TimerG_setCaptureCompareValue(PWM_AUDIO_INST, v, DL_TIMER_CC_0_INDEX);
+#else
+    (void)v;
+#endif
+
+    if (++read_pos < config.block_size) return;
+    read_pos = 0;
+
+    if (ready[b]) {
+        ready[b] = false;
+        read_block = b ^ 1;
+    } else if (started) {
+        stats.dropped++;
+    }
+    if (config.on_space) config.on_space(config.user);
+}
+
+const AudioOutBackend_t AUDIO_OUT_PWM = {
+    "PWM", pwm_open, pwm_submit_block, pwm_mute, pwm_stats, pwm_close,
+    pwm_service
+};
+
+#endif /* !AUDIO_OUT_SIM */
@@ -0,0 +1,108 @@
+/**
+ * @file audio_out_uart.c
+ * @brief UART PCM Output Backend (16-bit little-endian over UART_AUDIO)
+ *
+ * Each block is decimated (boxcar average) to sample_rate /
+ * UART_PCM_DECIMATION and sent by DMA_CH1, the UART_AUDIO TX channel, as
+ * raw int16 LE. uart_audio_player.py plays it in RAW AUDIO mode (4 kHz by
+ * default). UART_AUDIO also carries MIDI, so the two are exclusive.
+ */
+
+#include "audio_out.h"
+
+#if !AUDIO_OUT_SIM
+
+#include "ti_msp_dl_config.h"
+#include <string.h>
+
+#ifndef UART_PCM_DECIMATION
+#define UART_PCM_DECIMATION 4   // 16 kHz -> 4 kHz (player default)
+#endif
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+static uint8_t tx_buf[(AUDIO_OUT_BLOCK_MAX / UART_PCM_DECIMATION) * 2];
+static AudioOutConfig_t config;
+static AudioOutStats_t stats;
+static volatile uint16_t tick;
+static volatile bool muted;
+
+//=============================================================================
+// BACKEND OPERATIONS
+//=============================================================================
+
+static bool uart_open(const AudioOutConfig_t *cfg) {
+    config = *cfg;
+    if (config.block_size > AUDIO_OUT_BLOCK_MAX) {
+        config.block_size = AUDIO_OUT_BLOCK_MAX;
+    }
+    memset(&stats, 0, sizeof(stats));
+    tick = 0;
+    muted = false;
+
+    // SysConfig sets DMA_CH1 to repeat; one block per enable here
+    DL_DMA_disableChannel(DMA, DMA_CH1_CHAN_ID);
+    DL_DMA_setTransferMode(DMA, DMA_CH1_CHAN_ID, DL_DMA_SINGLE_TRANSFER_MODE);
+    DL_DMA_setDestAddr(DMA, DMA_CH1_CHAN_ID, (uint32_t)&UART_AUDIO_INST->TXDATA);
+    return true;
+}
+
+static bool uart_submit_block(const int16_t *mix, uint16_t n) {
+    uint32_t start = AudioOut_StatsBegin(&config);
+    // Single mode disables the channel when the last byte is taken
+    bool accepted = !DL_DMA_isChannelEnabled(DMA, DMA_CH1_CHAN_ID);
+
+    if (accepted) {
+        uint16_t frames = n / UART_PCM_DECIMATION;
+        uint8_t *p = tx_buf;
+
+        if (frames > sizeof(tx_buf) / 2) frames = sizeof(tx_buf) / 2;
+        for (uint16_t f = 0; f < frames; f++) {
+            int32_t sum = 0;
+            for (uint16_t k = 0; k < UART_PCM_DECIMATION; k++) {
+                sum += mix[f * UART_PCM_DECIMATION + k];
+            }
+            int16_t s = muted ? 0 : (int16_t)(sum / UART_PCM_DECIMATION);
+            *p++ = (uint8_t)s;
+            *p++ = (uint8_t)((uint16_t)s >> 8);
+        }
+
+        DL_DMA_setSrcAddr(DMA, DMA_CH1_CHAN_ID, (uint32_t)tx_buf);
+        DL_DMA_setTransferSize(DMA, DMA_CH1_CHAN_ID, frames * 2);
+        DL_DMA_enableChannel(DMA, DMA_CH1_CHAN_ID);
+        stats.bytes += frames * 2;
+    }
+
+    AudioOut_StatsEnd(&config, &stats, start, n, accepted);
+    return accepted;
+}
+
+static void uart_mute(bool mute) {
+    muted = mute;
+}
+
+static void uart_stats(AudioOutStats_t *out) {
+    *out = stats;
+}
+
+static void uart_close(void) {
+    DL_DMA_disableChannel(DMA, DMA_CH1_CHAN_ID);
+}
+
+/**
+ * Sample tick: the UART has no sample clock of its own, so the sample
+ * timer paces rendering and asks for a block every block_size ticks.
+ */
+static void uart_service(void) {
+    if (++tick < config.block_size) return;
+    tick = 0;
+    if (config.on_space) config.on_space(config.user);
+}
+
+const AudioOutBackend_t AUDIO_OUT_UART = {
+    "UART", uart_open, uart_submit_block, uart_mute, uart_stats, uart_close,
+    uart_service
+};
+
+#endif /* !AUDIO_OUT_SIM */
@@ -0,0 +1,106 @@
+/**
+ * @file audio_out_wav.c
+ * @brief WAV File Output Backend (Linux host builds)
+ *
+ * Writes mono 16-bit PCM. The RIFF and data sizes are patched in close().
+ */
+
+#include "audio_out.h"
+
+#if AUDIO_OUT_SIM
+
+#include <stdio.h>
+#include <string.h>
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+static FILE *wav;
+static AudioOutConfig_t config;
+static AudioOutStats_t stats;
+static bool muted;
+
+static void put_le(uint8_t *p, uint32_t v, uint8_t bytes) {
+    for (uint8_t i = 0; i < bytes; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void write_header(uint32_t data_bytes) {
+    uint8_t h[44];
+
+    memcpy(h, "RIFF", 4);
+    put_le(h + 4, 36 + data_bytes, 4);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put_le(h + 16, 16, 4);                        // fmt chunk size
+    put_le(h + 20, 1, 2);                         // PCM
+    put_le(h + 22, 1, 2);                         // Mono
+    put_le(h + 24, config.sample_rate, 4);
+    put_le(h + 28, config.sample_rate * 2u, 4);   // Byte rate
+    put_le(h + 32, 2, 2);                         // Block align
+    put_le(h + 34, 16, 2);                        // Bits per sample
+    memcpy(h + 36, "data", 4);
+    put_le(h + 40, data_bytes, 4);
+    fwrite(h, 1, sizeof(h), wav);
+}
+
+//=============================================================================
+// BACKEND OPERATIONS
+//=============================================================================
+
+static bool wav_open(const AudioOutConfig_t *cfg) {
+    config = *cfg;
+    memset(&stats, 0, sizeof(stats));
+    muted = false;
+
+    wav = fopen(cfg->path ? cfg->path : "out.wav", "wb");
+    if (wav == NULL) return false;
+    write_header(0);
+    return true;
+}
+
+static bool wav_submit_block(const int16_t *mix, uint16_t n) {
+    uint32_t start = AudioOut_StatsBegin(&config);
+    uint8_t frame[AUDIO_OUT_BLOCK_MAX * 2];
+
+    if (wav == NULL) {
+        AudioOut_StatsEnd(&config, &stats, start, n, false);
+        return false;
+    }
+    if (n > AUDIO_OUT_BLOCK_MAX) n = AUDIO_OUT_BLOCK_MAX;
+    for (uint16_t i = 0; i < n; i++) {
+        put_le(frame + 2 * i, muted ? 0 : (uint16_t)mix[i], 2);
+    }
+    fwrite(frame, 2, n, wav);
+    stats.bytes += n * 2u;
+
+    AudioOut_StatsEnd(&config, &stats, start, n, true);
+    return true;
+}
+
+static void wav_mute(bool mute) {
+    muted = mute;
+}
+
+static void wav_stats(AudioOutStats_t *out) {
+    *out = stats;
+}
+
+static void wav_close(void) {
+    if (wav == NULL) return;
+    fseek(wav, 0, SEEK_SET);
+    write_header(stats.bytes);
+    fclose(wav);
+    wav = NULL;
+}
+
+static void wav_service(void) {
+    // A file is never full: the caller renders as fast as it likes
+}
+
+const AudioOutBackend_t AUDIO_OUT_WAV = {
+    "WAV", wav_open, wav_submit_block, wav_mute, wav_stats, wav_close,
+    wav_service
+};
+
+#endif /* AUDIO_OUT_SIM */
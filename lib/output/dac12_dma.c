@@ -0,0 +1,220 @@
+/**
+ * @file dac12_dma.c
+ * @brief Hardware-Paced DAC12 Output Implementation
+ */
+
+#include "dac12_dma.h"
+#include <stddef.h>
+#include <string.h>
+
+#if !DAC12_DMA_SIM
+#include "ti_msp_dl_config.h"
+
+#ifndef DAC_DMA_TRIGGER
+#define DAC_DMA_TRIGGER DMA_DAC0_EVT_BD_1_TRIG
+#endif
+#endif
+
+//=============================================================================
+// INTERNAL STATE
+//=============================================================================
+
+#define BLOCK_NONE 0xFF
+
+// Played whenever the renderer has not delivered the next block
+static uint16_t silence[DAC_DMA_BLOCK_MAX];
+
+//=============================================================================
+// HARDWARE ACCESS
+//=============================================================================
+
+#if DAC12_DMA_SIM
+
+static void dma_queue(DacDma_t *out, const uint16_t *src) {
+    out->sim_src = src;
+}
+
+static void hw_init(DacDmaTrigger_t trigger) {
+    (void)trigger;
+}
+
+static void hw_start(void) {}
+static void hw_stop(void) {}
+
+#else
+
+static void dma_queue(DacDma_t *out, const uint16_t *src) {
+    DL_DMA_setSrcAddr(DMA, DAC_DMA_CHAN_ID, (uint32_t)src);
+    DL_DMA_setTransferSize(DMA, DAC_DMA_CHAN_ID, out->block_size);
+    DL_DMA_enableChannel(DMA, DAC_DMA_CHAN_ID);
+}
+
+static void hw_init(DacDmaTrigger_t trigger) {
+    // One 12-bit code per FIFO request, fixed destination
+    static const DL_DMA_Config dma_config = {
+        .trigger = DAC_DMA_TRIGGER,
+        .triggerType = DL_DMA_TRIGGER_TYPE_EXTERNAL,
+        .transferMode = DL_DMA_SINGLE_TRANSFER_MODE,
+        .extendedMode = DL_DMA_NORMAL_MODE,
+        .srcWidth = DL_DMA_WIDTH_HALF_WORD,
+        .destWidth = DL_DMA_WIDTH_HALF_WORD,
+        .srcIncrement = DL_DMA_ADDR_INCREMENT,
+        .destIncrement = DL_DMA_ADDR_UNCHANGED,
+    };
+
+    DL_DAC12_disable(DAC0);
+    DL_DMA_disableChannel(DMA, DAC_DMA_CHAN_ID);
+    DL_DMA_initChannel(DMA, DAC_DMA_CHAN_ID, &dma_config);
+    DL_DMA_setDestAddr(DMA, DAC_DMA_CHAN_ID, (uint32_t)&DAC0->DATA0);
+
+    DL_DAC12_enableFIFO(DAC0);
+    DL_DAC12_setFIFOThreshold(DAC0, DL_DAC12_FIFO_THRESHOLD_TWO_QTRS_EMPTY);
+
+    if (trigger == DAC_DMA_TRIG_EVENT) {
+        // Sample clock from the timer's event publisher
+        DL_DAC12_disableSampleTimeGenerator(DAC0);
+        DL_DAC12_setSubscriberChanID(DAC0, DL_DAC12_SUBSCRIBER_INDEX_0,
+                                     DAC_DMA_EVENT_CHANNEL);
+        DL_DAC12_setFIFOTriggerSource(DAC0, DL_DAC12_FIFO_TRIGGER_HWTRIG0);
+    } else {
+        DL_DAC12_setSampleRate(DAC0, DL_DAC12_SAMPLES_PER_SECOND_16K);
+        DL_DAC12_setFIFOTriggerSource(DAC0, DL_DAC12_FIFO_TRIGGER_SAMPLETIMER);
+        DL_DAC12_enableSampleTimeGenerator(DAC0);
+    }
+
+    DL_DAC12_enableDMATrigger(DAC0);
+    DL_DAC12_clearInterruptStatus(DAC0, DL_DAC12_INTERRUPT_DMA_DONE);
+    DL_DAC12_enableInterrupt(DAC0, DL_DAC12_INTERRUPT_DMA_DONE);
+}
+
+static void hw_start(void) {
+    DL_DAC12_enable(DAC0);
+}
+
+static void hw_stop(void) {
+    DL_DMA_disableChannel(DMA, DAC_DMA_CHAN_ID);
+    DL_DAC12_disable(DAC0);
+    DL_DAC12_output12(DAC0, DAC_DMA_MIDPOINT);
+}
+
+#endif
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void DacDma_Init(DacDma_t *out, uint16_t block_size, DacDmaTrigger_t trigger) {
+    if (block_size == 0) block_size = 1;
+    if (block_size > DAC_DMA_BLOCK_MAX) block_size = DAC_DMA_BLOCK_MAX;
+
+    memset(out, 0, sizeof(DacDma_t));
+    out->block_size = block_size;
+
+    for (uint16_t i = 0; i < DAC_DMA_BLOCK_MAX; i++) {
+        silence[i] = DAC_DMA_MIDPOINT;
+    }
+    out->owned_block = BLOCK_NONE;
+
+    hw_init(trigger);
+}
+
+void DacDma_Start(DacDma_t *out) {
+    if (out->running) return;
+
+    if (out->ready[out->read_block]) {
+        out->owned_block = out->read_block;
+        out->read_block ^= 1;
+        dma_queue(out, out->blocks[out->owned_block]);
+    } else {
+        out->owned_block = BLOCK_NONE;
+        dma_queue(out, silence);
+    }
+
+    out->running = true;
+    hw_start();
+}
+
+void DacDma_Stop(DacDma_t *out) {
+    out->running = false;
+    hw_stop();
+
+    out->ready[0] = false;
+    out->ready[1] = false;
+    out->write_block = 0;
+    out->read_block = 0;
+    out->owned_block = BLOCK_NONE;
+}
+
+uint16_t *DacDma_GetFreeBlock(DacDma_t *out) {
+    // Ready covers both "queued" and "being played"
+    if (out->ready[out->write_block]) return NULL;
+    return out->blocks[out->write_block];
+}
+
+void DacDma_CommitBlock(DacDma_t *out) {
+    if (out->ready[out->write_block]) return;
+    out->ready[out->write_block] = true;
+    out->write_block ^= 1;
+}
+
+bool DacDma_IRQHandler(DacDma_t *out) {
+#if !DAC12_DMA_SIM
+    if (DL_DAC12_getPendingInterrupt(DAC0) != DL_DAC12_IIDX_DMA_DONE) {
+        return false;
+    }
+#endif
+    if (!out->running) return false;
+
+    // The FIFO still holds a few samples: queue the next block first
+    uint8_t done = out->owned_block;
+    if (out->ready[out->read_block]) {
+        out->owned_block = out->read_block;
+        out->read_block ^= 1;
+        dma_queue(out, out->blocks[out->owned_block]);
+    } else {
+        out->owned_block = BLOCK_NONE;
+        dma_queue(out, silence);
+        out->underruns++;
+    }
+
+    if (done != BLOCK_NONE) {
+        out->ready[done] = false;
+    }
+    out->blocks_played++;
+
+    return !out->ready[out->write_block];
+}
+
+//=============================================================================
+// SIMULATED SINK
+//=============================================================================
+#if DAC12_DMA_SIM
+
+void DacDma_SimSetSink(DacDma_t *out, DacDmaSink_t sink, void *ctx) {
+    out->sink = sink;
+    out->sink_ctx = ctx;
+}
+
+uint32_t DacDma_SimRun(DacDma_t *out, uint32_t samples) {
+    uint32_t played = 0;
+
+    while (played < samples && out->running && out->sim_src != NULL) {
+        uint32_t n = out->block_size - out->sim_pos;
+        if (n > samples - played) n = samples - played;
+
+        if (out->sink) {
+            out->sink(out->sink_ctx, out->sim_src + out->sim_pos, (uint16_t)n);
+        }
+        out->sim_pos += (uint16_t)n;
+        played += n;
+
+        if (out->sim_pos >= out->block_size) {
+            out->sim_pos = 0;
+            if (DacDma_IRQHandler(out)) break;
+        }
+    }
+
+    return played;
+}
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file dac12_dma.h
+ * @brief Hardware-Paced DAC12 Output (FIFO + DMA, Ping-Pong Blocks)
+ * @version 1.0.0
+ *
+ * The DAC12 FIFO is clocked by the DAC sample time generator (or by a timer
+ * event on HWTRIG0), and a DMA channel refills the FIFO from one of two
+ * blocks of DAC codes. Sample timing is set by hardware only; the CPU runs
+ * once per block (DMA done) to queue the next block and hand the finished
+ * one back for rendering.
+ *
+ * If the renderer is late, the DMA plays a block of midpoint codes
+ * (silence) and the underrun is counted. The output never stalls.
+ *
+ * On Linux (or with DAC12_DMA_SIM defined) the DAC, FIFO and DMA are
+ * replaced by a simulated sink: DacDma_SimRun() consumes samples at the
+ * "hardware" rate and passes every played code to a callback.
+ *
+ * Usage:
+ *   static DacDma_t dac_out;
+ *   DacDma_Init(&dac_out, 32, DAC_DMA_TRIG_SAMPLE_TIMER);
+ *   Render(DacDma_GetFreeBlock(&dac_out), 32); DacDma_CommitBlock(&dac_out);
+ *   Render(DacDma_GetFreeBlock(&dac_out), 32); DacDma_CommitBlock(&dac_out);
+ *   DacDma_Start(&dac_out);
+ *
+ *   void DAC0_IRQHandler(void) {
+ *       if (DacDma_IRQHandler(&dac_out)) {
+ *           // A block is free: render into DacDma_GetFreeBlock()
+ *       }
+ *   }
+ */
+
+#ifndef DAC12_DMA_H_
+#define DAC12_DMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__linux__) && !defined(DAC12_DMA_SIM)
+#define DAC12_DMA_SIM 1
+#endif
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DAC_DMA_BLOCK_MAX 64     // Largest block (samples)
+#define DAC_DMA_MIDPOINT  2048   // Code played on underrun
+
+#ifndef DAC_DMA_CHAN_ID
+#define DAC_DMA_CHAN_ID 3        // Free basic DMA channel (0-2 are in use)
+#endif
+
+#ifndef DAC_DMA_EVENT_CHANNEL
+#define DAC_DMA_EVENT_CHANNEL 1  // TIMER_SAMPLE publishes ZERO on channel 1
+#endif
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+
+/**
+ * @brief What clocks samples out of the DAC FIFO
+ */
+typedef enum {
+    DAC_DMA_TRIG_SAMPLE_TIMER = 0, ///< DAC12 sample time generator (16 kSPS)
+    DAC_DMA_TRIG_EVENT             ///< Timer event fabric on HWTRIG0 (TIMG7)
+} DacDmaTrigger_t;
+
+/**
+ * @brief Receives played DAC codes in simulation
+ */
+typedef void (*DacDmaSink_t)(void *ctx, const uint16_t *codes, uint16_t n);
+
+/**
+ * @brief Output driver state
+ */
+typedef struct {
+    uint16_t blocks[2][DAC_DMA_BLOCK_MAX]; ///< Ping-pong DAC codes
+    uint16_t block_size;                   ///< Samples per block
+    volatile bool ready[2];                ///< Block rendered (queued or playing)
+    volatile uint8_t write_block;          ///< Next block to render
+    volatile uint8_t read_block;           ///< Next block to play
+    volatile uint8_t owned_block;          ///< Block the DMA reads (0xFF = silence)
+    volatile bool running;
+    volatile uint32_t blocks_played;       ///< Blocks sent to the DAC
+    volatile uint32_t underruns;           ///< Silence blocks played
+#if DAC12_DMA_SIM
+    const uint16_t *sim_src;               ///< Block the "DMA" reads
+    DacDmaSink_t sink;                     ///< Receives played codes
+    void *sink_ctx;
+    uint16_t sim_pos;                      ///< Sample position in block
+#endif
+} DacDma_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Configure DAC FIFO, trigger and DMA channel (output stays idle)
+ * @param out Pointer to driver state
+ * @param block_size Samples per block (<= DAC_DMA_BLOCK_MAX)
+ * @param trigger Sample clock source
+ */
+void DacDma_Init(DacDma_t *out, uint16_t block_size, DacDmaTrigger_t trigger);
+
+/**
+ * @brief Start playback (fill both blocks first to avoid initial silence)
+ * @param out Pointer to driver state
+ */
+void DacDma_Start(DacDma_t *out);
+
+/**
+ * @brief Stop playback and park the DAC at midpoint
+ * @param out Pointer to driver state
+ */
+void DacDma_Stop(DacDma_t *out);
+
+/**
+ * @brief Get the block the renderer may write
+ * @param out Pointer to driver state
+ * @return Block of block_size codes, or NULL if both blocks are queued
+ */
+uint16_t *DacDma_GetFreeBlock(DacDma_t *out);
+
+/**
+ * @brief Mark the free block as rendered
+ * @param out Pointer to driver state
+ */
+void DacDma_CommitBlock(DacDma_t *out);
+
+/**
+ * @brief Block-done handler (call from DAC0_IRQHandler)
+ * @param out Pointer to driver state
+ * @return true if a block was released for rendering
+ */
+bool DacDma_IRQHandler(DacDma_t *out);
+
+#if DAC12_DMA_SIM
+/**
+ * @brief Attach the simulated sink
+ * @param out Pointer to driver state
+ * @param sink Callback for played codes (may be NULL)
+ * @param ctx Passed to the callback
+ */
+void DacDma_SimSetSink(DacDma_t *out, DacDmaSink_t sink, void *ctx);
+
+/**
+ * @brief Advance simulated hardware time
+ * @param out Pointer to driver state
+ * @param samples Sample periods to play
+ * @return Sample periods actually played
+ *
+ * Runs DacDma_IRQHandler() at every block boundary, like the DMA done
+ * interrupt, and returns early when that released a block so the caller
+ * can render it before continuing.
+ */
+uint32_t DacDma_SimRun(DacDma_t *out, uint32_t samples);
+#endif
+
+#endif /* DAC12_DMA_H_ */
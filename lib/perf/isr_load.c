@@ -0,0 +1,43 @@
+/**
+ * @file isr_load.c
+ * @brief Interrupt Load Monitor Implementation
+ */
+
+#include "isr_load.h"
+#include <string.h>
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void IsrLoad_Init(IsrLoad_t *mon, uint32_t budget_cycles, uint32_t now) {
+    memset(mon, 0, sizeof(*mon));
+    mon->budget = budget_cycles;
+    mon->window_start = now;
+    IsrLoad_Reset(mon);
+}
+
+void IsrLoad_Reset(IsrLoad_t *mon) {
+    mon->min_cycles = UINT32_MAX;
+    mon->max_cycles = 0;
+    mon->overruns = 0;
+}
+
+void IsrLoad_Update(IsrLoad_t *mon, uint32_t now) {
+    uint32_t busy_total = mon->busy_total;
+    uint32_t count_total = mon->count_total;
+    uint32_t busy = busy_total - mon->window_busy;
+    uint32_t count = count_total - mon->window_count;
+    uint32_t elapsed = now - mon->window_start;
+
+    mon->window_busy = busy_total;
+    mon->window_count = count_total;
+    mon->window_start = now;
+
+    mon->avg_cycles = count ? busy / count : 0;
+
+    // busy * 1000 would overflow: scale the window down instead
+    uint32_t per_mille = elapsed / 1000u;
+    uint32_t load = per_mille ? busy / per_mille : 0;
+    mon->load_pct10 = (uint16_t)(load > 1000u ? 1000u : load);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file isr_load.h
+ * @brief Interrupt Load Monitor (cycles per activation, CPU load, overruns)
+ * @version 1.0.0
+ *
+ * The Cortex-M0+ has no DWT cycle counter, so the caller timestamps each
+ * interrupt on entry and exit with a free-running up-counter (TIMG12 at
+ * MCLK on the MSPM0G3507, Cycles_Now() in main.c) and passes the values in.
+ * The module itself touches no hardware and runs unchanged on the host.
+ *
+ * Per monitor:
+ *   min / max   Cycles of one activation since IsrLoad_Reset
+ *   avg         Mean cycles per activation over the last window
+ *   load_pct10  Busy share of the last window, 0.1 % (1000 = 100 %)
+ *   overruns    Activations longer than the budget (missed deadlines)
+ *
+ * Times are gross: an activation that is preempted by a higher-priority
+ * interrupt includes the time spent there. The window totals are read
+ * without locking, so a window can be off by one activation.
+ *
+ * Usage:
+ *   IsrLoad_Init(&render, 32 * 5000, Cycles_Now());  // 32 samples at 16 kHz
+ *
+ *   void PendSV_Handler(void) {
+ *       IsrLoad_Enter(&render, Cycles_Now());
+ *       ...
+ *       IsrLoad_Exit(&render, Cycles_Now());
+ *   }
+ *
+ *   IsrLoad_Update(&render, Cycles_Now());            // every 100 ms
+ *   printf("%u.%u %%\n", render.load_pct10 / 10, render.load_pct10 % 10);
+ */
+
+#ifndef ISR_LOAD_H_
+#define ISR_LOAD_H_
+
+#include <stdint.h>
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    uint32_t budget;           ///< Deadline in cycles per activation
+    uint32_t entry;            ///< Timestamp of the running activation
+
+    // Since IsrLoad_Reset (written by the interrupt)
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t overruns;         ///< Activations longer than budget
+
+    // Running totals (wrap; windows use differences)
+    uint32_t busy_total;
+    uint32_t count_total;
+
+    // Last window (written by IsrLoad_Update)
+    uint32_t window_start;
+    uint32_t window_busy;
+    uint32_t window_count;
+    uint32_t avg_cycles;       ///< Mean cycles per activation
+    uint16_t load_pct10;       ///< Busy share, 0.1 %
+} IsrLoad_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Clear the monitor and open the first window
+ * @param budget_cycles Deadline per activation (e.g. the interrupt period)
+ * @param now Current counter value
+ */
+void IsrLoad_Init(IsrLoad_t *mon, uint32_t budget_cycles, uint32_t now);
+
+/**
+ * @brief Clear min/max and the overrun count (window totals keep running)
+ */
+void IsrLoad_Reset(IsrLoad_t *mon);
+
+/**
+ * @brief Close the current window: compute avg_cycles and load_pct10
+ *
+ * Call from a lower-priority context at a fixed rate (10 Hz in main.c).
+ * Windows must be shorter than one counter wrap (53 s at 80 MHz).
+ */
+void IsrLoad_Update(IsrLoad_t *mon, uint32_t now);
+
+/**
+ * @brief First statement of the interrupt handler
+ */
+static inline void IsrLoad_Enter(IsrLoad_t *mon, uint32_t now) {
+    mon->entry = now;
+}
+
+/**
+ * @brief Last statement of the interrupt handler
+ */
+static inline void IsrLoad_Exit(IsrLoad_t *mon, uint32_t now) {
+    uint32_t cycles = now - mon->entry;   // Wraps correctly
+
+    if (cycles < mon->min_cycles) mon->min_cycles = cycles;
+    if (cycles > mon->max_cycles) mon->max_cycles = cycles;
+    if (cycles > mon->budget) mon->overruns++;
+    mon->busy_total += cycles;
+    mon->count_total++;
+}
+
+#endif /* ISR_LOAD_H_ */
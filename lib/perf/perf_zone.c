@@ -0,0 +1,102 @@
+/**
+ * @file perf_zone.c
+ * @brief Named Cycle-Accounting Zones Implementation
+ */
+
+#include "perf_zone.h"
+
+#if PERF_ENABLE
+
+#include "../midi/midi_msg.h"
+#include <string.h>
+
+//=============================================================================
+// PRIVATE STATE
+//=============================================================================
+#define PERF_ZONE_NAME(id, name) name,
+static const char *const ZONE_NAMES[PERF_ZONE_COUNT] = {
+    PERF_ZONE_LIST(PERF_ZONE_NAME)
+};
+#undef PERF_ZONE_NAME
+
+static uint32_t No_Cycles(void) {
+    return 0;
+}
+
+uint32_t (*perf_cycles)(void) = No_Cycles;
+
+static PerfZone_t zones[PERF_ZONE_COUNT];
+static uint64_t elapsed;       // Cycles up to last_now
+static uint32_t last_now;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void Perf_Init(uint32_t (*cycles)(void)) {
+    perf_cycles = cycles ? cycles : No_Cycles;
+    Perf_Reset();
+}
+
+void Perf_Reset(void) {
+    memset(zones, 0, sizeof(zones));
+    elapsed = 0;
+    last_now = perf_cycles();
+}
+
+void Perf_Update(void) {
+    uint32_t now = perf_cycles();
+    elapsed += now - last_now;
+    last_now = now;
+}
+
+void Perf_Record(PerfZoneId_t zone, uint32_t cycles) {
+    PerfZone_t *z = &zones[zone];
+    z->count++;
+    z->total += cycles;
+    if (cycles > z->max) z->max = cycles;
+}
+
+const PerfZone_t *Perf_GetZone(PerfZoneId_t zone) {
+    return &zones[zone];
+}
+
+void Perf_DumpBegin(PerfDump_t *dump) {
+    Perf_Update();
+    dump->elapsed = elapsed;
+    dump->next = 0;
+}
+
+uint8_t Perf_DumpFrame(PerfDump_t *dump, uint8_t *frame) {
+    uint8_t *p = frame;
+
+    if (dump->next > PERF_ZONE_COUNT) return 0;
+
+    *p++ = MIDI_SYSEX_START;
+    *p++ = MIDI_SYSEX_ID_NONCOMMERCIAL;
+
+    if (dump->next == 0) {
+        *p++ = PERF_REPORT_HEADER;
+        p = MIDI_PackU32(p, (uint32_t)dump->elapsed);
+        p = MIDI_PackU32(p, (uint32_t)(dump->elapsed >> 32));
+        *p++ = PERF_ZONE_COUNT;
+    } else {
+        uint8_t id = dump->next - 1;
+        const PerfZone_t *z = &zones[id];
+        *p++ = PERF_REPORT_ZONE;
+        *p++ = id;
+        p = MIDI_PackU32(p, z->count);
+        p = MIDI_PackU32(p, (uint32_t)z->total);
+        p = MIDI_PackU32(p, (uint32_t)(z->total >> 32));
+        p = MIDI_PackU32(p, z->max);
+        for (const char *c = ZONE_NAMES[id];
+             *c && c < ZONE_NAMES[id] + PERF_NAME_MAX; c++)
+            *p++ = (uint8_t)(*c & 0x7F);
+    }
+    dump->next++;
+
+    *p++ = MIDI_SYSEX_END;
+    return (uint8_t)(p - frame);
+}
+
+#endif /* PERF_ENABLE */
@@ -0,0 +1,149 @@
+/**
+ * @file perf_zone.h
+ * @brief Named Cycle-Accounting Zones (PERF_BEGIN / PERF_END)
+ * @version 1.0.0
+ *
+ * Each zone keeps count, total and max cycles in a fixed table, timed with
+ * the free-running counter passed to Perf_Init (TIMG12 in main.c). Zones
+ * are declared once in PERF_ZONE_LIST. The macros declare a local, so a
+ * zone is scoped to the block it starts in.
+ *
+ * Everything compiles to nothing when PERF_ENABLE is 0: by default in
+ * release builds (NDEBUG) and on the host, where the golden regression
+ * and the benchmarks must measure the code without the hooks.
+ *
+ * The table is read out as SysEx frames, the same way as the profiler
+ * (profiler.h), and tools/host/perf_report.py prints it:
+ *   F0 7D 05 elapsed:u32 elapsed_hi:u32 zones:u7 F7
+ *   F0 7D 06 zone:u7 count:u32 total:u32 total_hi:u32 max:u32 name F7
+ * The name is plain ASCII, so the report does not depend on the host
+ * knowing this list.
+ *
+ * Times are gross (preemption included). A zone entered from two
+ * interrupt levels (Update_Phase_Increment: controls and the renderer)
+ * can lose one update when a record is preempted by another.
+ *
+ * Usage:
+ *   Perf_Init(Cycles_Now);
+ *
+ *   PERF_BEGIN(DISPLAY_UPDATE);
+ *   Display_Update();
+ *   PERF_END(DISPLAY_UPDATE);
+ */
+
+#ifndef PERF_ZONE_H_
+#define PERF_ZONE_H_
+
+#include <stdint.h>
+
+#ifndef PERF_ENABLE
+#if defined(NDEBUG) || defined(__linux__)
+#define PERF_ENABLE 0
+#else
+#define PERF_ENABLE 1
+#endif
+#endif
+
+//=============================================================================
+// ZONES
+//=============================================================================
+#define PERF_ZONE_LIST(X)                                      \
+    X(DISPLAY_UPDATE,   "Display_Update")                      \
+    X(LCD_FILL,         "LCD_FillScreen")                      \
+    X(MUSIC_CONTROLS,   "Process_Musical_Controls")            \
+    X(PHASE_INCREMENT,  "Update_Phase_Increment")              \
+    X(AUDIO_SAMPLE,     "Generate_Audio_Sample")               \
+    X(ADC0_IRQ,         "ADC0_IRQHandler")                     \
+    X(ADC1_IRQ,         "ADC1_IRQHandler")
+
+#define PERF_ZONE_ID(id, name) PERF_ZONE_##id,
+typedef enum {
+    PERF_ZONE_LIST(PERF_ZONE_ID)
+    PERF_ZONE_COUNT
+} PerfZoneId_t;
+#undef PERF_ZONE_ID
+
+// SysEx report IDs (after F0 7D; 02-04 are the profiler's)
+#define PERF_REPORT_HEADER 0x05
+#define PERF_REPORT_ZONE   0x06
+
+#define PERF_NAME_MAX  24
+#define PERF_FRAME_MAX (4 + 4 * 5 + PERF_NAME_MAX + 1)
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    uint32_t count;
+    uint64_t total;            ///< Cycles
+    uint32_t max;              ///< Cycles, longest single pass
+} PerfZone_t;
+
+typedef struct {
+    uint64_t elapsed;          ///< Cycles from Perf_Reset to Perf_DumpBegin
+    uint8_t next;              ///< Next frame (0 = header)
+} PerfDump_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+#if PERF_ENABLE
+
+extern uint32_t (*perf_cycles)(void);
+
+#define PERF_BEGIN(zone) const uint32_t perf_start_##zone = perf_cycles()
+#define PERF_END(zone) \
+    Perf_Record(PERF_ZONE_##zone, perf_cycles() - perf_start_##zone)
+
+/**
+ * @brief Set the cycle counter (up-counting, 32-bit) and clear the table
+ */
+void Perf_Init(uint32_t (*cycles)(void));
+
+/**
+ * @brief Clear the table and restart the elapsed time
+ */
+void Perf_Reset(void);
+
+/**
+ * @brief Extend the elapsed time past the 32-bit counter
+ *
+ * Call at least once per counter wrap (53 s at 80 MHz), from the same
+ * context as Perf_DumpBegin; main.c does it with every display refresh.
+ */
+void Perf_Update(void);
+
+void Perf_Record(PerfZoneId_t zone, uint32_t cycles);
+
+const PerfZone_t *Perf_GetZone(PerfZoneId_t zone);
+
+/**
+ * @brief Start a readout (snapshots the elapsed time)
+ */
+void Perf_DumpBegin(PerfDump_t *dump);
+
+/**
+ * @brief Write the next SysEx frame of the readout
+ * @param frame At least PERF_FRAME_MAX bytes
+ * @return Frame length, 0 when the readout is complete
+ */
+uint8_t Perf_DumpFrame(PerfDump_t *dump, uint8_t *frame);
+
+#else
+
+#define PERF_BEGIN(zone) do { } while (0)
+#define PERF_END(zone) do { } while (0)
+
+static inline void Perf_Init(uint32_t (*cycles)(void)) { (void)cycles; }
+static inline void Perf_Reset(void) { }
+static inline void Perf_Update(void) { }
+static inline void Perf_DumpBegin(PerfDump_t *dump) { (void)dump; }
+static inline uint8_t Perf_DumpFrame(PerfDump_t *dump, uint8_t *frame) {
+    (void)dump;
+    (void)frame;
+    return 0;
+}
+
+#endif /* PERF_ENABLE */
+
+#endif /* PERF_ZONE_H_ */
@@ -0,0 +1,103 @@
+/**
+ * @file profiler.c
+ * @brief Statistical Sampling Profiler Implementation
+ */
+
+#include "profiler.h"
+#include "../midi/midi_msg.h"
+#include <string.h>
+
+//=============================================================================
+// PRIVATE TYPES
+//=============================================================================
+enum {
+    DUMP_BEGIN = 0,
+    DUMP_DATA,
+    DUMP_END,
+    DUMP_DONE
+};
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void Profiler_Init(Profiler_t *prof, uint32_t code_start, uint32_t code_bytes) {
+    memset(prof, 0, sizeof(*prof));
+
+    uint8_t shift = 1;
+    while (((uint32_t)PROFILER_BUCKETS << shift) < code_bytes && shift < 16)
+        shift++;
+
+    prof->base = code_start & ~1u;
+    prof->shift = shift;
+    prof->size = (uint32_t)PROFILER_BUCKETS << shift;
+}
+
+void Profiler_Start(Profiler_t *prof) {
+    prof->running = false;
+    memset(prof->counts, 0, sizeof(prof->counts));
+    prof->samples = 0;
+    prof->outside = 0;
+    prof->saturated = false;
+    prof->running = true;
+}
+
+void Profiler_Stop(Profiler_t *prof) {
+    prof->running = false;
+}
+
+void Profiler_DumpBegin(ProfilerDump_t *dump) {
+    dump->bucket = 0;
+    dump->pairs = 0;
+    dump->stage = DUMP_BEGIN;
+}
+
+uint8_t Profiler_DumpFrame(const Profiler_t *prof, ProfilerDump_t *dump,
+                           uint8_t *frame) {
+    uint8_t *p = frame;
+
+    if (dump->stage == DUMP_DONE) return 0;
+
+    *p++ = MIDI_SYSEX_START;
+    *p++ = MIDI_SYSEX_ID_NONCOMMERCIAL;
+
+    if (dump->stage == DUMP_BEGIN) {
+        *p++ = PROFILER_REPORT_BEGIN;
+        p = MIDI_PackU32(p, prof->base);
+        *p++ = prof->shift;
+        p = MIDI_PackU21(p, PROFILER_BUCKETS);
+        p = MIDI_PackU32(p, prof->samples);
+        p = MIDI_PackU32(p, prof->outside);
+        dump->stage = DUMP_DATA;
+    } else if (dump->stage == DUMP_DATA) {
+        // Up to PROFILER_FRAME_PAIRS non-empty buckets
+        uint8_t pairs = 0;
+        uint16_t i = dump->bucket;
+        while (i < PROFILER_BUCKETS && prof->counts[i] == 0) i++;
+
+        if (i < PROFILER_BUCKETS) {
+            *p++ = PROFILER_REPORT_DATA;
+            for (; i < PROFILER_BUCKETS && pairs < PROFILER_FRAME_PAIRS; i++) {
+                if (prof->counts[i] == 0) continue;
+                p = MIDI_PackU21(p, i);
+                p = MIDI_PackU21(p, prof->counts[i]);
+                pairs++;
+            }
+            dump->bucket = i;
+            dump->pairs += pairs;
+        } else {
+            // Nothing left: this call sends the end frame instead
+            dump->bucket = PROFILER_BUCKETS;
+            dump->stage = DUMP_END;
+        }
+    }
+
+    if (dump->stage == DUMP_END && p == frame + 2) {
+        *p++ = PROFILER_REPORT_END;
+        p = MIDI_PackU21(p, dump->pairs);
+        dump->stage = DUMP_DONE;
+    }
+
+    *p++ = MIDI_SYSEX_END;
+    return (uint8_t)(p - frame);
+}
@@ -0,0 +1,138 @@
+/**
+ * @file profiler.h
+ * @brief Statistical Sampling Profiler (PC histogram + SysEx dump)
+ * @version 1.0.0
+ *
+ * A spare timer interrupt at a rate unrelated to the audio clocks
+ * (TIMG8 at 997 Hz in main.c) reads the PC stacked by the exception entry
+ * and passes it to Profiler_Sample(). The code range is split into
+ * PROFILER_BUCKETS buckets of 2^shift bytes, and each bucket counts the
+ * samples that landed in it. The result is a flat profile of everything
+ * the CPU did, interrupts included, for about 1 cycle per 80000.
+ *
+ * The histogram is read out as MIDI SysEx frames, one per call, so the
+ * dump can share the MIDI UART with the note stream.
+ * tools/host/prof_symbolize.py maps the buckets to functions with the
+ * firmware ELF or linker .map file.
+ *
+ * Frames (all values 7-bit packed, LSB first; see midi_msg.h):
+ *   F0 7D 02 base:u32 shift:u7 buckets:u21 samples:u32 outside:u32 F7
+ *   F0 7D 03 { index:u21 count:u21 } x 1..PROFILER_FRAME_PAIRS F7
+ *   F0 7D 04 pairs:u21 F7
+ * Only non-empty buckets are sent. pairs in the last frame is their
+ * number, so the host can tell if a frame was lost. (Report 01 is the
+ * ISR load telemetry from main.c.)
+ *
+ * Usage:
+ *   static Profiler_t prof;
+ *   Profiler_Init(&prof, 0x00000000, 64 * 1024);   // Flash code range
+ *   Profiler_Start(&prof);
+ *   Profiler_Sample(&prof, stacked_pc);            // Timer ISR
+ *   Profiler_Stop(&prof);
+ *
+ *   ProfilerDump_t dump;
+ *   uint8_t frame[PROFILER_FRAME_MAX];
+ *   Profiler_DumpBegin(&dump);
+ *   while ((n = Profiler_DumpFrame(&prof, &dump, frame)) != 0)
+ *       uart_send(frame, n);
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef PROFILER_BUCKETS
+#define PROFILER_BUCKETS 1024      // 2 KB of counters
+#endif
+
+#define PROFILER_FRAME_PAIRS 4     // Buckets per data frame (28 bytes)
+
+// SysEx report IDs (after F0 7D)
+#define PROFILER_REPORT_BEGIN 0x02
+#define PROFILER_REPORT_DATA  0x03
+#define PROFILER_REPORT_END   0x04
+
+// Largest frame: a full data frame (the begin frame is 23 bytes)
+#define PROFILER_FRAME_MAX (3 + PROFILER_FRAME_PAIRS * 6 + 1)
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    uint16_t counts[PROFILER_BUCKETS];
+    uint32_t base;             ///< First profiled address
+    uint32_t size;             ///< Bytes covered (buckets << shift)
+    uint8_t shift;             ///< log2(bytes per bucket)
+    uint32_t samples;          ///< Samples inside [base, base + size)
+    uint32_t outside;          ///< Samples elsewhere (ROM, SRAM)
+    volatile bool running;
+    bool saturated;            ///< Stopped: a bucket reached 65535
+} Profiler_t;
+
+typedef struct {
+    uint16_t bucket;           ///< Next bucket to scan
+    uint16_t pairs;            ///< Non-empty buckets sent
+    uint8_t stage;             ///< Begin, data, end, done
+} ProfilerDump_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Set the code range and clear the histogram (not running)
+ *
+ * The bucket size is the smallest power of two (at least 2 bytes, one
+ * Thumb instruction) that covers code_bytes with PROFILER_BUCKETS.
+ */
+void Profiler_Init(Profiler_t *prof, uint32_t code_start, uint32_t code_bytes);
+
+/**
+ * @brief Clear the histogram and start counting
+ */
+void Profiler_Start(Profiler_t *prof);
+
+void Profiler_Stop(Profiler_t *prof);
+
+/**
+ * @brief Count one sample (from the timer interrupt)
+ * @param pc PC stacked by the exception entry
+ */
+static inline void Profiler_Sample(Profiler_t *prof, uint32_t pc) {
+    if (!prof->running) return;
+
+    uint32_t offset = (pc & ~1u) - prof->base;   // Below base wraps high
+    if (offset >= prof->size) {
+        prof->outside++;
+        return;
+    }
+    uint16_t *count = &prof->counts[offset >> prof->shift];
+    if (*count == UINT16_MAX) {
+        // Keep the ratios intact rather than clip the hottest bucket
+        prof->running = false;
+        prof->saturated = true;
+        return;
+    }
+    (*count)++;
+    prof->samples++;
+}
+
+/**
+ * @brief Start a readout (stop the profiler first)
+ */
+void Profiler_DumpBegin(ProfilerDump_t *dump);
+
+/**
+ * @brief Write the next SysEx frame of the readout
+ * @param frame At least PROFILER_FRAME_MAX bytes
+ * @return Frame length, 0 when the readout is complete
+ */
+uint8_t Profiler_DumpFrame(const Profiler_t *prof, ProfilerDump_t *dump,
+                           uint8_t *frame);
+
+#endif /* PROFILER_H_ */
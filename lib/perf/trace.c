@@ -0,0 +1,77 @@
+/**
+ * @file trace.c
+ * @brief Event Trace Ring Implementation
+ */
+
+#include "trace.h"
+
+#if TRACE_ENABLE
+
+#include "../midi/midi_msg.h"
+
+//=============================================================================
+// PRIVATE STATE
+//=============================================================================
+static uint32_t No_Clock(void) {
+    return 0;
+}
+
+TraceRing_t trace_ring;
+uint32_t (*trace_clock)(void) = No_Clock;
+
+static uint16_t peeked;      // Records in the last peeked frame (reader)
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+void Trace_Init(uint32_t (*clock)(void)) {
+    uint32_t primask = Trace_Lock();
+    trace_clock = clock ? clock : No_Clock;
+    trace_ring.head = 0;
+    trace_ring.tail = 0;
+    trace_ring.dropped = 0;
+    peeked = 0;
+    Trace_Unlock(primask);
+}
+
+uint8_t Trace_PeekFrame(uint8_t *frame) {
+    uint16_t tail = trace_ring.tail;
+    uint16_t available = (uint16_t)(trace_ring.head - tail);
+    uint8_t *p = frame;
+
+    peeked = 0;
+    if (available == 0) return 0;
+    if (available > TRACE_FRAME_RECORDS) available = TRACE_FRAME_RECORDS;
+
+    *p++ = MIDI_SYSEX_START;
+    *p++ = MIDI_SYSEX_ID_NONCOMMERCIAL;
+    *p++ = TRACE_REPORT_EVENTS;
+    p = MIDI_PackU21(p, trace_ring.dropped);
+    for (uint16_t i = 0; i < available; i++, tail++) {
+        const TraceRecord_t *r =
+            &trace_ring.records[tail & (TRACE_RING_SIZE - 1)];
+        p = MIDI_PackU32(p, r->time);
+        *p++ = r->event & 0x7F;
+        p = MIDI_PackU32(p, ((uint32_t)r->a << 16) | r->b);
+    }
+    *p++ = MIDI_SYSEX_END;
+
+    peeked = available;
+    return (uint8_t)(p - frame);
+}
+
+void Trace_ReleaseFrame(void) {
+    // Free the slots only once they are copied out
+    __asm volatile("" : : : "memory");
+    trace_ring.tail = (uint16_t)(trace_ring.tail + peeked);
+    peeked = 0;
+}
+
+uint8_t Trace_DrainFrame(uint8_t *frame) {
+    uint8_t length = Trace_PeekFrame(frame);
+    Trace_ReleaseFrame();
+    return length;
+}
+
+#endif /* TRACE_ENABLE */
@@ -0,0 +1,187 @@
+/**
+ * @file trace.h
+ * @brief Event Trace Ring (fixed-size binary records, SysEx drain)
+ * @version 1.0.0
+ *
+ * Interrupts and the main loop append 8-byte records (timestamp, event,
+ * two arguments) to a power-of-two ring. The main loop drains it as SysEx
+ * frames; main.c sends them with the UART_AUDIO TX DMA channel.
+ * tools/host/trace_dump.py prints the timeline. An append is about 30
+ * cycles, so the trace stays on in release builds.
+ *
+ * The Cortex-M0+ has no LDREX/STREX. Producers are serialised by masking
+ * interrupts around the append. There is no spinning and nothing waits on
+ * the consumer. When the ring is full the new record is dropped and
+ * counted. The reader owns the tail and needs no masking: a record is
+ * complete before the head moves past it.
+ *
+ * Timestamps are the clock passed to Trace_Init (TIMG12 cycles in main.c,
+ * wrapping every 53 s; the host unwraps them).
+ *
+ * Frames (all values 7-bit packed, LSB first; see midi_msg.h):
+ *   F0 7D 07 dropped:u21 { time:u32 event:u7 a<<16|b:u32 }
+ *            x 1..TRACE_FRAME_RECORDS F7
+ * dropped counts all records lost since Trace_Init.
+ *
+ * Usage:
+ *   Trace_Init(Cycles_Now);
+ *   Trace_Event(TRACE_NOTE_ON, note, velocity);  // Any context
+ *
+ *   uint8_t frame[TRACE_FRAME_MAX];
+ *   if ((n = Trace_DrainFrame(frame)) != 0)      // Main loop
+ *       uart_send(frame, n);
+ *
+ *   // When the send can be refused, free the records only once it is not
+ *   if ((n = Trace_PeekFrame(frame)) != 0 && queue_write(frame, n))
+ *       Trace_ReleaseFrame();
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#ifndef TRACE_ENABLE
+#if defined(__linux__)
+#define TRACE_ENABLE 0
+#else
+#define TRACE_ENABLE 1
+#endif
+#endif
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 128        // Records, power of two (1 KB)
+#endif
+
+#define TRACE_FRAME_RECORDS 4      // Records per frame (51 bytes, 0.55 ms)
+
+// SysEx report ID (after F0 7D)
+#define TRACE_REPORT_EVENTS 0x07
+
+#define TRACE_FRAME_MAX (3 + 3 + TRACE_FRAME_RECORDS * 11 + 1)
+
+//=============================================================================
+// EVENTS (keep tools/host/trace_dump.py in step)
+//=============================================================================
+typedef enum {
+    TRACE_NOTE_ON = 1,         ///< a = MIDI note, b = velocity
+    TRACE_NOTE_OFF,            ///< a = MIDI note
+    TRACE_ALL_NOTES_OFF,       ///< CC 123 sent
+    TRACE_ENV_STATE,           ///< a = EnvelopeState_t
+    TRACE_HARMONY,             ///< a = HarmonicFunction_t, b = Hz
+    TRACE_BUTTON,              ///< a = SynthButton_t, b = SynthPress_t
+    TRACE_UNDERRUN,            ///< b = blocks dropped (total)
+    TRACE_DISPLAY_FRAME        ///< a = load page, b = us (saturated)
+} TraceEventId_t;
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef struct {
+    uint32_t time;             ///< Clock at the append
+    uint8_t event;             ///< TraceEventId_t
+    uint8_t a;
+    uint16_t b;
+} TraceRecord_t;
+
+typedef struct {
+    TraceRecord_t records[TRACE_RING_SIZE];
+    volatile uint16_t head;    ///< Producers (interrupts masked)
+    volatile uint16_t tail;    ///< Reader (main loop)
+    volatile uint32_t dropped; ///< Records lost to a full ring
+} TraceRing_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+#if TRACE_ENABLE
+
+extern TraceRing_t trace_ring;
+extern uint32_t (*trace_clock)(void);
+
+#if defined(__linux__)
+// Host tests: one thread, nothing to mask
+static inline uint32_t Trace_Lock(void) { return 0; }
+static inline void Trace_Unlock(uint32_t primask) { (void)primask; }
+#else
+static inline uint32_t Trace_Lock(void) {
+    uint32_t primask;
+    __asm volatile("mrs %0, primask\n cpsid i" : "=r"(primask) : : "memory");
+    return primask;
+}
+
+static inline void Trace_Unlock(uint32_t primask) {
+    __asm volatile("msr primask, %0" : : "r"(primask) : "memory");
+}
+#endif
+
+/**
+ * @brief Set the timestamp clock and empty the ring
+ */
+void Trace_Init(uint32_t (*clock)(void));
+
+/**
+ * @brief Append one record (any context)
+ */
+static inline void Trace_Event(TraceEventId_t event, uint8_t a, uint16_t b) {
+    uint32_t primask = Trace_Lock();
+    uint16_t head = trace_ring.head;
+
+    // Timestamp inside the lock, so the ring is in time order
+    if ((uint16_t)(head - trace_ring.tail) < TRACE_RING_SIZE) {
+        TraceRecord_t *r = &trace_ring.records[head & (TRACE_RING_SIZE - 1)];
+        r->time = trace_clock();
+        r->event = (uint8_t)event;
+        r->a = a;
+        r->b = b;
+        trace_ring.head = head + 1;
+    } else {
+        trace_ring.dropped++;
+    }
+    Trace_Unlock(primask);
+}
+
+/**
+ * @brief Copy up to TRACE_FRAME_RECORDS of the oldest records into a SysEx
+ * frame, leaving them in the ring
+ * @param frame At least TRACE_FRAME_MAX bytes
+ * @return Frame length, 0 if the ring is empty
+ */
+uint8_t Trace_PeekFrame(uint8_t *frame);
+
+/**
+ * @brief Free the records of the last Trace_PeekFrame() frame
+ */
+void Trace_ReleaseFrame(void);
+
+/**
+ * @brief Move up to TRACE_FRAME_RECORDS records into a SysEx frame
+ * @param frame At least TRACE_FRAME_MAX bytes
+ * @return Frame length, 0 if the ring is empty
+ */
+uint8_t Trace_DrainFrame(uint8_t *frame);
+
+#else
+
+static inline void Trace_Init(uint32_t (*clock)(void)) { (void)clock; }
+static inline void Trace_Event(TraceEventId_t event, uint8_t a, uint16_t b) {
+    (void)event;
+    (void)a;
+    (void)b;
+}
+static inline uint8_t Trace_PeekFrame(uint8_t *frame) {
+    (void)frame;
+    return 0;
+}
+static inline void Trace_ReleaseFrame(void) {}
+static inline uint8_t Trace_DrainFrame(uint8_t *frame) {
+    (void)frame;
+    return 0;
+}
+
+#endif /* TRACE_ENABLE */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,252 @@
+/**
+ * @file flash_kv.c
+ * @brief Log-Structured Key-Value Store Implementation
+ */
+
+#include "flash_kv.h"
+#include <string.h>
+
+//=============================================================================
+// PRIVATE FUNCTIONS
+//=============================================================================
+#define FLAG_DELETED 0x01
+#define COPY_WORDS   8          // Record copy through RAM, 32 bytes a time
+
+enum { RECORD_END, RECORD_OK, RECORD_BAD };
+
+static uint16_t Get_U16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t Get_U32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static uint16_t Record_Size(uint16_t length) {
+    return (uint16_t)(FLASH_KV_HEADER + ((length + 7u) & ~7u));
+}
+
+static const uint8_t *Sector(const FlashKv_t *kv, uint8_t sector) {
+    return kv->base + (uint32_t)sector * FLASH_KV_SECTOR_SIZE;
+}
+
+static bool Sector_Valid(const uint8_t *sector, uint16_t *sequence) {
+    uint16_t seq = Get_U16(sector + 4);
+    uint16_t check = (uint16_t)~seq;
+    if (Get_U32(sector) != FLASH_KV_MAGIC || Get_U16(sector + 6) != check)
+        return false;
+    *sequence = seq;
+    return true;
+}
+
+// RECORD_END at erased flash, RECORD_BAD for a record cut short
+static uint8_t Check_Record(const FlashKv_t *kv, uint16_t offset,
+                            uint16_t *size) {
+    const uint8_t *r = Sector(kv, kv->active) + offset;
+
+    if (offset + FLASH_KV_HEADER > FLASH_KV_SECTOR_SIZE) return RECORD_END;
+    uint8_t erased = 0xFF;
+    for (uint8_t i = 0; i < FLASH_KV_HEADER; i++) erased &= r[i];
+    if (erased == 0xFF) return RECORD_END;
+
+    uint16_t length = Get_U16(r + 6);
+    if (r[4] >= FLASH_KV_KEYS || r[5] > FLAG_DELETED ||
+        length > FLASH_KV_VALUE_MAX ||
+        offset + Record_Size(length) > FLASH_KV_SECTOR_SIZE)
+        return RECORD_BAD;
+    if (kv->port->crc32(r + 4, (uint16_t)(4 + length)) != Get_U32(r))
+        return RECORD_BAD;
+    *size = Record_Size(length);
+    return RECORD_OK;
+}
+
+static uint16_t Indexed_Size(const FlashKv_t *kv, uint8_t key) {
+    if (kv->index[key] == 0) return 0;
+    return Record_Size(Get_U16(Sector(kv, kv->active) + kv->index[key] + 6));
+}
+
+// A whole record of the active sector becomes the key's latest
+static void Index_Record(FlashKv_t *kv, uint16_t offset) {
+    const uint8_t *r = Sector(kv, kv->active) + offset;
+    uint8_t key = r[4];
+
+    kv->live -= Indexed_Size(kv, key);
+    if (r[5] & FLAG_DELETED) {
+        kv->index[key] = 0;
+    } else {
+        kv->index[key] = offset;
+        kv->live += Record_Size(Get_U16(r + 6));
+    }
+}
+
+// Record into kv->buffer, padded with erased bytes; returns its size
+static uint16_t Build_Record(FlashKv_t *kv, uint8_t key, uint8_t flags,
+                             const void *value, uint16_t length) {
+    uint8_t *r = (uint8_t *)kv->buffer;
+    uint16_t size = Record_Size(length);
+
+    memset(r, 0xFF, size);
+    r[4] = key;
+    r[5] = flags;
+    r[6] = (uint8_t)length;
+    r[7] = (uint8_t)(length >> 8);
+    if (length) memcpy(r + FLASH_KV_HEADER, value, length);
+    uint32_t crc = kv->port->crc32(r + 4, (uint16_t)(4 + length));
+    r[0] = (uint8_t)crc;
+    r[1] = (uint8_t)(crc >> 8);
+    r[2] = (uint8_t)(crc >> 16);
+    r[3] = (uint8_t)(crc >> 24);
+    return size;
+}
+
+// Next sector of the ring: the live records, the new one, the header last.
+// Nothing in kv changes unless the new sector is complete.
+static KvStatus_t Rotate(FlashKv_t *kv, uint8_t key, uint8_t flags,
+                         uint16_t size) {
+    uint8_t next = (uint8_t)((kv->active + 1) % FLASH_KV_SECTORS);
+    uint32_t to = (uint32_t)next * FLASH_KV_SECTOR_SIZE;
+    const uint8_t *from = Sector(kv, kv->active);
+    uint16_t index[FLASH_KV_KEYS] = {0};
+    uint16_t offset = FLASH_KV_HEADER;
+    bool deleted = (flags & FLAG_DELETED) != 0;
+
+    // A deletion is left out instead of written
+    uint16_t need = (uint16_t)(kv->live - Indexed_Size(kv, key) +
+                               (deleted ? 0 : size));
+    if (FLASH_KV_HEADER + need > FLASH_KV_SECTOR_SIZE) return KV_ERR_FULL;
+
+    if (!kv->port->erase(to)) return KV_ERR_FLASH;
+    kv->rotations++;
+
+    for (uint8_t k = 0; k < FLASH_KV_KEYS; k++) {
+        if (k == key || kv->index[k] == 0) continue;
+        const uint8_t *r = from + kv->index[k];
+        uint16_t n = Record_Size(Get_U16(r + 6));
+        index[k] = offset;
+        for (uint16_t done = 0; done < n; done += COPY_WORDS * 4) {
+            uint32_t chunk[COPY_WORDS];
+            uint16_t bytes = (uint16_t)(n - done < COPY_WORDS * 4
+                                            ? n - done : COPY_WORDS * 4);
+            memcpy(chunk, r + done, bytes);
+            if (!kv->port->program(to + offset + done, chunk,
+                                   (uint16_t)(bytes / 4)))
+                return KV_ERR_FLASH;
+        }
+        offset = (uint16_t)(offset + n);
+    }
+    if (!deleted) {
+        if (!kv->port->program(to + offset, kv->buffer, (uint16_t)(size / 4)))
+            return KV_ERR_FLASH;
+        index[key] = offset;
+        offset = (uint16_t)(offset + size);
+        kv->appends++;
+    }
+
+    uint16_t sequence = (uint16_t)(kv->sequence + 1);
+    uint32_t header[2] = {FLASH_KV_MAGIC,
+                          sequence | ((uint32_t)(uint16_t)~sequence << 16)};
+    if (!kv->port->program(to, header, 2)) return KV_ERR_FLASH;
+
+    memcpy(kv->index, index, sizeof(index));
+    kv->active = next;
+    kv->sequence = sequence;
+    kv->write = offset;
+    kv->live = (uint16_t)(offset - FLASH_KV_HEADER);
+    kv->formatted = true;
+    return KV_OK;
+}
+
+static KvStatus_t Write(FlashKv_t *kv, uint8_t key, uint8_t flags,
+                        const void *value, uint16_t length) {
+    uint16_t size = Build_Record(kv, key, flags, value, length);
+    uint16_t offset = kv->write;
+
+    if (offset + size > FLASH_KV_SECTOR_SIZE) return Rotate(kv, key, flags, size);
+
+    // A failed program may leave part of a record: the next write moves on
+    kv->write = FLASH_KV_SECTOR_SIZE;
+    if (!kv->port->program((uint32_t)kv->active * FLASH_KV_SECTOR_SIZE + offset,
+                           kv->buffer, (uint16_t)(size / 4)))
+        return KV_ERR_FLASH;
+    kv->write = (uint16_t)(offset + size);
+    Index_Record(kv, offset);
+    kv->appends++;
+    return KV_OK;
+}
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+void FlashKv_Init(FlashKv_t *kv, const uint8_t *base,
+                  const FlashKvPort_t *port) {
+    uint32_t start = port->cycles ? port->cycles() : 0;
+
+    memset(kv, 0, sizeof(*kv));
+    kv->base = base;
+    kv->port = port;
+    // No valid sector: "full", so the first write formats sector 0
+    kv->active = FLASH_KV_SECTORS - 1;
+    kv->write = FLASH_KV_SECTOR_SIZE;
+
+    for (uint8_t s = 0; s < FLASH_KV_SECTORS; s++) {
+        uint16_t seq;
+        if (!Sector_Valid(Sector(kv, s), &seq)) continue;
+        if (!kv->formatted || (int16_t)(seq - kv->sequence) > 0) {
+            kv->active = s;
+            kv->sequence = seq;
+            kv->formatted = true;
+        }
+    }
+
+    if (kv->formatted) {
+        uint16_t offset = FLASH_KV_HEADER, size;
+        uint8_t status;
+        while ((status = Check_Record(kv, offset, &size)) == RECORD_OK) {
+            Index_Record(kv, offset);
+            kv->scan_records++;
+            offset = (uint16_t)(offset + size);
+        }
+        kv->torn = status == RECORD_BAD;
+        kv->write = kv->torn ? FLASH_KV_SECTOR_SIZE : offset;
+    }
+
+    if (port->cycles) kv->scan_cycles = port->cycles() - start;
+}
+
+const uint8_t *FlashKv_Get(const FlashKv_t *kv, uint8_t key,
+                           uint16_t *length) {
+    if (key >= FLASH_KV_KEYS || kv->index[key] == 0) return NULL;
+    const uint8_t *r = Sector(kv, kv->active) + kv->index[key];
+    if (length) *length = Get_U16(r + 6);
+    return r + FLASH_KV_HEADER;
+}
+
+KvStatus_t FlashKv_Set(FlashKv_t *kv, uint8_t key, const void *value,
+                       uint16_t length) {
+    uint16_t stored;
+
+    if (key >= FLASH_KV_KEYS) return KV_ERR_KEY;
+    if (length > FLASH_KV_VALUE_MAX) return KV_ERR_SIZE;
+    const uint8_t *old = FlashKv_Get(kv, key, &stored);
+    if (old && stored == length &&
+        (length == 0 || memcmp(old, value, length) == 0))
+        return KV_OK; // Unchanged: no wear
+    return Write(kv, key, 0, value, length);
+}
+
+KvStatus_t FlashKv_Delete(FlashKv_t *kv, uint8_t key) {
+    if (key >= FLASH_KV_KEYS) return KV_ERR_KEY;
+    if (kv->index[key] == 0) return KV_OK;
+    return Write(kv, key, FLAG_DELETED, NULL, 0);
+}
+
+uint32_t FlashKv_Crc32(const uint8_t *data, uint16_t n) {
+    uint32_t crc = 0xFFFFFFFFu;
+    while (n--) {
+        crc ^= *data++;
+        for (uint8_t b = 0; b < 8; b++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+    }
+    return crc;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file flash_kv.h
+ * @brief Log-Structured Key-Value Store in Flash (wear-levelled, power-safe)
+ * @version 1.0.0
+ *
+ * Small values (settings, the sound bank) under 8-bit keys, in a ring of
+ * FLASH_KV_SECTORS flash sectors. Only one sector is active. Writes append
+ * a record to it and never rewrite a flash word, which ECC flash needs.
+ *
+ *   sector  header (magic, sequence, ~sequence) | record | record | ... | FF
+ *   record  CRC-32 (u32) key (u8) flags (u8) length (u16) | value, padded
+ *           to a multiple of 8 bytes (one flash word)
+ * The CRC covers key, flags, length and value. It comes from the port
+ * (the CRC peripheral in the firmware); the host tools use
+ * FlashKv_Crc32, the same CRC in software.
+ *
+ * When the active sector is full, the next sector in the ring is erased.
+ * The latest record of every key is copied into it, then the new record is
+ * written, and the sector header goes in last. Erases go round the ring in
+ * turn, so every sector wears at the same rate. A power cut at any point
+ * leaves either the old sector or the finished new one as the newest
+ * valid sector. A record cut short fails its CRC, and the key keeps its
+ * previous value. The next write then moves on to a fresh sector.
+ *
+ * Boot (FlashKv_Init) reads the sector headers and the active sector's
+ * records once, building a RAM index with one entry per key, so a lookup
+ * is O(1). The scan reads at most (sector - 8) / 8 records, and its time
+ * is measured with the port's cycle counter.
+ *
+ * Values are read in place (a pointer into flash, 8-byte aligned). A
+ * pointer stays valid until the next write moves the key or the record.
+ * Not reentrant: all calls from one context (the firmware main loop).
+ *
+ * Usage:
+ *   static const FlashKvPort_t port = {Erase, Program, Crc32, Cycles};
+ *   static FlashKv_t kv;
+ *   FlashKv_Init(&kv, (const uint8_t *)0x1C000, &port);
+ *   FlashKv_Set(&kv, KEY_VOLUME, &volume, 1);
+ *   const uint8_t *v = FlashKv_Get(&kv, KEY_VOLUME, &length);
+ *   FlashKv_Delete(&kv, KEY_VOLUME);
+ */
+
+#ifndef FLASH_KV_H_
+#define FLASH_KV_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#ifndef FLASH_KV_SECTOR_SIZE
+#define FLASH_KV_SECTOR_SIZE 1024  // Bytes (MSPM0G3507 main flash)
+#endif
+#ifndef FLASH_KV_SECTORS
+#define FLASH_KV_SECTORS     4     // Ring length (erases spread over these)
+#endif
+#ifndef FLASH_KV_KEYS
+#define FLASH_KV_KEYS        32    // Keys 0 .. FLASH_KV_KEYS-1
+#endif
+#ifndef FLASH_KV_VALUE_MAX
+#define FLASH_KV_VALUE_MAX   248   // Longest value (a record is <= 256 bytes)
+#endif
+
+#define FLASH_KV_WORD        8     // Flash word: the unit of programming
+#define FLASH_KV_HEADER      8     // Sector header and record header bytes
+#define FLASH_KV_MAGIC       0x31564B46u  // "FKV1"
+#define FLASH_KV_REGION_SIZE (FLASH_KV_SECTORS * FLASH_KV_SECTOR_SIZE)
+
+// Longest scan at boot: a sector of empty records
+#define FLASH_KV_SCAN_MAX \
+    ((FLASH_KV_SECTOR_SIZE - FLASH_KV_HEADER) / FLASH_KV_HEADER)
+
+#if FLASH_KV_SECTORS < 2
+#error "FLASH_KV_SECTORS: the ring needs a sector to move into"
+#endif
+#if FLASH_KV_VALUE_MAX % FLASH_KV_WORD || \
+    FLASH_KV_HEADER + FLASH_KV_VALUE_MAX > FLASH_KV_SECTOR_SIZE / 2
+#error "FLASH_KV_VALUE_MAX: a multiple of 8, at most half a sector"
+#endif
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef enum {
+    KV_OK = 0,
+    KV_ERR_KEY,            ///< Key out of range, or not stored
+    KV_ERR_SIZE,           ///< Value longer than FLASH_KV_VALUE_MAX
+    KV_ERR_FULL,           ///< The live values would not fit in a sector
+    KV_ERR_FLASH           ///< Erase or program failed
+} KvStatus_t;
+
+/**
+ * @brief Flash access (offsets from the start of the region)
+ */
+typedef struct {
+    bool (*erase)(uint32_t offset);          ///< Sector at offset
+    /** Program words at offset (8-byte aligned, erased), an even count */
+    bool (*program)(uint32_t offset, const uint32_t *words, uint16_t count);
+    /** CRC-32 (0x04C11DB7 reflected, seed 0xFFFFFFFF, no final XOR) */
+    uint32_t (*crc32)(const uint8_t *data, uint16_t n);
+    uint32_t (*cycles)(void);                ///< Boot scan timing (may be NULL)
+} FlashKvPort_t;
+
+typedef struct {
+    const uint8_t *base;       ///< Region, memory-mapped
+    const FlashKvPort_t *port;
+    uint16_t index[FLASH_KV_KEYS]; ///< Latest record in the active sector, 0 = none
+    uint16_t write;            ///< Next free offset in the active sector
+    uint16_t live;             ///< Bytes the indexed records take
+    uint16_t sequence;         ///< Active sector's sequence (wraps)
+    uint8_t active;            ///< Active sector (FLASH_KV_SECTORS-1 if none)
+    bool formatted;            ///< A valid sector was found or written
+    bool torn;                 ///< Boot found a record cut short
+    uint16_t scan_records;     ///< Records read by the boot scan
+    uint32_t scan_cycles;      ///< Boot scan time (port cycles)
+    uint32_t appends;          ///< Records written since init
+    uint32_t rotations;        ///< Sectors erased since init
+    uint32_t buffer[(FLASH_KV_HEADER + FLASH_KV_VALUE_MAX) / 4]; ///< Record being written
+} FlashKv_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Find the newest valid sector and index its records
+ *
+ * Erased or foreign flash is not an error: the store starts empty and the
+ * first write formats the first sector. Nothing is erased or written here.
+ */
+void FlashKv_Init(FlashKv_t *kv, const uint8_t *base,
+                  const FlashKvPort_t *port);
+
+/**
+ * @brief Latest value of a key
+ * @param length Set to the value length (may be NULL)
+ * @return Value in flash, or NULL if the key has none
+ */
+const uint8_t *FlashKv_Get(const FlashKv_t *kv, uint8_t key,
+                           uint16_t *length);
+
+/**
+ * @brief Store a value (a value equal to the stored one is not written)
+ *
+ * Appends one record, or moves to the next sector first when the active
+ * one is full (one erase, and a copy of every live value).
+ */
+KvStatus_t FlashKv_Set(FlashKv_t *kv, uint8_t key, const void *value,
+                       uint16_t length);
+
+/**
+ * @brief Forget a key (KV_OK if it had no value)
+ */
+KvStatus_t FlashKv_Delete(FlashKv_t *kv, uint8_t key);
+
+/**
+ * @brief The record CRC in software (host tools, or a part without CRC)
+ */
+uint32_t FlashKv_Crc32(const uint8_t *data, uint16_t n);
+
+#endif /* FLASH_KV_H_ */
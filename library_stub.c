@@ -52,7 +52,6 @@ extern int Envelope_GetState(const void* env);
 extern const int16_t* Audio_GetSineTable(void);
 extern int16_t Audio_GenerateWaveform(uint8_t index, int waveform);
 extern uint32_t Audio_CalculatePhaseIncrement(uint32_t freq_hz, uint32_t sample_rate_hz);
-extern uint16_t Audio_SampleToPWM(int16_t sample, uint16_t pwm_center, uint16_t pwm_max);
 
 // From audio_filters.h
 extern void Filter_Reset(void);
@@ -110,7 +109,6 @@ void __attribute__((used)) __force_library_symbols_inclusion(void) {
     (void)&Audio_GetSineTable;
     (void)&Audio_GenerateWaveform;
     (void)&Audio_CalculatePhaseIncrement;
-    (void)&Audio_SampleToPWM;
     
     // Filters
     (void)&Filter_Reset;
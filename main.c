@@ -22,7 +22,9 @@
  * BUTTON CONTROLS:
  * S1: Short=Instrument, Long=Major/Minor, Double=Effects
  * S2: Short=Play/Stop, Long=Chord, Double=Arpeggiator
- * JOY_SEL: Short=GREENSLEEVES (🍀 Traditional Melody), Long=Reset
+ * JOY_SEL: Short=GREENSLEEVES (🍀 Traditional Melody), Long=Reset (and the
+ *          board's position becomes level for the accelerometer),
+ *          Double=Audio load page + profiler (leaving it dumps the profile)
  * JOY_X: Select key (C-B) with deadzone hold
  * JOY_Y: Volume (0-100%) with deadzone hold
  * ACCEL_X: Harmonic progression (24 positions: vii↓ to I↑↑↑)
@@ -39,10 +41,20 @@
  */
 
 #include "main.h"
+#include "flash_layout.h"
 #include "lcd_driver.h"
-#include "lib/audio/audio_engine.h"
-#include "lib/audio/audio_envelope.h"
-#include "lib/audio/audio_filters.h"
+#include "lib/audio/synth.h"
+#include "lib/audio/audio_biquad.h"
+#include "lib/audio/synth_bank.h"
+#include "lib/midi/midi_in.h"
+#include "lib/midi/midi_msg.h"
+#include "lib/midi/midi_out.h"
+#include "lib/output/audio_out.h"
+#include "lib/perf/isr_load.h"
+#include "lib/perf/profiler.h"
+#include "lib/perf/perf_zone.h"
+#include "lib/perf/trace.h"
+#include "lib/storage/flash_kv.h"
 #include "lib/edumkii/edumkii.h"
 #include "ti_msp_dl_config.h"
 #include <stdbool.h>
@@ -50,304 +62,61 @@
 #include <stdio.h>
 #include <string.h>
 
-//=============================================================================
-// MIDI PROTOCOL IMPLEMENTATION
-//=============================================================================
-// MIDI Note 69 (A4) = 440 Hz (concert pitch)
-// Formula: f = 440 * 2^((N - 69) / 12)
-
-// MIDI Status Bytes
-#define MIDI_NOTE_OFF           0x80
-#define MIDI_NOTE_ON            0x90
-#define MIDI_CONTROL_CHANGE     0xB0
-#define MIDI_PROGRAM_CHANGE     0xC0
-#define MIDI_PITCH_BEND         0xE0
-
-// MIDI Control Change Numbers
-#define MIDI_CC_VOLUME          0x07
-
-// MIDI Message Structure
-typedef struct {
-    uint8_t status;
-    uint8_t data1;
-    uint8_t data2;
-    uint8_t length;
-} MIDI_Message_t;
-
-// MIDI Frequency Table (complete 0-127)
-static const uint16_t MIDI_FREQ_TABLE[128] = {
-    8, 9, 9, 10, 10, 11, 12, 12, 13, 14, 15, 15,
-    16, 17, 18, 19, 21, 22, 23, 25, 26, 28, 29, 31,
-    33, 35, 37, 39, 41, 44, 46, 49, 52, 55, 58, 62,
-    65, 69, 73, 78, 82, 87, 92, 98, 104, 110, 117, 123,
-    131, 139, 147, 156, 165, 175, 185, 196, 208, 220, 233, 247,
-    262, 277, 294, 311, 330, 349, 370, 392, 415, 440, 466, 494,
-    523, 554, 587, 622, 659, 698, 740, 784, 831, 880, 932, 988,
-    1047, 1109, 1175, 1245, 1319, 1397, 1480, 1568, 1661, 1760, 1865, 1976,
-    2093, 2217, 2349, 2489, 2637, 2794, 2960, 3136, 3322, 3520, 3729, 3951,
-    4186, 4435, 4699, 4978, 5274, 5588, 5920, 6272, 6645, 7040, 7459, 7902,
-    8372, 8870, 9397, 9956, 10548, 11175, 11840, 12544
-};
-
-static inline uint16_t MIDI_NoteToFreq(uint8_t note) {
-    if (note > 127) note = 127;
-    return MIDI_FREQ_TABLE[note];
-}
-
-static inline uint8_t MIDI_FreqToNote(uint16_t freq) {
-    if (freq < 8) return 0;
-    if (freq > 12544) return 127;
-    
-    // Binary search
-    uint8_t low = 0, high = 127;
-    while (low < high) {
-        uint8_t mid = (low + high) / 2;
-        if (freq < MIDI_FREQ_TABLE[mid]) {
-            high = mid;
-        } else if (freq > MIDI_FREQ_TABLE[mid]) {
-            low = mid + 1;
-        } else {
-            return mid;
-        }
-    }
-    
-    if (low > 0) {
-        uint16_t diff_low = (freq >= MIDI_FREQ_TABLE[low]) ? 
-            (freq - MIDI_FREQ_TABLE[low]) : (MIDI_FREQ_TABLE[low] - freq);
-        uint16_t diff_prev = (freq >= MIDI_FREQ_TABLE[low-1]) ? 
-            (freq - MIDI_FREQ_TABLE[low-1]) : (MIDI_FREQ_TABLE[low-1] - freq);
-        if (diff_prev < diff_low) return low - 1;
-    }
-    return low;
-}
-
-static inline void MIDI_CreateNoteOn(uint8_t channel, uint8_t note, 
-                                     uint8_t velocity, MIDI_Message_t* msg) {
-    msg->status = MIDI_NOTE_ON | (channel & 0x0F);
-    msg->data1 = note & 0x7F;
-    msg->data2 = velocity & 0x7F;
-    msg->length = 3;
-}
-
-static inline void MIDI_CreateNoteOff(uint8_t channel, uint8_t note,
-                                      uint8_t velocity, MIDI_Message_t* msg) {
-    msg->status = MIDI_NOTE_OFF | (channel & 0x0F);
-    msg->data1 = note & 0x7F;
-    msg->data2 = velocity & 0x7F;
-    msg->length = 3;
-}
-
-static inline void MIDI_CreateControlChange(uint8_t channel, uint8_t controller,
-                                            uint8_t value, MIDI_Message_t* msg) {
-    msg->status = MIDI_CONTROL_CHANGE | (channel & 0x0F);
-    msg->data1 = controller & 0x7F;
-    msg->data2 = value & 0x7F;
-    msg->length = 3;
-}
-
-static inline void MIDI_CreateProgramChange(uint8_t channel, uint8_t program,
-                                            MIDI_Message_t* msg) {
-    msg->status = MIDI_PROGRAM_CHANGE | (channel & 0x0F);
-    msg->data1 = program & 0x7F;
-    msg->data2 = 0;
-    msg->length = 2;
-}
-
-
 //=============================================================================
 // CONFIGURATION
 //=============================================================================
-#define SAMPLE_RATE_HZ 16000
+#define SAMPLE_RATE_HZ SYNTH_SAMPLE_RATE_HZ
 #define SYSTICK_RATE_HZ 100
 #define MCLK_FREQ_HZ 80000000UL
 #define SYSTICK_LOAD_VALUE ((MCLK_FREQ_HZ / SYSTICK_RATE_HZ) - 1)
-#define PORTAMENTO_SPEED 25
-#define AUDIO_GAIN_BOOST 8
-
-// OPA GAIN COMPENSATION
-// Set to 2 if using OPA with 2x gain (DAC Output on PSEL)
-// Set to 1 if using OPA with 1x gain (IN0+ external pin) or no OPA
-#define OPA_GAIN_FACTOR 2  // Compensate for 2x OPA gain to prevent clipping
-#define FREQ_MIN_HZ 20
-#define FREQ_MAX_HZ 8000
-
-#define ACCEL_Y_NEUTRAL 2849
-#define ACCEL_Y_THRESHOLD 300
 
-#define PWM_MAX_VALUE 2047 // 11-bit oppløsning (fjerner pipelyd)
-#define PWM_CENTER_VALUE 1023
+// Block rendering: the output backend plays one block while PendSV renders
+// the next
+#define AUDIO_BLOCK_SIZE SYNTH_BLOCK_SIZE  // 2 ms at 16 kHz
+
+// Audio interrupt load: budgets in MCLK cycles, windows in SysTicks
+#define CYCLES_PER_SAMPLE (MCLK_FREQ_HZ / SAMPLE_RATE_HZ)  // 5000 at 16 kHz
+#define RENDER_BUDGET_CYCLES (AUDIO_BLOCK_SIZE * CYCLES_PER_SAMPLE)
+#if AUDIO_OUT_BACKEND == AUDIO_BACKEND_DAC12
+#define SERVICE_BUDGET_CYCLES RENDER_BUDGET_CYCLES  // DAC0: once per block
+#else
+#define SERVICE_BUDGET_CYCLES CYCLES_PER_SAMPLE     // TIMG7: every sample
+#endif
+#define LOAD_WINDOW_TICKS 10   // 100 ms
+#define TELEMETRY_TICKS 100    // 1 s: SysEx load report on the MIDI UART
+#define TELEMETRY_ISR_LOAD 0x01
+#define TELEMETRY_PART_LOAD 0x08
+#define MIDI_VOLUME_TICKS 3    // 30 ms: volume CC at most ~33 times a second
+
+// Sampling profiler (TIMG8, 997 Hz): flash from 0x0, raise if the .map
+// shows more code
+#define PROFILER_CODE_BYTES (64 * 1024)
+
+// Settings and the sound bank (lib/storage/flash_kv.h) live in the last
+// four 1 KB flash sectors, SETTINGS_FLASH_ADDRESS in flash_layout.h. A
+// compiled sound bank (tools/host/bank_tool compile, flashed with UniFlash
+// or CCS) sits in the sector below, BANK_BLOB_ADDRESS, and is played in
+// place. mspm0g3507.cmd ends the linker's FLASH region below both.
+#define SETTINGS_SAVE_TICKS 500 // 5 s unchanged before a setting is written
+_Static_assert(SETTINGS_FLASH_SIZE == FLASH_KV_REGION_SIZE,
+               "flash_layout.h: the settings region is the flash_kv ring");
+_Static_assert(BANK_BLOB_SIZE == DL_FLASHCTL_SECTOR_SIZE,
+               "flash_layout.h: the sound bank blob is one flash sector");
+_Static_assert(BANK_IMAGE_BYTES <= BANK_BLOB_SIZE,
+               "the compiled sound bank fits its sector");
 
-#define ENABLE_CHORD_MODE 1
-#define ENABLE_ARPEGGIATOR 1
 #define ENABLE_WAVEFORM_DISPLAY 1
 #define ENABLE_DEBUG_LEDS 2
+// Output backend: build with -DAUDIO_OUT_BACKEND=AUDIO_BACKEND_PWM (or _UART)
+// to replace the DAC12. UART PCM and MIDI share UART_AUDIO.
+#define ENABLE_MIDI_OUT (AUDIO_OUT_BACKEND != AUDIO_BACKEND_UART)
+// MIDI input on UART_AUDIO RX (free with every backend)
+#define ENABLE_MIDI_IN 1
 
 //=============================================================================
-// MUSICAL SCALES
+// DISPLAY NAMES
 //=============================================================================
-typedef enum {
-  SCALE_MAJOR = 0,
-  SCALE_MINOR,
-  SCALE_PENTATONIC_MAJOR,
-  SCALE_PENTATONIC_MINOR,
-  SCALE_BLUES,
-  SCALE_DORIAN,
-  SCALE_COUNT
-} ScaleType_t;
-
-typedef enum {
-  KEY_C = 0,
-  KEY_D,
-  KEY_E,
-  KEY_F,
-  KEY_G,
-  KEY_A,
-  KEY_B,
-  KEY_COUNT
-} MusicalKey_t;
-
-static const int8_t SCALE_INTERVALS[SCALE_COUNT][8] = {
-    {0, 2, 4, 5, 7, 9, 11, 12},  {0, 2, 3, 5, 7, 8, 10, 12},
-    {0, 2, 4, 7, 9, 12, 12, 12}, {0, 3, 5, 7, 10, 12, 12, 12},
-    {0, 3, 5, 6, 7, 10, 12, 12}, {0, 2, 3, 5, 7, 9, 10, 12}};
-
-static const uint16_t ROOT_FREQUENCIES[KEY_COUNT] = {262, 294, 330, 349,
-                                                     392, 440, 494};
 static const char *KEY_NAMES[KEY_COUNT] = {"C", "D", "E", "F", "G", "A", "B"};
-static const char *SCALE_NAMES[SCALE_COUNT] = {"MAJ",  "MIN",  "PNT+",
-                                               "PNT-", "BLUE", "DOR"};
-
-typedef struct {
-  MusicalKey_t current_key;
-  ScaleType_t current_scale;
-  uint8_t scale_position;
-  uint16_t current_note_freq;
-} ScaleState_t;
-
-//=============================================================================
-// HARMONIC PROGRESSION SYSTEM
-//=============================================================================
-typedef enum {
-  MODE_MAJOR = 0,
-  MODE_MINOR = 1,
-  MODE_COUNT = 2
-} MusicalMode_t;
-
-// Harmonic function: Extended harmony with 24 positions for smooth ACCEL_X control
-// Follows MIDI standard with semitone-based progressions
-// Organized for natural musical flow with octave variants
-typedef enum {
-  // Low register (-7 to -1 semitones from root)
-  HARM_vii_low = 0,   // -1 semitone (leading tone below)
-  HARM_vi_low,        // -2 semitones
-  HARM_V_low,         // -5 semitones (dominant below)
-  HARM_IV_low,        // -7 semitones (subdominant below)
-  
-  // Mid-low register (base diatonic chords)
-  HARM_I = 4,         // 0 semitones - Root/Tonic ⭐
-  HARM_ii,            // +2 semitones - Supertonic
-  HARM_iii,           // +4 semitones - Mediant
-  HARM_IV,            // +5 semitones - Subdominant
-  HARM_V,             // +7 semitones - Dominant
-  HARM_vi,            // +9 semitones - Submediant
-  HARM_vii,           // +11 semitones - Leading tone
-  
-  // Mid-high register (extended chords)
-  HARM_I_oct,         // +12 semitones - Tonic octave up
-  HARM_V7,            // +7 semitones - Dominant 7th
-  HARM_ii7,           // +2 semitones - Supertonic 7th
-  HARM_vi7,           // +9 semitones - Submediant 7th
-  HARM_IVmaj7,        // +5 semitones - Subdominant maj7
-  
-  // High register (+12 to +19 semitones from root)
-  HARM_I_inv,         // +16 semitones - Tonic first inversion high
-  HARM_ii_high,       // +14 semitones
-  HARM_IV_high,       // +17 semitones
-  HARM_V_high,        // +19 semitones
-  
-  // Very high register (+24 semitones = 2 octaves)
-  HARM_I_2oct,        // +24 semitones - Tonic 2 octaves up
-  HARM_V_2oct,        // +31 semitones - Dominant 2 octaves up
-  HARM_IV_2oct,       // +29 semitones - Subdominant 2 octaves up
-  HARM_I_3oct,        // +36 semitones - Tonic 3 octaves up
-  
-  HARM_COUNT
-} HarmonicFunction_t;
-
-// Chord intervals from root (semitones) - MAJOR MODE
-// Root = MIDI note 60 (C4), all intervals calculated from there
-static const int8_t HARMONIC_INTERVALS_MAJOR[HARM_COUNT][4] = {
-    // Low register
-    {-1, 2, 6, -1},      // vii_low - B dim below (B-D-F)
-    {-2, 1, 5, -1},      // vi_low  - A minor below (A-C-E)
-    {-5, -1, 2, -1},     // V_low   - G major below (G-B-D)
-    {-7, -3, 0, -1},     // IV_low  - F major below (F-A-C)
-    
-    // Mid-low register (base chords)
-    {0, 4, 7, -1},       // I       - C major (C-E-G)
-    {2, 5, 9, -1},       // ii      - D minor (D-F-A)
-    {4, 7, 11, -1},      // iii     - E minor (E-G-B)
-    {5, 9, 12, -1},      // IV      - F major (F-A-C)
-    {7, 11, 14, -1},     // V       - G major (G-B-D)
-    {9, 12, 16, -1},     // vi      - A minor (A-C-E)
-    {11, 14, 17, -1},    // vii     - B dim (B-D-F)
-    
-    // Mid-high register (extended)
-    {12, 16, 19, -1},    // I_oct   - C major octave up
-    {7, 11, 14, 17},     // V7      - G7 (G-B-D-F)
-    {2, 5, 9, 12},       // ii7     - Dm7 (D-F-A-C)
-    {9, 12, 16, 19},     // vi7     - Am7 (A-C-E-G)
-    {5, 9, 12, 16},      // IVmaj7  - Fmaj7 (F-A-C-E)
-    
-    // High register
-    {16, 19, 24, -1},    // I_inv   - C/E high (E-G-C)
-    {14, 17, 21, -1},    // ii_high - D minor high
-    {17, 21, 24, -1},    // IV_high - F major high
-    {19, 23, 26, -1},    // V_high  - G major high
-    
-    // Very high register
-    {24, 28, 31, -1},    // I_2oct  - C major 2 octaves up
-    {31, 35, 38, -1},    // V_2oct  - G major 2 octaves up
-    {29, 33, 36, -1},    // IV_2oct - F major 2 octaves up
-    {36, 40, 43, -1}     // I_3oct  - C major 3 octaves up
-};
-
-// Chord intervals from root (semitones) - MINOR MODE
-static const int8_t HARMONIC_INTERVALS_MINOR[HARM_COUNT][4] = {
-    // Low register
-    {-1, 2, 6, -1},      // vii_low - B dim below
-    {-4, -1, 3, -1},     // VI_low  - Ab major below
-    {-5, -1, 2, -1},     // V_low   - G major below
-    {-7, -4, 0, -1},     // iv_low  - F minor below
-    
-    // Mid-low register
-    {0, 3, 7, -1},       // i       - C minor (C-Eb-G)
-    {2, 5, 8, -1},       // ii°     - D dim (D-F-Ab)
-    {3, 7, 10, -1},      // III     - Eb major (Eb-G-Bb)
-    {5, 8, 12, -1},      // iv      - F minor (F-Ab-C)
-    {7, 11, 14, -1},     // V       - G major (G-B-D) - harmonic minor!
-    {8, 12, 15, -1},     // VI      - Ab major (Ab-C-Eb)
-    {11, 14, 17, -1},    // vii°    - B dim (B-D-F)
-    
-    // Mid-high register
-    {12, 15, 19, -1},    // i_oct   - C minor octave up
-    {7, 11, 14, 17},     // V7      - G7 (G-B-D-F)
-    {2, 5, 8, 12},       // ii°7    - Dm7b5 (D-F-Ab-C)
-    {8, 12, 15, 19},     // VI7     - Abmaj7 (Ab-C-Eb-G)
-    {5, 8, 12, 15},      // iv7     - Fm7 (F-Ab-C-Eb)
-    
-    // High register
-    {15, 19, 24, -1},    // i_inv   - Cm/Eb high
-    {14, 17, 20, -1},    // ii_high - D dim high
-    {17, 20, 24, -1},    // iv_high - F minor high
-    {19, 23, 26, -1},    // V_high  - G major high
-    
-    // Very high register
-    {24, 27, 31, -1},    // i_2oct  - C minor 2 octaves up
-    {31, 35, 38, -1},    // V_2oct  - G major 2 octaves up
-    {29, 32, 36, -1},    // iv_2oct - F minor 2 octaves up
-    {36, 39, 43, -1}     // i_3oct  - C minor 3 octaves up
-};
 
 static const char* HARMONIC_NAMES_MAJOR[HARM_COUNT] = {
     "vii↓", "vi↓", "V↓", "IV↓",           // Low register
@@ -365,87 +134,9 @@ static const char* HARMONIC_NAMES_MINOR[HARM_COUNT] = {
     "i↑↑", "V↑↑", "iv↑↑", "i↑↑↑"         // Very high
 };
 
-//=============================================================================
-// CHORD & ARPEGGIATOR
-//=============================================================================
-typedef enum {
-  CHORD_OFF = 0,
-  CHORD_MAJOR,
-  CHORD_MINOR,
-  CHORD_MODE_COUNT
-} ChordMode_t;
-static const int8_t CHORD_INTERVALS[CHORD_MODE_COUNT][3] = {
-    {0, 0, 0}, {0, 4, 7}, {0, 3, 7}};
-
-typedef enum {
-  ARP_OFF = 0,
-  ARP_UP,
-  ARP_DOWN,
-  ARP_UP_DOWN,
-  ARP_RANDOM,
-  ARP_MODE_COUNT
-} ArpMode_t;
-typedef struct {
-  ArpMode_t mode;
-  uint8_t current_step;
-  uint32_t step_counter;
-  uint32_t steps_per_note;
-} Arpeggiator_t;
-
-//=============================================================================
-// INSTRUMENTS
-//=============================================================================
-typedef enum {
-  INSTRUMENT_PIANO = 0,
-  INSTRUMENT_ORGAN,
-  INSTRUMENT_STRINGS,
-  INSTRUMENT_BASS,
-  INSTRUMENT_LEAD,
-  INSTRUMENT_COUNT
-} Instrument_t;
-
-typedef struct {
-  const char *name;
-  ADSR_Profile_t adsr; // Kommer fra audio_envelope.h (via main.h)
-  Waveform_t waveform; // Kommer fra audio_engine.h (via main.h)
-  uint8_t num_harmonics;
-  uint8_t vibrato_depth;
-  uint8_t tremolo_depth;
-  uint16_t color;
-} InstrumentProfile_t;
-
-static const InstrumentProfile_t INSTRUMENTS[INSTRUMENT_COUNT] = {
-    // PIANO: Quick attack, moderate decay, bright
-    {"PIANO", {40, 1200, 650, 600}, WAVE_TRIANGLE, 2, 0, 0, LCD_COLOR_CYAN},
-    
-    // ORGAN: Instant attack, sustained, rich harmonics
-    {"ORGAN", {0, 0, 1000, 200}, WAVE_SINE, 3, 25, 0, LCD_COLOR_RED},
-    
-    // STRINGS: Very slow attack, long sustain, warm vibrato
-    {"STRINGS", {3200, 4000, 900, 5000}, WAVE_SAWTOOTH, 1, 20, 15, LCD_COLOR_YELLOW},
-    
-    // BASS: Fast attack, punchy, deep and resonant
-    {"BASS", {80, 400, 950, 600}, WAVE_SINE, 0, 0, 0, LCD_COLOR_BLUE},
-    
-    // LEAD: Sharp attack, bright square wave, aggressive vibrato
-    {"LEAD", {20, 800, 900, 1200}, WAVE_SQUARE, 2, 40, 8, LCD_COLOR_GREEN}
-};
-
-//=============================================================================
-// PRESETS
-//=============================================================================
-typedef struct {
-  const char *name;
-  Instrument_t instrument;
-  bool effects_enabled;
-  ChordMode_t chord_mode;
-  ArpMode_t arp_mode;
-} Preset_t;
-
-static const Preset_t PRESETS[3] = {
-    {"CLASSIC", INSTRUMENT_PIANO, false, CHORD_OFF, ARP_OFF},
-    {"AMBIENT", INSTRUMENT_STRINGS, true, CHORD_MAJOR, ARP_OFF},
-    {"SEQUENCE", INSTRUMENT_LEAD, true, CHORD_MINOR, ARP_UP}};
+static const uint16_t INSTRUMENT_COLORS[INSTRUMENT_COUNT] = {
+    LCD_COLOR_CYAN, LCD_COLOR_RED, LCD_COLOR_YELLOW, LCD_COLOR_BLUE,
+    LCD_COLOR_GREEN};
 
 //=============================================================================
 // DMA (from v27)
@@ -455,42 +146,18 @@ static volatile uint16_t gADC0_DMA_Buffer[ADC0_BUFFER_SIZE]
     __attribute__((aligned(4)));
 static volatile bool gADC0_DMA_Complete = false;
 
-//=============================================================================
-// PITCH BEND TABLE (from v27)
-//=============================================================================
-static const uint32_t PITCH_BEND_TABLE[25] = {
-    32768, 34675, 36781,  38967,  41285,  43742,  46341, 49091, 51998,
-    55041, 58255, 61644,  65536,  69433,  73533,  77841, 82366, 87111,
-    92123, 97549, 103397, 109681, 116411, 123596, 131072};
-
 //=============================================================================
 // HARDWARE OBJECTS (Library Instances)
 //=============================================================================
 static Button_t btn_s1, btn_s2, btn_joy_sel;
 static Joystick_t joystick;
 static Accelerometer_t accel;
-static Envelope_t envelope;
 
 //=============================================================================
 // GLOBAL STATE
 //=============================================================================
 volatile SynthState_t gSynthState;
 
-static ScaleState_t scale_state = {KEY_C, SCALE_MAJOR, 3, 262};
-static MusicalMode_t current_mode = MODE_MAJOR;
-static HarmonicFunction_t current_harmony = HARM_I;
-static Instrument_t current_instrument = INSTRUMENT_PIANO;
-static uint8_t current_preset = 0;
-static bool effects_enabled = true;
-static ChordMode_t chord_mode = CHORD_OFF;
-static Arpeggiator_t arpeggiator = {0};
-
-// Epic Organ Mode (inspired by 70s progressive rock)
-static bool epic_mode_active = false;
-static uint8_t epic_sequence_step = 0;
-static uint32_t epic_step_counter = 0;
-static const uint32_t EPIC_STEPS_PER_NOTE = 32000; // ~2 seconds per note at 16kHz
-
 // MIDI State
 static uint8_t midi_last_note = 0;
 static uint16_t midi_last_frequency = 0;
@@ -498,84 +165,128 @@ static bool midi_note_is_on = false;
 static uint8_t midi_last_volume = 0;
 static uint8_t midi_last_instrument = 0xFF;
 
-static uint32_t base_frequency_hz = 440;
-static uint32_t target_frequency_hz = 440;
-static uint32_t current_frequency_hz = 440;
-static int8_t current_octave_shift = 0;
-
-// Phase accumulators (v27 globals - kept for compatibility!)
-volatile uint32_t g_phase = 0;
-volatile uint32_t g_phase_increment = 118111601;
-volatile uint32_t g_chord_phases[3] = {0};
-volatile uint32_t g_chord_increments[3] = {118111601, 118111601, 118111601};
-
-static uint16_t vibrato_phase = 0, tremolo_phase = 0;
-
-#if ENABLE_WAVEFORM_DISPLAY
-static int16_t waveform_buffer[64] = {0};
-static uint8_t waveform_write_index = 0;
+// Audio interrupt load: block render (PendSV) and the backend's clock IRQ
+static IsrLoad_t isr_render, isr_service;
+static volatile uint32_t systick_count = 0;
+static volatile bool load_due = false; // Windows closed by the main loop
+#if ENABLE_MIDI_OUT
+static volatile bool telemetry_due = false;
+#endif
+static bool display_load_page = false;
+
+// Sampling profiler: runs while the load page is shown
+static Profiler_t profiler;
+#if ENABLE_MIDI_OUT
+static ProfilerDump_t profiler_dump;
+static volatile bool profiler_dump_due = false;
+static PerfDump_t perf_dump;
+static volatile bool perf_dump_due = false;
+
+// Everything for UART_AUDIO is queued here and sent by DMA_CH1
+static MidiOut_t midi_out;
 #endif
+#if ENABLE_MIDI_IN
+// UART_AUDIO RX interrupt -> ring -> parser at the start of each block
+static MidiInRing_t midi_rx;
+static MidiIn_t midi_in;
+#endif
+#if ENABLE_MIDI_IN && ENABLE_MIDI_OUT
+// Sound bank over SysEx: dumped by PendSV one frame per block, written to
+// flash by the main loop
+static SynthBank_t bank_dump;
+static uint8_t bank_dump_cursor;
+static volatile bool bank_dump_due = false;
+static volatile bool bank_flash_due = false;
+static volatile bool bank_reply_due = false;
+static volatile uint8_t bank_flash_op;            // BANK_OP_STORE / _FACTORY
+static volatile BankStatus_t bank_flash_status;
+static uint32_t bank_image[BANK_IMAGE_BYTES / 4]; // 64-bit flash words
+_Static_assert(BANK_IMAGE_BYTES <= FLASH_KV_VALUE_MAX,
+               "the bank image is one flash_kv value");
+#endif
+
+// Settings kept over power-off: one flash_kv key each, restored at boot and
+// written by the main loop
+typedef enum {
+  SETTING_KEY = 0,
+  SETTING_MODE,
+  SETTING_INSTRUMENT,
+  SETTING_PRESET,
+  SETTING_VOLUME,
+  SETTING_ACCEL_CAL,  // Accelerometer offsets X, Y (int16_t)
+  SETTING_BANK        // SynthBank_Encode image (bank store over SysEx)
+} SettingKey_t;
+
+static FlashKv_t settings;
+static const SynthBank_t *bank_blob; // NULL: no valid image at BANK_BLOB_ADDRESS
 
 //=============================================================================
 // PROTOTYPES
 //=============================================================================
 static void SysTick_Init(void);
-static void Process_Musical_Controls(void);
-static void Process_Accelerometer(void);
-static void Process_Arpeggiator(void);
-static void Process_Epic_Mode(void);
-static void Toggle_Epic_Mode(void);
-static void Process_Portamento(void);
-static void Generate_Audio_Sample(void);
-static void Update_Phase_Increment(void);
-static int16_t Generate_Chord_Sample(volatile uint32_t *phases,
-                                     volatile uint32_t *increments);
+#if ENABLE_MIDI_OUT
+static void Process_MIDI_Output(const SynthStatus_t *status);
+static void Telemetry_Send(void);
+static void Midi_Out_Init(void);
+static void Trace_Drain(void);
+#endif
+#if ENABLE_MIDI_IN
+static void Midi_In_Init(void);
+#endif
+static void Settings_Load(void);
+static void Settings_Poll(void);
+#if ENABLE_MIDI_IN && ENABLE_MIDI_OUT
+static BankStatus_t Bank_Flash_Write(bool store);
+#endif
+static void Load_Update(void);
+static uint32_t Cycles_Now(void);
+static void On_Synth_Event(SynthEvent_t event, int32_t value);
 static void Display_Update(void);
-static void Display_Waveform(void);
-static void Display_Scale_Info(void);
-static uint16_t Calculate_Scale_Frequency(MusicalKey_t key, ScaleType_t scale,
-                                          uint8_t position,
-                                          int8_t octave_shift);
-static uint16_t Calculate_Harmonic_Frequency(MusicalKey_t key, MusicalMode_t mode,
-                                             HarmonicFunction_t harmony, int8_t octave_shift);
-void Change_Instrument(void);
-void Change_Preset(void);
-void Change_Scale_Type(void);
-void Trigger_Note_On(void);
-void Trigger_Note_Off(void);
-
-// Biquad Filter Forward Declarations
-typedef struct {
-    int32_t x1, x2;
-    int32_t y1, y2;
-    int32_t b0, b1, b2;
-    int32_t a1, a2;
-} BiquadFilter_t;
-
-static void BiquadFilter_Init(BiquadFilter_t *filter);
-static inline int16_t BiquadFilter_Process(BiquadFilter_t *filter, int16_t input);
-
-// Interpolator Forward Declarations
-typedef struct {
-    int16_t last_sample;
-    bool enabled;
-} Interpolator_t;
-
-static inline int16_t Interpolate_Linear(int16_t current, uint8_t fraction);
+#if ENABLE_WAVEFORM_DISPLAY
+static void Display_Waveform(const int16_t *scope);
+#endif
+static void Display_Scale_Info(const SynthStatus_t *status);
+static void Display_Load_Page(void);
+
 
 // Global Instances
 static BiquadFilter_t g_biquad_filter;
-static Interpolator_t g_interpolator = {0, true};
-
-// DAC12 Helper Functions (defined later)
-static inline uint16_t Audio_SampleToDAC12(int16_t sample);
-static inline void Audio_WriteDAC12(int16_t sample);
-static inline void Audio_MuteDAC12(void);
+static void Audio_Out_Request(void *user);
 
 #if ENABLE_DEBUG_LEDS
 static void Debug_LED_Update(int8_t octave);
 #endif
 //=============================================================================
+// MATHACL SINE WAVE GENERATION
+//=============================================================================
+/**
+ * @brief Generate sine sample using MATHACL hardware
+ * @param phase Phase accumulator (0 to UINT32_MAX = 0 to 2π)
+ * @return Sample value (-1024 to +1024 for 11-bit PWM)
+ */
+static inline int16_t MATHACL_Sine(uint32_t phase) {
+    // Convert phase to Q31 angle for MATHACL
+    // Phase 0x00000000 = 0°, 0x80000000 = 180°, 0xFFFFFFFF = 360°
+    int32_t angle = (int32_t)(phase >> 1);  // Scale to Q31
+    
+    // Configure MATHACL for SINCOS operation
+    DL_MathACL_operationConfig config = {
+        .opType = DL_MATHACL_OP_TYPE_SINCOS,
+        .qType = DL_MATHACL_Q_TYPE_Q31,
+        .opSign = DL_MATHACL_OPSIGN_SIGNED
+    };
+    
+    // Execute hardware sine
+    DL_MathACL_configOperation(MATHACL, &config, angle, 0);
+    DL_MathACL_waitForOperation(MATHACL);
+    
+    // Get result (Q31: -2^31 to +2^31 represents -1.0 to +1.0)
+    int32_t result = DL_MathACL_getResultOne(MATHACL);
+    
+    // Scale to 11-bit PWM range (-1024 to +1024)
+    return (int16_t)(result >> 21);
+}
+//=============================================================================
 // MAIN
 //=============================================================================
 int main(void) {
@@ -587,29 +298,16 @@ int main(void) {
   // Initialize and calibrate DAC12
   DL_DAC12_enable(DAC0);
   delay_cycles(1000);  // Let DAC12 settle
-  Audio_MuteDAC12();   // Set to midpoint
+  DL_DAC12_output12(DAC0, 2048);  // Midpoint = silence
 
   // Initialize biquad anti-aliasing filter for 48 kHz
   BiquadFilter_Init(&g_biquad_filter);
-  
-  // Initialize interpolator
-  g_interpolator.enabled = true;
-  g_interpolator.last_sample = 0;
 
   memset((void *)&gSynthState, 0, sizeof(SynthState_t));
   gSynthState.frequency = 440;
   gSynthState.volume = 80;
   gSynthState.audio_playing = 1;
 
-  // Initialiser Audio-motoren (Biblioteket tar seg av phase_increment)
-  Audio_Init(SAMPLE_RATE_HZ);
-
-  // Sett bølgeform via biblioteket
-  Audio_SetWaveform(INSTRUMENTS[current_instrument].waveform);
-
-  // Sett frekvens via biblioteket
-  Audio_SetFrequency(440);
-
   // Initialize hardware objects (Library API)
   Button_Init(&btn_s1);
   Button_Init(&btn_s2);
@@ -617,25 +315,22 @@ int main(void) {
   Joystick_Init(&joystick, 100); // 100 = deadzone
   Accel_Init(&accel, 100);       // 100 = deadzone
 
-  // Initialize audio (Library API)
-  Filter_Reset();
-  Envelope_Init(&envelope, &INSTRUMENTS[current_instrument].adsr);
-  Envelope_NoteOn(&envelope);
-
-  // Initialize frequencies
-  base_frequency_hz = 440;
-  target_frequency_hz = 440;
-  current_frequency_hz = 440;
-  current_octave_shift = 0;
-  g_phase_increment = 118111601;
-  g_chord_increments[0] = g_phase_increment;
-  g_chord_increments[1] = g_phase_increment;
-  g_chord_increments[2] = g_phase_increment;
-  Update_Phase_Increment();
-
-  // Initialize arpeggiator
-  arpeggiator.mode = ARP_OFF;
-  arpeggiator.steps_per_note = (SAMPLE_RATE_HZ * 60) / (120 * 4);
+  // Free-running cycle counter (TIMG12, 32-bit, MCLK) for FX accounting
+  DL_TimerG_setLoadValue(TIMER_CYCLES_INST, 0xFFFFFFFF);
+  DL_TimerG_startCounter(TIMER_CYCLES_INST);
+  IsrLoad_Init(&isr_render, RENDER_BUDGET_CYCLES, Cycles_Now());
+  IsrLoad_Init(&isr_service, SERVICE_BUDGET_CYCLES, Cycles_Now());
+  gSynthState.isr_budget = RENDER_BUDGET_CYCLES;
+  Profiler_Init(&profiler, 0x00000000, PROFILER_CODE_BYTES);
+  Perf_Init(Cycles_Now); // PERF_BEGIN/PERF_END zones (debug builds)
+  Trace_Init(Cycles_Now);
+
+  // Synth engine: MATHACL sine, TIMG12 for the FX budget, LED feedback
+  static const SynthPlatform_t synth_hw = {MATHACL_Sine, Cycles_Now,
+                                           On_Synth_Event};
+  Synth_Init(&synth_hw);
+  Settings_Load(); // Stored settings and bank, where flash holds valid ones
+  gSynthState.waveform = INSTRUMENTS[INSTRUMENT_PIANO].waveform;
 
   // Initialize ADC
   NVIC_EnableIRQ(ADC0_INT_IRQn);
@@ -659,11 +354,33 @@ int main(void) {
 
   // Initialize SysTick & Timer
   SysTick_Init();
+  NVIC_SetPriority(PendSV_IRQn, 3); // Block rendering below the sample timer
+  NVIC_SetPriority(TIMG8_INT_IRQn, 0); // Profiler samples inside the others
+  NVIC_EnableIRQ(TIMG8_INT_IRQn);
   __enable_irq();
+#if AUDIO_OUT_BACKEND == AUDIO_BACKEND_DAC12
+  // DAC sample timer clocks the FIFO; the CPU only sees one IRQ per block
+  NVIC_ClearPendingIRQ(DAC0_INT_IRQn);
+  NVIC_SetPriority(DAC0_INT_IRQn, 1);
+  NVIC_EnableIRQ(DAC0_INT_IRQn);
+#else
   NVIC_ClearPendingIRQ(TIMG7_INT_IRQn);
   NVIC_SetPriority(TIMG7_INT_IRQn, 1);
   NVIC_EnableIRQ(TIMG7_INT_IRQn);
   DL_TimerG_startCounter(TIMER_SAMPLE_INST);
+#endif
+  const AudioOutConfig_t out_cfg = {SAMPLE_RATE_HZ, AUDIO_BLOCK_SIZE,
+                                    Audio_Out_Request, NULL, Cycles_Now, NULL};
+  if (!AUDIO_OUT.open(&out_cfg)) {
+    LCD_PrintString(10, 90, "AUDIO OUT FAIL!", LCD_COLOR_RED, LCD_COLOR_BLACK,
+                    FONT_MEDIUM);
+  }
+#if ENABLE_MIDI_OUT
+  Midi_Out_Init();
+#endif
+#if ENABLE_MIDI_IN
+  Midi_In_Init();
+#endif
 
   // Verify timer working
   DL_Common_delayCycles(8000);
@@ -694,73 +411,80 @@ int main(void) {
     // Buttons (Disse må sjekkes ofte for å fange korte trykk)
     // NB: Selve oppdateringen skjer nå i SysTick, så vi bare henter events her
 
-    // S1 Button
+    // S1 Button: Short=Instrument, Long=Major/Minor, Double=Effects
     ButtonEvent_t s1_event = Button_GetEvent(&btn_s1);
-    if (s1_event == BTN_EVENT_SHORT_CLICK) {
-      Change_Instrument();
-      display_counter = 200000;
-    } else if (s1_event == BTN_EVENT_LONG_PRESS) {
-      // Toggle between Major and Minor mode
-      current_mode = (MusicalMode_t)((current_mode + 1) % MODE_COUNT);
-
-      // Update frequency for new mode
-      scale_state.current_note_freq = Calculate_Harmonic_Frequency(
-          scale_state.current_key, current_mode, current_harmony, current_octave_shift);
-      target_frequency_hz = scale_state.current_note_freq;
-      Update_Phase_Increment();
-
-      display_counter = 200000;
-    } else if (s1_event == BTN_EVENT_DOUBLE_CLICK) {
-      effects_enabled = !effects_enabled;
+    if (s1_event != BTN_EVENT_NONE) {
+      Trace_Event(TRACE_BUTTON, SYNTH_BTN_S1, s1_event);
+      Synth_Button(SYNTH_BTN_S1, (SynthPress_t)s1_event);
+      // The engine applies the press at the next block; PendSV mirrors
+      // the new instrument and sends the program change
       display_counter = 200000;
     }
 
-    // S2 Button
+    // S2 Button: Short=Play/Stop, Long=Chord, Double=Arpeggiator
     ButtonEvent_t s2_event = Button_GetEvent(&btn_s2);
-    if (s2_event == BTN_EVENT_SHORT_CLICK) {
-      gSynthState.audio_playing = !gSynthState.audio_playing;
-      if (gSynthState.audio_playing) {
-        Trigger_Note_On();
-      } else {
-        Trigger_Note_Off();
-        // Flush UART to prevent hanging MIDI notes
-        while(DL_UART_isTXFIFOEmpty(UART_AUDIO_INST) == false);
-      }
-      display_counter = 200000;
-    } else if (s2_event == BTN_EVENT_LONG_PRESS) {
-      chord_mode = (ChordMode_t)((chord_mode + 1) % CHORD_MODE_COUNT);
-      display_counter = 200000;
-    } else if (s2_event == BTN_EVENT_DOUBLE_CLICK) {
-      if (arpeggiator.mode == ARP_OFF)
-        arpeggiator.mode = ARP_UP;
-      else
-        arpeggiator.mode = ARP_OFF;
+    if (s2_event != BTN_EVENT_NONE) {
+      Trace_Event(TRACE_BUTTON, SYNTH_BTN_S2, s2_event);
+      Synth_Button(SYNTH_BTN_S2, (SynthPress_t)s2_event);
       display_counter = 200000;
     }
 
     // JOY_SEL Button
     ButtonEvent_t joy_sel_event = Button_GetEvent(&btn_joy_sel);
+    if (joy_sel_event != BTN_EVENT_NONE) {
+      Trace_Event(TRACE_BUTTON, SYNTH_BTN_JOY_SEL, joy_sel_event);
+    }
     if (joy_sel_event == BTN_EVENT_SHORT_CLICK) {
       // Force blue/green LED immediately to confirm button press
       DL_GPIO_setPins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN);
       DL_GPIO_clearPins(GPIO_RGB_PORT, GPIO_RGB_GREEN_PIN);
-      
-      Toggle_Epic_Mode();
+
+      if (Synth_ToggleEpic()) {
+        // Visual feedback: BLUE LED on (Celtic mode)
+        gSynthState.waveform = INSTRUMENTS[INSTRUMENT_STRINGS].waveform;
+
+        // Show activation message
+        LCD_FillScreen(LCD_COLOR_BLACK);
+        LCD_PrintString(10, 50, "GREENSLEEVES", LCD_COLOR_GREEN, LCD_COLOR_BLACK, FONT_LARGE);
+        LCD_PrintString(35, 70, "MODE!", LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_MEDIUM);
+        DL_Common_delayCycles(40000000); // Brief pause to see message
+      } else {
+        // Return to normal operation
+        // Visual feedback: GREEN LED on
+        DL_GPIO_setPins(GPIO_RGB_PORT, GPIO_RGB_GREEN_PIN);
+        DL_GPIO_clearPins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN);
+      }
       display_counter = 200000;
     } else if (joy_sel_event == BTN_EVENT_LONG_PRESS) {
-      // Reset logic...
-      epic_mode_active = false;
-      current_instrument = INSTRUMENT_PIANO;
-      current_preset = 0;
-      effects_enabled = true;
-      chord_mode = CHORD_OFF;
-      arpeggiator.mode = ARP_OFF;
-      scale_state.current_key = KEY_C;
-      scale_state.current_scale = SCALE_MAJOR;
-      
-      // Mute DAC12 on reset
-      Audio_MuteDAC12();
-      
+      Synth_Button(SYNTH_BTN_JOY_SEL, SYNTH_PRESS_LONG);
+      // The board is held level: saved with the settings
+      Accel_Calibrate(&accel, gSynthState.accel_x, gSynthState.accel_y);
+      IsrLoad_Reset(&isr_render);
+      IsrLoad_Reset(&isr_service);
+      display_counter = 200000;
+    } else if (joy_sel_event == BTN_EVENT_DOUBLE_CLICK) {
+      // Toggle between the synth page and the audio load page; the
+      // profiler runs while the load page is shown
+      display_load_page = !display_load_page;
+      if (display_load_page) {
+#if ENABLE_MIDI_OUT
+        profiler_dump_due = false;
+        perf_dump_due = false;
+#endif
+        Perf_Reset();
+        Profiler_Start(&profiler);
+        DL_TimerG_startCounter(TIMER_PROFILER_INST);
+      } else {
+        DL_TimerG_stopCounter(TIMER_PROFILER_INST);
+        Profiler_Stop(&profiler);
+#if ENABLE_MIDI_OUT
+        Profiler_DumpBegin(&profiler_dump);
+        Perf_DumpBegin(&perf_dump);
+        profiler_dump_due = true; // PendSV sends both, one frame per block
+        perf_dump_due = true;
+#endif
+      }
+      LCD_FillScreen(LCD_COLOR_BLACK);
       display_counter = 200000;
     }
 
@@ -775,407 +499,44 @@ int main(void) {
                    gSynthState.accel_z);
 
       // 2. KJØR logikken som sjekker flaggene (x_changed etc.)
-      Process_Musical_Controls();
-      Process_Accelerometer();
+      Synth_ProcessControls(&joystick, &accel);
     }
 
     // Update display (Sjeldnere)
     if (display_counter++ >= 100000) {
+      uint32_t frame_start = Cycles_Now();
+      PERF_BEGIN(DISPLAY_UPDATE);
       Display_Update();
+      PERF_END(DISPLAY_UPDATE);
+      Perf_Update();
+      uint32_t frame_us =
+          (Cycles_Now() - frame_start) / (MCLK_FREQ_HZ / 1000000);
+      Trace_Event(TRACE_DISPLAY_FRAME, display_load_page,
+                  (frame_us > 0xFFFF) ? 0xFFFF : (uint16_t)frame_us);
       display_counter = 0;
     }
 
-    loop_counter++;
-  }
-}
-
-//=============================================================================
-// MUSICAL CONTROLS (Using Library API)
-//=============================================================================
-static void Process_Musical_Controls(void) {
-  // Skip manual controls if epic mode is running
-  if (epic_mode_active) return;
-  
-  // 1. Key selection (JOY_X) - Now selects musical key
-  if (joystick.x_changed) {
-    if (joystick.raw_x < 1000) {
-      // Left - previous key
-      if (scale_state.current_key > 0)
-        scale_state.current_key--;
-      else
-        scale_state.current_key = (MusicalKey_t)(KEY_COUNT - 1);
-    } else if (joystick.raw_x > 3000) {
-      // Right - next key
-      if (scale_state.current_key < (KEY_COUNT - 1))
-        scale_state.current_key++;
-      else
-        scale_state.current_key = (MusicalKey_t)0;
+    // Audio load windows, below PendSV and the backend IRQ as
+    // IsrLoad_Update requires
+    if (load_due) {
+      load_due = false;
+      Load_Update();
     }
 
-    // Update frequency based on current harmony
-    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
-        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
-    target_frequency_hz = scale_state.current_note_freq;
-    Update_Phase_Increment();
-  }
-
-  // 2. Volume (JOY_Y) - Unchanged
-  if (joystick.y_changed) {
-    gSynthState.volume = Joystick_GetVolume(&joystick);
-  }
-
-  // 3. Harmonic progression (ACCEL_X) - 24 positions for smooth control!
-  if (accel.x_changed) {
-    // Map accelerometer X (0-4095) to harmonic functions (0-23)
-    // This gives smooth semitone-based progressions across full tilt range
-    uint8_t harm_pos = (uint8_t)((accel.x * HARM_COUNT) / 4096);
-    if (harm_pos >= HARM_COUNT) harm_pos = HARM_COUNT - 1;
-
-    current_harmony = (HarmonicFunction_t)harm_pos;
-
-    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
-        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
-    target_frequency_hz = scale_state.current_note_freq;
-    Update_Phase_Increment();
-  }
-}
-
-//==================================================================
-// ACCELROMETER
-//===================================================================
-static void Process_Accelerometer(void) {
-  // Skip manual controls if epic mode is running
-  if (epic_mode_active) return;
-  
-  int16_t ay = accel.y;
-  int16_t deviation = ay - ACCEL_Y_NEUTRAL;
-
-  // Vi definerer terskler for hver oktav (ca. 400 enheter mellom hver)
-  const int16_t LIMIT_1 = 500;  // Første oktav
-  const int16_t LIMIT_2 = 1000; // Andre oktav
-
-  int8_t new_octave_shift = 0;
-
-  // Sjekk tilt-soner for flere oktaver
-  if (deviation > LIMIT_2) {
-    new_octave_shift = 24; // Mye tilt forover -> To oktaver opp
-  } else if (deviation > LIMIT_1) {
-    new_octave_shift = 12; // Litt tilt forover -> En oktav opp
-  } else if (deviation < -LIMIT_2) {
-    new_octave_shift = -24; // Mye tilt bakover -> To oktaver ned
-  } else if (deviation < -LIMIT_1) {
-    new_octave_shift = -12; // Litt tilt bakover -> En oktav ned
-  } else {
-    new_octave_shift = 0; // Flatt brett -> Normal
-  }
-
-  // Bare oppdater hvis vi faktisk har skiftet sone
-  if (current_octave_shift != new_octave_shift) {
-    current_octave_shift = new_octave_shift;
-
-    scale_state.current_note_freq = Calculate_Scale_Frequency(
-        scale_state.current_key, scale_state.current_scale,
-        scale_state.scale_position, current_octave_shift);
-
-    target_frequency_hz = scale_state.current_note_freq;
-    Update_Phase_Increment();
-
-#if ENABLE_DEBUG_LEDS
-    // Lys-indikasjon for å se hvor du er
-    if (current_octave_shift > 0)
-      Debug_LED_Update(1); // Grønn for opp
-    else if (current_octave_shift < 0)
-      Debug_LED_Update(-1); // Blå for ned
-    else
-      Debug_LED_Update(0); // Av for midten
+    Settings_Poll();
+#if ENABLE_MIDI_IN && ENABLE_MIDI_OUT
+    // Bank store / factory reset: audio stalls if a sector erases
+    if (bank_flash_due) {
+      bank_flash_status = Bank_Flash_Write(bank_flash_op == BANK_OP_STORE);
+      bank_flash_due = false;
+      bank_reply_due = true; // PendSV sends it
+    }
 #endif
-  }
-}
-
-static void Process_Portamento(void) {
-  if (current_frequency_hz < target_frequency_hz) {
-    current_frequency_hz += PORTAMENTO_SPEED;
-    if (current_frequency_hz > target_frequency_hz)
-      current_frequency_hz = target_frequency_hz;
-  } else if (current_frequency_hz > target_frequency_hz) {
-    current_frequency_hz -= PORTAMENTO_SPEED;
-    if (current_frequency_hz < target_frequency_hz)
-      current_frequency_hz = target_frequency_hz;
-  }
-  if (current_frequency_hz != base_frequency_hz) {
-    base_frequency_hz = current_frequency_hz;
-    // Note: We DON'T call Audio_SetFrequency() - we manage phase manually!
-    Update_Phase_Increment();
-  }
-}
-
-//=============================================================================
-// MATHACL SINE WAVE GENERATION
-//=============================================================================
-/**
- * @brief Generate sine sample using MATHACL hardware
- * @param phase Phase accumulator (0 to UINT32_MAX = 0 to 2π)
- * @return Sample value (-1024 to +1024 for 11-bit PWM)
- */
-static inline int16_t MATHACL_Sine(uint32_t phase) {
-    // Convert phase to Q31 angle for MATHACL
-    // Phase 0x00000000 = 0°, 0x80000000 = 180°, 0xFFFFFFFF = 360°
-    int32_t angle = (int32_t)(phase >> 1);  // Scale to Q31
-    
-    // Configure MATHACL for SINCOS operation
-    DL_MathACL_operationConfig config = {
-        .opType = DL_MATHACL_OP_TYPE_SINCOS,
-        .qType = DL_MATHACL_Q_TYPE_Q31,
-        .opSign = DL_MATHACL_OPSIGN_SIGNED
-    };
-    
-    // Execute hardware sine
-    DL_MathACL_configOperation(MATHACL, &config, angle, 0);
-    DL_MathACL_waitForOperation(MATHACL);
-    
-    // Get result (Q31: -2^31 to +2^31 represents -1.0 to +1.0)
-    int32_t result = DL_MathACL_getResultOne(MATHACL);
-    
-    // Scale to 11-bit PWM range (-1024 to +1024)
-    return (int16_t)(result >> 21);
-}
-//=============================================================================
-// HELPER FUNCTIONS
-//=============================================================================
-static uint16_t Calculate_Scale_Frequency(MusicalKey_t key, ScaleType_t scale,
-                                          uint8_t position,
-                                          int8_t octave_shift) {
-  uint16_t root_freq = ROOT_FREQUENCIES[key];
-  int8_t interval = SCALE_INTERVALS[scale][position];
-  int8_t total_semitones = interval + octave_shift;
-
-  const uint16_t semitone_ratio[25] = {1000, 1059, 1122, 1189, 1260, 1335, 1414,
-                                       1498, 1587, 1682, 1782, 1888, 2000, 2119,
-                                       2245, 2378, 2520, 2670, 2828, 2997, 3175,
-                                       3364, 3564, 3775, 4000};
-
-  int8_t idx = total_semitones + 12;
-  if (idx < 0)
-    idx = 0;
-  if (idx > 24)
-    idx = 24;
-
-  uint32_t freq = ((uint32_t)root_freq * semitone_ratio[idx]) / 1000;
-  if (freq < 100)
-    freq = 100;
-  if (freq > 2000)
-    freq = 2000;
-
-  return (uint16_t)freq;
-}
-
-static uint16_t Calculate_Harmonic_Frequency(MusicalKey_t key, MusicalMode_t mode,
-                                             HarmonicFunction_t harmony, int8_t octave_shift) {
-  uint16_t root_freq = ROOT_FREQUENCIES[key];
-
-  // Get chord intervals based on mode
-  const int8_t* intervals = (mode == MODE_MAJOR) ?
-      HARMONIC_INTERVALS_MAJOR[harmony] :
-      HARMONIC_INTERVALS_MINOR[harmony];
-
-  // Use root note of the chord
-  int8_t semitone = intervals[0] + octave_shift;
-
-  // Use same calculation as original
-  const uint16_t semitone_ratio[25] = {
-      1000, 1059, 1122, 1189, 1260, 1335, 1414, 1498, 1587, 1682, 1782, 1888, 2000,
-      2119, 2245, 2378, 2520, 2670, 2828, 2997, 3175, 3364, 3564, 3775, 4000};
-
-  int8_t idx = semitone + 12;
-  if (idx < 0) idx = 0;
-  if (idx > 24) idx = 24;
-
-  uint32_t freq = ((uint32_t)root_freq * semitone_ratio[idx]) / 1000;
-  if (freq < 100) freq = 100;
-  if (freq > 2000) freq = 2000;
-
-  return (uint16_t)freq;
-}
-
-void Change_Scale_Type(void) {
-  scale_state.current_scale =
-      (ScaleType_t)((scale_state.current_scale + 1) % SCALE_COUNT);
-  scale_state.current_note_freq = Calculate_Scale_Frequency(
-      scale_state.current_key, scale_state.current_scale,
-      scale_state.scale_position, current_octave_shift);
-  target_frequency_hz = scale_state.current_note_freq;
-}
-
-void Change_Instrument(void) {
-  current_instrument =
-      (Instrument_t)((current_instrument + 1) % INSTRUMENT_COUNT);
-  gSynthState.waveform = INSTRUMENTS[current_instrument].waveform;
-  Envelope_Init(&envelope,
-                &INSTRUMENTS[current_instrument].adsr); // Library API
-  
-  // Send MIDI Program Change
-  if (current_instrument != midi_last_instrument) {
-    midi_last_instrument = current_instrument;
-    MIDI_Message_t msg;
-    MIDI_CreateProgramChange(0, current_instrument, &msg);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-  }
-  
-  Trigger_Note_On();
-}
-
-void Change_Preset(void) {
-  current_preset = (current_preset + 1) % 3;
-  const Preset_t *preset = &PRESETS[current_preset];
-  current_instrument = preset->instrument;
-  effects_enabled = preset->effects_enabled;
-  chord_mode = preset->chord_mode;
-  arpeggiator.mode = preset->arp_mode;
-  gSynthState.waveform = INSTRUMENTS[current_instrument].waveform;
-  Envelope_Init(&envelope,
-                &INSTRUMENTS[current_instrument].adsr); // Library API
-  Trigger_Note_On();
-}
-
-void Trigger_Note_On(void) {
-  Envelope_NoteOn(&envelope); // Library API
-}
-
-void Trigger_Note_Off(void) {
-  Envelope_NoteOff(&envelope); // Library API
-  // Immediately mute DAC12
-  Audio_MuteDAC12();
-}
-
-//=============================================================================
-// ARPEGGIATOR
-//=============================================================================
-static void Process_Arpeggiator(void) {
-  if (arpeggiator.mode == ARP_OFF)
-    return;
-
-  arpeggiator.step_counter++;
-  if (arpeggiator.step_counter >= arpeggiator.steps_per_note) {
-    arpeggiator.step_counter = 0;
-    Trigger_Note_On();
-    arpeggiator.current_step = (arpeggiator.current_step + 1) % 8;
-  }
-}
-
-//=============================================================================
-// CELTIC MODE - Greensleeves (Traditional, Public Domain)
-//=============================================================================
-// Based on the iconic English/Irish traditional melody from 16th century
-// Chord progression: Am - C - G - Am - E - Am - C - G - Am - E - Am
-// This is authentic traditional music - no copyright restrictions!
-static const struct {
-  MusicalKey_t key;
-  HarmonicFunction_t harmony;
-  MusicalMode_t mode;
-  int8_t octave_shift;
-} EPIC_SEQUENCE[] = {
-    // Verse 1: "Alas my love, you do me wrong..."
-    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (home)
-    {KEY_A, HARM_iii, MODE_MINOR, 0},    // C major (relative major)
-    {KEY_A, HARM_V, MODE_MINOR, 0},      // G major (bVII)
-    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (return)
-    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (dominant - harmonic minor!)
-    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (resolve)
-    
-    // Verse 2: "To cast me off discourteously..."
-    {KEY_A, HARM_iii, MODE_MINOR, 0},    // C major
-    {KEY_A, HARM_V, MODE_MINOR, 0},      // G major (bVII)
-    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am
-    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (dominant)
-    {KEY_A, HARM_I, MODE_MINOR, 0},      // Am (resolve)
-    
-    // Chorus: "Greensleeves was all my joy..."
-    {KEY_A, HARM_iii, MODE_MINOR, 5},    // C major (up a 4th - lift!)
-    {KEY_A, HARM_V, MODE_MINOR, 5},      // G major (stay up)
-    {KEY_A, HARM_I, MODE_MINOR, 5},      // Am (high point)
-    {KEY_A, HARM_V, MODE_MINOR, 0},      // E major (back down)
-    {KEY_A, HARM_I, MODE_MINOR, 0}       // Am (final home)
-};
-
-#define EPIC_SEQUENCE_LENGTH (sizeof(EPIC_SEQUENCE) / sizeof(EPIC_SEQUENCE[0]))
-
-static void Process_Epic_Mode(void) {
-  if (!epic_mode_active) return;
-  
-  epic_step_counter++;
-  
-  if (epic_step_counter >= EPIC_STEPS_PER_NOTE) {
-    epic_step_counter = 0;
-    epic_sequence_step = (epic_sequence_step + 1) % EPIC_SEQUENCE_LENGTH;
-    
-    // Visual feedback: Toggle between blue and green at each step
-    DL_GPIO_togglePins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN | GPIO_RGB_GREEN_PIN);
-    
-    // Update harmony from sequence
-    scale_state.current_key = EPIC_SEQUENCE[epic_sequence_step].key;
-    current_harmony = EPIC_SEQUENCE[epic_sequence_step].harmony;
-    current_mode = EPIC_SEQUENCE[epic_sequence_step].mode;
-    current_octave_shift = EPIC_SEQUENCE[epic_sequence_step].octave_shift;
-    
-    // Calculate new frequency
-    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
-        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
-    target_frequency_hz = scale_state.current_note_freq;
-    Update_Phase_Increment();
-    
-    // Trigger note on for each change
-    Trigger_Note_On();
-  }
-}
-
-static void Toggle_Epic_Mode(void) {
-  epic_mode_active = !epic_mode_active;
-  
-  if (epic_mode_active) {
-    // Visual feedback: BLUE LED on (Celtic mode)
-    DL_GPIO_setPins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN);
-    DL_GPIO_clearPins(GPIO_RGB_PORT, GPIO_RGB_GREEN_PIN);
-    
-    // Show activation message
-    LCD_FillScreen(LCD_COLOR_BLACK);
-    LCD_PrintString(10, 50, "GREENSLEEVES", LCD_COLOR_GREEN, LCD_COLOR_BLACK, FONT_LARGE);
-    LCD_PrintString(35, 70, "MODE!", LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_MEDIUM);
-    DL_Common_delayCycles(40000000); // Brief pause to see message
-    
-    // Enable epic mode with strings sound (Celtic fiddle-like)
-    current_instrument = INSTRUMENT_STRINGS;
-    effects_enabled = true;
-    chord_mode = CHORD_OFF; // Single notes for clarity
-    arpeggiator.mode = ARP_OFF;
-    
-    // Start from beginning
-    epic_sequence_step = 0;
-    epic_step_counter = 0;
-    
-    // Set initial state
-    scale_state.current_key = EPIC_SEQUENCE[0].key;
-    current_harmony = EPIC_SEQUENCE[0].harmony;
-    current_mode = EPIC_SEQUENCE[0].mode;
-    current_octave_shift = EPIC_SEQUENCE[0].octave_shift;
-    
-    // Update envelope for strings
-    gSynthState.waveform = INSTRUMENTS[INSTRUMENT_STRINGS].waveform;
-    Envelope_Init(&envelope, &INSTRUMENTS[INSTRUMENT_STRINGS].adsr);
-    
-    // Calculate first note
-    scale_state.current_note_freq = Calculate_Harmonic_Frequency(
-        scale_state.current_key, current_mode, current_harmony, current_octave_shift);
-    target_frequency_hz = scale_state.current_note_freq;
-    Update_Phase_Increment();
-    
-    Trigger_Note_On();
-  } else {
-    // Return to normal operation
-    // Visual feedback: GREEN LED on
-    DL_GPIO_setPins(GPIO_RGB_PORT, GPIO_RGB_GREEN_PIN);
-    DL_GPIO_clearPins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN);
-    current_octave_shift = 0;
+#if ENABLE_MIDI_OUT
+    Trace_Drain();
+    MidiOut_Poll(&midi_out);
+#endif
+    loop_counter++;
   }
 }
 
@@ -1194,6 +555,40 @@ void SysTick_Handler(void) {
   Button_Update(&btn_s1, GPIO_BUTTONS_PORT, GPIO_BUTTONS_S1_MKII_PIN);
   Button_Update(&btn_s2, GPIO_BUTTONS_PORT, GPIO_BUTTONS_S2_MKII_PIN);
   Button_Update(&btn_joy_sel, GPIO_BUTTONS_PORT, GPIO_BUTTONS_JOY_SEL_PIN);
+
+  systick_count++;
+  if (systick_count % LOAD_WINDOW_TICKS == 0) {
+    load_due = true; // SysTick preempts the audio interrupts it measures
+  }
+#if ENABLE_MIDI_OUT
+  if (systick_count % TELEMETRY_TICKS == 0) {
+    telemetry_due = true; // Sent from PendSV, which owns the MIDI UART
+  }
+#endif
+}
+
+//=============================================================================
+// SAMPLING PROFILER (TIMG8, highest priority)
+//=============================================================================
+static void __attribute__((used)) Profiler_Tick(uint32_t pc) {
+  DL_TimerG_getPendingInterrupt(TIMER_PROFILER_INST); // Clears ZERO
+  Profiler_Sample(&profiler, pc);
+}
+
+// Naked, so sp still points at the exception frame: r0-r3, r12, lr, pc,
+// xPSR. EXC_RETURN bit 2 tells whether it was stacked on MSP or PSP.
+__attribute__((naked)) void TIMG8_IRQHandler(void) {
+  __asm volatile("  movs r0, #4        \n"
+                 "  mov  r1, lr        \n"
+                 "  tst  r0, r1        \n"
+                 "  beq  1f            \n"
+                 "  mrs  r0, psp       \n"
+                 "  b    2f            \n"
+                 "1: mrs r0, msp       \n"
+                 "2: ldr r0, [r0, #24] \n" // Stacked PC
+                 "  push {r4, lr}      \n"
+                 "  bl   Profiler_Tick \n"
+                 "  pop  {r4, pc}      \n");
 }
 
 //=============================================================================
@@ -1206,6 +601,7 @@ void DMA_IRQHandler(void) {
 }
 
 void ADC0_IRQHandler(void) {
+  PERF_BEGIN(ADC0_IRQ);
   gSynthState.adc0_count++;
 
   switch (DL_ADC12_getPendingInterrupt(ADC_JOY_INST)) {
@@ -1216,9 +612,11 @@ void ADC0_IRQHandler(void) {
   default:
     break;
   }
+  PERF_END(ADC0_IRQ);
 }
 
 void ADC1_IRQHandler(void) {
+  PERF_BEGIN(ADC1_IRQ);
   gSynthState.adc1_count++;
 
   if (DL_ADC12_getPendingInterrupt(ADC_ACCEL_INST) ==
@@ -1232,456 +630,614 @@ void ADC1_IRQHandler(void) {
     gSynthState.joy_y =
         DL_ADC12_getMemResult(ADC_ACCEL_INST, DL_ADC12_MEM_IDX_3);
   }
+  PERF_END(ADC1_IRQ);
 }
 
+#if AUDIO_OUT_BACKEND == AUDIO_BACKEND_DAC12
+//=============================================================================
+// DAC12 DMA DONE (once per block)
+//=============================================================================
+void DAC0_IRQHandler(void) {
+  IsrLoad_Enter(&isr_service, Cycles_Now());
+  AUDIO_OUT.service();
+  gSynthState.timer_count += AUDIO_BLOCK_SIZE;
+  IsrLoad_Exit(&isr_service, Cycles_Now());
+}
+#else
 //=============================================================================
-// AUDIO TIMER ISR
+// AUDIO TIMER ISR (sample clock for the PWM and UART backends)
 //=============================================================================
 void TIMG7_IRQHandler(void) {
   uint32_t status = DL_TimerG_getPendingInterrupt(TIMER_SAMPLE_INST);
   if (!(status & DL_TIMERG_IIDX_ZERO))
     return;
 
+  IsrLoad_Enter(&isr_service, Cycles_Now()); // Exit is the last statement
   gSynthState.timer_count++;
-  if (g_phase_increment == 0)
-    g_phase_increment = 118111601;
-
-  Envelope_Process(&envelope); // Library API
-  Process_Arpeggiator();
-  Process_Epic_Mode();
-  Process_Portamento();
-
-  vibrato_phase += 82;
-  tremolo_phase += 67;
-
-  if (gSynthState.audio_playing) {
-    Generate_Audio_Sample();
-  } else {
-    // MUTE: Set DAC12 to midpoint
-    Audio_MuteDAC12();
-  }
+  AUDIO_OUT.service();
+  IsrLoad_Exit(&isr_service, Cycles_Now());
 }
+#endif
 
 //=============================================================================
-// MATHACL BIQUAD FILTER (Anti-Aliasing)
+// BLOCK RENDERER (PendSV, lowest priority)
 //=============================================================================
-
-/**
- * @brief Initialize biquad filter for 48 kHz sampling
- * 
- * Butterworth low-pass, fc = 15 kHz
- * Coefficients calculated for fs = 48 kHz
- */
-static void BiquadFilter_Init(BiquadFilter_t *filter) {
-    // Clear state
-    filter->x1 = 0;
-    filter->x2 = 0;
-    filter->y1 = 0;
-    filter->y2 = 0;
-    
-    // Butterworth coefficients (Q15 format, scaled by 32768)
-    // fc = 15 kHz, fs = 48 kHz
-    filter->b0 = 16384;   // 0.5 * 32768
-    filter->b1 = 32768;   // 1.0 * 32768
-    filter->b2 = 16384;   // 0.5 * 32768
-    filter->a1 = -10486;  // -0.32 * 32768 (approx)
-    filter->a2 = 6554;    // 0.2 * 32768 (approx)
+static void Audio_Out_Request(void *user) {
+  (void)user;
+  SCB->ICSR = SCB_ICSR_PENDSVSET_Msk; // Render the block just played
 }
 
-/**
- * @brief Process sample through biquad filter using MATHACL
- * 
- * @param filter Biquad filter state
- * @param input Input sample (16-bit)
- * @return Filtered output sample (16-bit)
- * 
- * Uses MATHACL MPY_32 for efficient fixed-point multiplication
- * Direct Form II Transposed structure for numerical stability
- */
-static inline int16_t BiquadFilter_Process(BiquadFilter_t *filter, int16_t input) {
-    // Convert input to Q15
-    int32_t x0 = (int32_t)input << 15;
-    
-    // Calculate feedforward
-    // w0 = x0 - a1*y1 - a2*y2
-    int32_t w0 = x0;
-    
-    // Use MATHACL for multiplication (faster than software)
-    // a1 * y1
-    DL_MathACL_operationConfig config = {
-        .opType = DL_MATHACL_OP_TYPE_MPY_32,
-        .qType = DL_MATHACL_Q_TYPE_Q31,
-        .opSign = DL_MATHACL_OPSIGN_SIGNED
-    };
-    
-    DL_MathACL_configOperation(MATHACL, &config, filter->a1, filter->y1);
-    DL_MathACL_waitForOperation(MATHACL);
-    int32_t temp = DL_MathACL_getResultOne(MATHACL);
-    w0 -= (temp >> 15);
-    
-    // a2 * y2
-    DL_MathACL_configOperation(MATHACL, &config, filter->a2, filter->y2);
-    DL_MathACL_waitForOperation(MATHACL);
-    temp = DL_MathACL_getResultOne(MATHACL);
-    w0 -= (temp >> 15);
-    
-    // Calculate output
-    // y0 = b0*w0 + b1*w1 + b2*w2
-    int32_t y0 = 0;
-    
-    // b0 * w0
-    DL_MathACL_configOperation(MATHACL, &config, filter->b0, w0);
-    DL_MathACL_waitForOperation(MATHACL);
-    temp = DL_MathACL_getResultOne(MATHACL);
-    y0 += (temp >> 15);
-    
-    // b1 * x1
-    DL_MathACL_configOperation(MATHACL, &config, filter->b1, filter->x1);
-    DL_MathACL_waitForOperation(MATHACL);
-    temp = DL_MathACL_getResultOne(MATHACL);
-    y0 += (temp >> 15);
-    
-    // b2 * x2
-    DL_MathACL_configOperation(MATHACL, &config, filter->b2, filter->x2);
-    DL_MathACL_waitForOperation(MATHACL);
-    temp = DL_MathACL_getResultOne(MATHACL);
-    y0 += (temp >> 15);
-    
-    // Update state
-    filter->x2 = filter->x1;
-    filter->x1 = w0;
-    filter->y2 = filter->y1;
-    filter->y1 = y0;
-    
-    // Convert back to 16-bit
-    return (int16_t)(y0 >> 15);
+void PendSV_Handler(void) {
+  int16_t mix[AUDIO_BLOCK_SIZE];
+  AudioOutStats_t stats;
+  SynthStatus_t status;
+
+  IsrLoad_Enter(&isr_render, Cycles_Now());
+#if ENABLE_MIDI_IN
+  // Received since the last block: applied before this one renders
+  MidiIn_Process(&midi_in, &midi_rx);
+  gSynthState.midi_in_overruns = midi_rx.overruns;
+  gSynthState.midi_in_errors = midi_in.errors;
+#endif
+  Synth_RenderBlock(mix, AUDIO_BLOCK_SIZE);
+  AUDIO_OUT.submit_block(mix, AUDIO_BLOCK_SIZE);
+  AUDIO_OUT.stats(&stats);
+  if (stats.dropped != gSynthState.audio_underruns) {
+    Trace_Event(TRACE_UNDERRUN, 0, (uint16_t)stats.dropped);
+  }
+  gSynthState.audio_underruns = stats.dropped;
+
+  // Mirror the engine for the debugger and the display
+  Synth_GetStatus(&status);
+  gSynthState.volume = status.volume;
+  gSynthState.audio_playing = status.playing;
+  gSynthState.waveform = INSTRUMENTS[status.instrument].waveform;
+  gSynthState.frequency = (float)status.pitch_hz;
+  gSynthState.phase_increment = status.phase_increment;
+  gSynthState.audio_samples_generated = status.samples_generated;
+  gSynthState.fx_cycles = status.fx_cycles;
+  gSynthState.limiter_gr_db10 = status.limiter_gr_db10;
+  gSynthState.tempo_bpm10 = status.tempo_bpm10;
+  gSynthState.clock_external = status.clock_external;
+
+#if ENABLE_MIDI_OUT
+  Process_MIDI_Output(&status);
+#endif
+  IsrLoad_Exit(&isr_render, Cycles_Now());
+
+#if ENABLE_MIDI_OUT
+  // Reports only queue bytes; outside the measurement all the same, so
+  // the load figures show the audio work alone
+  if (telemetry_due) {
+    telemetry_due = false;
+    Telemetry_Send();
+  }
+  // Dumps wait a block for room rather than lose a frame
+  if (profiler_dump_due) {
+    uint8_t frame[PROFILER_FRAME_MAX];
+    if (MidiOut_Free(&midi_out) >= PROFILER_FRAME_MAX) {
+      uint8_t length = Profiler_DumpFrame(&profiler, &profiler_dump, frame);
+      if (length == 0) {
+        profiler_dump_due = false;
+      } else {
+        MidiOut_Write(&midi_out, frame, length);
+      }
+    }
+  } else if (perf_dump_due) {
+    uint8_t frame[PERF_FRAME_MAX];
+    if (MidiOut_Free(&midi_out) >= PERF_FRAME_MAX) {
+      uint8_t length = Perf_DumpFrame(&perf_dump, frame);
+      if (length == 0) {
+        perf_dump_due = false;
+      } else {
+        MidiOut_Write(&midi_out, frame, length);
+      }
+    }
+  }
+#if ENABLE_MIDI_IN
+  if (bank_dump_due) {
+    uint8_t frame[BANK_FRAME_MAX];
+    if (MidiOut_Free(&midi_out) >= BANK_FRAME_MAX) {
+      uint16_t length =
+          SynthBank_DumpFrame(&bank_dump, &bank_dump_cursor, frame);
+      if (length == 0) { // Every record sent: the reply closes the dump
+        length = SynthBank_ReplyFrame(BANK_SYSEX_REQUEST, BANK_OK, frame);
+        bank_dump_due = false;
+      }
+      MidiOut_Write(&midi_out, frame, length);
+    }
+  }
+  if (bank_reply_due && MidiOut_Free(&midi_out) >= BANK_FRAME_MAX) {
+    uint8_t frame[BANK_FRAME_MAX];
+    uint16_t length =
+        SynthBank_ReplyFrame(BANK_SYSEX_COMMAND, bank_flash_status, frame);
+    MidiOut_Write(&midi_out, frame, length);
+    bank_reply_due = false;
+  }
+#endif
+  MidiOut_FlushControllers(&midi_out, systick_count);
+  MidiOut_Poll(&midi_out);
+#endif
 }
 
 //=============================================================================
-// LINEAR INTERPOLATION
+// AUDIO INTERRUPT LOAD (SysTick, every LOAD_WINDOW_TICKS)
 //=============================================================================
-
-/**
- * @brief Linear interpolation between samples
- * 
- * @param current Current sample
- * @param fraction Interpolation fraction (0-255)
- * @return Interpolated sample
- * 
- * Uses simple linear interpolation: y = y0 + (y1-y0) * fraction
- * Fraction is 8-bit for efficiency (0 = full last, 255 = full current)
- */
-static inline int16_t Interpolate_Linear(int16_t current, uint8_t fraction) {
-    if (!g_interpolator.enabled || fraction == 255) {
-        g_interpolator.last_sample = current;
-        return current;
-    }
-    
-    // Linear interpolation
-    int32_t delta = (int32_t)current - (int32_t)g_interpolator.last_sample;
-    int32_t result = (int32_t)g_interpolator.last_sample + ((delta * fraction) >> 8);
-    
-    g_interpolator.last_sample = current;
-    return (int16_t)result;
+static void Load_Update(void) {
+  uint32_t now = Cycles_Now();
+  IsrLoad_Update(&isr_render, now);
+  IsrLoad_Update(&isr_service, now);
+
+  gSynthState.isr_cycles_min =
+      (isr_render.count_total != 0) ? isr_render.min_cycles : 0;
+  gSynthState.isr_cycles_avg = isr_render.avg_cycles;
+  gSynthState.isr_cycles_max = isr_render.max_cycles;
+  gSynthState.isr_overruns = isr_render.overruns;
+  gSynthState.svc_cycles_max = isr_service.max_cycles;
+  gSynthState.cpu_load_pct10 =
+      isr_render.load_pct10 + isr_service.load_pct10;
+  Synth_UpdatePartLoad(now); // Share of the render time per part
 }
 
 //=============================================================================
-// DAC12 AUDIO OUTPUT HELPERS
+// SYNTH ENGINE FEEDBACK
 //=============================================================================
-
-/**
- * @brief Convert audio sample to 12-bit DAC value
- * @param sample Audio sample (-2048 to +2047 for 12-bit range)
- * @return DAC value (0 to 4095)
- */
-static inline uint16_t Audio_SampleToDAC12(int16_t sample) {
-    // OPA GAIN COMPENSATION
-    // If OPA has 2x gain, scale sample by 0.5 to prevent output clipping
-    // This ensures OPA output stays within 0-3.3V range
-    #if (OPA_GAIN_FACTOR == 2)
-        sample = sample / 2;  // Reduce amplitude by 50% for 2x OPA gain
-    #endif
-    
-    // Convert signed sample to unsigned DAC value
-    // Sample range: -2048 to +2047 (or -1024 to +1023 with 2x compensation)
-    // DAC range:    0 to 4095
-    int32_t dac_val = (int32_t)sample + 2048;
-    
-    // Clamp to 12-bit range
-    if (dac_val < 0) dac_val = 0;
-    if (dac_val > 4095) dac_val = 4095;
-    
-    return (uint16_t)dac_val;
-}
-
-/**
- * @brief Write audio sample to DAC12
- * @param sample Audio sample (-2048 to +2047)
- */
-static inline void Audio_WriteDAC12(int16_t sample) {
-    uint16_t dac_val = Audio_SampleToDAC12(sample);
-    DL_DAC12_output12(DAC0, dac_val);
+static void On_Synth_Event(SynthEvent_t event, int32_t value) {
+  if (event == SYNTH_EVENT_EPIC_STEP) {
+    // Visual feedback: Toggle between blue and green at each step
+    DL_GPIO_togglePins(GPIO_RGB_PORT, GPIO_RGB_BLUE_PIN | GPIO_RGB_GREEN_PIN);
+  } else if (event == SYNTH_EVENT_OCTAVE) {
+#if ENABLE_DEBUG_LEDS
+    // Lys-indikasjon for å se hvor du er
+    Debug_LED_Update((int8_t)value);
+#else
+    (void)value;
+#endif
+  } else if (event == SYNTH_EVENT_MIDI_CLOCK) {
+#if ENABLE_MIDI_OUT
+    // Master clock: queued in the block it falls in (up to a block early)
+    uint8_t byte = (uint8_t)value;
+    MidiOut_Write(&midi_out, &byte, 1);
+#endif
+  }
 }
 
-/**
- * @brief Mute DAC12 output (set to midpoint)
- */
-static inline void Audio_MuteDAC12(void) {
-    DL_DAC12_output12(DAC0, 2048);  // Midpoint = silence
+//=============================================================================
+// CYCLE COUNTER
+//=============================================================================
+static uint32_t Cycles_Now(void) {
+  return DL_TimerG_getTimerCount(TIMER_CYCLES_INST);
 }
 
 //=============================================================================
-// AUDIO GENERATION (Using Library API for waveforms)
+// MIDI OUTPUT (once per block)
 //=============================================================================
-static void Generate_Audio_Sample(void) {
-  if (g_phase_increment == 0)
-    g_phase_increment = 118111601;
-
-  uint16_t amplitude = Envelope_GetAmplitude(&envelope); // Library API
-  if (gSynthState.volume == 0 || amplitude == 0) {
-    // MUTE: Set DAC12 to midpoint
-    Audio_MuteDAC12();
-    g_phase += g_phase_increment;
-    gSynthState.audio_samples_generated++;
-    return;
-  }
-
-  int16_t sample;
-  if (chord_mode != CHORD_OFF) {
-    sample = Generate_Chord_Sample(g_chord_phases, g_chord_increments);
-  } else {
-    const InstrumentProfile_t *inst = &INSTRUMENTS[current_instrument];
-    uint32_t modulated_phase = g_phase;
-
-    // Vibrato
-    if (effects_enabled && inst->vibrato_depth > 0) {
-      uint8_t vib_index = vibrato_phase >> 8;
-      const int16_t *sine = Audio_GetSineTable(); // Library API
-      int16_t vibrato_lfo = sine[vib_index];
-      int32_t phase_offset = ((int32_t)vibrato_lfo * inst->vibrato_depth *
-                              (int32_t)g_phase_increment) /
-                             100000;
-      modulated_phase = g_phase + phase_offset;
-    }
-
-    uint8_t index = (uint8_t)((modulated_phase >> 24) & 0xFF);
-    
-    // Use MATHACL hardware for sine, library for others
-    if (inst->waveform == WAVE_SINE) {
-        // Perfect hardware-accelerated sine!
-        sample = MATHACL_Sine(modulated_phase);
-    } else {
-        // Use library for square/saw/triangle
-        sample = Audio_GenerateWaveform(index, inst->waveform);
-    }
-
-    // Harmonics
-    if (inst->num_harmonics >= 1) {
-      uint8_t h1_index = (index << 1) & 0xFF;
-      int16_t harmonic1 =
-          Audio_GenerateWaveform(h1_index, inst->waveform); // Library API
-      sample = (sample * 2 + harmonic1) / 3;
-    }
-
-    #if ENABLE_WAVEFORM_DISPLAY                                                       
-static uint8_t waveform_decimate_counter = 0;                                    
-if (++waveform_decimate_counter >= 40) {                                         
-     waveform_decimate_counter = 0;                                                
-  waveform_buffer[waveform_write_index++] = sample;                              
-   if (waveform_write_index >= 64)                                                
-     waveform_write_index = 0;                                                    
-  }                                     
-#endif        
-
-    // Tremolo
-    if (effects_enabled && inst->tremolo_depth > 0) {
-      uint8_t trem_index = tremolo_phase >> 8;
-      const int16_t *sine = Audio_GetSineTable(); // Library API
-      int16_t tremolo_lfo = sine[trem_index];
-      int16_t mod = 1000 + ((int32_t)tremolo_lfo * inst->tremolo_depth) / 100;  
-      sample = (int16_t)(((int32_t)sample * mod) / 1000);
-    }
-    g_phase += g_phase_increment;
+#if ENABLE_MIDI_OUT
+static void Process_MIDI_Output(const SynthStatus_t *status) {
+  // Send MIDI Program Change when the instrument changes
+  if (status->instrument != midi_last_instrument) {
+    midi_last_instrument = status->instrument;
+    MIDI_Message_t msg;
+    MIDI_CreateProgramChange(0, status->instrument, &msg);
+    MidiOut_Send(&midi_out, &msg);
   }
 
-  // ✅ CORRECT ORDER: Apply envelope and volume FIRST
-  sample = (int16_t)(((int32_t)sample * amplitude) / 1000);
-  sample = (int16_t)(((int32_t)sample * gSynthState.volume) / 100);
-
-
-  // ✅ CORRECT: Write to DAC12 using helper
-  Audio_WriteDAC12(sample);
-
-  // ============================================================================
-  // MIDI OUTPUT - Send MIDI messages instead of raw audio
-  // ============================================================================
-  
   // Send MIDI Note On/Off on frequency changes
-  if (base_frequency_hz != midi_last_frequency) {
-    midi_last_frequency = base_frequency_hz;
+  if (status->frequency_hz != midi_last_frequency) {
+    midi_last_frequency = status->frequency_hz;
     
-    uint8_t midi_note = MIDI_FreqToNote((uint16_t)base_frequency_hz);
+    uint8_t midi_note = MIDI_FreqToNote((uint16_t)status->frequency_hz);
     
     // Note Off for previous note
     if (midi_note_is_on && midi_last_note != midi_note) {
       MIDI_Message_t msg;
       MIDI_CreateNoteOff(0, midi_last_note, 64, &msg);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data2);
+      MidiOut_Send(&midi_out, &msg);
+      Trace_Event(TRACE_NOTE_OFF, midi_last_note, 64);
       midi_note_is_on = false;
     }
     
     // Note On for new note
-    if (gSynthState.audio_playing && (!midi_note_is_on || midi_last_note != midi_note)) {
+    if (status->playing && (!midi_note_is_on || midi_last_note != midi_note)) {
       MIDI_Message_t msg;
-      uint8_t velocity = (gSynthState.volume * 127) / 100;
+      uint8_t velocity = (status->volume * 127) / 100;
       if (velocity == 0) velocity = 1; // MIDI velocity 0 = Note Off
       MIDI_CreateNoteOn(0, midi_note, velocity, &msg);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-      DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data2);
+      MidiOut_Send(&midi_out, &msg);
+      Trace_Event(TRACE_NOTE_ON, midi_note, velocity);
       midi_last_note = midi_note;
       midi_note_is_on = true;
     }
   }
   
   // Send MIDI Note Off when audio stops
-  if (!gSynthState.audio_playing && midi_note_is_on) {
+  if (!status->playing && midi_note_is_on) {
     MIDI_Message_t msg;
     MIDI_CreateNoteOff(0, midi_last_note, 64, &msg);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data2);
+    MidiOut_Send(&midi_out, &msg);
+    Trace_Event(TRACE_NOTE_OFF, midi_last_note, 64);
     
     // Send MIDI CC 123 (All Notes Off) as safety
     MIDI_CreateControlChange(0, 123, 0, &msg);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data2);
+    MidiOut_Send(&midi_out, &msg);
+    Trace_Event(TRACE_ALL_NOTES_OFF, 0, 0);
     
     midi_note_is_on = false;
   }
   
-  // Send MIDI CC for volume changes
-  if (gSynthState.volume != midi_last_volume) {
-    midi_last_volume = gSynthState.volume;
-    MIDI_Message_t msg;
-    uint8_t midi_volume = (gSynthState.volume * 127) / 100;
-    MIDI_CreateControlChange(0, MIDI_CC_VOLUME, midi_volume, &msg);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.status);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data1);
-    DL_UART_transmitDataBlocking(UART_AUDIO_INST, msg.data2);
+  // Send MIDI CC for volume changes (thinned while the joystick moves)
+  if (status->volume != midi_last_volume) {
+    midi_last_volume = status->volume;
+    uint8_t midi_volume = (status->volume * 127) / 100;
+    MidiOut_ControlChange(&midi_out, 0, MIDI_CC_VOLUME, midi_volume,
+                          systick_count);
   }
-
-  // ✅ CORRECT: Increment counter only ONCE
-  gSynthState.audio_samples_generated++;
 }
-//==============================================================================
-// CHORD GENERATION
-//==============================================================================
-static int16_t Generate_Chord_Sample(volatile uint32_t *phases,
-                                     volatile uint32_t *increments) {
-  const InstrumentProfile_t *inst = &INSTRUMENTS[current_instrument];
-  int32_t mixed = 0;
-  uint8_t num_voices = (chord_mode == CHORD_OFF) ? 1 : 3;
-
-  for (uint8_t v = 0; v < num_voices; v++) {
-    uint8_t index = (uint8_t)((phases[v] >> 24) & 0xFF);
-    int16_t sample = Audio_GenerateWaveform(index, inst->waveform); // Library API
-
-    if (inst->num_harmonics >= 1) {
-      uint8_t h_index = (index << 1) & 0xFF;
-      int16_t harmonic =
-          Audio_GenerateWaveform(h_index, inst->waveform); // Library API
-      sample = (sample * 2 + harmonic) / 3;
-    }
+#endif
 
-    mixed += sample;
-    phases[v] += increments[v];
+//=============================================================================
+// TELEMETRY (SysEx on the MIDI UART, once per second)
+//=============================================================================
+#if ENABLE_MIDI_OUT
+/*
+ * F0 7D 01 <load> <min> <avg> <max> <budget> <overruns> <underruns>
+ * <svc_max> F7: eight values, each 21 bits as three 7-bit bytes, LSB first
+ * (MIDI_PackU21). load is 0.1 %, cycles are MCLK. Decoded by
+ * uart_audio_player.py.
+ *
+ * Then F0 7D 08 <count> and per multi-timbral part <load> <avg> <max>
+ * <voices> F7 (21-bit values as above; avg/max are render cycles per block).
+ */
+static void Telemetry_Send_Parts(void) {
+  uint8_t frame[4 + SYNTH_PART_COUNT * 4 * 3 + 1];
+  uint8_t *p = frame;
+
+  *p++ = MIDI_SYSEX_START;
+  *p++ = MIDI_SYSEX_ID_NONCOMMERCIAL;
+  *p++ = TELEMETRY_PART_LOAD;
+  *p++ = SYNTH_PART_COUNT;
+  for (uint8_t i = 0; i < SYNTH_PART_COUNT; i++) {
+    SynthPartStatus_t part;
+    Synth_GetPartStatus(i, &part);
+    p = MIDI_PackU21(p, part.load_pct10);
+    p = MIDI_PackU21(p, part.cycles_avg);
+    p = MIDI_PackU21(p, part.cycles_max);
+    p = MIDI_PackU21(p, part.voices);
   }
+  *p++ = MIDI_SYSEX_END;
 
-  return (int16_t)(mixed / num_voices);
+  MidiOut_Write(&midi_out, frame, (uint8_t)(p - frame));
+}
+
+static void Telemetry_Send(void) {
+  uint8_t frame[3 + 8 * 3 + 1];
+  uint8_t *p = frame;
+
+  *p++ = MIDI_SYSEX_START;
+  *p++ = MIDI_SYSEX_ID_NONCOMMERCIAL;
+  *p++ = TELEMETRY_ISR_LOAD;
+  p = MIDI_PackU21(p, gSynthState.cpu_load_pct10);
+  p = MIDI_PackU21(p, gSynthState.isr_cycles_min);
+  p = MIDI_PackU21(p, gSynthState.isr_cycles_avg);
+  p = MIDI_PackU21(p, gSynthState.isr_cycles_max);
+  p = MIDI_PackU21(p, gSynthState.isr_budget);
+  p = MIDI_PackU21(p, gSynthState.isr_overruns);
+  p = MIDI_PackU21(p, gSynthState.audio_underruns);
+  p = MIDI_PackU21(p, gSynthState.svc_cycles_max);
+  *p++ = MIDI_SYSEX_END;
+
+  MidiOut_Write(&midi_out, frame, (uint8_t)(p - frame));
+  Telemetry_Send_Parts();
 }
 
 //=============================================================================
-// UPDATE PHASE INCREMENT (from v27 - uses global g_phase_increment)
+// MIDI UART (DMA_CH1 -> UART_AUDIO TX, queued by lib/midi/midi_out)
 //=============================================================================
-static void Update_Phase_Increment(void) {
-  if (base_frequency_hz == 0)
-    base_frequency_hz = 440;
-
-  int8_t table_index = current_octave_shift + 12;
-  if (table_index < 0)
-    table_index = 0;
-  if (table_index > 24)
-    table_index = 24;
-
-  uint32_t bend_ratio = PITCH_BEND_TABLE[table_index];
-  uint64_t bent_freq_64 = ((uint64_t)base_frequency_hz * bend_ratio) >> 16;
-  uint32_t bent_freq = (uint32_t)bent_freq_64;
-
-  if (bent_freq < FREQ_MIN_HZ)
-    bent_freq = FREQ_MIN_HZ;
-  if (bent_freq > FREQ_MAX_HZ)
-    bent_freq = FREQ_MAX_HZ;
-
-  if (bent_freq > 0 && bent_freq <= 8000) {
-    uint64_t temp = ((uint64_t)bent_freq << 32) / 16000ULL;
-    if (temp > 0 && temp <= 0xFFFFFFFF)
-      g_phase_increment = (uint32_t)temp;
-    else
-      g_phase_increment = 118111601;
-  } else {
-    g_phase_increment = 118111601;
+// Single mode disables the channel when the last byte is taken
+static bool Midi_Dma_Busy(void) {
+  return DL_DMA_isChannelEnabled(DMA, DMA_CH1_CHAN_ID);
+}
+
+static void Midi_Dma_Start(const uint8_t *data, uint16_t n) {
+  DL_DMA_setSrcAddr(DMA, DMA_CH1_CHAN_ID, (uint32_t)data);
+  DL_DMA_setTransferSize(DMA, DMA_CH1_CHAN_ID, n);
+  DL_DMA_enableChannel(DMA, DMA_CH1_CHAN_ID);
+}
+
+static void Midi_Out_Init(void) {
+  static const MidiOutPort_t port = {Midi_Dma_Busy, Midi_Dma_Start};
+
+  // SysConfig sets DMA_CH1 to repeat; one span per enable here
+  DL_DMA_disableChannel(DMA, DMA_CH1_CHAN_ID);
+  DL_DMA_setTransferMode(DMA, DMA_CH1_CHAN_ID, DL_DMA_SINGLE_TRANSFER_MODE);
+  DL_DMA_setDestAddr(DMA, DMA_CH1_CHAN_ID, (uint32_t)&UART_AUDIO_INST->TXDATA);
+  MidiOut_Init(&midi_out, &port);
+  MidiOut_ThinController(&midi_out, 0, MIDI_CC_VOLUME, MIDI_VOLUME_TICKS);
+}
+
+//=============================================================================
+// EVENT TRACE (main loop, SysEx frames into the MIDI queue)
+//=============================================================================
+static void Trace_Drain(void) {
+  uint8_t frame[TRACE_FRAME_MAX];
+
+  // Records stay in the trace ring until a whole frame fits
+  if (MidiOut_Free(&midi_out) < TRACE_FRAME_MAX) return;
+
+  // PendSV can fill the queue after the check: release the records only
+  // once the write is taken, a refused frame goes again next time
+  uint8_t length = Trace_PeekFrame(frame);
+  if (length != 0 && MidiOut_Write(&midi_out, frame, length)) {
+    Trace_ReleaseFrame();
+  }
+}
+#endif
+
+#if ENABLE_MIDI_IN
+//=============================================================================
+// MIDI INPUT (UART_AUDIO RX -> lib/midi/midi_in -> engine)
+//=============================================================================
+// Priority 1, above the block renderer: the 4-byte RX FIFO fills in 43 us
+// at 921600 baud, a block takes up to 2 ms
+void UART_AUDIO_INST_IRQHandler(void) {
+  switch (DL_UART_Main_getPendingInterrupt(UART_AUDIO_INST)) {
+  case DL_UART_MAIN_IIDX_OVERRUN_ERROR:
+    midi_rx.overruns++; // Lost in the FIFO
+    /* fall through */
+  case DL_UART_MAIN_IIDX_RX:
+  case DL_UART_MAIN_IIDX_RX_TIMEOUT_ERROR:
+    while (!DL_UART_Main_isRXFIFOEmpty(UART_AUDIO_INST)) {
+      MidiIn_RingPut(&midi_rx, DL_UART_Main_receiveData(UART_AUDIO_INST));
+    }
+    break;
+  default:
+    break;
   }
+}
+
+// PendSV: the engine takes MIDI in the audio context
+static void Midi_In_Message(void *ctx, const MIDI_Message_t *msg) {
+  (void)ctx;
+  Synth_MidiMessage(msg->status, msg->data1, msg->data2);
+}
 
-  if (g_phase_increment == 0)
-    g_phase_increment = 118111601;
-
-  gSynthState.phase_increment = g_phase_increment;
-  gSynthState.frequency = (float)bent_freq;
-
-  // Update chord increments
-  if (chord_mode != CHORD_OFF) {
-    const int8_t *intervals = CHORD_INTERVALS[chord_mode];
-    for (uint8_t voice = 0; voice < 3; voice++) {
-      int8_t chord_table_index = table_index + intervals[voice];
-      if (chord_table_index < 0)
-        chord_table_index = 0;
-      if (chord_table_index > 24)
-        chord_table_index = 24;
-
-      uint32_t chord_ratio = PITCH_BEND_TABLE[chord_table_index];
-      uint64_t chord_freq_64 =
-          ((uint64_t)base_frequency_hz * chord_ratio) >> 16;
-      uint32_t chord_freq = (uint32_t)chord_freq_64;
-
-      if (chord_freq < FREQ_MIN_HZ)
-        chord_freq = FREQ_MIN_HZ;
-      if (chord_freq > FREQ_MAX_HZ)
-        chord_freq = FREQ_MAX_HZ;
-
-      if (chord_freq > 0 && chord_freq <= 8000) {
-        uint64_t chord_temp = ((uint64_t)chord_freq << 32) / 16000ULL;
-        if (chord_temp > 0 && chord_temp <= 0xFFFFFFFF)
-          g_chord_increments[voice] = (uint32_t)chord_temp;
-        else
-          g_chord_increments[voice] = g_phase_increment;
+// Clock and transport (timed at the block they are parsed in)
+static void Midi_In_RealTime(void *ctx, uint8_t byte) {
+  (void)ctx;
+  Synth_MidiRealTime(byte);
+}
+
+#if ENABLE_MIDI_OUT
+// Sound bank frames (lib/audio/synth_bank.h). A record goes into the bank
+// in use at once; a dump or a flash write is handed on and replied later.
+static void Midi_In_SysEx(void *ctx, const uint8_t *frame, uint16_t length) {
+  static SynthBank_t edit; // Kept off the PendSV stack
+  uint8_t reply[BANK_FRAME_MAX];
+  (void)ctx;
+
+  Synth_GetBank(&edit);
+  BankFrame_t f = SynthBank_ParseFrame(&edit, frame, length);
+  switch (f.id) {
+  case BANK_SYSEX_INSTRUMENT:
+  case BANK_SYSEX_PRESET:
+    if (f.status == BANK_OK) {
+      Synth_SetBank(&edit);
+    }
+    break;
+  case BANK_SYSEX_REQUEST:
+    if (f.status == BANK_OK) {
+      bank_dump = edit;
+      bank_dump_cursor = 0;
+      bank_dump_due = true;
+      return;
+    }
+    break;
+  case BANK_SYSEX_COMMAND:
+    if (f.status == BANK_OK && bank_flash_due) {
+      f.status = BANK_ERR_FLASH; // Still writing the last one
+    } else if (f.status == BANK_OK) {
+      if (f.arg == BANK_OP_FACTORY && bank_blob) {
+        Synth_MapBank(bank_blob); // The compiled bank is this board's factory
+      } else if (f.arg == BANK_OP_FACTORY) {
+        Synth_FactoryBank();
       } else {
-        g_chord_increments[voice] = g_phase_increment;
+        SynthBank_Encode(&edit, (uint8_t *)bank_image);
       }
+      bank_flash_op = f.arg;
+      bank_flash_due = true;
+      return;
+    }
+    break;
+  default:
+    return; // Not a bank frame, or a reply
+  }
+  // Dropped if the queue is full; the host times out and sends again
+  length = SynthBank_ReplyFrame(f.id, f.status, reply);
+  MidiOut_Write(&midi_out, reply, length);
+}
+#endif
+
+static void Midi_In_Init(void) {
+#if ENABLE_MIDI_OUT
+  static const MidiInHandlers_t handlers = {Midi_In_Message, Midi_In_RealTime,
+                                            Midi_In_SysEx, NULL};
+#else
+  static const MidiInHandlers_t handlers = {Midi_In_Message, Midi_In_RealTime,
+                                            NULL, NULL};
+#endif
+
+  MidiIn_RingInit(&midi_rx);
+  MidiIn_Init(&midi_in, &handlers);
+
+  // One interrupt per two bytes in a burst; the timeout takes the odd last
+  // byte after one character time of silence
+  DL_UART_Main_setRXFIFOThreshold(UART_AUDIO_INST,
+                                  DL_UART_RX_FIFO_LEVEL_1_2_FULL);
+  DL_UART_Main_setRXInterruptTimeout(UART_AUDIO_INST, 10);
+  DL_UART_Main_enableInterrupt(UART_AUDIO_INST,
+                               DL_UART_MAIN_INTERRUPT_RX |
+                                   DL_UART_MAIN_INTERRUPT_RX_TIMEOUT_ERROR |
+                                   DL_UART_MAIN_INTERRUPT_OVERRUN_ERROR);
+  NVIC_ClearPendingIRQ(UART_AUDIO_INST_INT_IRQN);
+  NVIC_SetPriority(UART_AUDIO_INST_INT_IRQN, 1);
+  NVIC_EnableIRQ(UART_AUDIO_INST_INT_IRQN);
+}
+#endif
+
+//=============================================================================
+// SETTINGS FLASH (SETTINGS_FLASH_ADDRESS, lib/storage/flash_kv.h)
+//=============================================================================
+// Main loop only. Erases and programs run from RAM, but anything else that
+// fetches from flash waits for them: a record takes some 100 us, a sector
+// erase a few ms (expect an audio underrun).
+static bool Kv_Erase(uint32_t offset) {
+  uint32_t address = SETTINGS_FLASH_ADDRESS + offset;
+
+  DL_FlashCTL_executeClearStatus(FLASHCTL);
+  DL_FlashCTL_unprotectSector(FLASHCTL, address,
+                              DL_FLASHCTL_REGION_SELECT_MAIN);
+  return DL_FlashCTL_eraseMemoryFromRAM(FLASHCTL, address,
+                                        DL_FLASHCTL_COMMAND_SIZE_SECTOR) ==
+         DL_FLASHCTL_COMMAND_STATUS_PASSED;
+}
+
+// Never crosses a sector: flash_kv writes within the active one
+static bool Kv_Program(uint32_t offset, const uint32_t *words,
+                       uint16_t count) {
+  uint32_t address = SETTINGS_FLASH_ADDRESS + offset;
+
+  DL_FlashCTL_executeClearStatus(FLASHCTL);
+  DL_FlashCTL_unprotectSector(FLASHCTL, address,
+                              DL_FLASHCTL_REGION_SELECT_MAIN);
+  if (!DL_FlashCTL_programMemoryBlocking64WithECCGenerated(
+          FLASHCTL, address, (uint32_t *)words, count,
+          DL_FLASHCTL_REGION_SELECT_MAIN)) {
+    return false;
+  }
+  // Read back: what the next boot will scan
+  return memcmp((const void *)(uintptr_t)address, words, count * 4u) == 0;
+}
+
+// CRC peripheral, set up in Settings_Load as the CRC-32 flash_kv expects
+static uint32_t Kv_Crc32(const uint8_t *data, uint16_t n) {
+  DL_CRC_setSeed32(CRC, 0xFFFFFFFF);
+  while (n--) {
+    DL_CRC_feedData8(CRC, *data++);
+  }
+  return DL_CRC_getResult32(CRC);
+}
+
+// Stored value of a key, if it has the expected length
+static const uint8_t *Setting_Get(SettingKey_t key, uint16_t length) {
+  uint16_t stored;
+  const uint8_t *value = FlashKv_Get(&settings, key, &stored);
+  return (value && stored == length) ? value : NULL;
+}
 
-      if (g_chord_increments[voice] == 0)
-        g_chord_increments[voice] = g_phase_increment;
+// Boot, before the audio starts: keys without a value (erased flash, a
+// record cut short) keep their defaults. The engine checks the ranges.
+static void Settings_Load(void) {
+  static const FlashKvPort_t port = {Kv_Erase, Kv_Program, Kv_Crc32,
+                                     Cycles_Now};
+  const uint8_t *value;
+  uint16_t length;
+
+  DL_CRC_reset(CRC);
+  DL_CRC_enablePower(CRC);
+  delay_cycles(POWER_STARTUP_DELAY);
+  DL_CRC_init(CRC, DL_CRC_32_POLYNOMIAL, DL_CRC_BIT_REVERSED,
+              DL_CRC_INPUT_ENDIANESS_LITTLE_ENDIAN,
+              DL_CRC_OUTPUT_BYTESWAP_DISABLED);
+
+  FlashKv_Init(&settings, (const uint8_t *)SETTINGS_FLASH_ADDRESS, &port);
+  gSynthState.settings_scan_cycles = settings.scan_cycles;
+  gSynthState.settings_records = settings.scan_records;
+
+  // The compiled bank, then a bank stored over SysEx on top of it
+  if (SynthBank_Map(&bank_blob, (const uint8_t *)BANK_BLOB_ADDRESS,
+                    BANK_IMAGE_BYTES) == BANK_OK) {
+    Synth_MapBank(bank_blob);
+  }
+  value = FlashKv_Get(&settings, SETTING_BANK, &length);
+  if (value) {
+    SynthBank_t stored;
+    if (SynthBank_Decode(&stored, value, length) == BANK_OK) {
+      Synth_SetBank(&stored);
     }
-  } else {
-    g_chord_increments[0] = g_phase_increment;
-    g_chord_increments[1] = g_phase_increment;
-    g_chord_increments[2] = g_phase_increment;
+  }
+  // Applied in this order at the first block: the preset sets an
+  // instrument, which may have been changed after it
+  if ((value = Setting_Get(SETTING_PRESET, 1))) {
+    Synth_SetPreset(value[0]);
+  }
+  if ((value = Setting_Get(SETTING_INSTRUMENT, 1))) {
+    Synth_SetInstrument((Instrument_t)value[0]);
+  }
+  if ((value = Setting_Get(SETTING_KEY, 1))) {
+    Synth_SetKey((MusicalKey_t)value[0]);
+  }
+  if ((value = Setting_Get(SETTING_MODE, 1))) {
+    Synth_SetMode((MusicalMode_t)value[0]);
+  }
+  if ((value = Setting_Get(SETTING_VOLUME, 1))) {
+    Synth_SetVolume(value[0]);
+  }
+  if ((value = Setting_Get(SETTING_ACCEL_CAL, 4))) {
+    memcpy(&accel.offset_x, value, 2);
+    memcpy(&accel.offset_y, value + 2, 2);
   }
 }
 
+// Main loop: the settings are written once they have stayed put for
+// SETTINGS_SAVE_TICKS, so a sweep of the joystick costs one record per key.
+// flash_kv skips the keys that still hold the same value. Greensleeves
+// drives the instrument and key itself, so nothing is saved while it plays.
+static void Settings_Poll(void) {
+  static uint8_t pending[5];
+  static int16_t pending_cal[2];
+  static uint32_t changed_at;
+  static bool dirty = false;
+  SynthStatus_t status;
+
+  Synth_GetStatus(&status);
+  if (status.epic_active) {
+    return;
+  }
+  const uint8_t now[5] = {status.key, status.mode, status.instrument,
+                          status.preset, status.volume};
+  const int16_t cal[2] = {accel.offset_x, accel.offset_y};
+  if (memcmp(now, pending, sizeof(now)) != 0 ||
+      memcmp(cal, pending_cal, sizeof(cal)) != 0) {
+    memcpy(pending, now, sizeof(now));
+    memcpy(pending_cal, cal, sizeof(cal));
+    changed_at = systick_count;
+    dirty = true;
+    return;
+  }
+  if (!dirty || systick_count - changed_at < SETTINGS_SAVE_TICKS) {
+    return;
+  }
+  dirty = false; // A failed write is tried again at the next change
+  FlashKv_Set(&settings, SETTING_KEY, &now[0], 1);
+  FlashKv_Set(&settings, SETTING_MODE, &now[1], 1);
+  FlashKv_Set(&settings, SETTING_INSTRUMENT, &now[2], 1);
+  FlashKv_Set(&settings, SETTING_PRESET, &now[3], 1);
+  FlashKv_Set(&settings, SETTING_VOLUME, &now[4], 1);
+  FlashKv_Set(&settings, SETTING_ACCEL_CAL, cal, sizeof(cal));
+}
+
+#if ENABLE_MIDI_IN && ENABLE_MIDI_OUT
+// Main loop only. store = false forgets the stored bank, so the next boot
+// uses the built-in one.
+static BankStatus_t Bank_Flash_Write(bool store) {
+  KvStatus_t status =
+      store ? FlashKv_Set(&settings, SETTING_BANK, bank_image,
+                          BANK_IMAGE_BYTES)
+            : FlashKv_Delete(&settings, SETTING_BANK);
+  return (status == KV_OK) ? BANK_OK : BANK_ERR_FLASH;
+}
+#endif
+
 #if ENABLE_DEBUG_LEDS
 static void Debug_LED_Update(int8_t octave) {
   if (octave < 0) {
@@ -1699,92 +1255,100 @@ static void Debug_LED_Update(int8_t octave) {
 //=============================================================================
 // DISPLAY
 //=============================================================================
-static void Display_Scale_Info(void) {
+static void Display_Scale_Info(const SynthStatus_t *status) {
   char buf[32];
   LCD_DrawRect(0, 28, 128, 10, LCD_COLOR_BLACK);
 
   // Show key and mode
-  const char* mode_name = (current_mode == MODE_MAJOR) ? "MAJ" : "MIN";
-  snprintf(buf, sizeof(buf), "%s %s", KEY_NAMES[scale_state.current_key], mode_name);
+  const char* mode_name = (status->mode == MODE_MAJOR) ? "MAJ" : "MIN";
+  snprintf(buf, sizeof(buf), "%s %s", KEY_NAMES[status->key], mode_name);
   LCD_PrintString(3, 28, buf, LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_SMALL);
 
   // Show current harmonic function
-  const char** harm_names = (current_mode == MODE_MAJOR) ?
+  const char** harm_names = (status->mode == MODE_MAJOR) ?
       HARMONIC_NAMES_MAJOR : HARMONIC_NAMES_MINOR;
-  snprintf(buf, sizeof(buf), "%s", harm_names[current_harmony]);
+  snprintf(buf, sizeof(buf), "%s", harm_names[status->harmony]);
   LCD_PrintString(85, 28, buf, LCD_COLOR_CYAN, LCD_COLOR_BLACK, FONT_SMALL);
 }
 
 static void Display_Update(void) {
-  const InstrumentProfile_t *inst = &INSTRUMENTS[current_instrument];
+  if (display_load_page) {
+    Display_Load_Page();
+    return;
+  }
+
+  SynthStatus_t status;
+  Synth_GetStatus(&status);
+  const InstrumentProfile_t *inst = &INSTRUMENTS[status.instrument];
+  const uint16_t color = INSTRUMENT_COLORS[status.instrument];
   char buf[32];
 
-  LCD_DrawRect(0, 0, 128, 16, inst->color);
-  LCD_PrintString(3, 4, inst->name, LCD_COLOR_WHITE, inst->color, FONT_SMALL);
+  LCD_DrawRect(0, 0, 128, 16, color);
+  LCD_PrintString(3, 4, inst->name, LCD_COLOR_WHITE, color, FONT_SMALL);
   
   // Show EPIC MODE if active
-  if (epic_mode_active) {
-    LCD_PrintString(50, 4, "EPIC", LCD_COLOR_RED, inst->color, FONT_SMALL);
-    snprintf(buf, sizeof(buf), "%d/16", epic_sequence_step + 1);
-    LCD_PrintString(85, 4, buf, LCD_COLOR_YELLOW, inst->color, FONT_SMALL);
+  if (status.epic_active) {
+    LCD_PrintString(50, 4, "EPIC", LCD_COLOR_RED, color, FONT_SMALL);
+    snprintf(buf, sizeof(buf), "%d/16", status.epic_step + 1);
+    LCD_PrintString(85, 4, buf, LCD_COLOR_YELLOW, color, FONT_SMALL);
   } else {
-    LCD_PrintString(60, 4, PRESETS[current_preset].name, LCD_COLOR_BLACK,
-                    inst->color, FONT_SMALL);
+    LCD_PrintString(60, 4, PRESETS[status.preset].name, LCD_COLOR_BLACK,
+                    color, FONT_SMALL);
   }
 
   LCD_DrawRect(0, 18, 128, 10, LCD_COLOR_BLACK);
   LCD_PrintString(3, 18, "F:", LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_SMALL);
-  LCD_PrintNumber(18, 18, base_frequency_hz, LCD_COLOR_WHITE, LCD_COLOR_BLACK,
+  LCD_PrintNumber(18, 18, status.frequency_hz, LCD_COLOR_WHITE, LCD_COLOR_BLACK,
                   FONT_SMALL);
 
-  if (current_octave_shift == -12) {
+  if (status.octave_shift == -12) {
     LCD_PrintString(55, 18, "LOW", LCD_COLOR_BLUE, LCD_COLOR_BLACK, FONT_SMALL);
-  } else if (current_octave_shift == 12) {
+  } else if (status.octave_shift == 12) {
     LCD_PrintString(55, 18, "HI", LCD_COLOR_RED, LCD_COLOR_BLACK, FONT_SMALL);
   } else {
     LCD_PrintString(55, 18, "MID", LCD_COLOR_CYAN, LCD_COLOR_BLACK, FONT_SMALL);
   }
 
-  Display_Scale_Info();
+  Display_Scale_Info(&status);
 
   LCD_DrawRect(3, 40, 60, 4, LCD_COLOR_DARKGRAY);
-  uint8_t bar_w = gSynthState.volume;
+  uint8_t bar_w = status.volume;
   if (bar_w > 100)
     bar_w = 100;
   LCD_DrawRect(3, 40, (bar_w * 60) / 100, 4, LCD_COLOR_GREEN);
 
-  snprintf(buf, sizeof(buf), "%d%%", gSynthState.volume);
+  snprintf(buf, sizeof(buf), "%d%%", status.volume);
   LCD_PrintString(3, 46, buf, LCD_COLOR_WHITE, LCD_COLOR_BLACK, FONT_SMALL);
 
   LCD_DrawRect(66, 40, 62, 10, LCD_COLOR_BLACK);
   LCD_PrintString(66, 40, "FX:", LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_SMALL);
-  LCD_PrintString(84, 40, effects_enabled ? "ON" : "OFF",
-                  effects_enabled ? LCD_COLOR_GREEN : LCD_COLOR_RED,
+  LCD_PrintString(84, 40, status.effects_enabled ? "ON" : "OFF",
+                  status.effects_enabled ? LCD_COLOR_GREEN : LCD_COLOR_RED,
                   LCD_COLOR_BLACK, FONT_SMALL);
 
-  if (chord_mode != CHORD_OFF) {
+  if (status.chord_mode != CHORD_OFF) {
     const char *chord_names[] = {"", "MAJ", "MIN"};
-    LCD_PrintString(105, 40, chord_names[chord_mode], LCD_COLOR_MAGENTA,
+    LCD_PrintString(105, 40, chord_names[status.chord_mode], LCD_COLOR_MAGENTA,
                     LCD_COLOR_BLACK, FONT_SMALL);
   }
 
   LCD_DrawRect(0, 50, 128, 10, LCD_COLOR_BLACK);
-  if (arpeggiator.mode != ARP_OFF) {
+  if (status.arp_mode != ARP_OFF) {
     LCD_PrintString(3, 50, "ARP", LCD_COLOR_GREEN, LCD_COLOR_BLACK, FONT_SMALL);
   }
 
   const char *env_names[] = {"IDLE", "ATK", "DEC", "SUS", "REL"};
-  LCD_PrintString(55, 50, env_names[Envelope_GetState(&envelope)],
+  LCD_PrintString(55, 50, env_names[status.env_state],
                   LCD_COLOR_CYAN, LCD_COLOR_BLACK, FONT_SMALL);
-  LCD_PrintNumber(90, 50, Envelope_GetAmplitude(&envelope) / 10,
+  LCD_PrintNumber(90, 50, status.env_amplitude / 10,
                   LCD_COLOR_WHITE, LCD_COLOR_BLACK, FONT_SMALL);
 
 #if ENABLE_WAVEFORM_DISPLAY
-  Display_Waveform();
+  Display_Waveform(Synth_GetScope());
 #endif
 
   LCD_DrawRect(0, 118, 128, 10, LCD_COLOR_BLACK);
-  if (gSynthState.audio_playing) {
+  if (status.playing) {
     LCD_PrintString(3, 118, "PLAYING", LCD_COLOR_GREEN, LCD_COLOR_BLACK,
                     FONT_SMALL);
   } else {
@@ -1792,19 +1356,68 @@ static void Display_Update(void) {
                     FONT_SMALL);
   }
 
-  snprintf(buf, sizeof(buf), "V:%d", gSynthState.volume);
+  snprintf(buf, sizeof(buf), "V:%d", status.volume);
   LCD_PrintString(70, 118, buf, LCD_COLOR_YELLOW, LCD_COLOR_BLACK, FONT_SMALL);
 }
 
+// Audio interrupt load (JOY_SEL double click), cycles at MCLK
+static void Display_Load_Page(void) {
+  char buf[32];
+  const uint16_t load = gSynthState.cpu_load_pct10;
+  const uint32_t max = gSynthState.isr_cycles_max;
+
+  LCD_DrawRect(0, 0, 128, 16, LCD_COLOR_DARKGRAY);
+  LCD_PrintString(3, 4, "AUDIO LOAD", LCD_COLOR_WHITE, LCD_COLOR_DARKGRAY,
+                  FONT_SMALL);
+  if (profiler.running) {
+    LCD_PrintString(95, 4, "PROF", LCD_COLOR_RED, LCD_COLOR_DARKGRAY,
+                    FONT_SMALL);
+  }
+
+  LCD_DrawRect(0, 20, 128, 10, LCD_COLOR_BLACK);
+  snprintf(buf, sizeof(buf), "CPU %u.%u%%", load / 10, load % 10);
+  LCD_PrintString(3, 20, buf, (load > 800) ? LCD_COLOR_RED : LCD_COLOR_GREEN,
+                  LCD_COLOR_BLACK, FONT_SMALL);
+  LCD_DrawRect(66, 22, 60, 4, LCD_COLOR_DARKGRAY);
+  LCD_DrawRect(66, 22, (load > 1000 ? 1000 : load) * 60 / 1000, 4,
+               LCD_COLOR_GREEN);
+
+  LCD_DrawRect(0, 34, 128, 60, LCD_COLOR_BLACK);
+  LCD_PrintString(3, 34, "RENDER / BLOCK", LCD_COLOR_YELLOW, LCD_COLOR_BLACK,
+                  FONT_SMALL);
+  snprintf(buf, sizeof(buf), "MIN %lu", (unsigned long)gSynthState.isr_cycles_min);
+  LCD_PrintString(3, 46, buf, LCD_COLOR_WHITE, LCD_COLOR_BLACK, FONT_SMALL);
+  snprintf(buf, sizeof(buf), "AVG %lu", (unsigned long)gSynthState.isr_cycles_avg);
+  LCD_PrintString(3, 56, buf, LCD_COLOR_WHITE, LCD_COLOR_BLACK, FONT_SMALL);
+  snprintf(buf, sizeof(buf), "MAX %lu", (unsigned long)max);
+  LCD_PrintString(3, 66, buf,
+                  (max > gSynthState.isr_budget) ? LCD_COLOR_RED : LCD_COLOR_WHITE,
+                  LCD_COLOR_BLACK, FONT_SMALL);
+  snprintf(buf, sizeof(buf), "BUDGET %lu", (unsigned long)gSynthState.isr_budget);
+  LCD_PrintString(3, 76, buf, LCD_COLOR_CYAN, LCD_COLOR_BLACK, FONT_SMALL);
+
+  LCD_DrawRect(0, 94, 128, 34, LCD_COLOR_BLACK);
+  snprintf(buf, sizeof(buf), "SVC MAX %lu", (unsigned long)gSynthState.svc_cycles_max);
+  LCD_PrintString(3, 94, buf, LCD_COLOR_WHITE, LCD_COLOR_BLACK, FONT_SMALL);
+  snprintf(buf, sizeof(buf), "OVERRUNS %lu", (unsigned long)gSynthState.isr_overruns);
+  LCD_PrintString(3, 106, buf,
+                  gSynthState.isr_overruns ? LCD_COLOR_RED : LCD_COLOR_GREEN,
+                  LCD_COLOR_BLACK, FONT_SMALL);
+  snprintf(buf, sizeof(buf), "UNDERRUNS %lu", (unsigned long)gSynthState.audio_underruns);
+  LCD_PrintString(3, 118, buf,
+                  gSynthState.audio_underruns ? LCD_COLOR_RED : LCD_COLOR_GREEN,
+                  LCD_COLOR_BLACK, FONT_SMALL);
+}
+
 #if ENABLE_WAVEFORM_DISPLAY
-static void Display_Waveform(void) {
+static void Display_Waveform(const int16_t *scope) {
   uint16_t yc = 85, ys = 25;
   LCD_DrawRect(0, 60, 128, 55, LCD_COLOR_BLACK);
   for (uint8_t x = 0; x < 128; x += 4)
     LCD_DrawPixel(x, yc, LCD_COLOR_DARKGRAY);
-  for (uint8_t i = 0; i < 63; i++) {
-    int16_t y1 = yc - ((waveform_buffer[i] * ys) / 1000);
-    int16_t y2 = yc - ((waveform_buffer[i + 1] * ys) / 1000);
+  for (uint8_t i = 0; i < SYNTH_SCOPE_SIZE - 1; i++) {
+    int16_t y1 = yc - ((scope[i] * ys) / 1000);
+    int16_t y2 = yc - ((scope[i + 1] * ys) / 1000);
     if (y1 < 60)
       y1 = 60;
     if (y1 > 110)
@@ -33,6 +33,24 @@ typedef struct {
     volatile uint32_t adc0_count;
     volatile uint32_t adc1_count;
     volatile uint32_t audio_samples_generated;
+    volatile uint32_t audio_underruns;   // Blocks not rendered in time
+    volatile uint32_t fx_cycles;         // Insert chain cycles, last block
+    volatile uint16_t limiter_gr_db10;   // Master limiter reduction (0.1 dB)
+    volatile uint16_t midi_in_overruns;  // MIDI bytes lost (ring or RX FIFO)
+    volatile uint16_t midi_in_errors;    // MIDI bytes the parser threw away
+    volatile uint16_t tempo_bpm10;       // Transport tempo (0.1 BPM)
+    volatile bool clock_external;        // Following received MIDI clock
+    volatile uint32_t settings_scan_cycles; // Flash settings boot scan (MCLK)
+    volatile uint16_t settings_records;  // Records the boot scan read
+
+    // Audio interrupt load (lib/perf/isr_load.h), MCLK cycles
+    volatile uint32_t isr_cycles_min;    // Block render (PendSV), best case
+    volatile uint32_t isr_cycles_avg;    // Block render, mean of last 100 ms
+    volatile uint32_t isr_cycles_max;    // Block render, worst case
+    volatile uint32_t isr_budget;        // Block render deadline (one block)
+    volatile uint32_t isr_overruns;      // Renders that missed the deadline
+    volatile uint32_t svc_cycles_max;    // Sample/DMA interrupt, worst case
+    volatile uint16_t cpu_load_pct10;    // All audio interrupts (0.1 %)
 } SynthState_t;
 
 extern volatile SynthState_t gSynthState;
@@ -0,0 +1,60 @@
+/*
+ * mspm0g3507.cmd - linker command file (TI Arm Clang)
+ *
+ * Replaces the one SysConfig generates (ProjectConfig.genLinker = false in
+ * ti_msp_dl_config.syscfg): the same sections, but FLASH stops at the
+ * sound bank and settings sectors of flash_layout.h, which get regions of
+ * their own with nothing placed in them.
+ *
+ * Guards, all at link time:
+ *   - code or constants past APP_FLASH_SIZE fail placement in FLASH
+ *   - a FLASH region grown into BANK_BLOB or SETTINGS overlaps them
+ *   - the #if below rejects a layout whose regions do not tile the flash
+ */
+#include "flash_layout.h"
+
+#if APP_FLASH_SIZE > BANK_BLOB_ADDRESS
+#error "flash_layout.h: FLASH overlaps the sound bank sector"
+#endif
+#if BANK_BLOB_ADDRESS + BANK_BLOB_SIZE != SETTINGS_FLASH_ADDRESS
+#error "flash_layout.h: the sound bank must sit right below the settings"
+#endif
+#if SETTINGS_FLASH_ADDRESS + SETTINGS_FLASH_SIZE != FLASH_BASE + FLASH_SIZE
+#error "flash_layout.h: the settings must end at the top of flash"
+#endif
+
+-uinterruptVectors
+
+MEMORY
+{
+    FLASH      (RX)  : origin = FLASH_BASE,             length = APP_FLASH_SIZE
+    BANK_BLOB  (R)   : origin = BANK_BLOB_ADDRESS,      length = BANK_BLOB_SIZE
+    SETTINGS   (R)   : origin = SETTINGS_FLASH_ADDRESS, length = SETTINGS_FLASH_SIZE
+    SRAM       (RWX) : origin = 0x20200000,             length = 0x00008000
+    BCR_CONFIG (R)   : origin = 0x41C00000,             length = 0x00000080
+    BSL_CONFIG (R)   : origin = 0x41C00100,             length = 0x00000080
+}
+
+SECTIONS
+{
+    .intvecs:   > 0x00000000
+    .text   : palign(8) {} > FLASH
+    .const  : palign(8) {} > FLASH
+    .cinit  : palign(8) {} > FLASH
+    .pinit  : palign(8) {} > FLASH
+    .rodata : palign(8) {} > FLASH
+    .ARM.exidx    : palign(8) {} > FLASH
+    .init_array   : palign(8) {} > FLASH
+    .binit        : palign(8) {} > FLASH
+    .TI.ramfunc   : load = FLASH, palign(8), run = SRAM, table(BINIT)
+
+    .vtable :   > SRAM
+    .args   :   > SRAM
+    .data   :   > SRAM
+    .bss    :   > SRAM
+    .sysmem :   > SRAM
+    .stack  :   > SRAM (HIGH)
+
+    .BCRConfig  : {} > BCR_CONFIG
+    .BSLConfig  : {} > BSL_CONFIG
+}
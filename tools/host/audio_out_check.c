@@ -0,0 +1,339 @@
+/**
+ * @file audio_out_check.c
+ * @brief Audio Output Backend Check and Comparison (Linux host)
+ * @version 1.0.0
+ *
+ * Plays one second of a 440 Hz sine at -6 dBFS through every backend of
+ * lib/output/audio_out.h with the same open/submit_block/stats calls, and
+ * prints their stats side by side (blocks, samples, dropped, bytes, and
+ * the time spent in submit_block() on this host).
+ *
+ * DAC12 and WAV build as they do for Linux. PWM and UART are the target
+ * sources built with AUDIO_OUT_SIM=0 against dl_fake/ti_msp_dl_config.h;
+ * this file stands in for their hardware: the sample timer calls service()
+ * once per sample, the PWM timer keeps every compare value, and the UART
+ * sends the DMA_CH1 transfer by the next block boundary. As in main.c, a
+ * block is rendered only when the backend calls on_space.
+ *
+ *   steady    No render missed: DAC12 plays 16000 contiguous codes, PWM
+ *             loads 16000 compare values (the rendered mix, then the
+ *             midpoint on close), UART sends the decimated PCM, WAV writes
+ *             a valid 16 kHz mono file; only the start-up silence, no drops.
+ *   underrun  6 of the renders skipped (UART: its line held for 6 block
+ *             periods instead, so 6 submits find DMA_CH1 busy): each
+ *             backend reports 6 dropped blocks, and DAC12 and PWM play
+ *             exactly 6 extra silent blocks.
+ *
+ * Exit status 1 on any failure.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./audio_out_check
+ */
+
+#include "output/audio_out.h"
+#include "output/dac12_dma.h"
+#include "dl_fake/ti_msp_dl_config.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Built from the target sources (AUDIO_OUT_SIM=0), see build.sh
+extern const AudioOutBackend_t AUDIO_OUT_PWM;
+extern const AudioOutBackend_t AUDIO_OUT_UART;
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define SAMPLE_RATE     16000u
+#define BLOCK           32u
+#define TONE_HZ         440
+#define TONE_AMPLITUDE  16384.0     // -6 dBFS
+#define PWM_MIDPOINT    2048u       // audio_out_pwm.c: period 4096
+#define UART_DECIMATION 4u          // audio_out_uart.c default
+#define WAV_PATH        "audio_out_check.wav"
+
+// Block releases left unanswered in the underrun test
+static const uint32_t SKIP[] = {10, 11, 50, 200, 201, 202};
+#define SKIP_COUNT (sizeof(SKIP) / sizeof(SKIP[0]))
+
+//=============================================================================
+// SIMULATED HARDWARE
+//=============================================================================
+GPTIMER_Regs fake_pwm_timer;
+DMA_Regs fake_dma;
+UART_Regs fake_uart;
+
+static int16_t tone[2 * SAMPLE_RATE];
+static uint32_t sent;               // Samples accepted so far
+static volatile bool space;         // on_space seen, render due
+
+static uint16_t codes[2 * SAMPLE_RATE];   // DAC12 sink
+static uint32_t code_count;
+static uint8_t line[2 * SAMPLE_RATE];     // Bytes sent by the UART
+static uint32_t line_count;
+
+static void On_Space(void *user) {
+    (void)user;
+    space = true;
+}
+
+static uint32_t Clock_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+static void Dac12_Sink(void *ctx, const uint16_t *c, uint16_t n) {
+    (void)ctx;
+    for (uint16_t i = 0; i < n && code_count < 2 * SAMPLE_RATE; i++)
+        codes[code_count++] = c[i];
+}
+
+static uint32_t Dac12_Run(uint32_t samples) {
+    return AudioOutDac12_SimRun(samples);
+}
+
+// Sample timer: one service() per tick, until the backend asks for a block
+static uint32_t Timer_Run(const AudioOutBackend_t *out, uint32_t samples) {
+    uint32_t ticks = 0;
+    while (ticks < samples && !space) {
+        out->service();
+        ticks++;
+    }
+    return ticks;
+}
+
+static uint32_t Pwm_Run(uint32_t samples) {
+    return Timer_Run(&AUDIO_OUT_PWM, samples);
+}
+
+static uint32_t Uart_Run(uint32_t samples) {
+    return Timer_Run(&AUDIO_OUT_UART, samples);
+}
+
+// The UART has sent the whole transfer: single mode drops the enable bit
+static void Uart_Drain(void) {
+    FakeDmaChannel_t *ch = &fake_dma.chan[DMA_CH1_CHAN_ID];
+    const uint8_t *src = (const uint8_t *)(uintptr_t)ch->src;
+
+    if (!ch->enabled) return;
+    for (uint16_t i = 0; i < ch->size && line_count < sizeof(line); i++) {
+        fake_uart.TXDATA = src[i];
+        line[line_count++] = src[i];
+    }
+    ch->enabled = false;
+}
+
+// No clock: a file takes a block whenever the renderer has one
+static uint32_t Wav_Run(uint32_t samples) {
+    space = true;
+    return samples < BLOCK ? samples : BLOCK;
+}
+
+//=============================================================================
+// PLAYBACK
+//=============================================================================
+typedef struct {
+    const AudioOutBackend_t *out;
+    uint32_t (*run)(uint32_t samples);  ///< Play, stop after on_space
+    bool line;                          ///< UART: skips hold the line
+} Target_t;
+
+static const Target_t TARGETS[] = {
+    {&AUDIO_OUT_DAC12, Dac12_Run, false},
+    {&AUDIO_OUT_PWM, Pwm_Run, false},
+    {&AUDIO_OUT_UART, Uart_Run, true},
+    {&AUDIO_OUT_WAV, Wav_Run, false},
+};
+#define TARGET_COUNT (sizeof(TARGETS) / sizeof(TARGETS[0]))
+
+/**
+ * @brief Play one second, answering every on_space but the first `skips`
+ * of SKIP[], then close
+ */
+static void Play(const Target_t *t, uint32_t skips, AudioOutStats_t *stats) {
+    const AudioOutConfig_t cfg = {SAMPLE_RATE, BLOCK, On_Space, NULL,
+                                  Clock_Ns, WAV_PATH};
+    uint32_t total = 0, releases = 0, next = 0;
+
+    memset(&fake_pwm_timer, 0, sizeof(fake_pwm_timer));
+    memset(&fake_dma, 0, sizeof(fake_dma));
+    sent = code_count = line_count = 0;
+    space = false;
+    AudioOutDac12_SimSetSink(Dac12_Sink, NULL);
+
+    t->out->open(&cfg);
+    fake_pwm_timer.load_count = 0;      // Keep the sample ticks only
+    while (total < SAMPLE_RATE) {
+        uint32_t n = t->run(SAMPLE_RATE - total);
+        total += n;
+        if (!space) {
+            if (n == 0) break;
+            continue;
+        }
+        space = false;
+
+        bool skip = next < skips && releases == SKIP[next];
+        if (skip) next++;
+        releases++;
+        if (t->line && !skip) Uart_Drain();
+        if (skip && !t->line) continue;
+        if (t->out->submit_block(tone + sent, BLOCK)) sent += BLOCK;
+    }
+    if (t->line) Uart_Drain();          // The last transfer finishes
+    t->out->stats(stats);
+    t->out->close();
+}
+
+//=============================================================================
+// OUTPUT CHECKS
+//=============================================================================
+
+// Whole blocks of `mid` in a played stream; the rest must match `expect`
+static int Count_Silent(const uint16_t *v, uint32_t count, uint16_t mid,
+                        uint16_t (*expect)(uint32_t i), uint32_t *matched) {
+    int silent = 0;
+    uint32_t k = 0;
+
+    for (uint32_t b = 0; b + BLOCK <= count; b += BLOCK) {
+        uint32_t same = 0;
+        for (uint32_t i = 0; i < BLOCK; i++) same += v[b + i] == mid;
+        if (same == BLOCK) {
+            silent++;
+            continue;
+        }
+        for (uint32_t i = 0; i < BLOCK && expect; i++, k++) {
+            if (v[b + i] != expect(k)) return -1;
+        }
+    }
+    if (matched) *matched = k;
+    return silent;
+}
+
+static uint16_t Pwm_Expect(uint32_t i) {
+    int32_t v = (int32_t)PWM_MIDPOINT + (tone[i] >> 4);
+    return (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+}
+
+static bool Check_Dac12(uint32_t skips, const AudioOutStats_t *st,
+                        char *what, size_t size) {
+    int silent = Count_Silent(codes, code_count, DAC_DMA_MIDPOINT, NULL, NULL);
+    snprintf(what, size, "DAC12: %u codes, %d silent blocks, %u dropped",
+             (unsigned)code_count, silent, (unsigned)st->dropped);
+    return code_count == SAMPLE_RATE && silent == 2 + (int)skips &&
+           st->dropped == skips;
+}
+
+static bool Check_Pwm(uint32_t skips, const AudioOutStats_t *st,
+                      char *what, size_t size) {
+    uint32_t matched = 0;
+    int silent = Count_Silent(fake_pwm_timer.loads, fake_pwm_timer.load_count,
+                              PWM_MIDPOINT, Pwm_Expect, &matched);
+    // One value per sample tick, then close() parks CC0 at the midpoint
+    uint32_t ticks = fake_pwm_timer.load_count - 1;
+    snprintf(what, size, "PWM: %u compare values, %d silent blocks, "
+             "%u dropped", (unsigned)ticks, silent, (unsigned)st->dropped);
+    return ticks == SAMPLE_RATE &&
+           fake_pwm_timer.loads[ticks] == PWM_MIDPOINT &&
+           silent == 1 + (int)skips && matched <= sent &&
+           st->dropped == skips;
+}
+
+static bool Check_Uart(uint32_t skips, const AudioOutStats_t *st,
+                       char *what, size_t size) {
+    uint32_t frames = sent / UART_DECIMATION;
+    bool same = line_count == 2 * frames && st->bytes == line_count;
+
+    for (uint32_t f = 0; f < frames && same; f++) {
+        int32_t sum = 0;
+        for (uint32_t k = 0; k < UART_DECIMATION; k++)
+            sum += tone[f * UART_DECIMATION + k];
+        int16_t s = (int16_t)(sum / (int32_t)UART_DECIMATION);
+        same = line[2 * f] == (uint8_t)s &&
+               line[2 * f + 1] == (uint8_t)((uint16_t)s >> 8);
+    }
+    snprintf(what, size, "UART: %u PCM bytes %s, %u dropped",
+             (unsigned)line_count, same ? "as decimated" : "WRONG",
+             (unsigned)st->dropped);
+    return same && st->dropped == skips;
+}
+
+static uint32_t Le(const uint8_t *p, uint8_t bytes) {
+    uint32_t v = 0;
+    for (uint8_t i = 0; i < bytes; i++) v |= (uint32_t)p[i] << (8 * i);
+    return v;
+}
+
+static bool Check_Wav(uint32_t skips, const AudioOutStats_t *st,
+                      char *what, size_t size) {
+    static uint8_t file[44 + 4 * SAMPLE_RATE];
+    FILE *f = fopen(WAV_PATH, "rb");
+    size_t len = f ? fread(file, 1, sizeof(file), f) : 0;
+    bool ok = len >= 44 && !memcmp(file, "RIFF", 4) &&
+              !memcmp(file + 8, "WAVEfmt ", 8) && Le(file + 22, 2) == 1 &&
+              Le(file + 24, 4) == SAMPLE_RATE && Le(file + 34, 2) == 16 &&
+              Le(file + 40, 4) == 2 * sent && len == 44 + 2 * sent;
+
+    (void)skips;
+    if (f) fclose(f);
+    remove(WAV_PATH);
+    for (uint32_t i = 0; i < sent && ok; i++)
+        ok = (int16_t)Le(file + 44 + 2 * i, 2) == tone[i];
+    snprintf(what, size, "WAV: %u Hz mono file, %u samples, %u dropped",
+             (unsigned)Le(file + 24, 4), (unsigned)sent,
+             (unsigned)st->dropped);
+    return ok && sent == SAMPLE_RATE && st->dropped == 0;
+}
+
+typedef bool (*Check_t)(uint32_t skips, const AudioOutStats_t *st,
+                        char *what, size_t size);
+static const Check_t CHECKS[TARGET_COUNT] = {Check_Dac12, Check_Pwm,
+                                             Check_Uart, Check_Wav};
+
+static bool Report(const char *test, const char *what, bool ok) {
+    printf("%-9s %-54s %s\n", test, what, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(void) {
+    AudioOutStats_t stats[TARGET_COUNT];
+    char what[80];
+    bool ok = true;
+
+    for (uint32_t i = 0; i < 2 * SAMPLE_RATE; i++)
+        tone[i] = (int16_t)lround(TONE_AMPLITUDE *
+                                  sin(2 * M_PI * TONE_HZ * i / SAMPLE_RATE));
+
+    for (unsigned t = 0; t < TARGET_COUNT; t++) {
+        Play(&TARGETS[t], 0, &stats[t]);
+        ok = Report("steady", what,
+                    CHECKS[t](0, &stats[t], what, sizeof(what))) && ok;
+    }
+    for (unsigned t = 0; t < TARGET_COUNT; t++) {
+        AudioOutStats_t st;
+        if (TARGETS[t].run == Wav_Run) continue;    // No clock to miss
+        Play(&TARGETS[t], SKIP_COUNT, &st);
+        ok = Report("underrun", what,
+                    CHECKS[t](SKIP_COUNT, &st, what, sizeof(what))) && ok;
+    }
+
+    printf("\nOne second at %u Hz, %u-sample blocks (host ns)\n",
+           SAMPLE_RATE, BLOCK);
+    printf("%-7s %7s %8s %8s %7s %10s %8s\n", "backend", "blocks", "samples",
+           "dropped", "bytes", "ns/submit", "max ns");
+    for (unsigned t = 0; t < TARGET_COUNT; t++) {
+        const AudioOutStats_t *s = &stats[t];
+        uint32_t calls = s->blocks + s->dropped;
+        printf("%-7s %7u %8u %8u %7u %10u %8u\n", TARGETS[t].out->name,
+               (unsigned)s->blocks, (unsigned)s->samples,
+               (unsigned)s->dropped, (unsigned)s->bytes,
+               (unsigned)(calls ? s->cycles / calls : 0),
+               (unsigned)s->cycles_max);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,624 @@
+/**
+ * @file bank_tool.c
+ * @brief Sound Bank Compiler: Text, SysEx and Flash Image (Linux host)
+ * @version 1.0.0
+ *
+ * Converts the synth sound bank (every instrument and preset) between an
+ * editable text file and the two forms lib/audio/synth_bank.h defines:
+ * the SysEx record frames the firmware takes on its MIDI input, and the
+ * flash image it stores or maps in place. Values are checked the way the
+ * firmware checks them, so a file this tool writes is one the firmware
+ * accepts. banks/factory.txt is the built-in bank in this form.
+ *
+ * Text: one entry per line, '#' starts a comment. Names are up to 11
+ * characters without spaces; enums take a name or a number.
+ *   instrument <0-4> <name> attack=<samples> decay=<samples>
+ *       sustain=<0-1000> release=<samples> wave=sine|square|sawtooth|triangle
+ *       harmonics=<0-3> vibrato=<0-255> tremolo=<0-255> drive=<0-255>
+ *   preset <0-2> <name> instrument=piano|organ|strings|bass|lead
+ *       effects=on|off chord=off|major|minor arp=off|up|down|updown|random
+ *       fx=<slot>,<slot>,... (none|tremolo|drive|crush)
+ * Entries left out keep the built-in values; keys left out keep the
+ * entry's built-in values.
+ *
+ * compile also reports what each instrument costs the audio context per
+ * sample, for one held note with the effects on:
+ *   osc    waveform evaluations: the fundamental, plus the octave when
+ *          harmonics >= 1; one note, then a 3-note chord
+ *   div    the vibrato's 32-bit divide (one note only; the M0+ has no
+ *          divide instruction, so it is a library call there)
+ *   fx     inserts the instrument switches on (tremolo, drive)
+ *   ns     the engine on this host, over a muted engine (best of 5 runs
+ *          of one second): a ranking, not M0+ time (./build.sh m0 runs
+ *          the kernels in the M0+ simulator)
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./bank_tool export > bank.txt          Built-in bank as text
+ *   ./bank_tool syx bank.txt bank.syx      Record frames
+ *   ./bank_tool syx bank.txt bank.syx -s   ... and store in flash
+ *   ./bank_tool compile bank.txt bank.bin  Flash image and CPU cost
+ *                                          (image: the same, no report);
+ *                                          program it at BANK_BLOB_ADDRESS
+ *                                          (flash_layout.h)
+ *   ./bank_tool text dump.syx              Frames or image back to text
+ *   ./bank_tool request req.syx            Dump request (-f: factory reset)
+ *   ./bank_tool check                      Round trips and damaged input
+ *
+ *   python3 uart_audio_player.py --send bank.syx      Load into the synth
+ *   python3 uart_audio_player.py --bank-dump dump.syx Read it back
+ */
+
+#include "audio/synth.h"
+#include "audio/synth_bank.h"
+#include "../../flash_layout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define FILE_MAX   65536         // Largest input file
+#define LINE_MAX_CHARS 256
+#define COST_SAMPLES 16000       // One second at 16 kHz
+#define COST_RUNS    5
+
+static const char *const WAVE_NAMES[WAVE_COUNT] = {
+    "sine", "square", "sawtooth", "triangle"};
+static const char *const INSTRUMENT_NAMES[INSTRUMENT_COUNT] = {
+    "piano", "organ", "strings", "bass", "lead"};
+static const char *const CHORD_NAMES[CHORD_MODE_COUNT] = {
+    "off", "major", "minor"};
+static const char *const ARP_NAMES[ARP_MODE_COUNT] = {
+    "off", "up", "down", "updown", "random"};
+static const char *const EFFECT_NAMES[EFFECT_COUNT] = {
+    "none", "tremolo", "drive", "crush"};
+
+//=============================================================================
+// FILES
+//=============================================================================
+static long Read_File(const char *path, uint8_t *data, long max) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Cannot open %s\n", path);
+        return -1;
+    }
+    long n = (long)fread(data, 1, (size_t)max, f);
+    fclose(f);
+    if (n == max) {
+        fprintf(stderr, "%s: larger than %d bytes\n", path, FILE_MAX);
+        return -1;
+    }
+    return n;
+}
+
+static int Write_File(const char *path, const uint8_t *data, long n) {
+    FILE *f = fopen(path, "wb");
+    if (!f || fwrite(data, 1, (size_t)n, f) != (size_t)n) {
+        fprintf(stderr, "Cannot write %s\n", path);
+        if (f) fclose(f);
+        return 1;
+    }
+    fclose(f);
+    return 0;
+}
+
+static void Factory_Bank(SynthBank_t *bank) {
+    Synth_Init(NULL);
+    Synth_GetBank(bank);
+}
+
+//=============================================================================
+// TEXT
+//=============================================================================
+static void Write_Text(FILE *out, const SynthBank_t *bank) {
+    fprintf(out, "# Sound bank (tools/host/bank_tool)\n");
+    for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+        const InstrumentProfile_t *in = &bank->instruments[i];
+        fprintf(out, "instrument %u %s attack=%u decay=%u sustain=%u "
+                "release=%u wave=%s harmonics=%u vibrato=%u tremolo=%u "
+                "drive=%u\n", i, in->name[0] ? in->name : "-",
+                in->adsr.attack_samples, in->adsr.decay_samples,
+                in->adsr.sustain_level, in->adsr.release_samples,
+                WAVE_NAMES[in->waveform], in->num_harmonics,
+                in->vibrato_depth, in->tremolo_depth, in->drive);
+    }
+    for (uint8_t i = 0; i < SYNTH_PRESET_COUNT; i++) {
+        const Preset_t *p = &bank->presets[i];
+        fprintf(out, "preset %u %s instrument=%s effects=%s chord=%s "
+                "arp=%s fx=", i, p->name[0] ? p->name : "-",
+                INSTRUMENT_NAMES[p->instrument],
+                p->effects_enabled ? "on" : "off",
+                CHORD_NAMES[p->chord_mode], ARP_NAMES[p->arp_mode]);
+        for (uint8_t s = 0; s < FX_CHAIN_MAX_SLOTS; s++)
+            fprintf(out, "%s%s", s ? "," : "", EFFECT_NAMES[p->effects[s]]);
+        fputc('\n', out);
+    }
+}
+
+// Name from a table or a number below count; -1 if neither
+static int Parse_Enum(const char *s, const char *const *names, int count) {
+    for (int i = 0; i < count; i++) {
+        if (strcmp(s, names[i]) == 0) return i;
+    }
+    char *end;
+    long v = strtol(s, &end, 10);
+    return (*s && !*end && v >= 0 && v < count) ? (int)v : -1;
+}
+
+static int Parse_Number(const char *s, long max) {
+    char *end;
+    long v = strtol(s, &end, 10);
+    return (*s && !*end && v >= 0 && v <= max) ? (int)v : -1;
+}
+
+static bool Parse_Name(char *name, const char *s) {
+    if (strlen(s) >= SYNTH_NAME_SIZE) return false;
+    memset(name, 0, SYNTH_NAME_SIZE);
+    if (strcmp(s, "-") != 0) strcpy(name, s);
+    return true;
+}
+
+static bool Parse_Instrument_Key(InstrumentProfile_t *in, const char *key,
+                                 const char *value) {
+    int v;
+    if (strcmp(key, "wave") == 0) {
+        if ((v = Parse_Enum(value, WAVE_NAMES, WAVE_COUNT)) < 0) return false;
+        in->waveform = (Waveform_t)v;
+        return true;
+    }
+    if (strcmp(key, "attack") == 0 || strcmp(key, "decay") == 0 ||
+        strcmp(key, "release") == 0) {
+        if ((v = Parse_Number(value, 65535)) < 0) return false;
+        if (key[0] == 'a') in->adsr.attack_samples = (uint16_t)v;
+        else if (key[0] == 'd') in->adsr.decay_samples = (uint16_t)v;
+        else in->adsr.release_samples = (uint16_t)v;
+        return true;
+    }
+    if (strcmp(key, "sustain") == 0) {
+        if ((v = Parse_Number(value, 1000)) < 0) return false;
+        in->adsr.sustain_level = (uint16_t)v;
+        return true;
+    }
+    if (strcmp(key, "harmonics") == 0) {
+        if ((v = Parse_Number(value, 3)) < 0) return false;
+        in->num_harmonics = (uint8_t)v;
+        return true;
+    }
+    if ((v = Parse_Number(value, 255)) < 0) return false;
+    if (strcmp(key, "vibrato") == 0) in->vibrato_depth = (uint8_t)v;
+    else if (strcmp(key, "tremolo") == 0) in->tremolo_depth = (uint8_t)v;
+    else if (strcmp(key, "drive") == 0) in->drive = (uint8_t)v;
+    else return false;
+    return true;
+}
+
+static bool Parse_Preset_Key(Preset_t *p, const char *key, char *value) {
+    int v;
+    if (strcmp(key, "instrument") == 0) {
+        v = Parse_Enum(value, INSTRUMENT_NAMES, INSTRUMENT_COUNT);
+        if (v < 0) return false;
+        p->instrument = (Instrument_t)v;
+    } else if (strcmp(key, "effects") == 0) {
+        if (strcmp(value, "on") != 0 && strcmp(value, "off") != 0)
+            return false;
+        p->effects_enabled = strcmp(value, "on") == 0;
+    } else if (strcmp(key, "chord") == 0) {
+        if ((v = Parse_Enum(value, CHORD_NAMES, CHORD_MODE_COUNT)) < 0)
+            return false;
+        p->chord_mode = (ChordMode_t)v;
+    } else if (strcmp(key, "arp") == 0) {
+        if ((v = Parse_Enum(value, ARP_NAMES, ARP_MODE_COUNT)) < 0)
+            return false;
+        p->arp_mode = (ArpMode_t)v;
+    } else if (strcmp(key, "fx") == 0) {
+        uint8_t slot = 0;
+        for (char *s = strtok(value, ","); s; s = strtok(NULL, ",")) {
+            if (slot == FX_CHAIN_MAX_SLOTS) return false;
+            if ((v = Parse_Enum(s, EFFECT_NAMES, EFFECT_COUNT)) < 0)
+                return false;
+            p->effects[slot++] = (EffectId_t)v;
+        }
+        while (slot < FX_CHAIN_MAX_SLOTS) p->effects[slot++] = EFFECT_NONE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Entries over the built-in bank; 0 or the first bad line number
+static int Parse_Text(SynthBank_t *bank, char *text) {
+    int line_no = 0;
+    char *save_line;
+
+    Factory_Bank(bank);
+    for (char *line = strtok_r(text, "\n", &save_line); line;
+         line = strtok_r(NULL, "\n", &save_line)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char *save, *kind = strtok_r(line, " \t\r", &save);
+        if (!kind) continue;
+        char *index = strtok_r(NULL, " \t\r", &save);
+        char *name = strtok_r(NULL, " \t\r", &save);
+        bool instrument = strcmp(kind, "instrument") == 0;
+        int count = instrument ? INSTRUMENT_COUNT : SYNTH_PRESET_COUNT;
+        int i = index ? Parse_Number(index, count - 1) : -1;
+        if ((!instrument && strcmp(kind, "preset") != 0) || i < 0 || !name)
+            return line_no;
+
+        InstrumentProfile_t *in = &bank->instruments[i];
+        Preset_t *p = &bank->presets[i];
+        if (!Parse_Name(instrument ? in->name : p->name, name)) return line_no;
+        for (char *kv = strtok_r(NULL, " \t\r", &save); kv;
+             kv = strtok_r(NULL, " \t\r", &save)) {
+            char *eq = strchr(kv, '=');
+            if (!eq) return line_no;
+            *eq = '\0';
+            bool ok = instrument ? Parse_Instrument_Key(in, kv, eq + 1)
+                                 : Parse_Preset_Key(p, kv, eq + 1);
+            if (!ok) return line_no;
+        }
+    }
+    return 0;
+}
+
+static int Load_Text(SynthBank_t *bank, const char *path) {
+    static uint8_t text[FILE_MAX];
+    long n = Read_File(path, text, FILE_MAX - 1);
+    if (n < 0) return 1;
+    text[n] = '\0';
+    int bad = Parse_Text(bank, (char *)text);
+    if (bad) {
+        fprintf(stderr, "%s:%d: not an entry, or a value out of range\n",
+                path, bad);
+        return 1;
+    }
+    return 0;
+}
+
+//=============================================================================
+// SYSEX AND IMAGE
+//=============================================================================
+static const char *Status_Name(BankStatus_t status) {
+    switch (status) {
+    case BANK_OK:          return "ok";
+    case BANK_ERR_FRAME:   return "bad frame";
+    case BANK_ERR_VALUE:   return "value out of range";
+    case BANK_ERR_VERSION: return "other format version";
+    case BANK_ERR_CRC:     return "bad CRC";
+    case BANK_ERR_FLASH:   return "flash write failed";
+    case BANK_ERR_ALIGN:   return "image not aligned";
+    }
+    return "?";
+}
+
+// Every record frame of a bank; store appends the store command
+static long Write_Frames(const SynthBank_t *bank, uint8_t *out, bool store) {
+    uint8_t cursor = 0;
+    long n = 0;
+    uint16_t length;
+
+    while ((length = SynthBank_DumpFrame(bank, &cursor, out + n)) != 0)
+        n += length;
+    if (store) n += SynthBank_CommandFrame(BANK_OP_STORE, out + n);
+    return n;
+}
+
+// Frames (a saved dump or a file this tool wrote) over the built-in bank.
+// Bytes outside bank frames (telemetry, clock) are skipped.
+static int Read_Frames(SynthBank_t *bank, const uint8_t *data, long n,
+                       int *records) {
+    int errors = 0;
+
+    Factory_Bank(bank);
+    *records = 0;
+    for (long i = 0; i < n; i++) {
+        if (data[i] != MIDI_SYSEX_START) continue;
+        long end = i + 1;
+        while (end < n && data[end] != MIDI_SYSEX_END) end++;
+        if (end == n) break;
+
+        uint16_t length = (uint16_t)(end - i + 1);
+        BankFrame_t f = SynthBank_ParseFrame(bank, data + i, length);
+        if (f.id == BANK_SYSEX_INSTRUMENT || f.id == BANK_SYSEX_PRESET) {
+            if (f.status == BANK_OK) {
+                (*records)++;
+            } else {
+                fprintf(stderr, "Frame at byte %ld (%s %u): %s\n", i,
+                        f.id == BANK_SYSEX_PRESET ? "preset" : "instrument",
+                        f.arg, Status_Name(f.status));
+                errors++;
+            }
+        } else if (f.id == BANK_SYSEX_REPLY) {
+            fprintf(stderr, "Reply to 0x%02X: %s\n", f.arg,
+                    Status_Name(f.status));
+        }
+        i = end;
+    }
+    return errors;
+}
+
+//=============================================================================
+// CPU COST
+//=============================================================================
+static double Now_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Host ns per sample of the engine holding one note (best of COST_RUNS)
+static double Render_Ns(const SynthBank_t *bank, uint8_t instrument,
+                        ChordMode_t chord, bool playing) {
+    int16_t block[SYNTH_BLOCK_SIZE];
+    double best = 0;
+
+    Synth_Init(NULL);
+    Synth_SetBank(bank);
+    Synth_SetInstrument((Instrument_t)instrument);
+    Synth_SetEffects(true);
+    Synth_SetChordMode(chord);
+    Synth_SetPlaying(playing);
+    Synth_NoteOn();
+    for (int run = 0; run < COST_RUNS; run++) {
+        double start = Now_Ns();
+        for (int n = 0; n < COST_SAMPLES; n += SYNTH_BLOCK_SIZE)
+            Synth_RenderBlock(block, SYNTH_BLOCK_SIZE);
+        double ns = (Now_Ns() - start) / COST_SAMPLES;
+        if (run == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+static void Print_Cost(const SynthBank_t *bank) {
+    double idle = Render_Ns(bank, 0, CHORD_OFF, false);
+    double idle_chord = Render_Ns(bank, 0, CHORD_MAJOR, false);
+
+    printf("\nCPU cost per sample (one held note, effects on)\n");
+    printf("%-12s %3s %5s %3s %2s %9s %9s\n", "instrument", "osc", "chord",
+           "div", "fx", "ns note", "ns chord");
+    for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+        const InstrumentProfile_t *in = &bank->instruments[i];
+        unsigned osc = 1u + (in->num_harmonics >= 1);
+        double note = Render_Ns(bank, i, CHORD_OFF, true) - idle;
+        double chord = Render_Ns(bank, i, CHORD_MAJOR, true) - idle_chord;
+        printf("%-12s %3u %5u %3u %2u %9.1f %9.1f\n",
+               in->name[0] ? in->name : "-", osc, osc * SYNTH_CHORD_VOICES,
+               in->vibrato_depth > 0, (in->tremolo_depth > 0) + (in->drive > 0),
+               note > 0 ? note : 0, chord > 0 ? chord : 0);
+    }
+}
+
+//=============================================================================
+// SELF-CHECK
+//=============================================================================
+static bool Bank_Equal(const SynthBank_t *a, const SynthBank_t *b) {
+    uint8_t ia[BANK_IMAGE_BYTES], ib[BANK_IMAGE_BYTES];
+    SynthBank_Encode(a, ia);
+    SynthBank_Encode(b, ib);
+    return memcmp(ia, ib, BANK_IMAGE_BYTES) == 0;
+}
+
+static int Check(const char *what, bool ok) {
+    printf("%-44s %s\n", what, ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int Run_Check(void) {
+    static uint8_t buffer[FILE_MAX];
+    static uint32_t words[BANK_IMAGE_BYTES / 4 + 1]; // Aligned, as in flash
+    uint8_t *image = (uint8_t *)words;
+    SynthBank_t factory, edited, back;
+    const SynthBank_t *mapped = NULL;
+    int fail = 0, records;
+
+    Factory_Bank(&factory);
+
+    // Text round trip, with an edit
+    edited = factory;
+    strcpy(edited.instruments[2].name, "PAD");
+    edited.instruments[2].adsr.attack_samples = 65535;
+    edited.presets[1].effects[3] = EFFECT_CRUSH;
+    FILE *mem = fmemopen(buffer, sizeof(buffer), "w");
+    Write_Text(mem, &edited);
+    fclose(mem);
+    fail |= Check("text round trip",
+                  Parse_Text(&back, (char *)buffer) == 0 &&
+                  Bank_Equal(&back, &edited));
+
+    // Flash image round trip, and damaged images
+    SynthBank_Encode(&edited, image);
+    fail |= Check("image round trip",
+                  SynthBank_Decode(&back, image, BANK_IMAGE_BYTES) ==
+                  BANK_OK && Bank_Equal(&back, &edited));
+    memset(buffer, 0xFF, BANK_IMAGE_BYTES);
+    fail |= Check("erased flash rejected",
+                  SynthBank_Decode(&back, buffer, BANK_IMAGE_BYTES) ==
+                  BANK_ERR_CRC);
+    memcpy(buffer, image, BANK_IMAGE_BYTES);
+    buffer[BANK_HEADER_BYTES + 20] ^= 0x04;
+    fail |= Check("flipped bit rejected",
+                  SynthBank_Decode(&back, buffer, BANK_IMAGE_BYTES) ==
+                  BANK_ERR_CRC);
+    memcpy(buffer, image, BANK_IMAGE_BYTES);
+    buffer[4] = BANK_VERSION + 1;
+    fail |= Check("other version rejected",
+                  SynthBank_Decode(&back, buffer, BANK_IMAGE_BYTES) ==
+                  BANK_ERR_VERSION);
+    fail |= Check("short image rejected",
+                  SynthBank_Decode(&back, image, BANK_IMAGE_BYTES / 2) ==
+                  BANK_ERR_CRC);
+
+    // Mapped in place: the bank is the image, and the engine plays it
+    fail |= Check("image maps in place",
+                  SynthBank_Map(&mapped, image, BANK_IMAGE_BYTES) == BANK_OK &&
+                  (const uint8_t *)mapped == image + BANK_HEADER_BYTES &&
+                  Bank_Equal(mapped, &edited));
+    int16_t block[SYNTH_BLOCK_SIZE];
+    Synth_Init(NULL);
+    Synth_NoteOn();
+    Synth_RenderBlock(block, SYNTH_BLOCK_SIZE);
+    Synth_MapBank(mapped);
+    Synth_RenderBlock(block, SYNTH_BLOCK_SIZE);
+    Synth_GetBank(&back);
+    fail |= Check("engine plays the mapped bank",
+                  INSTRUMENTS == mapped->instruments &&
+                  PRESETS == mapped->presets && Bank_Equal(&back, &edited));
+    Synth_FactoryBank();
+    memmove(image + 1, image, BANK_IMAGE_BYTES);
+    fail |= Check("misaligned image not mapped",
+                  SynthBank_Map(&mapped, image + 1, BANK_IMAGE_BYTES) ==
+                  BANK_ERR_ALIGN);
+    memmove(image, image + 1, BANK_IMAGE_BYTES);
+    image[BANK_HEADER_BYTES + 3] ^= 0x10;
+    mapped = NULL;
+    fail |= Check("damaged image not mapped",
+                  SynthBank_Map(&mapped, image, BANK_IMAGE_BYTES) ==
+                  BANK_ERR_CRC && mapped == NULL);
+
+    // SysEx round trip: every byte of a frame below 0x80
+    long n = Write_Frames(&edited, buffer, true);
+    bool seven_bit = true;
+    for (long i = 0; i < n; i++) {
+        if (buffer[i] & 0x80 && buffer[i] != MIDI_SYSEX_START &&
+            buffer[i] != MIDI_SYSEX_END)
+            seven_bit = false;
+    }
+    fail |= Check("sysex frames 7-bit clean", seven_bit);
+    fail |= Check("sysex round trip",
+                  Read_Frames(&back, buffer, n, &records) == 0 &&
+                  records == INSTRUMENT_COUNT + SYNTH_PRESET_COUNT &&
+                  Bank_Equal(&back, &edited));
+
+    // One damaged frame: rejected, the bank entry untouched
+    uint8_t frame[BANK_FRAME_MAX];
+    uint8_t cursor = 0;
+    uint16_t length = SynthBank_DumpFrame(&edited, &cursor, frame);
+    frame[6] ^= 0x01;
+    back = factory;
+    BankFrame_t f = SynthBank_ParseFrame(&back, frame, length);
+    fail |= Check("bad checksum rejected",
+                  f.status == BANK_ERR_FRAME && Bank_Equal(&back, &factory));
+    fail |= Check("truncated frame rejected",
+                  SynthBank_ParseFrame(&back, frame, length - 2).status ==
+                  BANK_ERR_FRAME);
+
+    // A value the engine cannot play, with a good checksum
+    SynthBank_t bad = factory;
+    bad.instruments[0].waveform = WAVE_COUNT;
+    cursor = 0;
+    length = SynthBank_DumpFrame(&bad, &cursor, frame);
+    f = SynthBank_ParseFrame(&back, frame, length);
+    fail |= Check("out-of-range value rejected",
+                  f.status == BANK_ERR_VALUE && Bank_Equal(&back, &factory));
+
+    length = SynthBank_ReplyFrame(BANK_SYSEX_COMMAND, BANK_ERR_FLASH, frame);
+    f = SynthBank_ParseFrame(&back, frame, length);
+    fail |= Check("reply frame",
+                  f.id == BANK_SYSEX_REPLY && f.arg == BANK_SYSEX_COMMAND &&
+                  f.status == BANK_ERR_FLASH);
+    return fail;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(void) {
+    fprintf(stderr,
+            "Usage: bank_tool export [out.txt]\n"
+            "       bank_tool syx <bank.txt> <out.syx> [-s]\n"
+            "       bank_tool compile <bank.txt> <out.bin>\n"
+            "       bank_tool text <in.syx|in.bin> [out.txt]\n"
+            "       bank_tool request <out.syx> [-f]\n"
+            "       bank_tool check\n");
+}
+
+int main(int argc, char **argv) {
+    static uint8_t data[FILE_MAX];
+    SynthBank_t bank;
+
+    if (argc < 2) {
+        Usage();
+        return 2;
+    }
+    const char *cmd = argv[1];
+
+    if (strcmp(cmd, "check") == 0) return Run_Check();
+
+    if (strcmp(cmd, "export") == 0) {
+        FILE *out = argc > 2 ? fopen(argv[2], "w") : stdout;
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", argv[2]);
+            return 1;
+        }
+        Factory_Bank(&bank);
+        Write_Text(out, &bank);
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
+    if (strcmp(cmd, "syx") == 0 && argc >= 4) {
+        if (Load_Text(&bank, argv[2])) return 1;
+        bool store = argc > 4 && strcmp(argv[4], "-s") == 0;
+        long n = Write_Frames(&bank, data, store);
+        printf("%s: %d records%s, %ld bytes\n", argv[3],
+               INSTRUMENT_COUNT + SYNTH_PRESET_COUNT,
+               store ? " and store" : "", n);
+        return Write_File(argv[3], data, n);
+    }
+
+    bool compile = strcmp(cmd, "compile") == 0;
+    if ((compile || strcmp(cmd, "image") == 0) && argc >= 4) {
+        if (Load_Text(&bank, argv[2])) return 1;
+        uint16_t n = SynthBank_Encode(&bank, data);
+        if (n > BANK_BLOB_SIZE) {
+            fprintf(stderr, "%s: %u bytes, the bank sector holds %u\n",
+                    argv[3], n, BANK_BLOB_SIZE);
+            return 1;
+        }
+        printf("%s: %u bytes, version %u, program at 0x%05X\n", argv[3], n,
+               BANK_VERSION, BANK_BLOB_ADDRESS);
+        if (Write_File(argv[3], data, n)) return 1;
+        if (compile) Print_Cost(&bank);
+        return 0;
+    }
+
+    if (strcmp(cmd, "text") == 0 && argc >= 3) {
+        long n = Read_File(argv[2], data, FILE_MAX);
+        if (n < 0) return 1;
+        if (n >= 4 && memcmp(data, "SBNK", 4) == 0) {
+            BankStatus_t status = SynthBank_Decode(&bank, data, (uint16_t)n);
+            if (status != BANK_OK) {
+                fprintf(stderr, "%s: %s\n", argv[2], Status_Name(status));
+                return 1;
+            }
+        } else {
+            int records;
+            int errors = Read_Frames(&bank, data, n, &records);
+            fprintf(stderr, "%s: %d records\n", argv[2], records);
+            if (errors) return 1;
+        }
+        FILE *out = argc > 3 ? fopen(argv[3], "w") : stdout;
+        if (!out) {
+            fprintf(stderr, "Cannot write %s\n", argv[3]);
+            return 1;
+        }
+        Write_Text(out, &bank);
+        if (out != stdout) fclose(out);
+        return 0;
+    }
+
+    if (strcmp(cmd, "request") == 0 && argc >= 3) {
+        bool factory = argc > 3 && strcmp(argv[3], "-f") == 0;
+        uint16_t n = factory ? SynthBank_CommandFrame(BANK_OP_FACTORY, data)
+                             : SynthBank_RequestFrame(data);
+        return Write_File(argv[2], data, n);
+    }
+
+    Usage();
+    return 2;
+}
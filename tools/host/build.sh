@@ -0,0 +1,175 @@
+#!/bin/bash
+# Build the host synth tools for Linux
+#   synth_render   control script -> WAV
+#   synth_regress  golden-audio regression suite
+#   synth_bench    audio kernel micro-benchmarks
+#   m0_bench       the same kernels in the Cortex-M0+ simulator
+#   m0sim_check    the simulator on hand-assembled Thumb instruction checks
+#   param_stress   parameter queue between two threads
+#   midi_fuzz      MIDI input parser: fuzz, line rate, engine dispatch
+#   clock_sync     MIDI clock transport against jittered clock streams
+#   bank_tool      sound bank compiler: text <-> SysEx frames and flash image
+#   kv_powercut    flash key-value store on simulated flash, power cuts
+#   dac_snr        DAC12 output stage: noise-shaping SNR gain
+#   dac_dma_sim    DAC12 FIFO + DMA driver on its simulated sink
+#   audio_out_check  every output backend on one tone, stats side by side
+#   mixer_pan      stereo pan law of the voice mixer, out-of-range pans
+# Usage: ./build.sh            (from tools/host)
+#        ./build.sh m0 [--json]
+#            Cross-compile the benchmarked kernels for the Cortex-M0+,
+#            print their code size and run them in m0_bench
+#            (needs arm-none-eabi-gcc, or set CROSS=; M0_OPT sets the
+#            optimization level, default -O2). --json writes
+#            build-m0/size.json and build-m0/cycles.json instead.
+
+cd "$(dirname "$0")"
+LIB=../../lib
+CC=${CC:-gcc}
+CFLAGS="-std=gnu11 -O2 -Wall -Wextra -I$LIB"
+
+ENGINE="synth_script.c
+    $LIB/audio/synth.c
+    $LIB/audio/synth_parts.c
+    $LIB/perf/isr_load.c
+    $LIB/midi/midi_clock.c
+    $LIB/audio/audio_engine.c
+    $LIB/audio/audio_envelope.c
+    $LIB/audio/audio_filters.c
+    $LIB/audio/audio_fxchain.c
+    $LIB/audio/audio_mixer.c
+    $LIB/audio/audio_dynamics.c
+    $LIB/edumkii/edumkii_joystick.c
+    $LIB/edumkii/edumkii_accel.c
+    $LIB/output/audio_out_wav.c"
+
+# synth_bench includes synth.c itself (for its private helpers)
+KERNELS="$LIB/audio/audio_engine.c
+    $LIB/audio/audio_envelope.c
+    $LIB/audio/audio_filters.c
+    $LIB/audio/audio_fxchain.c
+    $LIB/audio/audio_mixer.c
+    $LIB/audio/audio_dynamics.c
+    $LIB/audio/audio_biquad.c
+    $LIB/audio/synth_parts.c
+    $LIB/perf/isr_load.c
+    $LIB/midi/midi_clock.c"
+
+# Symbols in the code size report (static helpers included)
+SIZE_SYMBOLS="Audio_GenerateWaveform Envelope_Process Filter_LowPass
+    Filter_LowPassAlpha Filter_HighPass Filter_SoftClip Filter_HardClip
+    Filter_GainWithFreqCompensation BiquadFilter_Process Generate_Chord_Sample
+    Update_Phase_Increment MIDI_NoteToFreq MIDI_FreqToNote MIDI_CreateNoteOn
+    Synth_RenderBlock"
+
+if [ "$1" = "m0" ]; then
+    CROSS=${CROSS-arm-none-eabi-}
+    M0_FLAGS=${M0_FLAGS--mcpu=cortex-m0plus -mthumb}
+    M0_OPT=${M0_OPT:--O2}
+    M0_CFLAGS="-std=gnu11 $M0_FLAGS -ffunction-sections -fdata-sections
+        -DBENCH_KERNELS_ONLY -DBIQUAD_USE_MATHACL=0 -I$LIB"
+    OUT=build-m0
+    mkdir -p $OUT/size || exit 1
+    rm -f $OUT/*.o $OUT/size/*.o
+    SIZE_OUT=/dev/stdout
+    CYCLES_OUT=/dev/stdout
+    if [ "$2" = "--json" ]; then
+        SIZE_OUT=$OUT/size.json
+        CYCLES_OUT=$OUT/cycles.json
+    fi
+
+    # The biquad uses its C multiply: the MATHACL path needs the SysConfig
+    # headers (and the simulator has no MATHACL).
+    # Size objects: -Os -fno-inline keeps every kernel a symbol of its own.
+    for src in synth_bench.c $KERNELS $LIB/edumkii/edumkii_joystick.c \
+               $LIB/edumkii/edumkii_accel.c; do
+        obj=$(basename ${src%.c}).o
+        ${CROSS}gcc $M0_CFLAGS $M0_OPT -c $src -o $OUT/$obj || exit 1
+        ${CROSS}gcc $M0_CFLAGS -Os -fno-inline -c $src -o $OUT/size/$obj || exit 1
+    done
+    ${CROSS}gcc $M0_FLAGS -nostartfiles -T m0sim.ld -Wl,--gc-sections \
+        -o $OUT/bench.elf $OUT/*.o -lgcc -lc || exit 1
+
+    ${CROSS}nm -S --size-sort $OUT/size/*.o 2>/dev/null | awk -v want="$SIZE_SYMBOLS" \
+        -v json="$2" -v flags="$M0_FLAGS" '
+        function hex(s,   v, i) {
+            v = 0
+            for (i = 1; i <= length(s); i++)
+                v = v * 16 + index("0123456789abcdef", tolower(substr(s, i, 1))) - 1
+            return v
+        }
+        BEGIN { n = split(want, w); for (i = 1; i <= n; i++) size[w[i]] = -1 }
+        # GCC clones keep the name with a suffix (MIDI_CreateNoteOn.constprop.0)
+        { sym = $4; sub(/\..*/, "", sym) }
+        sym in size && size[sym] < 0 { size[sym] = hex($2) }
+        END {
+            if (json == "--json") printf "{\n  \"flags\": \"%s\",\n  \"kernels\": [", flags
+            else printf "Code size (-Os %s)\n\n%-34s %6s\n", flags, "kernel", "bytes"
+            for (i = 1; i <= n; i++) {
+                if (json == "--json")
+                    printf "%s\n    {\"name\": \"%s\", \"bytes\": %d}", (i > 1 ? "," : ""), w[i], size[w[i]]
+                else if (size[w[i]] < 0) printf "%-34s %6s\n", w[i], "-"
+                else printf "%-34s %6d\n", w[i], size[w[i]]
+            }
+            if (json == "--json") printf "\n  ]\n}\n"
+        }' > $SIZE_OUT
+
+    $CC $CFLAGS -o m0_bench m0_bench.c m0sim.c || exit 1
+    [ -n "$2" ] || echo
+    ./m0_bench $OUT/bench.elf $2 > $CYCLES_OUT || exit 1
+    [ -z "$2" ] || echo "Wrote $SIZE_OUT and $CYCLES_OUT"
+    exit 0
+fi
+
+for tool in synth_render synth_regress; do
+    $CC $CFLAGS -o $tool $tool.c $ENGINE -lm || exit 1
+    echo "Built tools/host/$tool"
+done
+
+$CC $CFLAGS -o synth_bench synth_bench.c $KERNELS \
+    $LIB/edumkii/edumkii_joystick.c $LIB/edumkii/edumkii_accel.c || exit 1
+echo "Built tools/host/synth_bench"
+
+$CC $CFLAGS -o m0_bench m0_bench.c m0sim.c || exit 1
+echo "Built tools/host/m0_bench"
+
+$CC $CFLAGS -o m0sim_check m0sim_check.c m0sim.c || exit 1
+echo "Built tools/host/m0sim_check"
+
+$CC $CFLAGS -o param_stress param_stress.c $ENGINE -lm -lpthread || exit 1
+echo "Built tools/host/param_stress"
+
+$CC $CFLAGS -o midi_fuzz midi_fuzz.c $LIB/midi/midi_in.c $LIB/midi/midi_out.c \
+    $ENGINE -lm -lpthread || exit 1
+echo "Built tools/host/midi_fuzz"
+
+$CC $CFLAGS -o clock_sync clock_sync.c $LIB/midi/midi_clock.c -lm || exit 1
+echo "Built tools/host/clock_sync"
+
+$CC $CFLAGS -o bank_tool bank_tool.c $LIB/audio/synth_bank.c $ENGINE -lm || exit 1
+echo "Built tools/host/bank_tool"
+
+$CC $CFLAGS -o kv_powercut kv_powercut.c $LIB/storage/flash_kv.c || exit 1
+echo "Built tools/host/kv_powercut"
+
+$CC $CFLAGS -o mixer_pan mixer_pan.c $LIB/audio/audio_mixer.c || exit 1
+echo "Built tools/host/mixer_pan"
+
+$CC $CFLAGS -o dac_snr dac_snr.c $LIB/audio/audio_dac.c -lm || exit 1
+echo "Built tools/host/dac_snr"
+
+$CC $CFLAGS -o dac_dma_sim dac_dma_sim.c $LIB/output/dac12_dma.c || exit 1
+echo "Built tools/host/dac_dma_sim"
+
+# The PWM and UART backends are target code: built with AUDIO_OUT_SIM=0
+# against the DriverLib stand-in in dl_fake/. They give the DMA its
+# addresses as uint32_t, so this tool links without PIE.
+mkdir -p build-host || exit 1
+for src in $LIB/output/audio_out_pwm.c $LIB/output/audio_out_uart.c; do
+    $CC $CFLAGS -fno-pie -Wno-pointer-to-int-cast -DAUDIO_OUT_SIM=0 -Idl_fake \
+        -c $src -o build-host/$(basename ${src%.c}).o || exit 1
+done
+$CC $CFLAGS -fno-pie -no-pie -o audio_out_check audio_out_check.c \
+    build-host/audio_out_pwm.o build-host/audio_out_uart.o \
+    $LIB/output/audio_out_dac12.c $LIB/output/audio_out_wav.c \
+    $LIB/output/dac12_dma.c $LIB/audio/audio_dac.c -lm || exit 1
+echo "Built tools/host/audio_out_check"
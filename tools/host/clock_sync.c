@@ -0,0 +1,461 @@
+/**
+ * @file clock_sync.c
+ * @brief MIDI Clock Transport Test with Jittered Clock Streams (Linux host)
+ * @version 1.0.0
+ *
+ * Drives lib/midi/midi_clock the way the firmware does: received bytes are
+ * handed over once per 32-sample block, before the block renders, and the
+ * transport advances one sample at a time. The source sends 24 clocks per
+ * beat, each late by a random amount (the sender, the cable, the RX ring),
+ * so a clock reaches the transport up to a block plus the jitter after its
+ * ideal time.
+ *
+ *   master     Own clock at a tempo off the sample grid: every clock within
+ *              a sample of its ideal time, none lost over ten minutes, and
+ *              every one sent.
+ *   slave      Steady tempos with block and random jitter: after two beats
+ *              every local clock (and so every arpeggiator step) must be
+ *              closer to the ideal beat grid than the received clocks are,
+ *              none missed or doubled, and the tempo estimate close.
+ *   ramp       Tempo sweeping up and back down: still no clock lost.
+ *   transport  Start, Stop (clocks keep coming, the position holds),
+ *              Continue (the position goes on), Start again (from zero).
+ *   dropout    The source goes quiet: master again after the timeout, at
+ *              the tempo it had learnt.
+ *   stop       The source sends Stop, then nothing (a DAW stopping): after
+ *              the timeout the transport is master but still stopped, and
+ *              no clock plays or is sent.
+ *
+ * Exit status 1 on any failure.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./clock_sync                     All tests
+ *   ./clock_sync -s 7                PRNG seed
+ *   ./clock_sync -j 3000             Worst random clock delay (us)
+ */
+
+#include "midi/midi_clock.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define SAMPLE_RATE      16000u
+#define BLOCK            32u         // Samples per block (2 ms)
+#define DEFAULT_SEED     1u
+#define DEFAULT_JITTER_US 1000u      // USB-MIDI interfaces manage about this
+#define LOCK_CLOCKS      (2 * MIDI_CLOCK_PPQN)  // Ignored while locking
+#define STEP_CLOCKS      6           // Arpeggiator sixteenths
+#define MAX_CLOCKS       100000u
+
+//=============================================================================
+// SOURCE
+//=============================================================================
+// Clock k is due at ideal[k] (samples) and arrives at arrive[k]
+typedef struct {
+    double ideal[MAX_CLOCKS];
+    double arrive[MAX_CLOCKS];
+    uint32_t count;
+} Source_t;
+
+static uint32_t Rand(uint32_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+static double Uniform(uint32_t *rng) {
+    return (double)Rand(rng) / 4294967296.0;
+}
+
+static double Samples_Per_Clock(double bpm) {
+    return SAMPLE_RATE * 60.0 / (bpm * MIDI_CLOCK_PPQN);
+}
+
+// Tempo from bpm_from to bpm_to (linear per clock), jitter_us late at most
+static void Source_Build(Source_t *s, double start, uint32_t clocks,
+                         double bpm_from, double bpm_to, uint32_t jitter_us,
+                         uint32_t *rng) {
+    double t = start;
+    double jitter = jitter_us * (SAMPLE_RATE / 1e6);
+
+    s->count = clocks;
+    for (uint32_t k = 0; k < clocks; k++) {
+        double bpm = bpm_from + (bpm_to - bpm_from) * k / clocks;
+        s->ideal[k] = t;
+        s->arrive[k] = t + jitter * Uniform(rng);
+        t += Samples_Per_Clock(bpm);
+    }
+}
+
+//=============================================================================
+// TRANSPORT RUN
+//=============================================================================
+typedef struct {
+    uint32_t time;                   // Sample the clock fell on
+    uint32_t position;
+} Clock_t;
+
+typedef struct {
+    Clock_t clocks[MAX_CLOCKS + 64];
+    uint32_t count;
+    uint32_t sent;                   // Master clocks through the hook
+} Run_t;
+
+static Run_t run;
+static Source_t source;
+
+static void Count_Sent(uint8_t byte) {
+    if (byte == MIDI_CLOCK_TICK) run.sent++;
+}
+
+// Samples up to 'until', handing over the source clocks (from 'next') at
+// the block after they arrive; returns the next clock not yet sent
+static uint32_t Run_Until(MidiClock_t *clock, uint32_t until, uint32_t next,
+                          const Source_t *s) {
+    while (clock->time < until) {
+        // A block: what arrived before it first
+        while (s && next < s->count && s->arrive[next] <= clock->time) {
+            MidiClock_RealTime(clock, MIDI_CLOCK_TICK);
+            next++;
+        }
+        for (uint32_t i = 0; i < BLOCK; i++) {
+            if (MidiClock_Advance(clock) && run.count < MAX_CLOCKS + 64) {
+                // time has already counted this sample
+                run.clocks[run.count].time = clock->time - 1;
+                run.clocks[run.count].position = clock->position;
+                run.count++;
+            }
+        }
+    }
+    return next;
+}
+
+// Half a clock after the last one (less a block: runs end on a block)
+static uint32_t End_Of(const Source_t *s) {
+    uint32_t n = s->count;
+    return (uint32_t)(s->ideal[n - 1] + (s->ideal[n - 1] - s->ideal[n - 2]) / 2)
+           - BLOCK;
+}
+
+static void Run_Reset(void) {
+    run.count = 0;
+    run.sent = 0;
+}
+
+//=============================================================================
+// CHECKS
+//=============================================================================
+typedef struct {
+    double mean;                     // Constant lag, samples
+    double max;                      // Worst distance from the mean
+    double rms;
+} Spread_t;
+
+static Spread_t Spread(const double *e, uint32_t n) {
+    Spread_t s = {0, 0, 0};
+    if (n == 0) return s;
+    for (uint32_t i = 0; i < n; i++) s.mean += e[i];
+    s.mean /= n;
+    for (uint32_t i = 0; i < n; i++) {
+        double d = e[i] - s.mean;
+        if (fabs(d) > s.max) s.max = fabs(d);
+        s.rms += d * d;
+    }
+    s.rms = sqrt(s.rms / n);
+    return s;
+}
+
+static double errors[MAX_CLOCKS];
+
+// Received clocks as the transport sees them: at the next block boundary
+static Spread_t Input_Spread(const Source_t *s, uint32_t from) {
+    uint32_t n = 0;
+    for (uint32_t k = from; k < s->count; k++) {
+        double seen = ceil(s->arrive[k] / BLOCK) * BLOCK;
+        errors[n++] = seen - s->ideal[k];
+    }
+    return Spread(errors, n);
+}
+
+// Local clocks against the ideal time of the same position (steps only if
+// 'step'); false if a position is missing, doubled or out of order
+static bool Output_Spread(const Source_t *s, uint32_t from, uint32_t step,
+                          Spread_t *out) {
+    uint32_t n = 0;
+    for (uint32_t i = 0; i < run.count; i++) {
+        uint32_t p = run.clocks[i].position;
+        if (p != i) {
+            printf("  clock %u has position %u\n", i, p);
+            return false;
+        }
+        if (p < from || p >= s->count || p % step) continue;
+        errors[n++] = run.clocks[i].time - s->ideal[p];
+    }
+    *out = Spread(errors, n);
+    return true;
+}
+
+static double Ms(double samples) {
+    return samples * 1000.0 / SAMPLE_RATE;
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+static bool Master_Test(void) {
+    static MidiClock_t clock;
+    const uint16_t bpm = 97;
+    const uint32_t minutes = 10;
+    double period = Samples_Per_Clock(bpm);
+    double worst = 0;
+
+    Run_Reset();
+    MidiClock_Init(&clock, SAMPLE_RATE, Count_Sent);
+    MidiClock_SetTempo(&clock, bpm);
+    uint32_t samples = minutes * 60u * SAMPLE_RATE;
+    uint32_t expected = (uint32_t)(samples / period);
+
+    // The run buffer holds the first clocks; the rest are only counted
+    uint32_t position = 0;
+    bool order = true;
+    for (uint32_t t = 0; t < samples; t++) {
+        if (!MidiClock_Advance(&clock)) continue;
+        position++;
+        order = order && clock.position == position;
+        double e = fabs(t + 1 - position * period);
+        if (e > worst) worst = e;
+    }
+    bool ok = order && position >= expected - 1 && position <= expected + 1 &&
+              run.sent == position && worst < 1.0 &&
+              MidiClock_GetTempo10(&clock) == bpm * 10;
+    printf("master    %u BPM, %u min: %u clocks (%u sent), within %.2f "
+           "samples of the grid  %s\n", bpm, minutes, position, run.sent,
+           worst, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+// Start, then 'beats' of clock at 'bpm'
+static bool Slave_Case(double bpm, uint32_t jitter_us, uint32_t beats,
+                       uint32_t *rng) {
+    static MidiClock_t clock;
+    uint32_t clocks = beats * MIDI_CLOCK_PPQN;
+    double start = 1000.5; // Off the block grid
+
+    Run_Reset();
+    MidiClock_Init(&clock, SAMPLE_RATE, Count_Sent);
+    Source_Build(&source, start, clocks, bpm, bpm, jitter_us, rng);
+    Run_Until(&clock, (uint32_t)start - 100, 0, NULL);
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    Run_Reset();
+
+    // Up to half a clock after the last: the local clock may run one ahead
+    Run_Until(&clock, End_Of(&source), 0, &source);
+
+    Spread_t in = Input_Spread(&source, LOCK_CLOCKS);
+    Spread_t out, steps;
+    bool ok = Output_Spread(&source, LOCK_CLOCKS, 1, &out) &&
+              Output_Spread(&source, LOCK_CLOCKS, STEP_CLOCKS, &steps);
+    double tempo = MidiClock_GetTempo10(&clock) / 10.0;
+
+    // Every clock once, none sent back, steadier than what came in
+    ok = ok && run.count == clocks && run.sent == 0 && clock.external &&
+         out.max <= in.max && out.rms < in.rms &&
+         fabs(tempo - bpm) <= bpm * 0.005;
+    printf("slave     %5.1f BPM, jitter %4u us: %u/%u clocks, tempo %5.1f, "
+           "in ±%.2f ms (rms %.2f), steps ±%.2f ms (rms %.2f), lag %.2f ms  %s\n",
+           bpm, jitter_us, run.count, clocks, tempo, Ms(in.max), Ms(in.rms),
+           Ms(steps.max), Ms(steps.rms), Ms(out.mean), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool Slave_Test(uint32_t jitter_us, uint32_t *rng) {
+    bool ok = true;
+    ok = Slave_Case(120.0, 0, 64, rng) && ok;
+    ok = Slave_Case(120.0, jitter_us, 64, rng) && ok;
+    ok = Slave_Case(174.3, jitter_us, 128, rng) && ok;
+    ok = Slave_Case(60.0, jitter_us, 32, rng) && ok;
+    ok = Slave_Case(MIDI_CLOCK_MAX_BPM, jitter_us, 128, rng) && ok;
+    ok = Slave_Case(MIDI_CLOCK_MIN_BPM, jitter_us, 16, rng) && ok;
+    return ok;
+}
+
+static bool Ramp_Test(uint32_t jitter_us, uint32_t *rng) {
+    static MidiClock_t clock;
+    uint32_t half = 32 * MIDI_CLOCK_PPQN;
+    Source_t *s = &source;
+
+    // 90 -> 150 -> 90 BPM, eight bars each way
+    Run_Reset();
+    MidiClock_Init(&clock, SAMPLE_RATE, NULL);
+    Source_Build(s, 500.0, half, 90.0, 150.0, jitter_us, rng);
+    static Source_t down;
+    double t = s->ideal[half - 1] + Samples_Per_Clock(150.0);
+    Source_Build(&down, t, half, 150.0, 90.0, jitter_us, rng);
+    memcpy(&s->ideal[half], down.ideal, half * sizeof(double));
+    memcpy(&s->arrive[half], down.arrive, half * sizeof(double));
+    s->count = 2 * half;
+
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    Run_Until(&clock, End_Of(s), 0, s);
+
+    Spread_t in = Input_Spread(s, LOCK_CLOCKS), out;
+    bool ok = Output_Spread(s, LOCK_CLOCKS, STEP_CLOCKS, &out) &&
+              run.count == s->count && out.max <= in.max + BLOCK;
+    printf("ramp      90-150-90 BPM, jitter %4u us: %u/%u clocks, "
+           "in ±%.2f ms, steps ±%.2f ms  %s\n", jitter_us, run.count, s->count,
+           Ms(in.max), Ms(out.max), ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool Transport_Test(uint32_t jitter_us, uint32_t *rng) {
+    static MidiClock_t clock;
+    Source_t *s = &source;
+    uint32_t beat = MIDI_CLOCK_PPQN;
+    bool ok = true;
+
+    // The source runs throughout; transport bytes go between its clocks
+    MidiClock_Init(&clock, SAMPLE_RATE, NULL);
+    Source_Build(s, 300.0, 40 * beat, 120.0, 120.0, jitter_us, rng);
+    double period = Samples_Per_Clock(120.0);
+    uint32_t next = Run_Until(&clock, 200, 0, s);
+
+    // Start: positions from 0, one per received clock
+    Run_Reset();
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    next = Run_Until(&clock, (uint32_t)(s->ideal[8 * beat] - period / 2), next, s);
+    uint32_t played = run.count;
+    ok = ok && played == 8 * beat && clock.position == 8 * beat - 1;
+
+    // Stop: no clocks for four beats while the source keeps clocking
+    MidiClock_RealTime(&clock, MIDI_CLOCK_STOP);
+    next = Run_Until(&clock, (uint32_t)(s->ideal[12 * beat] - period / 2), next, s);
+    ok = ok && run.count == played && !clock.running && clock.external;
+
+    // Continue: the next received clock is the next position
+    MidiClock_RealTime(&clock, MIDI_CLOCK_CONT);
+    next = Run_Until(&clock, (uint32_t)(s->ideal[20 * beat] - period / 2), next, s);
+    bool cont = run.count == played + 8 * beat;
+    for (uint32_t i = 0; i < run.count; i++) {
+        cont = cont && run.clocks[i].position == i;
+    }
+    // ... a clock after Continue falls near its received clock
+    double lag = run.clocks[played + beat].time -
+                 s->ideal[12 * beat + beat];
+    cont = cont && lag > 0 && lag < BLOCK + jitter_us * (SAMPLE_RATE / 1e6) + 8;
+    ok = ok && cont;
+
+    // Start again: back to position 0
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    Run_Reset();
+    Run_Until(&clock, (uint32_t)(s->ideal[24 * beat] - period / 2), next, s);
+    ok = ok && run.count == 4 * beat && run.clocks[0].position == 0 &&
+         clock.position == 4 * beat - 1;
+
+    printf("transport start/stop/continue/start at 120 BPM: position %u, "
+           "lag after continue %.2f ms  %s\n", clock.position, Ms(lag),
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool Dropout_Test(uint32_t jitter_us, uint32_t *rng) {
+    static MidiClock_t clock;
+    Source_t *s = &source;
+    double bpm = 133.0;
+
+    Run_Reset();
+    MidiClock_Init(&clock, SAMPLE_RATE, Count_Sent);
+    Source_Build(s, 100.0, 16 * MIDI_CLOCK_PPQN, bpm, bpm, jitter_us, rng);
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    uint32_t last = (uint32_t)s->ideal[s->count - 1];
+    Run_Until(&clock, last + BLOCK * 2, 0, s);
+    uint32_t followed = run.count;
+    bool ok = followed == s->count && run.sent == 0;
+
+    // Nothing more: one clock ahead at most, quiet for the timeout, then
+    // own clocks at the tempo
+    uint32_t timeout = SAMPLE_RATE * MIDI_CLOCK_TIMEOUT_MS / 1000u;
+    Run_Until(&clock, last + timeout + 4 * SAMPLE_RATE, s->count, s);
+    uint32_t first = followed, gaps = 0;
+    while (first < run.count && run.clocks[first].time <= last + timeout) first++;
+    double mean = 0;
+    if (run.count > first + 1) {
+        gaps = run.count - 1 - first;
+        mean = (double)(run.clocks[run.count - 1].time -
+                        run.clocks[first].time) / gaps;
+    }
+    double tempo = mean > 0 ? SAMPLE_RATE * 60.0 / (mean * MIDI_CLOCK_PPQN) : 0;
+    ok = ok && first <= followed + 1 && !clock.external && gaps > 0 &&
+         run.sent == run.count - first && fabs(tempo - bpm) <= bpm * 0.005;
+    printf("dropout   %.0f BPM source gone: master after %u ms, own clock at "
+           "%.1f BPM, %u sent  %s\n", bpm,
+           first < run.count
+               ? (unsigned)Ms(run.clocks[first].time - last)
+               : 0,
+           tempo, run.sent, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static bool Stop_Silence_Test(uint32_t jitter_us, uint32_t *rng) {
+    static MidiClock_t clock;
+    Source_t *s = &source;
+
+    Run_Reset();
+    MidiClock_Init(&clock, SAMPLE_RATE, Count_Sent);
+    Source_Build(s, 100.0, 8 * MIDI_CLOCK_PPQN, 120.0, 120.0, jitter_us, rng);
+    MidiClock_RealTime(&clock, MIDI_CLOCK_START);
+    uint32_t last = (uint32_t)s->ideal[s->count - 1];
+    Run_Until(&clock, last + BLOCK * 2, 0, s);
+    uint32_t followed = run.count;
+
+    // Stop, then silence for the timeout and four seconds more
+    MidiClock_RealTime(&clock, MIDI_CLOCK_STOP);
+    uint32_t timeout = SAMPLE_RATE * MIDI_CLOCK_TIMEOUT_MS / 1000u;
+    Run_Until(&clock, last + timeout + 4 * SAMPLE_RATE, s->count, s);
+    bool ok = followed == s->count && run.count == followed &&
+              run.sent == 0 && !clock.external && !clock.running;
+    printf("stop      Stop, then no clock: %u clocks after Stop, %u sent, "
+           "%s, %s  %s\n", run.count - followed, run.sent,
+           clock.external ? "slave" : "master",
+           clock.running ? "running" : "stopped", ok ? "OK" : "FAIL");
+    return ok;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-s seed] [-j jitter_us]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    uint32_t seed = DEFAULT_SEED;
+    uint32_t jitter_us = DEFAULT_JITTER_US;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            jitter_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+    if (seed == 0) Usage(argv[0]); // xorshift needs a non-zero state
+
+    uint32_t rng = seed;
+    bool ok = true;
+    ok = Master_Test() && ok;
+    ok = Slave_Test(jitter_us, &rng) && ok;
+    ok = Ramp_Test(jitter_us, &rng) && ok;
+    ok = Transport_Test(jitter_us, &rng) && ok;
+    ok = Dropout_Test(jitter_us, &rng) && ok;
+    ok = Stop_Silence_Test(jitter_us, &rng) && ok;
+    return ok ? 0 : 1;
+}
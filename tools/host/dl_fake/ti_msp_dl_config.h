@@ -0,0 +1,117 @@
+/**
+ * @file ti_msp_dl_config.h
+ * @brief DriverLib Stand-In for the Target Output Backends (Linux host)
+ * @version 1.0.0
+ *
+ * Just enough of the SysConfig header and DriverLib for
+ * lib/output/audio_out_pwm.c and audio_out_uart.c to build on Linux with
+ * AUDIO_OUT_SIM=0. The peripherals are plain structs: the PWM timer
+ * records every compare value it is given, the DMA channel keeps its
+ * addresses and enable bit. audio_out_check.c defines the instances and
+ * plays the part of the hardware (sample ticks, the UART draining DMA_CH1).
+ *
+ * The backends hand the DMA its addresses as uint32_t, as on the MCU, so
+ * whatever links them must be built without PIE (static data below 4 GB).
+ *
+ * Usage:
+ *   gcc -DAUDIO_OUT_SIM=0 -Idl_fake -fno-pie -c ../../lib/output/audio_out_pwm.c
+ */
+
+#ifndef TI_MSP_DL_CONFIG_H_
+#define TI_MSP_DL_CONFIG_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//=============================================================================
+// PERIPHERALS
+//=============================================================================
+#define FAKE_PWM_LOADS_MAX (4 * 16000)
+
+typedef struct {
+    bool running;
+    uint32_t compare;                        ///< CC0, as last loaded
+    uint16_t loads[FAKE_PWM_LOADS_MAX];      ///< Every value loaded into CC0
+    uint32_t load_count;
+} GPTIMER_Regs;
+
+typedef struct {
+    bool enabled;
+    uint32_t mode;
+    uint32_t src;
+    uint32_t dest;
+    uint16_t size;
+} FakeDmaChannel_t;
+
+typedef struct {
+    FakeDmaChannel_t chan[8];
+} DMA_Regs;
+
+typedef struct {
+    volatile uint32_t TXDATA;
+} UART_Regs;
+
+extern GPTIMER_Regs fake_pwm_timer;
+extern DMA_Regs fake_dma;
+extern UART_Regs fake_uart;
+
+//=============================================================================
+// SYSCONFIG NAMES
+//=============================================================================
+#define PWM_AUDIO_INST  (&fake_pwm_timer)
+#define UART_AUDIO_INST (&fake_uart)
+#define DMA             (&fake_dma)
+#define DMA_CH1_CHAN_ID 1
+
+#define DL_TIMER_CC_0_INDEX         0
+#define DL_DMA_SINGLE_TRANSFER_MODE 0
+
+//=============================================================================
+// DRIVERLIB
+//=============================================================================
+static inline void DL_TimerG_setCaptureCompareValue(GPTIMER_Regs *t,
+                                                    uint32_t value,
+                                                    uint32_t index) {
+    (void)index;
+    t->compare = value;
+    if (t->load_count < FAKE_PWM_LOADS_MAX)
+        t->loads[t->load_count++] = (uint16_t)value;
+}
+
+static inline void DL_TimerG_startCounter(GPTIMER_Regs *t) {
+    t->running = true;
+}
+
+static inline void DL_DMA_disableChannel(DMA_Regs *dma, uint8_t ch) {
+    dma->chan[ch].enabled = false;
+}
+
+static inline void DL_DMA_enableChannel(DMA_Regs *dma, uint8_t ch) {
+    dma->chan[ch].enabled = true;
+}
+
+static inline bool DL_DMA_isChannelEnabled(DMA_Regs *dma, uint8_t ch) {
+    return dma->chan[ch].enabled;
+}
+
+static inline void DL_DMA_setTransferMode(DMA_Regs *dma, uint8_t ch,
+                                          uint32_t mode) {
+    dma->chan[ch].mode = mode;
+}
+
+static inline void DL_DMA_setSrcAddr(DMA_Regs *dma, uint8_t ch,
+                                     uint32_t addr) {
+    dma->chan[ch].src = addr;
+}
+
+static inline void DL_DMA_setDestAddr(DMA_Regs *dma, uint8_t ch,
+                                      uint32_t addr) {
+    dma->chan[ch].dest = addr;
+}
+
+static inline void DL_DMA_setTransferSize(DMA_Regs *dma, uint8_t ch,
+                                          uint16_t size) {
+    dma->chan[ch].size = size;
+}
+
+#endif /* TI_MSP_DL_CONFIG_H_ */
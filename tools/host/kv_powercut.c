@@ -0,0 +1,434 @@
+/**
+ * @file kv_powercut.c
+ * @brief Flash Key-Value Store on a Simulated Flash with Power Cuts (Linux host)
+ * @version 1.0.0
+ *
+ * Runs lib/storage/flash_kv against a RAM copy of the flash region that
+ * behaves like the MSPM0 main flash: an erase sets a whole sector to 0xFF,
+ * and a program only clears bits. A 64-bit word may be programmed once
+ * between erases (ECC); programming it twice fails the test.
+ *
+ *   basic     Set, get, overwrite, delete, a rewrite of the same value
+ *             (no flash write), bad key, oversize value, a store too full.
+ *   reboot    Values and deletions survive a re-init from flash.
+ *   wear      Many writes: every sector of the ring is erased as often
+ *             as the others (within one), and the values stay right.
+ *   scan      Boot scan of the worst sectors: the most records (all
+ *             empty) and the most bytes (all full). The count is bounded
+ *             by FLASH_KV_SCAN_MAX; the time is this host's.
+ *   powercut  A workload of sets and deletes (small settings and a
+ *             200-byte bank) is cut off at every flash word it programs
+ *             and in every erase. The word being programmed keeps a random
+ *             part of its bits; the sector being erased keeps a random
+ *             mix of old and erased bytes. After each cut the store is
+ *             re-initialised from flash: every key must hold its value
+ *             from before the interrupted operation, and the key it was
+ *             writing may hold the new value instead. The store must then
+ *             take further writes and survive another reboot.
+ *
+ * Exit status 1 on any failure.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./kv_powercut                    All tests
+ *   ./kv_powercut -s 7               PRNG seed
+ *   ./kv_powercut -n 400             Operations in the power-cut workload
+ */
+
+#include "storage/flash_kv.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DEFAULT_SEED     1u
+#define DEFAULT_OPS      300u        // Power-cut workload
+#define WEAR_WRITES      50000u
+#define REBOOT_EVERY     97          // Wear test: re-init from flash
+#define KEYS_USED        6           // Power-cut workload: 0 = bank, 1-5 small
+#define BANK_BYTES       200
+#define AFTER_CUT_OPS    20
+#define SCAN_RUNS        1000
+
+//=============================================================================
+// SIMULATED FLASH
+//=============================================================================
+static uint8_t flash[FLASH_KV_REGION_SIZE];
+static uint32_t erase_count[FLASH_KV_SECTORS];
+static uint32_t word_programs;
+static long ops_left = -1;           // Flash operations before the cut
+static jmp_buf power_cut;
+static bool reprogrammed;            // A word programmed twice
+static uint32_t rng_state;
+
+static uint32_t Rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// true when the power goes now
+static bool Cut_Now(void) {
+    if (ops_left < 0) return false;
+    if (ops_left == 0) return true;
+    ops_left--;
+    return false;
+}
+
+static bool Sim_Erase(uint32_t offset) {
+    if (offset % FLASH_KV_SECTOR_SIZE || offset >= FLASH_KV_REGION_SIZE)
+        return false;
+    uint8_t *s = flash + offset;
+    if (Cut_Now()) {
+        for (uint32_t i = 0; i < FLASH_KV_SECTOR_SIZE; i++) {
+            if (Rand() & 1) s[i] = 0xFF;
+            else s[i] |= (uint8_t)Rand(); // Bits on their way to 1
+        }
+        longjmp(power_cut, 1);
+    }
+    memset(s, 0xFF, FLASH_KV_SECTOR_SIZE);
+    erase_count[offset / FLASH_KV_SECTOR_SIZE]++;
+    return true;
+}
+
+static bool Sim_Program(uint32_t offset, const uint32_t *words,
+                        uint16_t count) {
+    if (offset % FLASH_KV_WORD || count % 2 ||
+        offset + count * 4u > FLASH_KV_REGION_SIZE)
+        return false;
+    const uint8_t *src = (const uint8_t *)words;
+    for (uint16_t w = 0; w < count / 2; w++) {
+        uint8_t *dst = flash + offset + w * FLASH_KV_WORD;
+        if (Cut_Now()) {
+            for (uint8_t i = 0; i < FLASH_KV_WORD; i++)
+                dst[i] &= src[w * 8 + i] | (uint8_t)Rand(); // Some 0s not yet
+            longjmp(power_cut, 1);
+        }
+        for (uint8_t i = 0; i < FLASH_KV_WORD; i++) {
+            if (dst[i] != 0xFF) reprogrammed = true;
+            dst[i] &= src[w * 8 + i];
+        }
+        word_programs++;
+    }
+    return true;
+}
+
+static uint32_t Host_Ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+static const FlashKvPort_t SIM_PORT = {Sim_Erase, Sim_Program, FlashKv_Crc32,
+                                       Host_Ns};
+
+static void Flash_Reset(void) {
+    memset(flash, 0xFF, sizeof(flash));
+    memset(erase_count, 0, sizeof(erase_count));
+    word_programs = 0;
+    reprogrammed = false;
+    ops_left = -1;
+}
+
+//=============================================================================
+// MODEL (what the store should hold)
+//=============================================================================
+typedef struct {
+    bool has[FLASH_KV_KEYS];
+    uint16_t length[FLASH_KV_KEYS];
+    uint8_t value[FLASH_KV_KEYS][FLASH_KV_VALUE_MAX];
+} Model_t;
+
+typedef struct {
+    uint8_t key;
+    bool delete;
+    uint16_t length;
+    uint8_t value[FLASH_KV_VALUE_MAX];
+} Op_t;
+
+static void Model_Apply(Model_t *m, const Op_t *op) {
+    m->has[op->key] = !op->delete;
+    m->length[op->key] = op->length;
+    memcpy(m->value[op->key], op->value, op->length);
+}
+
+static bool Key_Matches(const FlashKv_t *kv, const Model_t *m, uint8_t key) {
+    uint16_t length;
+    const uint8_t *v = FlashKv_Get(kv, key, &length);
+    if (!m->has[key]) return v == NULL;
+    return v && length == m->length[key] &&
+           memcmp(v, m->value[key], length) == 0;
+}
+
+static bool Store_Matches(const FlashKv_t *kv, const Model_t *m) {
+    for (uint8_t k = 0; k < FLASH_KV_KEYS; k++) {
+        if (!Key_Matches(kv, m, k)) return false;
+    }
+    return true;
+}
+
+static KvStatus_t Store_Apply(FlashKv_t *kv, const Op_t *op) {
+    return op->delete ? FlashKv_Delete(kv, op->key)
+                      : FlashKv_Set(kv, op->key, op->value, op->length);
+}
+
+// Key 0 is a bank-sized value, keys 1..KEYS_USED-1 short settings
+static void Random_Op(Op_t *op, uint8_t keys) {
+    op->key = (uint8_t)(Rand() % keys);
+    op->delete = (Rand() % 10) == 0;
+    op->length = 0;
+    if (op->delete) return;
+    op->length = (uint16_t)(op->key == 0 ? BANK_BYTES : Rand() % 17);
+    for (uint16_t i = 0; i < op->length; i++) op->value[i] = (uint8_t)Rand();
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+static int Report(const char *name, const char *detail, bool ok) {
+    printf("%-9s %-52s %s\n", name, detail, ok ? "OK" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+static int Test_Basic(void) {
+    static FlashKv_t kv;
+    uint8_t big[FLASH_KV_VALUE_MAX + 1];
+    uint16_t length = 0;
+    bool ok = true;
+
+    Flash_Reset();
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    ok &= !kv.formatted && FlashKv_Get(&kv, 3, NULL) == NULL;
+    ok &= FlashKv_Set(&kv, 3, "abc", 3) == KV_OK;
+    const uint8_t *v = FlashKv_Get(&kv, 3, &length);
+    ok &= v && length == 3 && memcmp(v, "abc", 3) == 0;
+    ok &= ((uintptr_t)v % FLASH_KV_WORD) == 0;
+    ok &= FlashKv_Set(&kv, 3, "abcdefghij", 10) == KV_OK;
+    v = FlashKv_Get(&kv, 3, &length);
+    ok &= v && length == 10 && memcmp(v, "abcdefghij", 10) == 0;
+
+    uint32_t before = word_programs;
+    ok &= FlashKv_Set(&kv, 3, "abcdefghij", 10) == KV_OK;
+    ok &= word_programs == before; // Same value: nothing written
+    ok &= FlashKv_Set(&kv, 4, NULL, 0) == KV_OK;
+    ok &= FlashKv_Get(&kv, 4, &length) != NULL && length == 0;
+    ok &= FlashKv_Delete(&kv, 3) == KV_OK && FlashKv_Get(&kv, 3, NULL) == NULL;
+    ok &= FlashKv_Delete(&kv, 3) == KV_OK; // Already gone
+    ok &= FlashKv_Set(&kv, FLASH_KV_KEYS, "x", 1) == KV_ERR_KEY;
+    memset(big, 0x5A, sizeof(big));
+    ok &= FlashKv_Set(&kv, 1, big, FLASH_KV_VALUE_MAX + 1) == KV_ERR_SIZE;
+
+    // Four full-size values cannot share a sector
+    KvStatus_t status = KV_OK;
+    for (uint8_t k = 0; k < 4 && status == KV_OK; k++)
+        status = FlashKv_Set(&kv, k, big, FLASH_KV_VALUE_MAX);
+    ok &= status == KV_ERR_FULL && !reprogrammed;
+    return Report("basic", "set, get, overwrite, delete, same value, errors",
+                  ok);
+}
+
+static int Test_Reboot(void) {
+    static FlashKv_t kv;
+    static Model_t model;
+    Op_t op;
+    bool ok = true;
+
+    Flash_Reset();
+    memset(&model, 0, sizeof(model));
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    for (int i = 0; i < 40; i++) {
+        Random_Op(&op, KEYS_USED);
+        ok &= Store_Apply(&kv, &op) == KV_OK;
+        Model_Apply(&model, &op);
+    }
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    ok &= kv.formatted && !kv.torn && Store_Matches(&kv, &model);
+    return Report("reboot", "40 random writes read back after re-init", ok);
+}
+
+static int Test_Wear(void) {
+    static FlashKv_t kv;
+    static Model_t model;
+    char detail[80];
+    Op_t op;
+    bool ok = true;
+
+    Flash_Reset();
+    memset(&model, 0, sizeof(model));
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    for (uint32_t i = 0; i < WEAR_WRITES && ok; i++) {
+        Random_Op(&op, 8);
+        if (op.key == 0 && !op.delete) op.length = 24;
+        ok &= Store_Apply(&kv, &op) == KV_OK;
+        Model_Apply(&model, &op);
+        if (i % REBOOT_EVERY == 0) {
+            FlashKv_Init(&kv, flash, &SIM_PORT);
+            ok &= Store_Matches(&kv, &model);
+        }
+    }
+    uint32_t lo = erase_count[0], hi = erase_count[0], total = 0;
+    for (uint8_t s = 0; s < FLASH_KV_SECTORS; s++) {
+        if (erase_count[s] < lo) lo = erase_count[s];
+        if (erase_count[s] > hi) hi = erase_count[s];
+        total += erase_count[s];
+    }
+    ok &= hi - lo <= 1 && !reprogrammed && Store_Matches(&kv, &model);
+    snprintf(detail, sizeof(detail),
+             "%u writes, %u erases, %u-%u per sector", WEAR_WRITES, total,
+             lo, hi);
+    return Report("wear", detail, ok);
+}
+
+// Time of the boot scan of the flash as it is, best of SCAN_RUNS
+static uint32_t Scan_Ns(FlashKv_t *kv) {
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < SCAN_RUNS; i++) {
+        FlashKv_Init(kv, flash, &SIM_PORT);
+        if (kv->scan_cycles < best) best = kv->scan_cycles;
+    }
+    return best;
+}
+
+static int Test_Scan(void) {
+    static FlashKv_t kv;
+    static uint8_t value[FLASH_KV_VALUE_MAX];
+    char detail[80];
+    bool ok = true;
+
+    // Most records: empty values until the sector is full
+    Flash_Reset();
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    ok &= FlashKv_Set(&kv, 0, NULL, 0) == KV_OK; // Formats the sector
+    while (kv.write < FLASH_KV_SECTOR_SIZE) {
+        ok &= (FlashKv_Get(&kv, 0, NULL) ? FlashKv_Delete(&kv, 0)
+                                         : FlashKv_Set(&kv, 0, NULL, 0))
+              == KV_OK;
+    }
+    uint32_t ns = Scan_Ns(&kv);
+    ok &= kv.scan_records == FLASH_KV_SCAN_MAX;
+    snprintf(detail, sizeof(detail), "%u records (bound %u) in %.1f us",
+             kv.scan_records, FLASH_KV_SCAN_MAX, ns / 1000.0);
+    int fail = Report("scan", detail, ok);
+
+    // Most bytes: full-size values
+    Flash_Reset();
+    FlashKv_Init(&kv, flash, &SIM_PORT);
+    ok = FlashKv_Set(&kv, 0, value, FLASH_KV_VALUE_MAX) == KV_OK;
+    for (uint16_t i = 1;
+         kv.write + FLASH_KV_HEADER + FLASH_KV_VALUE_MAX <= FLASH_KV_SECTOR_SIZE;
+         i++) {
+        value[0] = (uint8_t)i;
+        ok &= FlashKv_Set(&kv, 0, value, FLASH_KV_VALUE_MAX) == KV_OK;
+    }
+    ns = Scan_Ns(&kv);
+    snprintf(detail, sizeof(detail), "%u records of %u bytes in %.1f us",
+             kv.scan_records, FLASH_KV_VALUE_MAX, ns / 1000.0);
+    return fail | Report("scan", detail, ok);
+}
+
+static int Test_Powercut(uint32_t ops, uint32_t seed) {
+    static FlashKv_t kv;
+    static Model_t before, after;
+    static Op_t *work;
+    static volatile uint32_t done;   // Operations finished before the cut
+    static uint32_t cuts, torn, took_new, failures;
+    char detail[96];
+
+    cuts = torn = took_new = failures = 0;
+    work = malloc(ops * sizeof(Op_t));
+    if (!work) return Report("powercut", "out of memory", false);
+    rng_state = seed;
+    for (uint32_t i = 0; i < ops; i++) Random_Op(&work[i], KEYS_USED);
+
+    for (long cut = 0;; cut++) {
+        Flash_Reset();
+        memset(&before, 0, sizeof(before));
+        FlashKv_Init(&kv, flash, &SIM_PORT);
+        done = 0;
+        ops_left = cut;
+        if (setjmp(power_cut) == 0) {
+            for (; done < ops; done++) {
+                if (Store_Apply(&kv, &work[done]) != KV_OK) break;
+                Model_Apply(&before, &work[done]);
+            }
+            ops_left = -1;
+            if (done < ops) failures++;
+            break; // The workload outran the cut: every point is covered
+        }
+
+        // Power back: the interrupted operation is all or nothing
+        ops_left = -1;
+        cuts++;
+        after = before;
+        Model_Apply(&after, &work[done]);
+        FlashKv_Init(&kv, flash, &SIM_PORT);
+        torn += kv.torn;
+        uint8_t key = work[done].key;
+        bool ok = true;
+        for (uint8_t k = 0; k < FLASH_KV_KEYS; k++) {
+            if (k == key) continue;
+            ok &= Key_Matches(&kv, &before, k);
+        }
+        if (Key_Matches(&kv, &after, key) && !Key_Matches(&kv, &before, key)) {
+            took_new++;
+            before = after;
+        } else {
+            ok &= Key_Matches(&kv, &before, key);
+        }
+
+        // Carries on, and the result survives another reboot
+        for (uint32_t i = 0; i < AFTER_CUT_OPS && ok; i++) {
+            const Op_t *op = &work[(done + 1 + i) % ops];
+            ok &= Store_Apply(&kv, op) == KV_OK;
+            Model_Apply(&before, op);
+        }
+        FlashKv_Init(&kv, flash, &SIM_PORT);
+        ok &= Store_Matches(&kv, &before) && !reprogrammed;
+        if (!ok) {
+            if (failures++ == 0)
+                printf("powercut  cut after %ld flash operations (op %u, key "
+                       "%u): wrong values\n", cut, done, key);
+        }
+    }
+    free(work);
+    snprintf(detail, sizeof(detail),
+             "%u cuts in %u ops: %u torn, %u kept the new value", cuts, ops,
+             torn, took_new);
+    return Report("powercut", detail, failures == 0);
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char **argv) {
+    uint32_t seed = DEFAULT_SEED, ops = DEFAULT_OPS;
+    int fail = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            ops = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [-s seed] [-n ops]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (seed == 0) seed = DEFAULT_SEED;
+
+    printf("Flash KV: %u sectors of %u bytes, %u keys, values up to %u "
+           "bytes\n\n", FLASH_KV_SECTORS, FLASH_KV_SECTOR_SIZE, FLASH_KV_KEYS,
+           FLASH_KV_VALUE_MAX);
+    rng_state = seed;
+    fail |= Test_Basic();
+    fail |= Test_Reboot();
+    fail |= Test_Wear();
+    fail |= Test_Scan();
+    fail |= Test_Powercut(ops, seed);
+    return fail;
+}
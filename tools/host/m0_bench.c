@@ -0,0 +1,168 @@
+/**
+ * @file m0_bench.c
+ * @brief Cortex-M0+ Cycle Benchmarks for the Audio Kernels
+ * @version 1.0.0
+ *
+ * Runs the synth_bench kernels, cross-compiled for the MSPM0G3507
+ * (thumbv6m), in the m0sim instruction-set simulator and reports cycles per
+ * sample against the per-sample budget of 80 MHz / SYNTH_SAMPLE_RATE_HZ
+ * (5000 cycles at 16 kHz). Unlike host ns/sample this includes what the
+ * M0+ really pays: no hardware divider (libgcc __aeabi_*div), Thumb-1
+ * only, 2-cycle loads and taken branches.
+ *
+ * The kernel list is read from the image (BENCH_KERNELS in synth_bench.c).
+ * Each kernel runs for n and for 2n samples; the difference / n is the
+ * reported cost, so per-call setup does not count. The checksum (n
+ * samples) must match "./synth_bench -n <n>" on the host.
+ *
+ * Usage:
+ *   ./build.sh m0                   Cross-compile, size report, this run
+ *   ./m0_bench build-m0/bench.elf   All kernels
+ *   ./m0_bench build-m0/bench.elf -w 2 filter
+ *
+ * Options:
+ *   -n <samples>  Samples per run (default 10000)
+ *   -w <states>   Flash wait states (default 0)
+ *   --small-mul   32-cycle multiplier instead of the 1-cycle one
+ *   --json        JSON instead of a table
+ */
+
+#include "m0sim.h"
+#include "audio/synth.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define MCLK_HZ          80000000u
+#define BUDGET_CYCLES    (MCLK_HZ / SYNTH_SAMPLE_RATE_HZ)
+#define DEFAULT_SAMPLES  10000u
+#define NAME_CHARS       32
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+static void Fail(const M0Sim_t *sim, const char *what) {
+    fprintf(stderr, "m0_bench: %s: %s\n", what, sim->message);
+    exit(1);
+}
+
+// Cycles and instructions of one call
+static void Run_Kernel(M0Sim_t *sim, const char *name, uint32_t func,
+                       uint32_t n, uint64_t *cycles, uint64_t *instructions) {
+    uint64_t c0 = sim->cycles, i0 = sim->instructions;
+    if (M0Sim_Call(sim, func, &n, 1, 0) != M0SIM_RETURNED) Fail(sim, name);
+    *cycles = sim->cycles - c0;
+    *instructions = sim->instructions - i0;
+}
+
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s <image.elf> [-n samples] [-w wait_states] "
+            "[--small-mul] [--json] [name-filter]\n", prog);
+    exit(2);
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char **argv) {
+    const char *elf_path = NULL;
+    const char *filter = NULL;
+    uint32_t samples = DEFAULT_SAMPLES;
+    unsigned wait_states = 0;
+    bool small_mul = false;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            wait_states = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--small-mul") == 0) {
+            small_mul = true;
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else if (elf_path == NULL) {
+            elf_path = argv[i];
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (elf_path == NULL || samples == 0 || wait_states > 15) Usage(argv[0]);
+
+    M0Sim_t sim;
+    if (!M0Sim_Init(&sim)) {
+        fprintf(stderr, "m0_bench: out of memory\n");
+        return 1;
+    }
+    if (!M0Sim_LoadElf(&sim, elf_path)) Fail(&sim, "load");
+    sim.flash_wait = (uint8_t)wait_states;
+    sim.mul_cycles = small_mul ? 32 : 1;
+
+    uint32_t init = M0Sim_Symbol(&sim, "Bench_Init", NULL);
+    uint32_t table = M0Sim_Symbol(&sim, "BENCH_KERNELS", NULL);
+    uint32_t count_addr = M0Sim_Symbol(&sim, "BENCH_KERNEL_COUNT", NULL);
+    uint32_t count = 0;
+    if (!init || !table || !M0Sim_Read32(&sim, count_addr, &count)) {
+        fprintf(stderr, "m0_bench: %s has no benchmark kernels "
+                "(build it with ./build.sh m0)\n", elf_path);
+        return 1;
+    }
+    if (M0Sim_Call(&sim, init, NULL, 0, 0) != M0SIM_RETURNED)
+        Fail(&sim, "Bench_Init");
+
+    if (json) {
+        printf("{\n  \"mclk_hz\": %u,\n  \"sample_rate_hz\": %u,\n"
+               "  \"budget_cycles\": %u,\n  \"flash_wait_states\": %u,\n"
+               "  \"multiplier_cycles\": %u,\n  \"samples\": %u,\n"
+               "  \"kernels\": [", MCLK_HZ, SYNTH_SAMPLE_RATE_HZ, BUDGET_CYCLES,
+               wait_states, sim.mul_cycles, samples);
+    } else {
+        printf("Cortex-M0+ @ %u MHz, %u wait states, budget %u cycles/sample "
+               "(%u Hz)\n\n", MCLK_HZ / 1000000, wait_states, BUDGET_CYCLES,
+               SYNTH_SAMPLE_RATE_HZ);
+        printf("%-22s %10s %8s %10s  %s\n", "kernel", "cyc/sample", "budget",
+               "ins/sample", "checksum");
+    }
+
+    bool first = true;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t name_addr, func;
+        char name[NAME_CHARS];
+        if (!M0Sim_Read32(&sim, table + 8 * i, &name_addr) ||
+            !M0Sim_Read32(&sim, table + 8 * i + 4, &func) ||
+            !M0Sim_ReadString(&sim, name_addr, name, sizeof(name))) {
+            fprintf(stderr, "m0_bench: bad kernel table entry %u\n", i);
+            return 1;
+        }
+        if (filter && strstr(name, filter) == NULL) continue;
+
+        uint64_t c1, i1, c2, i2;
+        Run_Kernel(&sim, name, func, samples, &c1, &i1);
+        uint32_t checksum = sim.r[0];
+        Run_Kernel(&sim, name, func, 2 * samples, &c2, &i2);
+
+        double cycles = (double)(c2 - c1) / samples;
+        double instr = (double)(i2 - i1) / samples;
+        double budget = 100.0 * cycles / BUDGET_CYCLES;
+
+        if (json) {
+            printf("%s\n    {\"name\": \"%s\", \"cycles_per_sample\": %.2f, "
+                   "\"instructions_per_sample\": %.2f, \"budget_pct\": %.3f, "
+                   "\"checksum\": \"%08x\"}",
+                   first ? "" : ",", name, cycles, instr, budget, checksum);
+        } else {
+            printf("%-22s %10.2f %7.2f%% %10.2f  %08x\n", name, cycles, budget,
+                   instr, checksum);
+        }
+        first = false;
+    }
+
+    if (json) printf("\n  ]\n}\n");
+    M0Sim_Free(&sim);
+    return 0;
+}
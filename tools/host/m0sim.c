@@ -0,0 +1,710 @@
+/**
+ * @file m0sim.c
+ * @brief Cortex-M0+ Instruction-Set Simulator Implementation
+ */
+
+#include "m0sim.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//=============================================================================
+// PRIVATE DEFINITIONS
+//=============================================================================
+#define RETURN_MAGIC  0xFFFFFFF0u      // LR for M0Sim_Call (bit 0 added)
+#define SP 13
+#define LR 14
+#define PC 15
+
+// ELF32 (only what the loader needs)
+#define EM_ARM   40
+#define PT_LOAD  1
+#define SHT_SYMTAB 2
+
+static bool Sim_Stop(M0Sim_t *sim, const char *fmt, ...) {
+    va_list ap;
+    sim->status = M0SIM_FAULT;
+    va_start(ap, fmt);
+    vsnprintf(sim->message, sizeof(sim->message), fmt, ap);
+    va_end(ap);
+    return false;
+}
+
+static uint16_t Get16(const uint8_t *p) { return (uint16_t)(p[0] | p[1] << 8); }
+
+static uint32_t Get32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+           (uint32_t)p[3] << 24;
+}
+
+//=============================================================================
+// MEMORY
+//=============================================================================
+
+// Host pointer for [addr, addr + size), NULL if unmapped
+static uint8_t *Sim_Map(const M0Sim_t *sim, uint32_t addr, uint32_t size) {
+    if (addr - M0SIM_FLASH_BASE < M0SIM_FLASH_SIZE &&
+        addr - M0SIM_FLASH_BASE + size <= M0SIM_FLASH_SIZE)
+        return sim->flash + (addr - M0SIM_FLASH_BASE);
+    if (addr - M0SIM_SRAM_BASE < M0SIM_SRAM_SIZE &&
+        addr - M0SIM_SRAM_BASE + size <= M0SIM_SRAM_SIZE)
+        return sim->sram + (addr - M0SIM_SRAM_BASE);
+    return NULL;
+}
+
+static bool Is_Flash(uint32_t addr) {
+    return addr - M0SIM_FLASH_BASE < M0SIM_FLASH_SIZE;
+}
+
+// Data load (size 1, 2 or 4); false = fault
+static bool Sim_Load(M0Sim_t *sim, uint32_t addr, uint32_t size, uint32_t *value) {
+    uint8_t *p = (addr & (size - 1)) ? NULL : Sim_Map(sim, addr, size);
+    if (p == NULL)
+        return Sim_Stop(sim, "load%u fault at 0x%08x (pc 0x%08x)", size * 8,
+                        addr, sim->insn_pc);
+    *value = size == 4 ? Get32(p) : size == 2 ? Get16(p) : p[0];
+    if (Is_Flash(addr)) sim->cycles += sim->flash_wait;
+    return true;
+}
+
+// Data store (size 1, 2 or 4); flash is read-only
+static bool Sim_Store(M0Sim_t *sim, uint32_t addr, uint32_t size, uint32_t value) {
+    uint8_t *p = (addr & (size - 1)) || Is_Flash(addr) ? NULL : Sim_Map(sim, addr, size);
+    if (p == NULL)
+        return Sim_Stop(sim, "store%u fault at 0x%08x (pc 0x%08x)", size * 8,
+                        addr, sim->insn_pc);
+    for (uint32_t i = 0; i < size; i++) p[i] = (uint8_t)(value >> (8 * i));
+    return true;
+}
+
+bool M0Sim_Read32(const M0Sim_t *sim, uint32_t addr, uint32_t *value) {
+    const uint8_t *p = (addr & 3) ? NULL : Sim_Map(sim, addr, 4);
+    if (p == NULL) return false;
+    *value = Get32(p);
+    return true;
+}
+
+bool M0Sim_ReadString(const M0Sim_t *sim, uint32_t addr, char *buf, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        const uint8_t *p = Sim_Map(sim, addr + (uint32_t)i, 1);
+        if (p == NULL) return false;
+        buf[i] = (char)*p;
+        if (*p == 0) return true;
+    }
+    if (size > 0) buf[size - 1] = '\0';
+    return true;
+}
+
+//=============================================================================
+// ALU HELPERS
+//=============================================================================
+static void Set_NZ(M0Sim_t *sim, uint32_t result) {
+    sim->n = (result >> 31) != 0;
+    sim->z = result == 0;
+}
+
+// a + b + carry_in, optionally setting NZCV (ADDS, ADCS, SUBS, SBCS, CMP...)
+static uint32_t Add_With_Carry(M0Sim_t *sim, uint32_t a, uint32_t b,
+                               uint32_t carry_in, bool set_flags) {
+    uint64_t wide = (uint64_t)a + b + carry_in;
+    uint32_t result = (uint32_t)wide;
+    if (set_flags) {
+        Set_NZ(sim, result);
+        sim->c = (wide >> 32) != 0;
+        sim->v = ((~(a ^ b) & (a ^ result)) >> 31) != 0;
+    }
+    return result;
+}
+
+static bool Condition_Passed(const M0Sim_t *sim, uint32_t cond) {
+    switch (cond) {
+        case 0x0: return sim->z;                       // EQ
+        case 0x1: return !sim->z;                      // NE
+        case 0x2: return sim->c;                       // CS
+        case 0x3: return !sim->c;                      // CC
+        case 0x4: return sim->n;                       // MI
+        case 0x5: return !sim->n;                      // PL
+        case 0x6: return sim->v;                       // VS
+        case 0x7: return !sim->v;                      // VC
+        case 0x8: return sim->c && !sim->z;            // HI
+        case 0x9: return !sim->c || sim->z;            // LS
+        case 0xA: return sim->n == sim->v;             // GE
+        case 0xB: return sim->n != sim->v;             // LT
+        case 0xC: return !sim->z && sim->n == sim->v;  // GT
+        case 0xD: return sim->z || sim->n != sim->v;   // LE
+        default:  return true;
+    }
+}
+
+// Shift types (same encoding as the instruction opcodes)
+enum { SHIFT_LSL = 0, SHIFT_LSR, SHIFT_ASR, SHIFT_ROR };
+
+// Shift with carry out; amount 0 leaves the value and carry unchanged
+static uint32_t Shift_C(M0Sim_t *sim, uint32_t value, int type, uint32_t amount) {
+    if (amount == 0) return value;
+    switch (type) {
+        case SHIFT_LSL:
+            if (amount < 32) {
+                sim->c = (value >> (32 - amount)) & 1;
+                return value << amount;
+            }
+            sim->c = amount == 32 ? (value & 1) : 0;
+            return 0;
+        case SHIFT_LSR:
+            if (amount < 32) {
+                sim->c = (value >> (amount - 1)) & 1;
+                return value >> amount;
+            }
+            sim->c = amount == 32 ? (value >> 31) : 0;
+            return 0;
+        case SHIFT_ASR:
+            if (amount < 32) {
+                sim->c = (value >> (amount - 1)) & 1;
+                return (uint32_t)((int32_t)value >> amount);
+            }
+            sim->c = value >> 31;
+            return (uint32_t)((int32_t)value >> 31);
+        default: {
+            uint32_t rot = amount & 31;
+            uint32_t result = rot ? (value >> rot) | (value << (32 - rot)) : value;
+            sim->c = result >> 31;
+            return result;
+        }
+    }
+}
+
+//=============================================================================
+// CONTROL FLOW
+//=============================================================================
+
+// Branch target: refetch (wait states) and stop at the return magic
+static void Branch_To(M0Sim_t *sim, uint32_t addr) {
+    sim->r[PC] = addr & ~1u;
+    sim->fetch_word = 1;       // Never a word address: forces a new fetch
+}
+
+// BX/BLX/POP {pc}: only Thumb state exists on the M0+
+static bool Interworking_Branch(M0Sim_t *sim, uint32_t addr) {
+    if ((addr & 1) == 0)
+        return Sim_Stop(sim, "branch to ARM state 0x%08x (pc 0x%08x)", addr,
+                        sim->insn_pc);
+    Branch_To(sim, addr);
+    return true;
+}
+
+//=============================================================================
+// EXECUTE
+//=============================================================================
+
+// 0100 00: data processing on low registers
+static bool Exec_Data_Processing(M0Sim_t *sim, uint16_t op) {
+    uint32_t rd = op & 7;
+    uint32_t rm = (op >> 3) & 7;
+    uint32_t a = sim->r[rd];
+    uint32_t b = sim->r[rm];
+    uint32_t result;
+
+    switch ((op >> 6) & 0xF) {
+        case 0x0: result = a & b; break;                              // ANDS
+        case 0x1: result = a ^ b; break;                              // EORS
+        case 0x2: result = Shift_C(sim, a, SHIFT_LSL, b & 0xFF); break;
+        case 0x3: result = Shift_C(sim, a, SHIFT_LSR, b & 0xFF); break;
+        case 0x4: result = Shift_C(sim, a, SHIFT_ASR, b & 0xFF); break;
+        case 0x5: sim->r[rd] = Add_With_Carry(sim, a, b, sim->c, true); return true;
+        case 0x6: sim->r[rd] = Add_With_Carry(sim, a, ~b, sim->c, true); return true;
+        case 0x7: result = Shift_C(sim, a, SHIFT_ROR, b & 0xFF); break;
+        case 0x8: Set_NZ(sim, a & b); return true;                    // TST
+        case 0x9: sim->r[rd] = Add_With_Carry(sim, ~b, 0, 1, true); return true; // RSBS #0
+        case 0xA: Add_With_Carry(sim, a, ~b, 1, true); return true;   // CMP
+        case 0xB: Add_With_Carry(sim, a, b, 0, true); return true;    // CMN
+        case 0xC: result = a | b; break;                              // ORRS
+        case 0xD:                                                     // MULS
+            result = a * b;
+            sim->cycles += sim->mul_cycles - 1u;
+            break;
+        case 0xE: result = a & ~b; break;                             // BICS
+        default:  result = ~b; break;                                 // MVNS
+    }
+    sim->r[rd] = result;
+    Set_NZ(sim, result);
+    return true;
+}
+
+// 0100 01: high register ADD/CMP/MOV and BX/BLX
+static bool Exec_Special(M0Sim_t *sim, uint16_t op, uint32_t pc_read) {
+    uint32_t rdn = (op & 7) | ((op >> 4) & 8);
+    uint32_t rm = (op >> 3) & 0xF;
+    uint32_t b = rm == PC ? pc_read : sim->r[rm];
+    uint32_t a = rdn == PC ? pc_read : sim->r[rdn];
+
+    switch ((op >> 8) & 3) {
+        case 0:                                                       // ADD
+            if (rdn == PC) {
+                Branch_To(sim, a + b);
+                sim->cycles++;
+            } else {
+                sim->r[rdn] = a + b;
+            }
+            return true;
+        case 1:                                                       // CMP
+            Add_With_Carry(sim, a, ~b, 1, true);
+            return true;
+        case 2:                                                       // MOV
+            if (rdn == PC) {
+                Branch_To(sim, b);
+                sim->cycles++;
+            } else {
+                sim->r[rdn] = b;
+            }
+            return true;
+        default:                                                      // BX/BLX
+            if (op & 0x80) sim->r[LR] = sim->r[PC] | 1;   // Next instruction
+            sim->cycles++;
+            return Interworking_Branch(sim, b);
+    }
+}
+
+// 0101: load/store with register offset
+static bool Exec_Load_Store_Reg(M0Sim_t *sim, uint16_t op) {
+    uint32_t rt = op & 7;
+    uint32_t addr = sim->r[(op >> 3) & 7] + sim->r[(op >> 6) & 7];
+    uint32_t value;
+
+    sim->cycles++;
+    switch ((op >> 9) & 7) {
+        case 0: return Sim_Store(sim, addr, 4, sim->r[rt]);           // STR
+        case 1: return Sim_Store(sim, addr, 2, sim->r[rt]);           // STRH
+        case 2: return Sim_Store(sim, addr, 1, sim->r[rt]);           // STRB
+        case 3:                                                       // LDRSB
+            if (!Sim_Load(sim, addr, 1, &value)) return false;
+            sim->r[rt] = (uint32_t)(int32_t)(int8_t)value;
+            return true;
+        case 4: return Sim_Load(sim, addr, 4, &sim->r[rt]);           // LDR
+        case 5: return Sim_Load(sim, addr, 2, &sim->r[rt]);           // LDRH
+        case 6: return Sim_Load(sim, addr, 1, &sim->r[rt]);           // LDRB
+        default:                                                      // LDRSH
+            if (!Sim_Load(sim, addr, 2, &value)) return false;
+            sim->r[rt] = (uint32_t)(int32_t)(int16_t)value;
+            return true;
+    }
+}
+
+// 1011: miscellaneous 16-bit instructions
+static bool Exec_Misc(M0Sim_t *sim, uint16_t op) {
+    uint32_t rd = op & 7;
+    uint32_t rm = (op >> 3) & 7;
+    uint32_t v = sim->r[rm];
+
+    switch ((op >> 8) & 0xF) {
+        case 0x0:                                                     // ADD/SUB SP
+            if (op & 0x80) sim->r[SP] -= (op & 0x7F) * 4u;
+            else sim->r[SP] += (op & 0x7F) * 4u;
+            return true;
+        case 0x2:                                                     // extend
+            switch ((op >> 6) & 3) {
+                case 0: sim->r[rd] = (uint32_t)(int32_t)(int16_t)v; break;
+                case 1: sim->r[rd] = (uint32_t)(int32_t)(int8_t)v; break;
+                case 2: sim->r[rd] = v & 0xFFFF; break;
+                default: sim->r[rd] = v & 0xFF; break;
+            }
+            return true;
+        case 0x4: case 0x5: {                                         // PUSH
+            uint32_t list = (op & 0xFF) | ((op & 0x100) ? 1u << LR : 0);
+            uint32_t count = (uint32_t)__builtin_popcount(list);
+            uint32_t addr = sim->r[SP] - 4 * count;
+            sim->r[SP] = addr;
+            for (uint32_t i = 0; i < 16; i++) {
+                if (!(list & (1u << i))) continue;
+                if (!Sim_Store(sim, addr, 4, sim->r[i])) return false;
+                addr += 4;
+            }
+            sim->cycles += count;
+            return true;
+        }
+        case 0x6:                                                     // CPS
+            if ((op & 0xFFEF) != 0xB662) break;
+            sim->primask = (op & 0x10) != 0;
+            return true;
+        case 0xA:                                                     // REV*
+            switch ((op >> 6) & 3) {
+                case 0: sim->r[rd] = __builtin_bswap32(v); return true;
+                case 1:
+                    sim->r[rd] = ((v & 0x00FF00FF) << 8) | ((v >> 8) & 0x00FF00FF);
+                    return true;
+                case 3:
+                    sim->r[rd] = (uint32_t)(int32_t)(int16_t)(((v & 0xFF) << 8) |
+                                                              ((v >> 8) & 0xFF));
+                    return true;
+                default: break;
+            }
+            break;
+        case 0xC: case 0xD: {                                         // POP
+            uint32_t list = (op & 0xFF) | ((op & 0x100) ? 1u << PC : 0);
+            uint32_t count = (uint32_t)__builtin_popcount(list);
+            uint32_t addr = sim->r[SP];
+            uint32_t new_pc = 0;
+            for (uint32_t i = 0; i < 16; i++) {
+                if (!(list & (1u << i))) continue;
+                uint32_t value;
+                if (!Sim_Load(sim, addr, 4, &value)) return false;
+                if (i == PC) new_pc = value;
+                else sim->r[i] = value;
+                addr += 4;
+            }
+            sim->r[SP] = addr;
+            sim->cycles += count;
+            if (list & (1u << PC)) {
+                sim->cycles += 2;
+                return Interworking_Branch(sim, new_pc);
+            }
+            return true;
+        }
+        case 0xE:                                                     // BKPT
+            Sim_Stop(sim, "bkpt #%u at 0x%08x", op & 0xFFu, sim->insn_pc);
+            sim->status = M0SIM_BREAKPOINT;
+            return false;
+        case 0xF:                                                     // hints
+            if ((op & 0xF) == 0 && (op & 0xF0) <= 0x40) return true;
+            break;
+        default: break;
+    }
+    return Sim_Stop(sim, "undefined instruction 0x%04x at 0x%08x", op, sim->insn_pc);
+}
+
+// 32-bit instructions: BL, MRS, MSR, barriers
+static bool Exec_32(M0Sim_t *sim, uint16_t hw1, uint16_t hw2, uint32_t pc) {
+    if ((hw2 & 0xD000) == 0xD000) {                                   // BL
+        uint32_t s = (hw1 >> 10) & 1;
+        uint32_t i1 = !(((hw2 >> 13) & 1) ^ s);
+        uint32_t i2 = !(((hw2 >> 11) & 1) ^ s);
+        uint32_t imm = (s << 24) | (i1 << 23) | (i2 << 22) |
+                       ((hw1 & 0x3FFu) << 12) | ((hw2 & 0x7FFu) << 1);
+        if (s) imm |= 0xFE000000u;
+        sim->r[LR] = (pc + 4) | 1;
+        Branch_To(sim, pc + 4 + imm);
+        sim->cycles += 2;
+        return true;
+    }
+    if ((hw2 & 0xC000) == 0x8000) {
+        if ((hw1 & 0xFFF0) == 0xF380 && (hw2 & 0xFF00) == 0x8800) {   // MSR
+            uint32_t value = sim->r[hw1 & 0xF];
+            uint32_t sysm = hw2 & 0xFF;
+            if (sysm < 8) {
+                sim->n = (value >> 31) & 1;
+                sim->z = (value >> 30) & 1;
+                sim->c = (value >> 29) & 1;
+                sim->v = (value >> 28) & 1;
+            } else if (sysm == 16) {
+                sim->primask = value & 1;
+            }
+            sim->cycles += 2;
+            return true;
+        }
+        if (hw1 == 0xF3EF && (hw2 & 0xF000) == 0x8000) {              // MRS
+            uint32_t sysm = hw2 & 0xFF;
+            uint32_t value = 0;
+            if (sysm < 8)
+                value = (uint32_t)sim->n << 31 | (uint32_t)sim->z << 30 |
+                        (uint32_t)sim->c << 29 | (uint32_t)sim->v << 28;
+            else if (sysm == 8 || sysm == 9)
+                value = sim->r[SP];
+            else if (sysm == 16)
+                value = sim->primask;
+            sim->r[(hw2 >> 8) & 0xF] = value;
+            sim->cycles += 2;
+            return true;
+        }
+        if (hw1 == 0xF3BF && (hw2 & 0xFFC0) == 0x8F40) {              // DSB/DMB/ISB
+            sim->cycles += 2;
+            return true;
+        }
+    }
+    return Sim_Stop(sim, "undefined instruction 0x%04x%04x at 0x%08x", hw1,
+                    hw2, pc);
+}
+
+// One instruction; false = stop (message set)
+static bool Sim_Step(M0Sim_t *sim) {
+    uint32_t pc = sim->r[PC];
+    const uint8_t *p = Sim_Map(sim, pc, 2);
+    if (p == NULL || (pc & 1))
+        return Sim_Stop(sim, "fetch fault at 0x%08x", pc);
+
+    // Wait states: one per new 32-bit fetch from flash
+    if (Is_Flash(pc) && (pc & ~3u) != sim->fetch_word) {
+        sim->fetch_word = pc & ~3u;
+        sim->cycles += sim->flash_wait;
+    }
+
+    uint16_t op = Get16(p);
+    sim->insn_pc = pc;
+    uint32_t pc_read = pc + 4;             // PC as an operand
+    sim->r[PC] = pc + 2;
+    sim->cycles++;
+    sim->instructions++;
+
+    switch (op >> 11) {
+        case 0x00: case 0x01: case 0x02: {                            // shift imm
+            uint32_t rd = op & 7;
+            uint32_t value = sim->r[(op >> 3) & 7];
+            uint32_t imm = (op >> 6) & 0x1F;
+            int type = op >> 11;
+            if (type != SHIFT_LSL && imm == 0) imm = 32;
+            sim->r[rd] = Shift_C(sim, value, type, imm);
+            Set_NZ(sim, sim->r[rd]);
+            return true;
+        }
+        case 0x03: {                                                  // ADDS/SUBS
+            uint32_t rd = op & 7;
+            uint32_t a = sim->r[(op >> 3) & 7];
+            uint32_t b = (op & 0x400) ? (op >> 6) & 7u : sim->r[(op >> 6) & 7];
+            sim->r[rd] = (op & 0x200) ? Add_With_Carry(sim, a, ~b, 1, true)
+                                      : Add_With_Carry(sim, a, b, 0, true);
+            return true;
+        }
+        case 0x04:                                                    // MOVS imm
+            sim->r[(op >> 8) & 7] = op & 0xFF;
+            Set_NZ(sim, op & 0xFF);
+            return true;
+        case 0x05:                                                    // CMP imm
+            Add_With_Carry(sim, sim->r[(op >> 8) & 7], ~(uint32_t)(op & 0xFF), 1, true);
+            return true;
+        case 0x06: {                                                  // ADDS imm8
+            uint32_t rd = (op >> 8) & 7;
+            sim->r[rd] = Add_With_Carry(sim, sim->r[rd], op & 0xFF, 0, true);
+            return true;
+        }
+        case 0x07: {                                                  // SUBS imm8
+            uint32_t rd = (op >> 8) & 7;
+            sim->r[rd] = Add_With_Carry(sim, sim->r[rd], ~(uint32_t)(op & 0xFF), 1, true);
+            return true;
+        }
+        case 0x08:
+            if (op & 0x0400) return Exec_Special(sim, op, pc_read);
+            return Exec_Data_Processing(sim, op);
+        case 0x09:                                                    // LDR literal
+            sim->cycles++;
+            return Sim_Load(sim, (pc_read & ~3u) + (op & 0xFFu) * 4,
+                            4, &sim->r[(op >> 8) & 7]);
+        case 0x0A: case 0x0B:
+            return Exec_Load_Store_Reg(sim, op);
+        case 0x0C: case 0x0D: case 0x0E: case 0x0F: {                 // LDR/STR(B) imm
+            uint32_t rt = op & 7;
+            bool byte = (op & 0x1000) != 0;
+            uint32_t imm = ((op >> 6) & 0x1F) * (byte ? 1u : 4u);
+            uint32_t addr = sim->r[(op >> 3) & 7] + imm;
+            sim->cycles++;
+            if (op & 0x0800) return Sim_Load(sim, addr, byte ? 1 : 4, &sim->r[rt]);
+            return Sim_Store(sim, addr, byte ? 1 : 4, sim->r[rt]);
+        }
+        case 0x10: case 0x11: {                                       // LDRH/STRH imm
+            uint32_t rt = op & 7;
+            uint32_t addr = sim->r[(op >> 3) & 7] + ((op >> 6) & 0x1F) * 2u;
+            sim->cycles++;
+            if (op & 0x0800) return Sim_Load(sim, addr, 2, &sim->r[rt]);
+            return Sim_Store(sim, addr, 2, sim->r[rt]);
+        }
+        case 0x12: case 0x13: {                                       // LDR/STR SP
+            uint32_t rt = (op >> 8) & 7;
+            uint32_t addr = sim->r[SP] + (op & 0xFFu) * 4;
+            sim->cycles++;
+            if (op & 0x0800) return Sim_Load(sim, addr, 4, &sim->r[rt]);
+            return Sim_Store(sim, addr, 4, sim->r[rt]);
+        }
+        case 0x14:                                                    // ADR
+            sim->r[(op >> 8) & 7] = (pc_read & ~3u) + (op & 0xFFu) * 4;
+            return true;
+        case 0x15:                                                    // ADD rd, SP
+            sim->r[(op >> 8) & 7] = sim->r[SP] + (op & 0xFFu) * 4;
+            return true;
+        case 0x16: case 0x17:
+            return Exec_Misc(sim, op);
+        case 0x18: case 0x19: {                                       // STM/LDM
+            uint32_t rn = (op >> 8) & 7;
+            uint32_t list = op & 0xFF;
+            uint32_t addr = sim->r[rn];
+            bool load = (op & 0x0800) != 0;
+            if (list == 0) break;
+            for (uint32_t i = 0; i < 8; i++) {
+                if (!(list & (1u << i))) continue;
+                bool ok = load ? Sim_Load(sim, addr, 4, &sim->r[i])
+                               : Sim_Store(sim, addr, 4, sim->r[i]);
+                if (!ok) return false;
+                addr += 4;
+            }
+            // LDM with the base in the list loads it instead of writing back
+            if (!load || !(list & (1u << rn))) sim->r[rn] = addr;
+            sim->cycles += (uint32_t)__builtin_popcount(list);
+            return true;
+        }
+        case 0x1A: case 0x1B: {                                       // Bcc/UDF/SVC
+            uint32_t cond = (op >> 8) & 0xF;
+            if (cond == 0xE) break;
+            if (cond == 0xF) {
+                Sim_Stop(sim, "svc #%u at 0x%08x", op & 0xFFu, pc);
+                sim->status = M0SIM_BREAKPOINT;
+                return false;
+            }
+            if (Condition_Passed(sim, cond)) {
+                Branch_To(sim, pc_read + (uint32_t)((int32_t)(int8_t)(op & 0xFF) * 2));
+                sim->cycles++;
+            }
+            return true;
+        }
+        case 0x1C: {                                                  // B
+            int32_t imm = (int32_t)((uint32_t)(op & 0x7FF) << 21) >> 20;
+            Branch_To(sim, pc_read + (uint32_t)imm);
+            sim->cycles++;
+            return true;
+        }
+        case 0x1E: case 0x1F: {                                       // 32-bit
+            if ((op >> 11) == 0x1F) break;
+            const uint8_t *p2 = Sim_Map(sim, pc + 2, 2);
+            if (p2 == NULL) return Sim_Stop(sim, "fetch fault at 0x%08x", pc + 2);
+            if (Is_Flash(pc + 2) && ((pc + 2) & ~3u) != sim->fetch_word) {
+                sim->fetch_word = (pc + 2) & ~3u;
+                sim->cycles += sim->flash_wait;
+            }
+            sim->r[PC] = pc + 4;
+            return Exec_32(sim, op, Get16(p2), pc);
+        }
+        default: break;
+    }
+    return Sim_Stop(sim, "undefined instruction 0x%04x at 0x%08x", op, pc);
+}
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+bool M0Sim_Init(M0Sim_t *sim) {
+    memset(sim, 0, sizeof(*sim));
+    sim->flash = calloc(1, M0SIM_FLASH_SIZE);
+    sim->sram = calloc(1, M0SIM_SRAM_SIZE);
+    sim->mul_cycles = 1;
+    sim->fetch_word = 1;
+    if (sim->flash == NULL || sim->sram == NULL) {
+        M0Sim_Free(sim);
+        return false;
+    }
+    return true;
+}
+
+void M0Sim_Free(M0Sim_t *sim) {
+    free(sim->flash);
+    free(sim->sram);
+    free(sim->symtab);
+    free(sim->strtab);
+    sim->flash = sim->sram = sim->symtab = NULL;
+    sim->strtab = NULL;
+}
+
+bool M0Sim_LoadElf(M0Sim_t *sim, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) return Sim_Stop(sim, "%s: cannot open", path);
+    fseek(f, 0, SEEK_END);
+    long length = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    uint8_t *elf = length > 52 ? malloc((size_t)length) : NULL;
+    bool read_ok = elf && fread(elf, 1, (size_t)length, f) == (size_t)length;
+    fclose(f);
+    if (!read_ok) {
+        free(elf);
+        return Sim_Stop(sim, "%s: cannot read", path);
+    }
+
+    size_t size = (size_t)length;
+    bool ok = false;
+    if (memcmp(elf, "\x7f" "ELF\x01\x01", 6) != 0 || Get16(elf + 18) != EM_ARM) {
+        Sim_Stop(sim, "%s: not a little-endian ARM ELF32 file", path);
+        goto done;
+    }
+
+    uint32_t phoff = Get32(elf + 28);
+    uint32_t shoff = Get32(elf + 32);
+    uint16_t phentsize = Get16(elf + 42), phnum = Get16(elf + 44);
+    uint16_t shentsize = Get16(elf + 46), shnum = Get16(elf + 48);
+
+    // Segments, at their run addresses
+    for (uint32_t i = 0; i < phnum; i++) {
+        const uint8_t *ph = elf + phoff + i * phentsize;
+        if (phoff + (i + 1) * phentsize > size) break;
+        if (Get32(ph) != PT_LOAD) continue;
+        uint32_t offset = Get32(ph + 4), vaddr = Get32(ph + 8);
+        uint32_t filesz = Get32(ph + 16), memsz = Get32(ph + 20);
+        if (memsz == 0) continue;
+        uint8_t *dst = Sim_Map(sim, vaddr, memsz);
+        if (dst == NULL || filesz > memsz || offset + filesz > size) {
+            Sim_Stop(sim, "%s: segment 0x%08x+%u outside flash/SRAM", path,
+                     vaddr, memsz);
+            goto done;
+        }
+        memcpy(dst, elf + offset, filesz);
+        memset(dst + filesz, 0, memsz - filesz);
+    }
+
+    // Symbol table and its string table
+    for (uint32_t i = 0; i < shnum; i++) {
+        const uint8_t *sh = elf + shoff + i * shentsize;
+        if (shoff + (i + 1) * shentsize > size) break;
+        if (Get32(sh + 4) != SHT_SYMTAB) continue;
+        uint32_t link = Get32(sh + 24);
+        const uint8_t *str = elf + shoff + link * shentsize;
+        uint32_t sym_off = Get32(sh + 16), sym_size = Get32(sh + 20);
+        uint32_t str_off = Get32(str + 16), str_size = Get32(str + 20);
+        if (link >= shnum || sym_off + sym_size > size || str_off + str_size > size)
+            break;
+        free(sim->symtab);
+        free(sim->strtab);
+        sim->symtab = malloc(sym_size);
+        sim->strtab = malloc(str_size + 1);
+        if (sim->symtab == NULL || sim->strtab == NULL) break;
+        memcpy(sim->symtab, elf + sym_off, sym_size);
+        memcpy(sim->strtab, elf + str_off, str_size);
+        sim->strtab[str_size] = '\0';
+        sim->symtab_size = sym_size;
+        sim->strtab_size = str_size;
+        break;
+    }
+    ok = true;
+
+done:
+    free(elf);
+    return ok;
+}
+
+uint32_t M0Sim_Symbol(const M0Sim_t *sim, const char *name, uint32_t *size) {
+    for (size_t off = 0; off + 16 <= sim->symtab_size; off += 16) {
+        const uint8_t *sym = sim->symtab + off;
+        uint32_t name_off = Get32(sym);
+        if (name_off >= sim->strtab_size) continue;
+        if (strcmp(sim->strtab + name_off, name) != 0) continue;
+        if (Get16(sym + 14) == 0) continue;        // Undefined
+        if (size) *size = Get32(sym + 8);
+        return Get32(sym + 4);
+    }
+    return 0;
+}
+
+M0SimStop_t M0Sim_Call(M0Sim_t *sim, uint32_t func, const uint32_t *args,
+                       unsigned nargs, uint64_t max_instructions) {
+    if (max_instructions == 0) max_instructions = M0SIM_MAX_INSTRUCTIONS;
+    for (unsigned i = 0; i < 4; i++) sim->r[i] = i < nargs ? args[i] : 0;
+    sim->r[SP] = M0SIM_SRAM_BASE + M0SIM_SRAM_SIZE;
+    sim->r[LR] = RETURN_MAGIC | 1;
+    Branch_To(sim, func);
+    sim->status = M0SIM_RETURNED;
+    sim->message[0] = '\0';
+
+    uint64_t limit = sim->instructions + max_instructions;
+    while (sim->r[PC] != RETURN_MAGIC) {
+        if (sim->instructions >= limit) {
+            snprintf(sim->message, sizeof(sim->message),
+                     "instruction limit reached (pc 0x%08x)", sim->r[PC]);
+            sim->status = M0SIM_LIMIT;
+            break;
+        }
+        if (!Sim_Step(sim)) break;
+    }
+    return sim->status;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file m0sim.h
+ * @brief Cortex-M0+ Instruction-Set Simulator (Linux host)
+ * @version 1.0.0
+ *
+ * Runs ARMv6-M (Thumb-1) code with cycle accounting from the Cortex-M0+
+ * timing tables, so kernels built for the MSPM0G3507 can be measured on
+ * a PC. Only the core is modelled: flash and SRAM at the MSPM0G3507
+ * addresses, no peripherals, no exceptions. Anything outside that
+ * (unmapped or unaligned access, UDF, SVC, BKPT) stops the run.
+ *
+ * Cycle model (Cortex-M0+ TRM, zero wait state memory):
+ *   data processing 1, MULS 1 (fast multiplier) or 32 (small), LDR/STR 2,
+ *   LDM/STM/PUSH/POP 1+N, POP {..,pc} 3+N, B 2, Bcc 2 taken / 1 not,
+ *   BL 3, BX/BLX 2, ADD/MOV to pc 2, MRS/MSR/DMB/DSB/ISB 3
+ * flash_wait adds wait states to every new 32-bit flash fetch (after a
+ * branch or when crossing a word) and to every data load from flash.
+ *
+ * Usage:
+ *   M0Sim_t sim;
+ *   M0Sim_Init(&sim);
+ *   if (!M0Sim_LoadElf(&sim, "kernels.elf")) ...
+ *   uint32_t fn = M0Sim_Symbol(&sim, "Bench_WaveSine", NULL);
+ *   uint32_t arg = 1000;
+ *   if (M0Sim_Call(&sim, fn, &arg, 1, 0) != M0SIM_RETURNED)
+ *       puts(sim.message);
+ *   printf("%llu cycles, r0 = %u\n", sim.cycles, sim.r[0]);
+ *   M0Sim_Free(&sim);
+ */
+
+#ifndef M0SIM_H
+#define M0SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define M0SIM_FLASH_BASE   0x00000000u
+#define M0SIM_FLASH_SIZE   0x00020000u     // 128 KB
+#define M0SIM_SRAM_BASE    0x20200000u
+#define M0SIM_SRAM_SIZE    0x00008000u     // 32 KB
+
+// Default instruction limit for M0Sim_Call (catches runaway code)
+#define M0SIM_MAX_INSTRUCTIONS 2000000000ull
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef enum {
+    M0SIM_RETURNED = 0,    ///< Function returned to the caller
+    M0SIM_FAULT,           ///< Bad access or undefined instruction
+    M0SIM_BREAKPOINT,      ///< BKPT or SVC
+    M0SIM_LIMIT            ///< Instruction limit reached
+} M0SimStop_t;
+
+typedef struct {
+    uint32_t r[16];            ///< r13 = SP, r14 = LR, r15 = PC
+    bool n, z, c, v;           ///< APSR flags
+    bool primask;
+
+    uint8_t *flash;
+    uint8_t *sram;
+
+    uint64_t cycles;           ///< Since M0Sim_Init (callers take differences)
+    uint64_t instructions;
+    uint8_t flash_wait;        ///< Wait states per flash access (default 0)
+    uint8_t mul_cycles;        ///< 1 = fast multiplier (default), 32 = small
+    uint32_t fetch_word;       ///< Last fetched flash word (wait-state model)
+
+    M0SimStop_t status;        ///< Why the last run stopped
+    char message[128];         ///< ... in words
+    uint32_t insn_pc;          ///< Address of the current instruction
+
+    // ELF symbol table (kept after loading)
+    uint8_t *symtab;
+    size_t symtab_size;
+    char *strtab;
+    size_t strtab_size;
+} M0Sim_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Allocate the memories and reset the core
+ * @return false if out of memory
+ */
+bool M0Sim_Init(M0Sim_t *sim);
+
+void M0Sim_Free(M0Sim_t *sim);
+
+/**
+ * @brief Load the PT_LOAD segments of an ARM ELF32 executable
+ *
+ * Segments go to their run addresses (.data is loaded already initialized,
+ * .bss is zeroed), so no startup code is needed.
+ *
+ * @return false with sim->message set on error
+ */
+bool M0Sim_LoadElf(M0Sim_t *sim, const char *path);
+
+/**
+ * @brief Look up a symbol of the loaded ELF
+ * @param size Symbol size in bytes (may be NULL)
+ * @return Address (functions have the Thumb bit set), 0 if not found
+ */
+uint32_t M0Sim_Symbol(const M0Sim_t *sim, const char *name, uint32_t *size);
+
+/**
+ * @brief Call a function with up to 4 arguments (AAPCS) and run until it
+ *        returns
+ *
+ * The stack starts at the top of SRAM. The result is in sim->r[0];
+ * sim->cycles and sim->instructions keep counting across calls.
+ *
+ * @param max_instructions 0 = M0SIM_MAX_INSTRUCTIONS
+ */
+M0SimStop_t M0Sim_Call(M0Sim_t *sim, uint32_t func, const uint32_t *args,
+                       unsigned nargs, uint64_t max_instructions);
+
+/**
+ * @brief Read target memory (returns false if unmapped or unaligned)
+ */
+bool M0Sim_Read32(const M0Sim_t *sim, uint32_t addr, uint32_t *value);
+
+/**
+ * @brief Copy a NUL-terminated string out of target memory
+ */
+bool M0Sim_ReadString(const M0Sim_t *sim, uint32_t addr, char *buf, size_t size);
+
+#endif /* M0SIM_H */
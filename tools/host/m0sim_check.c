@@ -0,0 +1,337 @@
+/**
+ * @file m0sim_check.c
+ * @brief Instruction Checks for the Cortex-M0+ Simulator (Linux host)
+ * @version 1.0.0
+ *
+ * Runs 16 short Thumb functions in m0sim and checks r0, the stop reason
+ * and, where counted by hand, the cycles:
+ *
+ *   add64 sub64    ADCS/SBCS carry chains
+ *   shift          LSL/LSR/ASR/ROR by register and by 32, shifted-out carry
+ *   mul            MULS with a negative operand
+ *   loop call      taken/not-taken Bcc, BL, PUSH and POP {pc} (cycles too)
+ *   mem            byte/half/word loads and stores, sign extension, LDM/STM
+ *   ext            SXTB/SXTH/UXTB/UXTH, REV/REV16/REVSH
+ *   cond           signed and unsigned conditions, CMN, overflow
+ *   jump logic     ADD pc, BICS/MVNS/RSBS/TST/ORRS
+ *   misc           ADR, BLX, ADD rd, sp, MRS/MSR, CPSID/CPSIE, barriers
+ *   hireg          MOV/ADD/CMP on r8-r15
+ *   unaligned bkpt flashwrite   must stop the run, not return
+ *
+ * The image below is llvm-mc output (-triple=thumbv6m-none-eabi), kept as
+ * halfwords so the check needs no ARM toolchain. Each function is word
+ * aligned with its own literal pool; the comments are llvm-objdump's.
+ * It is loaded at the start of flash and called like a kernel.
+ *
+ * Exit status 1 on any failure.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./m0sim_check
+ */
+
+#include "m0sim.h"
+#include <stdio.h>
+
+//=============================================================================
+// TEST IMAGE
+//=============================================================================
+static const uint16_t IMAGE[] = {
+    // t_add64
+    0x2000,        // 000  movs r0, #0
+    0x43c0,        // 002  mvns r0, r0
+    0x2100,        // 004  movs r1, #0
+    0x43c9,        // 006  mvns r1, r1
+    0x2201,        // 008  movs r2, #1
+    0x2300,        // 00a  movs r3, #0
+    0x1880,        // 00c  adds r0, r0, r2
+    0x4159,        // 00e  adcs r1, r3
+    0x2200,        // 010  movs r2, #0
+    0x4152,        // 012  adcs r2, r2
+    0x0112,        // 014  lsls r2, r2, #4
+    0x1888,        // 016  adds r0, r1, r2
+    0x4770,        // 018  bx lr
+    0x46c0,        // 01a  (pad)
+    // t_sub64
+    0x2000,        // 01c  movs r0, #0
+    0x2101,        // 01e  movs r1, #1
+    0x2201,        // 020  movs r2, #1
+    0x2300,        // 022  movs r3, #0
+    0x1a80,        // 024  subs r0, r0, r2
+    0x4199,        // 026  sbcs r1, r3
+    0x4048,        // 028  eors r0, r1
+    0x4770,        // 02a  bx lr
+    // t_shift
+    0x2003,        // 02c  movs r0, #3
+    0x2120,        // 02e  movs r1, #32
+    0x4088,        // 030  lsls r0, r1
+    0x2200,        // 032  movs r2, #0
+    0x4152,        // 034  adcs r2, r2
+    0x2301,        // 036  movs r3, #1
+    0x07db,        // 038  lsls r3, r3, #31
+    0x2128,        // 03a  movs r1, #40
+    0x410b,        // 03c  asrs r3, r1
+    0x18d0,        // 03e  adds r0, r2, r3
+    0x2101,        // 040  movs r1, #1
+    0x07c9,        // 042  lsls r1, r1, #31
+    0x0809,        // 044  lsrs r1, r1, #32
+    0x4148,        // 046  adcs r0, r1
+    0x2181,        // 048  movs r1, #129
+    0x2204,        // 04a  movs r2, #4
+    0x41d1,        // 04c  rors r1, r2
+    0x1840,        // 04e  adds r0, r0, r1
+    0x4770,        // 050  bx lr
+    0x46c0,        // 052  (pad)
+    // t_mul
+    0x4801,        // 054  ldr r0, [pc, #4]
+    0x4902,        // 056  ldr r1, [pc, #8]
+    0x4348,        // 058  muls r0, r1, r0
+    0x4770,        // 05a  bx lr
+    0xe240, 0x0001,// 05c  .word 0x0001e240
+    0xfceb, 0xffff,// 060  .word 0xfffffceb
+    // t_loop
+    0x200a,        // 064  movs r0, #10
+    0x3801,        // 066  subs r0, #1
+    0xd1fd,        // 068  bne t_loop+0x2
+    0x4770,        // 06a  bx lr
+    // t_call
+    0xb510,        // 06c  push {r4, lr}
+    0x2403,        // 06e  movs r4, #3
+    0xf000, 0xf802,// 070  bl helper
+    0x1900,        // 074  adds r0, r0, r4
+    0xbd10,        // 076  pop {r4, pc}
+    // helper
+    0x2004,        // 078  movs r0, #4
+    0x4770,        // 07a  bx lr
+    // t_mem
+    0xb5f0,        // 07c  push {r4, r5, r6, r7, lr}
+    0xb084,        // 07e  sub sp, #16
+    0x490d,        // 080  ldr r1, [pc, #52]
+    0x466a,        // 082  mov r2, sp
+    0x6011,        // 084  str r1, [r2]
+    0x8091,        // 086  strh r1, [r2, #4]
+    0x7191,        // 088  strb r1, [r2, #6]
+    0x2304,        // 08a  movs r3, #4
+    0x5ed4,        // 08c  ldrsh r4, [r2, r3]
+    0x2306,        // 08e  movs r3, #6
+    0x56d5,        // 090  ldrsb r5, [r2, r3]
+    0x8896,        // 092  ldrh r6, [r2, #4]
+    0x7857,        // 094  ldrb r7, [r2, #1]
+    0x1960,        // 096  adds r0, r4, r5
+    0x1980,        // 098  adds r0, r0, r6
+    0x19c0,        // 09a  adds r0, r0, r7
+    0x2401,        // 09c  movs r4, #1
+    0x2502,        // 09e  movs r5, #2
+    0x2603,        // 0a0  movs r6, #3
+    0x466b,        // 0a2  mov r3, sp
+    0xc370,        // 0a4  stm r3!, {r4, r5, r6}
+    0x4669,        // 0a6  mov r1, sp
+    0xc970,        // 0a8  ldm r1!, {r4, r5, r6}
+    0x1a5b,        // 0aa  subs r3, r3, r1
+    0x18c0,        // 0ac  adds r0, r0, r3
+    0x1980,        // 0ae  adds r0, r0, r6
+    0x9902,        // 0b0  ldr r1, [sp, #8]
+    0x1840,        // 0b2  adds r0, r0, r1
+    0xb004,        // 0b4  add sp, #16
+    0xbdf0,        // 0b6  pop {r4, r5, r6, r7, pc}
+    0x8001, 0xffff,// 0b8  .word 0xffff8001
+    // t_ext
+    0x4907,        // 0bc  ldr r1, [pc, #28]
+    0xb208,        // 0be  sxth r0, r1
+    0xb2ca,        // 0c0  uxtb r2, r1
+    0x1880,        // 0c2  adds r0, r0, r2
+    0xba0a,        // 0c4  rev r2, r1
+    0x4050,        // 0c6  eors r0, r2
+    0xba4a,        // 0c8  rev16 r2, r1
+    0x4050,        // 0ca  eors r0, r2
+    0xbaca,        // 0cc  revsh r2, r1
+    0x4050,        // 0ce  eors r0, r2
+    0xb24a,        // 0d0  sxtb r2, r1
+    0x4050,        // 0d2  eors r0, r2
+    0xb28a,        // 0d4  uxth r2, r1
+    0x4050,        // 0d6  eors r0, r2
+    0x4770,        // 0d8  bx lr
+    0x0000,        // 0da  (pad)
+    0x8765, 0x1234,// 0dc  .word 0x12348765
+    // t_cond
+    0x2000,        // 0e0  movs r0, #0
+    0x2105,        // 0e2  movs r1, #5
+    0x2200,        // 0e4  movs r2, #0
+    0x3a03,        // 0e6  subs r2, #3
+    0x428a,        // 0e8  cmp r2, r1
+    0xda00,        // 0ea  bge t_cond+0xe
+    0x3001,        // 0ec  adds r0, #1
+    0x428a,        // 0ee  cmp r2, r1
+    0xd900,        // 0f0  bls t_cond+0x14
+    0x3002,        // 0f2  adds r0, #2
+    0x4291,        // 0f4  cmp r1, r2
+    0xdd00,        // 0f6  ble t_cond+0x1a
+    0x3004,        // 0f8  adds r0, #4
+    0x4289,        // 0fa  cmp r1, r1
+    0xd100,        // 0fc  bne t_cond+0x20
+    0x3008,        // 0fe  adds r0, #8
+    0x42ca,        // 100  cmn r2, r1
+    0xd600,        // 102  bvs t_cond+0x26
+    0x3010,        // 104  adds r0, #16
+    0x4b04,        // 106  ldr r3, [pc, #16]
+    0x3301,        // 108  adds r3, #1
+    0xd700,        // 10a  bvc t_cond+0x2e
+    0x3020,        // 10c  adds r0, #32
+    0xd400,        // 10e  bmi t_cond+0x32
+    0xe000,        // 110  b t_cond+0x34
+    0x3040,        // 112  adds r0, #64
+    0x4770,        // 114  bx lr
+    0x0000,        // 116  (pad)
+    0xffff, 0x7fff,// 118  .word 0x7fffffff
+    // t_jump
+    0x2106,        // 11c  movs r1, #6
+    0x448f,        // 11e  add pc, r1
+    0x2000,        // 120  movs r0, #0
+    0x4770,        // 122  bx lr
+    0x2001,        // 124  movs r0, #1
+    0x4770,        // 126  bx lr
+    0x2002,        // 128  movs r0, #2
+    0x4770,        // 12a  bx lr
+    // t_logic
+    0x20f0,        // 12c  movs r0, #240
+    0x2130,        // 12e  movs r1, #48
+    0x4388,        // 130  bics r0, r1
+    0x2205,        // 132  movs r2, #5
+    0x4252,        // 134  rsbs r2, r2, #0
+    0x1880,        // 136  adds r0, r0, r2
+    0x43cb,        // 138  mvns r3, r1
+    0x420b,        // 13a  tst r3, r1
+    0xd000,        // 13c  beq t_logic+0x14
+    0x3064,        // 13e  adds r0, #100
+    0x2101,        // 140  movs r1, #1
+    0x4308,        // 142  orrs r0, r1
+    0x4770,        // 144  bx lr
+    0x46c0,        // 146  (pad)
+    // t_misc
+    0xb510,        // 148  push {r4, lr}
+    0xa10f,        // 14a  adr r1, target
+    0x3101,        // 14c  adds r1, #1
+    0x4788,        // 14e  blx r1
+    0x4604,        // 150  mov r4, r0
+    0xa901,        // 152  add r1, sp, #4
+    0x466a,        // 154  mov r2, sp
+    0x1a89,        // 156  subs r1, r1, r2
+    0x1864,        // 158  adds r4, r4, r1
+    0x2200,        // 15a  movs r2, #0
+    0x4292,        // 15c  cmp r2, r2
+    0xf3ef, 0x8300,// 15e  mrs r3, apsr
+    0x0f1b,        // 162  lsrs r3, r3, #28
+    0x18e4,        // 164  adds r4, r4, r3
+    0xb672,        // 166  cpsid i
+    0xf3ef, 0x8310,// 168  mrs r3, primask
+    0x18e4,        // 16c  adds r4, r4, r3
+    0xb662,        // 16e  cpsie i
+    0xf3bf, 0x8f5f,// 170  dmb sy
+    0xf3bf, 0x8f4f,// 174  dsb sy
+    0xf3bf, 0x8f6f,// 178  isb sy
+    0x2300,        // 17c  movs r3, #0
+    0xf383, 0x8800,// 17e  msr apsr, r3
+    0x4620,        // 182  mov r0, r4
+    0xbd10,        // 184  pop {r4, pc}
+    0x46c0,        // 186  (pad)
+    // target
+    0x2009,        // 188  movs r0, #9
+    0x4770,        // 18a  bx lr
+    // t_unaligned
+    0x4901,        // 18c  ldr r1, [pc, #4]
+    0x6808,        // 18e  ldr r0, [r1]
+    0x4770,        // 190  bx lr
+    0x0000,        // 192  (pad)
+    0x0001, 0x2020,// 194  .word 0x20200001
+    // t_bkpt
+    0xbe07,        // 198  bkpt #7
+    0x4770,        // 19a  bx lr
+    // t_flashwrite
+    0x2100,        // 19c  movs r1, #0
+    0x6009,        // 19e  str r1, [r1]
+    0x4770,        // 1a0  bx lr
+    0x46c0,        // 1a2  (pad)
+    // t_hireg
+    0x2007,        // 1a4  movs r0, #7
+    0x4680,        // 1a6  mov r8, r0
+    0x46c1,        // 1a8  mov r9, r8
+    0x44c1,        // 1aa  add r9, r8
+    0x210e,        // 1ac  movs r1, #14
+    0x4589,        // 1ae  cmp r9, r1
+    0xd101,        // 1b0  bne t_hireg+0x12
+    0x4648,        // 1b2  mov r0, r9
+    0x4440,        // 1b4  add r0, r8
+    0x4770,        // 1b6  bx lr
+};
+
+typedef struct {
+    const char *name;
+    uint32_t entry;            ///< Offset in IMAGE (the Thumb bit is added)
+    M0SimStop_t stop;
+    uint32_t r0;               ///< Checked when the function returns
+    uint32_t cycles;           ///< 0 = not checked
+} Check_t;
+
+static const Check_t CHECKS[] = {
+    {"add64",      0x000, M0SIM_RETURNED,   16,                      0},
+    {"sub64",      0x01c, M0SIM_RETURNED,   0xFFFFFFFFu,             0},
+    {"shift",      0x02c, M0SIM_RETURNED,   0x10000009u,             0},
+    // 123456 * -789
+    {"mul",        0x054, M0SIM_RETURNED,   0xFA31B0C0u,             0},
+    // movs 1 + 10 subs + 9 taken bne 2 + last bne 1 + bx 2
+    {"loop",       0x064, M0SIM_RETURNED,   0,                       32},
+    // push 3 + movs 1 + bl 3 + movs 1 + bx 2 + adds 1 + pop {r4, pc} 5
+    {"call",       0x06c, M0SIM_RETURNED,   7,                       16},
+    {"mem",        0x07c, M0SIM_RETURNED,   137,                     0},
+    {"ext",        0x0bc, M0SIM_RETURNED,   0xAE6A34D8u,             0},
+    {"cond",       0x0e0, M0SIM_RETURNED,   63,                      0},
+    {"jump",       0x11c, M0SIM_RETURNED,   2,                       0},
+    {"logic",      0x12c, M0SIM_RETURNED,   0xBB,                    0},
+    {"misc",       0x148, M0SIM_RETURNED,   20,                      0},
+    {"hireg",      0x1a4, M0SIM_RETURNED,   21,                      0},
+    {"unaligned",  0x18c, M0SIM_FAULT,      0,                       0},
+    {"bkpt",       0x198, M0SIM_BREAKPOINT, 0,                       0},
+    {"flashwrite", 0x19c, M0SIM_FAULT,      0,                       0},
+};
+
+static const char *STOP_NAMES[] = {"returned", "fault", "breakpoint",
+                                   "limit"};
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(void) {
+    M0Sim_t sim;
+    int failed = 0;
+
+    if (!M0Sim_Init(&sim)) {
+        puts("m0sim_check: out of memory");
+        return 1;
+    }
+    for (size_t i = 0; i < sizeof(IMAGE) / sizeof(IMAGE[0]); i++) {
+        sim.flash[2 * i] = (uint8_t)IMAGE[i];
+        sim.flash[2 * i + 1] = (uint8_t)(IMAGE[i] >> 8);
+    }
+
+    for (size_t i = 0; i < sizeof(CHECKS) / sizeof(CHECKS[0]); i++) {
+        const Check_t *c = &CHECKS[i];
+        uint64_t start = sim.cycles;
+        M0SimStop_t stop = M0Sim_Call(&sim, M0SIM_FLASH_BASE + c->entry + 1,
+                                      NULL, 0, 1000);
+        uint32_t cycles = (uint32_t)(sim.cycles - start);
+        bool ok = stop == c->stop &&
+                  (stop != M0SIM_RETURNED || sim.r[0] == c->r0) &&
+                  (c->cycles == 0 || cycles == c->cycles);
+
+        printf("%-10s %-10s r0 %08x  %3u cycles  %s", c->name,
+               STOP_NAMES[stop], sim.r[0], cycles, ok ? "OK" : "FAIL");
+        if (stop != M0SIM_RETURNED) printf("  (%s)", sim.message);
+        putchar('\n');
+        failed += !ok;
+    }
+
+    printf("%d of %zu failed\n", failed,
+           sizeof(CHECKS) / sizeof(CHECKS[0]));
+    M0Sim_Free(&sim);
+    return failed ? 1 : 0;
+}
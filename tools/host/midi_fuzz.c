@@ -0,0 +1,808 @@
+/**
+ * @file midi_fuzz.c
+ * @brief Fuzz and Throughput Test for the MIDI Input Parser (Linux host)
+ * @version 1.0.0
+ *
+ * Feeds lib/midi/midi_in byte streams and checks what comes out:
+ *
+ *   roundtrip  Random channel, system common and SysEx messages go through
+ *              the output queue (running status, Note Off as Note On 0),
+ *              real-time bytes are sprinkled in anywhere, even inside
+ *              messages and SysEx frames. The parser must return every
+ *              message and every real-time byte, in order.
+ *   garbage    Random bytes. Whatever the parser hands over must be well
+ *              formed, and a message after the garbage must still arrive.
+ *   threads    The roundtrip stream through the RX ring, with the
+ *              producer (the interrupt) and the parser on two threads.
+ *   line       The stream back to back at 921600 baud into the ring, the
+ *              parser once per 2 ms block, late by up to -l microseconds.
+ *              No byte may be lost.
+ *   engine     Notes, bend, volume and program change into the synth.
+ *   parts      Multi-timbral parts: channel routing, voice limits,
+ *              priority stealing, dropped notes, voices freed on release.
+ *   speed      Parser bytes per second on this host.
+ *
+ * Files on the command line (raw captures, e.g. from a MIDI monitor) are
+ * parsed and summarised instead; the line test runs on each of them.
+ *
+ * Exit status 1 on any failure. CC="gcc -fsanitize=address,undefined" or
+ * "-fsanitize=thread" builds check the parser and ring as well.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./midi_fuzz                      All tests, default sizes
+ *   ./midi_fuzz -n 1000000           Messages in the roundtrip stream
+ *   ./midi_fuzz -s 7                 PRNG seed
+ *   ./midi_fuzz -l 3000              Worst block lateness (us)
+ *   ./midi_fuzz capture.syx ...      Parse recorded streams
+ */
+
+#include "midi/midi_in.h"
+#include "midi/midi_out.h"
+#include "audio/synth.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DEFAULT_MESSAGES 200000u
+#define DEFAULT_SEED     1u
+#define DEFAULT_LATE_US  2000u       // A block render that takes its budget
+#define GARBAGE_BYTES    4000000u
+#define SPEED_PASSES     20
+#define BAUD             921600u
+#define BLOCK_US         2000u       // 32 samples at 16 kHz
+#define SETTLE_BLOCKS    64          // Portamento reaches the target
+
+//=============================================================================
+// EVENTS
+//=============================================================================
+// One thing handed over by the parser: a message, a real-time byte or a
+// SysEx frame (stored in a side buffer)
+typedef struct {
+    uint8_t kind;                    // 'm', 'r', 's'
+    uint8_t bytes[3];
+    uint32_t sysex_offset;
+    uint16_t sysex_length;
+} Event_t;
+
+typedef struct {
+    Event_t *events;
+    uint32_t count;
+    uint32_t capacity;
+    uint8_t *sysex;
+    uint32_t sysex_used;
+    uint32_t sysex_capacity;
+    uint32_t malformed;
+} EventLog_t;
+
+static void Log_Init(EventLog_t *log) {
+    memset(log, 0, sizeof(*log));
+}
+
+static void Log_Free(EventLog_t *log) {
+    free(log->events);
+    free(log->sysex);
+    Log_Init(log);
+}
+
+static Event_t *Log_Add(EventLog_t *log, uint8_t kind) {
+    if (log->count == log->capacity) {
+        log->capacity = log->capacity ? log->capacity * 2 : 4096;
+        log->events = realloc(log->events, log->capacity * sizeof(Event_t));
+        if (log->events == NULL) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    Event_t *e = &log->events[log->count++];
+    memset(e, 0, sizeof(*e));
+    e->kind = kind;
+    return e;
+}
+
+static void Log_SysEx(EventLog_t *log, const uint8_t *frame, uint16_t length) {
+    Event_t *e = Log_Add(log, 's');
+
+    if (log->sysex_used + length > log->sysex_capacity) {
+        log->sysex_capacity = (log->sysex_used + length) * 2;
+        log->sysex = realloc(log->sysex, log->sysex_capacity);
+        if (log->sysex == NULL) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    memcpy(&log->sysex[log->sysex_used], frame, length);
+    e->sysex_offset = log->sysex_used;
+    e->sysex_length = length;
+    log->sysex_used += length;
+}
+
+static bool Same_Event(const EventLog_t *a, uint32_t i, const EventLog_t *b,
+                       uint32_t j) {
+    const Event_t *x = &a->events[i];
+    const Event_t *y = &b->events[j];
+
+    if (x->kind != y->kind) return false;
+    if (x->kind != 's') return memcmp(x->bytes, y->bytes, 3) == 0;
+    return x->sysex_length == y->sysex_length &&
+           memcmp(&a->sysex[x->sysex_offset], &b->sysex[y->sysex_offset],
+                  x->sysex_length) == 0;
+}
+
+//=============================================================================
+// PARSER HANDLERS (check the output while logging it)
+//=============================================================================
+static uint8_t Data_Bytes(uint8_t status) {
+    switch (status & 0xF0) {
+    case 0xC0:
+    case 0xD0: return 1;
+    case 0xF0: return (status == 0xF2) ? 2 : (status == 0xF6) ? 0 : 1;
+    default:   return 2;
+    }
+}
+
+static void On_Message(void *ctx, const MIDI_Message_t *msg) {
+    EventLog_t *log = ctx;
+    Event_t *e = Log_Add(log, 'm');
+    bool ok = msg->status >= 0x80 && msg->status != 0xF0 &&
+              msg->status != 0xF4 && msg->status != 0xF5 &&
+              msg->status < 0xF7 &&
+              msg->length == 1 + Data_Bytes(msg->status) &&
+              msg->data1 < 0x80 && msg->data2 < 0x80 &&
+              !((msg->status & 0xF0) == MIDI_NOTE_ON && msg->data2 == 0);
+
+    if (!ok) log->malformed++;
+    e->bytes[0] = msg->status;
+    e->bytes[1] = msg->data1;
+    e->bytes[2] = msg->data2;
+}
+
+static void On_RealTime(void *ctx, uint8_t byte) {
+    EventLog_t *log = ctx;
+
+    if (byte < 0xF8) log->malformed++;
+    Log_Add(log, 'r')->bytes[0] = byte;
+}
+
+static void On_SysEx(void *ctx, const uint8_t *frame, uint16_t length) {
+    EventLog_t *log = ctx;
+    bool ok = length >= 2 && length <= MIDI_IN_SYSEX_MAX &&
+              frame[0] == MIDI_SYSEX_START && frame[length - 1] == MIDI_SYSEX_END;
+
+    for (uint16_t i = 1; ok && i + 1 < length; i++) {
+        if (frame[i] & 0x80) ok = false;
+    }
+    if (!ok) log->malformed++;
+    Log_SysEx(log, frame, length);
+}
+
+static void Parser_Init(MidiIn_t *in, EventLog_t *log) {
+    const MidiInHandlers_t handlers = {On_Message, On_RealTime, On_SysEx, log};
+    MidiIn_Init(in, &handlers);
+}
+
+//=============================================================================
+// STREAM GENERATOR (through the output queue, like the firmware sends)
+//=============================================================================
+typedef struct {
+    uint8_t *bytes;
+    uint32_t length;
+    uint32_t capacity;
+} Stream_t;
+
+static Stream_t *capture;
+
+static bool Capture_Busy(void) {
+    return false;
+}
+
+static void Capture_Start(const uint8_t *data, uint16_t n) {
+    if (capture->length + n > capture->capacity) {
+        capture->capacity = (capture->length + n) * 2;
+        capture->bytes = realloc(capture->bytes, capture->capacity);
+        if (capture->bytes == NULL) {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    memcpy(&capture->bytes[capture->length], data, n);
+    capture->length += n;
+}
+
+static uint32_t Rand(uint32_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+// Every queued byte into the capture, wrapped spans included
+static void Drain(MidiOut_t *out) {
+    while (MidiOut_Free(out) != MIDI_OUT_RING_SIZE) MidiOut_Poll(out);
+}
+
+static void Stream_Put(Stream_t *s, uint8_t byte) {
+    capture = s;
+    Capture_Start(&byte, 1);
+}
+
+/**
+ * @brief Random messages, their expected events, and the encoded stream
+ *
+ * Real-time bytes go in at random positions afterwards, so they land in
+ * the middle of messages and frames; the expected log gets them in order.
+ */
+static void Generate(uint32_t messages, uint32_t *rng, Stream_t *stream,
+                     EventLog_t *expected) {
+    static const MidiOutPort_t port = {Capture_Busy, Capture_Start};
+    static MidiOut_t out;
+    Stream_t plain = {NULL, 0, 0};
+    EventLog_t ordered;
+    uint32_t *at;          // Byte offset where each expected event ends
+
+    Log_Init(&ordered);
+    at = malloc((size_t)messages * sizeof(uint32_t));
+    if (at == NULL) {
+        perror("malloc");
+        exit(2);
+    }
+
+    capture = &plain;
+    MidiOut_Init(&out, &port);
+    for (uint32_t i = 0; i < messages; i++) {
+        uint32_t r = Rand(rng);
+        uint8_t ch = r & 0x0F;
+        uint8_t d1 = (r >> 8) & 0x7F;
+        uint8_t d2 = (r >> 16) & 0x7F;
+        MIDI_Message_t msg = {0, d1, d2, 3};
+
+        switch ((r >> 24) % 16) {
+        case 0: case 1: case 2: case 3:
+            msg.status = MIDI_NOTE_ON | ch;
+            break;
+        case 4: case 5:
+            msg.status = MIDI_NOTE_OFF | ch;
+            if (r & 0x100000) msg.data2 = 64; // Goes out as Note On 0
+            break;
+        case 6: case 7: case 8:
+            msg.status = MIDI_CONTROL_CHANGE | (ch & 1); // Runs of one status
+            break;
+        case 9:
+            msg.status = MIDI_PROGRAM_CHANGE | ch;
+            msg.length = 2;
+            break;
+        case 10:
+            msg.status = 0xD0 | ch; // Channel pressure
+            msg.length = 2;
+            break;
+        case 11:
+            msg.status = 0xA0 | ch; // Poly pressure
+            break;
+        case 12: case 13:
+            msg.status = MIDI_PITCH_BEND | ch;
+            break;
+        case 14: {
+            // System common: raw write, cancels running status
+            static const uint8_t common[] = {0xF1, 0xF2, 0xF3, 0xF6};
+            uint8_t bytes[3] = {common[r % 4], d1, d2};
+            msg.status = bytes[0];
+            msg.length = (uint8_t)(1 + Data_Bytes(bytes[0]));
+            MidiOut_Write(&out, bytes, msg.length);
+            break;
+        }
+        default: {
+            // SysEx frame, sometimes longer than the parser keeps
+            uint8_t frame[MIDI_IN_SYSEX_MAX + 8];
+            uint16_t n = (uint16_t)(2 + (Rand(rng) % (MIDI_IN_SYSEX_MAX + 4)));
+            frame[0] = MIDI_SYSEX_START;
+            for (uint16_t k = 1; k + 1 < n; k++) frame[k] = Rand(rng) & 0x7F;
+            frame[n - 1] = MIDI_SYSEX_END;
+            // Pieces: a frame may be longer than the output ring
+            for (uint16_t k = 0; k < n; k += 64) {
+                MidiOut_Write(&out, &frame[k], (uint16_t)(n - k < 64 ? n - k : 64));
+                Drain(&out);
+            }
+            if (n <= MIDI_IN_SYSEX_MAX) Log_SysEx(&ordered, frame, n);
+            else Log_Add(&ordered, 'x'); // Dropped by the parser
+            at[i] = plain.length;
+            continue;
+        }
+        }
+
+        if (msg.status < 0xF0) MidiOut_Send(&out, &msg);
+        Drain(&out);
+
+        // What the parser should hand over for it
+        Event_t *e = Log_Add(&ordered, 'm');
+        if (msg.length < 3) msg.data2 = 0;
+        if (msg.length < 2) msg.data1 = 0;
+        if ((msg.status & 0xF0) == MIDI_NOTE_ON && msg.data2 == 0) {
+            msg.status = MIDI_NOTE_OFF | (msg.status & 0x0F);
+            msg.data2 = 64;
+        }
+        e->bytes[0] = msg.status;
+        e->bytes[1] = msg.data1;
+        e->bytes[2] = msg.data2;
+        at[i] = plain.length;
+    }
+
+    // Sprinkle real-time bytes: each goes in before byte 'pos', so it is
+    // handed over before any event that ends at or after 'pos'
+    stream->length = 0;
+    uint32_t next = 0;
+    Log_Init(expected);
+    for (uint32_t pos = 0; pos < plain.length; pos++) {
+        while (next < messages && at[next] <= pos) {
+            if (ordered.events[next].kind == 's') {
+                Log_SysEx(expected,
+                          &ordered.sysex[ordered.events[next].sysex_offset],
+                          ordered.events[next].sysex_length);
+            } else if (ordered.events[next].kind == 'm') {
+                *Log_Add(expected, 'm') = ordered.events[next];
+            }
+            next++;
+        }
+        if (Rand(rng) % 8 == 0) {
+            uint8_t rt = (uint8_t)(0xF8 + Rand(rng) % 8);
+            Stream_Put(stream, rt);
+            Log_Add(expected, 'r')->bytes[0] = rt;
+        }
+        Stream_Put(stream, plain.bytes[pos]);
+    }
+    for (; next < messages; next++) {
+        if (ordered.events[next].kind == 's') {
+            Log_SysEx(expected, &ordered.sysex[ordered.events[next].sysex_offset],
+                      ordered.events[next].sysex_length);
+        } else if (ordered.events[next].kind == 'm') {
+            *Log_Add(expected, 'm') = ordered.events[next];
+        }
+    }
+
+    free(plain.bytes);
+    free(at);
+    Log_Free(&ordered);
+}
+
+static bool Compare(const char *test, const EventLog_t *got,
+                    const EventLog_t *expected) {
+    uint32_t n = got->count < expected->count ? got->count : expected->count;
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (!Same_Event(got, i, expected, i)) {
+            const Event_t *g = &got->events[i];
+            const Event_t *e = &expected->events[i];
+            printf("%s: event %u is %c %02X %02X %02X, expected %c %02X %02X "
+                   "%02X\n", test, i, g->kind, g->bytes[0], g->bytes[1],
+                   g->bytes[2], e->kind, e->bytes[0], e->bytes[1], e->bytes[2]);
+            return false;
+        }
+    }
+    if (got->count != expected->count) {
+        printf("%s: %u events, expected %u\n", test, got->count,
+               expected->count);
+        return false;
+    }
+    return true;
+}
+
+static double Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+static Stream_t stream;
+static EventLog_t expected;
+
+static bool Roundtrip_Test(void) {
+    static MidiIn_t in;
+    EventLog_t got;
+
+    Log_Init(&got);
+    Parser_Init(&in, &got);
+    for (uint32_t i = 0; i < stream.length; i++) MidiIn_Parse(&in, stream.bytes[i]);
+
+    bool ok = Compare("roundtrip", &got, &expected) && got.malformed == 0;
+    printf("roundtrip %u bytes, %u events, %u errors (oversized SysEx)  %s\n",
+           stream.length, got.count, in.errors, ok ? "OK" : "FAIL");
+    Log_Free(&got);
+    return ok;
+}
+
+static bool Garbage_Test(uint32_t *rng) {
+    static MidiIn_t in;
+    EventLog_t got;
+
+    Log_Init(&got);
+    Parser_Init(&in, &got);
+    for (uint32_t i = 0; i < GARBAGE_BYTES; i++) {
+        uint32_t r = Rand(rng);
+        // Half status bytes, so every state is entered often
+        uint8_t byte = (uint8_t)((r & 0x100) ? (r | 0x80) : (r & 0x7F));
+        MidiIn_Parse(&in, byte);
+    }
+
+    // Resynchronises on the next status byte
+    uint32_t before = got.count;
+    static const uint8_t probe[] = {0x93, 60, 100};
+    for (uint8_t i = 0; i < sizeof(probe); i++) MidiIn_Parse(&in, probe[i]);
+    bool resync = got.count == before + 1 &&
+                  memcmp(got.events[before].bytes, probe, 3) == 0;
+
+    bool ok = got.malformed == 0 && resync && in.bytes == GARBAGE_BYTES + 3;
+    printf("garbage   %u bytes, %u events, %u errors, %s  %s\n",
+           GARBAGE_BYTES, got.count, in.errors,
+           resync ? "resynchronised" : "lost sync", ok ? "OK" : "FAIL");
+    Log_Free(&got);
+    return ok;
+}
+
+static MidiInRing_t ring;
+static atomic_bool producer_done;
+
+static void *Ring_Producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < stream.length; i++) {
+        // The interrupt would drop on a full ring; here it waits, so the
+        // output must match exactly
+        while ((uint16_t)(atomic_load(&ring.head) - atomic_load(&ring.tail)) >=
+               MIDI_IN_RING_SIZE) {
+            sched_yield();
+        }
+        MidiIn_RingPut(&ring, stream.bytes[i]);
+    }
+    atomic_store(&producer_done, true);
+    return NULL;
+}
+
+static bool Thread_Test(void) {
+    static MidiIn_t in;
+    EventLog_t got;
+    pthread_t producer;
+
+    Log_Init(&got);
+    Parser_Init(&in, &got);
+    MidiIn_RingInit(&ring);
+    atomic_store(&producer_done, false);
+
+    double t = Seconds();
+    pthread_create(&producer, NULL, Ring_Producer, NULL);
+    for (;;) {
+        bool done = atomic_load(&producer_done);
+        if (MidiIn_Process(&in, &ring) == 0) {
+            if (done) break;
+            sched_yield();
+        }
+    }
+    pthread_join(producer, NULL);
+    t = Seconds() - t;
+
+    bool ok = Compare("threads", &got, &expected) && ring.overruns == 0;
+    printf("threads   %u bytes through the ring, %.1f MB/s  %s\n",
+           stream.length, stream.length / t / 1e6, ok ? "OK" : "FAIL");
+    Log_Free(&got);
+    return ok;
+}
+
+/**
+ * @brief The stream at line rate, parsed once per (late) block
+ */
+static bool Line_Test(const char *name, const uint8_t *bytes, uint32_t length,
+                      uint32_t late_us, uint32_t *rng) {
+    static MidiIn_t in;
+    uint16_t peak = 0;
+
+    MidiIn_Init(&in, NULL);
+    MidiIn_RingInit(&ring);
+
+    // Byte i is complete at (i + 1) * 10 bits / BAUD
+    uint64_t block = 0;
+    uint64_t due = BLOCK_US + (late_us ? Rand(rng) % (late_us + 1) : 0);
+    for (uint32_t i = 0; i < length; i++) {
+        uint64_t t_us = ((uint64_t)(i + 1) * 10u * 1000000u) / BAUD;
+        while (t_us >= due) {
+            MidiIn_Process(&in, &ring);
+            block++;
+            due = (block + 1) * BLOCK_US + (late_us ? Rand(rng) % (late_us + 1) : 0);
+        }
+        MidiIn_RingPut(&ring, bytes[i]);
+        uint16_t depth = (uint16_t)(atomic_load(&ring.head) - atomic_load(&ring.tail));
+        if (depth > peak) peak = depth;
+    }
+    MidiIn_Process(&in, &ring);
+
+    bool ok = ring.overruns == 0 && in.bytes == length;
+    printf("line      %s: %u bytes at %u baud, blocks up to %u us late, "
+           "peak %u of %u in the ring, %u lost  %s\n", name, length, BAUD,
+           late_us, peak, MIDI_IN_RING_SIZE, ring.overruns, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static void Render(uint32_t blocks) {
+    int16_t mix[SYNTH_BLOCK_SIZE];
+    while (blocks--) Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+}
+
+static bool Engine_Test(void) {
+    SynthStatus_t st;
+    bool ok = true;
+
+    Synth_Init(NULL);
+    Render(1);
+
+#define EXPECT(cond)                                                          \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("engine: %s\n", #cond);                                    \
+            ok = false;                                                       \
+        }                                                                     \
+    } while (0)
+
+    Synth_MidiMessage(0x90, 69, 100); // A4
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 440);
+    EXPECT(st.env_state != ENV_IDLE && st.env_state != ENV_RELEASE);
+
+    Synth_MidiMessage(0x95, 81, 100); // A5 over it, a channel without a
+                                      // part: glides up
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 880);
+
+    Synth_MidiMessage(0x95, 81, 0);   // Released: back to the held A4
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 440);
+
+    Synth_MidiMessage(0xE0, 0x7F, 0x7F); // Bend up 2 semitones (493.9 Hz)
+    Render(1);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz >= 492 && st.pitch_hz <= 495);
+    Synth_MidiMessage(0xE0, 0x00, 0x40); // Centre
+    Render(1);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 440);
+
+    Synth_MidiMessage(0xB0, MIDI_CC_VOLUME, 127);
+    Synth_MidiMessage(0xC0, 2, 0);
+    Render(1);
+    Synth_GetStatus(&st);
+    EXPECT(st.volume == 100);
+    EXPECT(st.instrument == (Instrument_t)(2 % INSTRUMENT_COUNT));
+
+    Synth_MidiMessage(0xB0, MIDI_CC_SUSTAIN, 127);
+    Synth_MidiMessage(0x80, 69, 64);  // Held by the pedal
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.env_state != ENV_IDLE && st.env_state != ENV_RELEASE);
+    Synth_MidiMessage(0xB0, MIDI_CC_SUSTAIN, 0);
+    Render(1);
+    Synth_GetStatus(&st);
+    EXPECT(st.env_state == ENV_RELEASE || st.env_state == ENV_IDLE);
+#undef EXPECT
+
+    printf("engine    notes, legato, bend, volume, program, sustain  %s\n",
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static uint8_t Part_Voices(uint8_t part) {
+    SynthPartStatus_t ps;
+    Synth_GetPartStatus(part, &ps);
+    return ps.voices;
+}
+
+// Default parts: 0 bass (MIDI channel 2, limit 2, priority 2), 1 strings
+// (3, limit 4, priority 0), 2 lead (4, limit 2, priority 1), 3 piano (5,
+// limit 4, priority 1); 8 voices
+static bool Parts_Test(void) {
+    SynthPartStatus_t ps;
+    SynthStatus_t st;
+    bool ok = true;
+
+#define EXPECT(cond)                                                          \
+    do {                                                                      \
+        if (!(cond)) {                                                        \
+            printf("parts: %s\n", #cond);                                     \
+            ok = false;                                                       \
+        }                                                                     \
+    } while (0)
+
+    Synth_Init(NULL);
+    Render(1);
+    Synth_MidiMessage(0x90, 69, 100); // Channel 1: the panel
+    Synth_MidiMessage(0x91, 81, 100); // Channel 2: the bass part
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 440);
+    EXPECT(Part_Voices(0) == 1);
+
+    // Limit 2: the third note takes the bass's own oldest voice
+    Synth_MidiMessage(0x91, 36, 100);
+    Synth_MidiMessage(0x91, 43, 100);
+    Render(1);
+    Synth_GetPartStatus(0, &ps);
+    EXPECT(ps.voices == 2 && ps.dropped == 0 && ps.stolen == 0);
+
+    // Fill the pool: 2 bass + 4 strings + 2 lead
+    for (uint8_t n = 0; n < 4; n++) Synth_MidiMessage(0x92, 60 + n, 80);
+    Synth_MidiMessage(0x93, 72, 100);
+    Synth_MidiMessage(0x93, 76, 100);
+    Render(1);
+    EXPECT(Part_Voices(1) == 4 && Part_Voices(2) == 2);
+
+    // Piano (priority 1) takes the oldest strings voice (priority 0)
+    Synth_MidiMessage(0x94, 48, 90);
+    Render(1);
+    Synth_GetPartStatus(1, &ps);
+    EXPECT(ps.voices == 3 && ps.stolen == 1);
+    EXPECT(Part_Voices(3) == 1);
+
+    // A released voice goes before any held one, whatever its priority
+    Synth_MidiMessage(0x83, 72, 0);
+    Render(1);
+    Synth_MidiMessage(0x94, 52, 90);
+    Render(1);
+    Synth_GetPartStatus(2, &ps);
+    EXPECT(ps.voices == 1 && ps.stolen == 1);
+    EXPECT(Part_Voices(1) == 3 && Part_Voices(3) == 2);
+
+    // All notes off: the voices fade out and go back to the pool
+    for (uint8_t c = 1; c <= 4; c++) Synth_MidiMessage(0xB0 | c, 123, 0);
+    Render(SETTLE_BLOCKS * 20);
+    for (uint8_t p = 0; p < 4; p++) EXPECT(Part_Voices(p) == 0);
+
+    // Eight held bass voices: the strings (lower) and the piano (lower)
+    // find nothing to take; the lead, raised above the bass, does
+    Synth_SetPart(0, SYNTH_PART_VOICES, 8);
+    Synth_SetPart(2, SYNTH_PART_PRIORITY, 3);
+    Render(1);
+    for (uint8_t n = 0; n < 8; n++) Synth_MidiMessage(0x91, 36 + n, 100);
+    Synth_MidiMessage(0x92, 60, 80);
+    Synth_MidiMessage(0x94, 60, 80);
+    Synth_MidiMessage(0x93, 72, 100);
+    Render(1);
+    Synth_GetPartStatus(1, &ps);
+    EXPECT(ps.dropped == 1 && ps.voices == 0);
+    Synth_GetPartStatus(3, &ps);
+    EXPECT(ps.dropped == 1 && ps.voices == 0);
+    Synth_GetPartStatus(0, &ps);
+    EXPECT(ps.voices == 7 && ps.stolen == 1);
+    EXPECT(Part_Voices(2) == 1);
+
+    // Channel off: channel 2 plays the panel again
+    Synth_SetPart(0, SYNTH_PART_CHANNEL, -1);
+    Render(1);
+    Synth_MidiMessage(0x91, 81, 100);
+    Render(SETTLE_BLOCKS);
+    Synth_GetStatus(&st);
+    EXPECT(st.pitch_hz == 880);
+    Synth_GetPartStatus(0, &ps);
+    EXPECT(ps.channel == -1 && ps.voices == 7);
+#undef EXPECT
+
+    printf("parts     routing, voice limits, stealing, drops         %s\n",
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static void Speed_Test(void) {
+    static MidiIn_t in;
+
+    MidiIn_Init(&in, NULL);
+    double t = Seconds();
+    for (int pass = 0; pass < SPEED_PASSES; pass++) {
+        for (uint32_t i = 0; i < stream.length; i++) MidiIn_Parse(&in, stream.bytes[i]);
+    }
+    t = Seconds() - t;
+
+    double rate = (double)stream.length * SPEED_PASSES / t;
+    printf("speed     %.1f MB/s, %.1f ns/byte (line rate needs %u B/s)\n",
+           rate / 1e6, 1e9 / rate, BAUD / 10);
+}
+
+//=============================================================================
+// RECORDED STREAMS
+//=============================================================================
+static bool Parse_File(const char *path, uint32_t late_us, uint32_t *rng) {
+    static MidiIn_t in;
+    EventLog_t got;
+    FILE *f = fopen(path, "rb");
+
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    Stream_t s = {NULL, 0, 0};
+    int c;
+    while ((c = fgetc(f)) != EOF) Stream_Put(&s, (uint8_t)c);
+    fclose(f);
+
+    Log_Init(&got);
+    Parser_Init(&in, &got);
+    for (uint32_t i = 0; i < s.length; i++) MidiIn_Parse(&in, s.bytes[i]);
+
+    uint32_t kinds[3] = {0};
+    uint32_t types[8] = {0};
+    for (uint32_t i = 0; i < got.count; i++) {
+        const Event_t *e = &got.events[i];
+        if (e->kind == 'm') {
+            kinds[0]++;
+            types[(e->bytes[0] >> 4) & 7]++;
+        } else {
+            kinds[e->kind == 'r' ? 1 : 2]++;
+        }
+    }
+    printf("%s: %u bytes, %u messages (off %u on %u poly %u cc %u pc %u "
+           "press %u bend %u common %u), %u real-time, %u SysEx, %u errors\n",
+           path, s.length, kinds[0], types[0], types[1], types[2], types[3],
+           types[4], types[5], types[6], types[7], kinds[1], kinds[2],
+           in.errors);
+
+    bool ok = got.malformed == 0 && Line_Test(path, s.bytes, s.length, late_us, rng);
+    Log_Free(&got);
+    free(s.bytes);
+    return ok;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n messages] [-s seed] [-l late_us] [file...]\n",
+            prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    uint32_t messages = DEFAULT_MESSAGES;
+    uint32_t seed = DEFAULT_SEED;
+    uint32_t late_us = DEFAULT_LATE_US;
+    int files = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            messages = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            late_us = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            argv[++files] = argv[i]; // Files compacted to argv[1..files]
+        }
+    }
+    if (seed == 0) Usage(argv[0]); // xorshift needs a non-zero state
+
+    uint32_t rng = seed;
+    bool ok = true;
+    if (files > 0) {
+        for (int i = 1; i <= files; i++) ok = Parse_File(argv[i], late_us, &rng) && ok;
+        return ok ? 0 : 1;
+    }
+
+    Generate(messages, &rng, &stream, &expected);
+    ok = Roundtrip_Test() && ok;
+    ok = Garbage_Test(&rng) && ok;
+    ok = Thread_Test() && ok;
+    ok = Line_Test("roundtrip stream", stream.bytes, stream.length, late_us,
+                   &rng) && ok;
+    ok = Engine_Test() && ok;
+    ok = Parts_Test() && ok;
+    Speed_Test();
+
+    free(stream.bytes);
+    Log_Free(&expected);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file mixer_pan.c
+ * @brief Stereo Pan Law Test for the Voice Mixer (Linux host)
+ * @version 1.0.0
+ *
+ * Sets every int8_t pan value on a MIXER_STEREO channel at unity and reads
+ * back the pre-multiplied left/right gains:
+ *
+ *   ends      -128 and -64 are hard left (full, 0); +63 and +127 hard
+ *             right (0, full): out-of-range values clamp to the ends
+ *   centre    0 is equal power, both sides -3 dB
+ *   sweep     every value: gains within 0..full, left never rising and
+ *             right never falling as pan moves right
+ *   render    a constant voice at pan +127 comes out on the right bus
+ *             only
+ *
+ * Run it under -fsanitize=address to catch pan table reads out of range.
+ *
+ * Exit status 1 on any failure.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./mixer_pan
+ */
+
+#include "audio/audio_mixer.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define FULL   32767        // pan_table[16] at unity fader and group level
+#define CENTRE 23170        // -3 dB
+#define BLOCK  32
+
+static bool Report(const char *test, const char *what, bool ok) {
+    printf("%-7s %-54s %s\n", test, what, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+static void Gains(Mixer_t *mix, int pan, int32_t *l, int32_t *r) {
+    Mixer_SetChannel(mix, 0, MIXER_UNITY, (int8_t)pan, 0);
+    *l = mix->channel[0].gain_l;
+    *r = mix->channel[0].gain_r;
+}
+
+//=============================================================================
+// TESTS
+//=============================================================================
+static bool Ends_Test(Mixer_t *mix) {
+    static const struct {
+        int pan;
+        int32_t l, r;
+    } ENDS[] = {{-128, FULL, 0}, {-64, FULL, 0}, {63, 0, FULL},
+                {127, 0, FULL}};
+    bool ok = true;
+    char what[80];
+
+    for (unsigned i = 0; i < sizeof(ENDS) / sizeof(ENDS[0]); i++) {
+        int32_t l, r;
+        Gains(mix, ENDS[i].pan, &l, &r);
+        snprintf(what, sizeof(what), "pan %+4d: left %5d right %5d",
+                 ENDS[i].pan, (int)l, (int)r);
+        ok = Report("ends", what, l == ENDS[i].l && r == ENDS[i].r) && ok;
+    }
+    return ok;
+}
+
+static bool Centre_Test(Mixer_t *mix) {
+    int32_t l, r;
+    char what[80];
+
+    Gains(mix, 0, &l, &r);
+    snprintf(what, sizeof(what), "pan 0: left %d right %d", (int)l, (int)r);
+    return Report("centre", what, l == CENTRE && r == CENTRE);
+}
+
+static bool Sweep_Test(Mixer_t *mix) {
+    int32_t last_l = FULL, last_r = 0;
+    int bad = 0;
+    char what[80];
+
+    for (int pan = -128; pan <= 127; pan++) {
+        int32_t l, r;
+        Gains(mix, pan, &l, &r);
+        if (l < 0 || l > FULL || r < 0 || r > FULL || l > last_l ||
+            r < last_r)
+            bad++;
+        last_l = l;
+        last_r = r;
+    }
+    snprintf(what, sizeof(what), "256 pan values, %d out of range or order",
+             bad);
+    return Report("sweep", what, bad == 0);
+}
+
+static bool Render_Test(Mixer_t *mix) {
+    int16_t in[BLOCK];
+    int32_t out_l[BLOCK], out_r[BLOCK];
+    int32_t peak_l = 0, peak_r = 0;
+    char what[80];
+
+    for (int i = 0; i < BLOCK; i++) in[i] = 1000;
+    Mixer_SetChannel(mix, 0, MIXER_UNITY, 127, 0);
+    Mixer_BeginBlock(mix, BLOCK);
+    Mixer_AddVoice(mix, 0, in, BLOCK);
+    Mixer_Render(mix, NULL, out_l, out_r, BLOCK);
+    for (int i = 0; i < BLOCK; i++) {
+        if (out_l[i] > peak_l) peak_l = out_l[i];
+        if (out_r[i] > peak_r) peak_r = out_r[i];
+    }
+    snprintf(what, sizeof(what), "pan +127: left bus %d, right bus %d",
+             (int)peak_l, (int)peak_r);
+    return Report("render", what, peak_l == 0 && peak_r > 15000);
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(void) {
+    static Mixer_t mix;
+    bool ok = true;
+
+    Mixer_Init(&mix, MIXER_STEREO);
+    ok = Ends_Test(&mix) && ok;
+    ok = Centre_Test(&mix) && ok;
+    ok = Sweep_Test(&mix) && ok;
+    ok = Render_Test(&mix) && ok;
+    return ok ? 0 : 1;
+}
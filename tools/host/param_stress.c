@@ -0,0 +1,292 @@
+/**
+ * @file param_stress.c
+ * @brief Stress Test for the Parameter Queue (Linux host, two threads)
+ * @version 1.0.0
+ *
+ * Runs the control/audio split of the synth engine on two threads, so the
+ * producer and the consumer really overlap:
+ *
+ *   queue   One thread pushes numbered messages as fast as it can, the
+ *           other pops them. Every message must arrive once, in order.
+ *   engine  One thread calls the public Synth_* API with random setters,
+ *           buttons and control movements; the other renders blocks.
+ *           The final engine state must equal a single-threaded
+ *           reference run of the same calls. Epic mode is left out: its
+ *           sequencer depends on how many samples were rendered.
+ *
+ * Exit status 1 on any mismatch. Build with ThreadSanitizer to also
+ * check that the control side never touches the engine's state:
+ *   CC="gcc -fsanitize=thread" ./build.sh && ./param_stress
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./param_stress                   Both tests, default sizes
+ *   ./param_stress -n 50000000       Queue messages
+ *   ./param_stress -c 200000         Engine calls
+ *   ./param_stress -s 7              PRNG seed for the engine calls
+ */
+
+#include "audio/synth.h"
+#include "audio/param_queue.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DEFAULT_MESSAGES 20000000u
+#define DEFAULT_CALLS    100000u
+#define DEFAULT_SEED     1u
+#define BURST_CALLS      6           // <= 4 messages each: fits the queue
+#define SETTLE_BLOCKS    64          // Portamento reaches the target
+
+//=============================================================================
+// QUEUE TEST
+//=============================================================================
+static ParamQueue_t queue;
+static uint32_t queue_messages;
+static uint64_t queue_full_spins;
+
+static void *Queue_Producer(void *arg) {
+    (void)arg;
+    for (uint32_t i = 0; i < queue_messages; i++) {
+        while (!ParamQueue_Push(&queue, (uint8_t)(i & 0x7F), (int32_t)i)) {
+            queue_full_spins++;
+            sched_yield();          // Lets the consumer run on one core
+        }
+    }
+    return NULL;
+}
+
+static double Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static bool Queue_Test(void) {
+    pthread_t producer;
+    ParamMsg_t msg;
+    uint32_t expected = 0;
+    uint64_t empty_polls = 0;
+    bool ok = true;
+
+    ParamQueue_Init(&queue);
+    queue_full_spins = 0;
+    double t0 = Seconds();
+    pthread_create(&producer, NULL, Queue_Producer, NULL);
+    while (expected < queue_messages) {
+        if (!ParamQueue_Pop(&queue, &msg)) {
+            empty_polls++;
+            sched_yield();
+            continue;
+        }
+        if (msg.value != (int32_t)expected || msg.id != (expected & 0x7F)) {
+            printf("queue: message %u arrived as id %u value %d\n", expected,
+                   msg.id, msg.value);
+            ok = false;
+            break;
+        }
+        expected++;
+    }
+    pthread_join(producer, NULL);
+    double t = Seconds() - t0;
+
+    if (ok && ParamQueue_Pop(&queue, &msg)) {
+        printf("queue: extra message after the last one\n");
+        ok = false;
+    }
+    printf("queue   %u messages in order, %.1f M/s (%llu full, %llu empty "
+           "polls)  %s\n", expected, expected / t / 1e6,
+           (unsigned long long)queue_full_spins,
+           (unsigned long long)empty_polls, ok ? "OK" : "FAIL");
+    return ok;
+}
+
+//=============================================================================
+// ENGINE TEST
+//=============================================================================
+static uint32_t engine_calls;
+static uint32_t engine_seed;
+static atomic_uint blocks_rendered;
+static atomic_bool producer_done;
+
+static uint32_t Rand(uint32_t *x) {
+    *x ^= *x << 13;
+    *x ^= *x >> 17;
+    *x ^= *x << 5;
+    return *x;
+}
+
+/**
+ * @brief One random control-side call (the firmware's main loop API)
+ */
+static void Random_Call(uint32_t *rng, Joystick_t *joy, Accelerometer_t *acc) {
+    uint32_t r = Rand(rng);
+    uint32_t arg = r >> 8;
+
+    switch (r % 17) {
+    case 0:  Synth_NoteOn(); break;
+    case 1:  Synth_NoteOff(); break;
+    case 2:  Synth_SetPlaying(arg & 1); break;
+    case 3:  Synth_SetVolume((uint8_t)(arg % 120)); break;
+    case 4:  Synth_SetKey((MusicalKey_t)(arg % KEY_COUNT)); break;
+    case 5:  Synth_SetMode((MusicalMode_t)(arg % MODE_COUNT)); break;
+    case 6:  Synth_SetHarmony((HarmonicFunction_t)(arg % HARM_COUNT)); break;
+    case 7:  Synth_SetInstrument((Instrument_t)(arg % INSTRUMENT_COUNT)); break;
+    case 8:  Synth_SetPreset((uint8_t)(arg % SYNTH_PRESET_COUNT)); break;
+    case 9:  Synth_SetEffects(arg & 1); break;
+    case 10: Synth_SetChordMode((ChordMode_t)(arg % CHORD_MODE_COUNT)); break;
+    case 11: Synth_SetArpMode((ArpMode_t)(arg % ARP_MODE_COUNT)); break;
+    case 12: Synth_NextScale(); break;
+    case 13:
+        Synth_Button((SynthButton_t)(arg % 2),
+                     (SynthPress_t)(SYNTH_PRESS_SHORT + (arg >> 4) % 3));
+        break;
+    case 14: Synth_Reset(); break;
+    default:
+        // Joystick and accelerometer, as the main loop feeds them
+        Joystick_Update(joy, (uint16_t)(arg % 4096), (uint16_t)((arg >> 12) % 4096));
+        Accel_Update(acc, (int16_t)(Rand(rng) % 4096), (int16_t)(Rand(rng) % 4096),
+                     2048);
+        Synth_ProcessControls(joy, acc);
+        break;
+    }
+}
+
+static void Controls_Init(Joystick_t *joy, Accelerometer_t *acc) {
+    Joystick_Init(joy, 100);
+    Accel_Init(acc, 100);
+    Accel_Update(acc, 2048, 2849, 2048);
+}
+
+static void *Engine_Consumer(void *arg) {
+    int16_t mix[SYNTH_BLOCK_SIZE];
+    (void)arg;
+
+    while (!atomic_load(&producer_done)) {
+        Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+        atomic_fetch_add(&blocks_rendered, 1);
+        sched_yield();
+    }
+    for (int i = 0; i < SETTLE_BLOCKS; i++) {
+        Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+    }
+    return NULL;
+}
+
+// Bursts of calls; each waits for two blocks, so the queue drains between
+static void Engine_Threaded(SynthStatus_t *status) {
+    pthread_t consumer;
+    Joystick_t joy;
+    Accelerometer_t acc;
+    uint32_t rng = engine_seed;
+
+    Synth_Init(NULL);
+    Controls_Init(&joy, &acc);
+    atomic_store(&blocks_rendered, 0);
+    atomic_store(&producer_done, false);
+    pthread_create(&consumer, NULL, Engine_Consumer, NULL);
+
+    for (uint32_t i = 0; i < engine_calls; i += BURST_CALLS) {
+        unsigned start = atomic_load(&blocks_rendered);
+        for (uint32_t k = 0; k < BURST_CALLS && i + k < engine_calls; k++) {
+            Random_Call(&rng, &joy, &acc);
+        }
+        while (atomic_load(&blocks_rendered) - start < 2) {
+            sched_yield();
+        }
+    }
+    atomic_store(&producer_done, true);
+    pthread_join(consumer, NULL);
+    Synth_GetStatus(status);
+}
+
+// The same calls on one thread, one block after each burst
+static void Engine_Reference(SynthStatus_t *status) {
+    int16_t mix[SYNTH_BLOCK_SIZE];
+    Joystick_t joy;
+    Accelerometer_t acc;
+    uint32_t rng = engine_seed;
+
+    Synth_Init(NULL);
+    Controls_Init(&joy, &acc);
+    for (uint32_t i = 0; i < engine_calls; i += BURST_CALLS) {
+        for (uint32_t k = 0; k < BURST_CALLS && i + k < engine_calls; k++) {
+            Random_Call(&rng, &joy, &acc);
+        }
+        Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+    }
+    for (int i = 0; i < SETTLE_BLOCKS; i++) {
+        Synth_RenderBlock(mix, SYNTH_BLOCK_SIZE);
+    }
+    Synth_GetStatus(status);
+}
+
+static bool Engine_Test(void) {
+    SynthStatus_t ref, got;
+    bool ok = true;
+
+    Engine_Reference(&ref);
+    double t0 = Seconds();
+    Engine_Threaded(&got);
+    double t = Seconds() - t0;
+
+#define CHECK(field)                                                        \
+    if (got.field != ref.field) {                                           \
+        printf("engine: %s is %ld, reference %ld\n", #field,                \
+               (long)got.field, (long)ref.field);                           \
+        ok = false;                                                         \
+    }
+    CHECK(instrument) CHECK(preset) CHECK(key) CHECK(mode) CHECK(harmony)
+    CHECK(octave_shift) CHECK(effects_enabled) CHECK(chord_mode)
+    CHECK(arp_mode) CHECK(epic_active) CHECK(volume) CHECK(playing)
+    CHECK(frequency_hz) CHECK(pitch_hz) CHECK(phase_increment)
+#undef CHECK
+    if (got.param_overflows || ref.param_overflows) {
+        printf("engine: %u messages lost to a full queue\n",
+               got.param_overflows + ref.param_overflows);
+        ok = false;
+    }
+
+    printf("engine  %u calls over %u blocks, %.2f s, state matches the "
+           "reference  %s\n", engine_calls, atomic_load(&blocks_rendered), t,
+           ok ? "OK" : "FAIL");
+    return ok;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n messages] [-c calls] [-s seed]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    queue_messages = DEFAULT_MESSAGES;
+    engine_calls = DEFAULT_CALLS;
+    engine_seed = DEFAULT_SEED;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            queue_messages = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            engine_calls = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            engine_seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else {
+            Usage(argv[0]);
+        }
+    }
+    if (engine_seed == 0) Usage(argv[0]); // xorshift needs a non-zero state
+
+    bool ok = Queue_Test();
+    ok = Engine_Test() && ok;
+    return ok ? 0 : 1;
+}
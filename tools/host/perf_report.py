@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""
+Cycle-accounting report from the PERF zones (lib/perf/perf_zone.h)
+
+Reads a raw capture of UART_AUDIO and prints the last complete zone
+report: passes, total/avg/max cycles and each zone's share of the 80 MHz
+over the measured window. The firmware sends it together with the
+profiler dump when the audio load page is closed (debug builds only).
+
+Usage:
+    python uart_audio_player.py --midi --record capture.bin
+    python tools/host/perf_report.py capture.bin [--mclk 80000000] [--json]
+"""
+
+import argparse
+import json
+import sys
+
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_ID_NONCOMMERCIAL = 0x7D
+REPORT_HEADER = 0x05
+REPORT_ZONE = 0x06
+
+
+def unpack7(data, pos, nbytes):
+    """nbytes of 7-bit payload, LSB first"""
+    value = 0
+    for i in range(nbytes):
+        value |= (data[pos + i] & 0x7F) << (7 * i)
+    return value, pos + nbytes
+
+
+def sysex_frames(data):
+    """Yield the payload after F0 7D of every complete SysEx frame"""
+    pos = 0
+    while True:
+        start = data.find(bytes([SYSEX_START]), pos)
+        if start < 0:
+            return
+        end = data.find(bytes([SYSEX_END]), start + 1)
+        if end < 0:
+            return
+        frame = data[start + 1:end]
+        cut = next((i for i, b in enumerate(frame) if b & 0x80), None)
+        if cut is not None:
+            pos = start + 1 + cut
+            continue
+        if len(frame) >= 2 and frame[0] == SYSEX_ID_NONCOMMERCIAL:
+            yield frame[1:]
+        pos = end + 1
+
+
+def parse_report(data):
+    """(elapsed_cycles, [zone dicts]) of the last complete report, or None"""
+    report = None
+    current = None
+    for frame in sysex_frames(data):
+        if frame[0] == REPORT_HEADER and len(frame) == 12:
+            lo, pos = unpack7(frame, 1, 5)
+            hi, pos = unpack7(frame, pos, 5)
+            current = {'elapsed': lo | (hi << 32), 'count': frame[pos],
+                       'zones': {}}
+        elif frame[0] == REPORT_ZONE and current and len(frame) >= 22:
+            zone = frame[1]
+            count, pos = unpack7(frame, 2, 5)
+            lo, pos = unpack7(frame, pos, 5)
+            hi, pos = unpack7(frame, pos, 5)
+            peak, pos = unpack7(frame, pos, 5)
+            current['zones'][zone] = {
+                'name': bytes(frame[pos:]).decode('ascii', 'replace'),
+                'count': count, 'total': lo | (hi << 32), 'max': peak}
+            if len(current['zones']) == current['count']:
+                report = current
+                current = None
+    if report is None:
+        return None
+    return report['elapsed'], [report['zones'][k] for k in sorted(report['zones'])]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode a PERF zone report')
+    parser.add_argument('capture', help='Raw UART capture with the report')
+    parser.add_argument('--mclk', type=int, default=80000000)
+    parser.add_argument('--json', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        parsed = parse_report(f.read())
+    if parsed is None:
+        sys.exit(f"{args.capture}: no complete PERF report")
+    elapsed, zones = parsed
+
+    for z in zones:
+        z['avg'] = round(z['total'] / z['count'], 1) if z['count'] else 0.0
+        z['percent'] = (round(100.0 * z['total'] / elapsed, 2)
+                        if elapsed else 0.0)
+
+    if args.json:
+        print(json.dumps({'mclk_hz': args.mclk, 'elapsed_cycles': elapsed,
+                          'zones': zones}, indent=2))
+        return
+
+    seconds = elapsed / args.mclk
+    print(f"{seconds:.3f} s measured ({elapsed} cycles at "
+          f"{args.mclk / 1e6:g} MHz)")
+    print()
+    print(f"{'zone':<26} {'passes':>8} {'avg cyc':>10} {'max cyc':>10} "
+          f"{'total cyc':>13} {'% cpu':>7}")
+    for z in sorted(zones, key=lambda z: -z['total']):
+        print(f"{z['name']:<26} {z['count']:>8} {z['avg']:>10.0f} "
+              f"{z['max']:>10} {z['total']:>13} {z['percent']:>6.2f}%")
+
+
+if __name__ == '__main__':
+    main()
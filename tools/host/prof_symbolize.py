@@ -0,0 +1,277 @@
+#!/usr/bin/env python3
+"""
+Flat profile from a sampling-profiler dump (lib/perf/profiler.h)
+
+Reads a raw capture of UART_AUDIO (MIDI with the profiler's SysEx frames
+mixed in), takes the last complete dump and maps its PC buckets to
+functions using the firmware ELF (.out) or the linker .map file. Each
+bucket is shared between the functions it overlaps, by bytes.
+
+The ELF is preferred: its symbol table has sizes and static functions.
+A .map only lists global symbols, so static functions are counted in the
+global symbol before them.
+
+Usage:
+    python uart_audio_player.py --midi --record capture.bin
+    (JOY_SEL double click, play, double click again to dump)
+    python tools/host/prof_symbolize.py capture.bin --elf Debug/Motion_Music_Studio.out
+    python tools/host/prof_symbolize.py capture.bin --map Debug/Motion_Music_Studio.map
+
+    # Check against the recorded dump in golden/
+    cd tools/host
+    ./prof_symbolize.py golden/profile_capture.bin --map golden/profile.map \\
+        | diff golden/profile_expected.txt -
+
+Options:
+    --top N     Only the N hottest rows
+    --buckets   Raw bucket histogram (hottest first) instead of functions
+    --json      JSON instead of a table
+"""
+
+import argparse
+import bisect
+import json
+import re
+import struct
+import sys
+
+# SysEx framing (lib/midi/midi_msg.h, lib/perf/profiler.h)
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_ID_NONCOMMERCIAL = 0x7D
+REPORT_BEGIN = 0x02
+REPORT_DATA = 0x03
+REPORT_END = 0x04
+
+UNKNOWN = '<unknown>'
+
+
+# ============================================================================
+# DUMP
+# ============================================================================
+def unpack7(data, pos, nbytes):
+    """nbytes of 7-bit payload, LSB first"""
+    value = 0
+    for i in range(nbytes):
+        value |= (data[pos + i] & 0x7F) << (7 * i)
+    return value, pos + nbytes
+
+
+def sysex_frames(data):
+    """Yield the payload after F0 7D of every complete SysEx frame"""
+    pos = 0
+    while True:
+        start = data.find(bytes([SYSEX_START]), pos)
+        if start < 0:
+            return
+        end = data.find(bytes([SYSEX_END]), start + 1)
+        if end < 0:
+            return
+        frame = data[start + 1:end]
+        # A status byte inside means the frame was cut off; resync there
+        cut = next((i for i, b in enumerate(frame) if b & 0x80), None)
+        if cut is not None:
+            pos = start + 1 + cut
+            continue
+        if len(frame) >= 2 and frame[0] == SYSEX_ID_NONCOMMERCIAL:
+            yield frame[1:]
+        pos = end + 1
+
+
+class Profile:
+    def __init__(self, base, shift, buckets, samples, outside):
+        self.base = base
+        self.shift = shift
+        self.buckets = buckets
+        self.samples = samples
+        self.outside = outside
+        self.counts = {}
+
+
+def parse_dump(data):
+    """Last complete profile in the capture, or None"""
+    profile = None
+    complete = None
+    pairs = 0
+    for frame in sysex_frames(data):
+        report, pos = frame[0], 1
+        if report == REPORT_BEGIN and len(frame) == 20:
+            base, pos = unpack7(frame, pos, 5)
+            shift, pos = frame[pos], pos + 1
+            buckets, pos = unpack7(frame, pos, 3)
+            samples, pos = unpack7(frame, pos, 5)
+            outside, pos = unpack7(frame, pos, 5)
+            profile = Profile(base, shift, buckets, samples, outside)
+            pairs = 0
+        elif report == REPORT_DATA and profile and (len(frame) - 1) % 6 == 0:
+            while pos < len(frame):
+                index, pos = unpack7(frame, pos, 3)
+                count, pos = unpack7(frame, pos, 3)
+                if index < profile.buckets:
+                    profile.counts[index] = count
+                pairs += 1
+        elif report == REPORT_END and profile and len(frame) == 4:
+            expected, _ = unpack7(frame, pos, 3)
+            if expected != pairs:
+                print(f"warning: dump has {pairs} buckets, expected "
+                      f"{expected} (frames lost?)", file=sys.stderr)
+            complete = profile
+            profile = None
+    return complete
+
+
+# ============================================================================
+# SYMBOLS
+# ============================================================================
+def load_elf_symbols(path):
+    """(address, size, name) of the FUNC symbols of an ARM ELF32 file"""
+    with open(path, 'rb') as f:
+        elf = f.read()
+    if elf[:4] != b'\x7fELF' or elf[4] != 1 or elf[5] != 1:
+        sys.exit(f"{path}: not a little-endian ELF32 file")
+
+    shoff, = struct.unpack_from('<I', elf, 0x20)
+    shentsize, shnum = struct.unpack_from('<HH', elf, 0x2E)
+    sections = [struct.unpack_from('<IIIIIIIIII', elf, shoff + i * shentsize)
+                for i in range(shnum)]
+
+    symbols = []
+    for sec in sections:
+        if sec[1] != 2:                 # SHT_SYMTAB
+            continue
+        strtab = sections[sec[6]]       # sh_link
+        str_off = strtab[4]
+        for off in range(sec[4], sec[4] + sec[5], 16):
+            name_off, value, size, info, _, shndx = \
+                struct.unpack_from('<IIIBBH', elf, off)
+            if info & 0xF != 2 or shndx == 0:   # STT_FUNC, defined
+                continue
+            end = elf.index(b'\0', str_off + name_off)
+            name = elf[str_off + name_off:end].decode('ascii', 'replace')
+            symbols.append((value & ~1, size, name))
+    return symbols
+
+
+# TI linker: "address   name" after "GLOBAL SYMBOLS: SORTED BY Symbol Address"
+TI_SYMBOL = re.compile(r'^([0-9a-fA-F]{8})\s+(\S+)\s*$')
+# GNU ld: "                0x000001c8                Synth_RenderBlock"
+GNU_SYMBOL = re.compile(r'^\s+0x([0-9a-fA-F]{8,16})\s+([A-Za-z_.$][\w.$]*)\s*$')
+
+
+def load_map_symbols(path):
+    """(address, 0, name) from a TI or GNU linker map (sizes inferred later)"""
+    symbols = []
+    ti_section = False
+    with open(path, errors='replace') as f:
+        for line in f:
+            if line.startswith('GLOBAL SYMBOLS'):
+                ti_section = 'SORTED BY Symbol Address' in line
+                continue
+            m = TI_SYMBOL.match(line) if ti_section else GNU_SYMBOL.match(line)
+            if m:
+                symbols.append((int(m.group(1), 16) & ~1, 0, m.group(2)))
+    return symbols
+
+
+def function_ranges(symbols):
+    """Sorted, non-overlapping [start, end, name]; missing sizes run to the
+    next symbol"""
+    symbols = sorted(set(symbols))
+    ranges = []
+    for i, (addr, size, name) in enumerate(symbols):
+        if ranges and ranges[-1][0] == addr:
+            continue                    # Aliases: keep the first name
+        if size == 0:
+            later = [s[0] for s in symbols[i + 1:] if s[0] > addr]
+            size = (later[0] - addr) if later else 2
+        ranges.append([addr, addr + size, name])
+    for prev, cur in zip(ranges, ranges[1:]):
+        prev[1] = min(prev[1], cur[0])
+    return ranges
+
+
+# ============================================================================
+# ATTRIBUTION
+# ============================================================================
+def flat_profile(profile, ranges):
+    """{function: samples}, buckets shared by overlapping bytes"""
+    starts = [r[0] for r in ranges]
+    totals = {}
+    width = 1 << profile.shift
+    for index, count in profile.counts.items():
+        lo = profile.base + (index << profile.shift)
+        hi = lo + width
+        covered = 0
+        i = max(bisect.bisect_right(starts, lo) - 1, 0)
+        while i < len(ranges) and ranges[i][0] < hi:
+            start, end, name = ranges[i]
+            overlap = min(end, hi) - max(start, lo)
+            if overlap > 0:
+                totals[name] = totals.get(name, 0.0) + count * overlap / width
+                covered += overlap
+            i += 1
+        if covered < width:
+            totals[UNKNOWN] = (totals.get(UNKNOWN, 0.0) +
+                               count * (width - covered) / width)
+    return totals
+
+
+# ============================================================================
+# MAIN
+# ============================================================================
+def main():
+    parser = argparse.ArgumentParser(description='Symbolise a profiler dump')
+    parser.add_argument('capture', help='Raw UART capture with the dump')
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument('--elf', help='Firmware ELF (.out)')
+    group.add_argument('--map', help='Linker map (.map)')
+    parser.add_argument('--top', type=int, default=0)
+    parser.add_argument('--buckets', action='store_true')
+    parser.add_argument('--json', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        profile = parse_dump(f.read())
+    if profile is None:
+        sys.exit(f"{args.capture}: no complete profiler dump")
+
+    width = 1 << profile.shift
+    total = profile.samples + profile.outside
+    pct = (lambda n: 100.0 * n / total) if total else (lambda n: 0.0)
+
+    if args.buckets:
+        rows = [(f"0x{profile.base + (i << profile.shift):08x}", float(c))
+                for i, c in sorted(profile.counts.items(),
+                                   key=lambda kv: (-kv[1], kv[0]))]
+    else:
+        if not (args.elf or args.map):
+            parser.error('--elf or --map is needed (or use --buckets)')
+        symbols = (load_elf_symbols(args.elf) if args.elf
+                   else load_map_symbols(args.map))
+        totals = flat_profile(profile, function_ranges(symbols))
+        if profile.outside:
+            totals['<outside code range>'] = float(profile.outside)
+        rows = sorted(totals.items(), key=lambda kv: (-kv[1], kv[0]))
+    if args.top:
+        rows = rows[:args.top]
+
+    if args.json:
+        print(json.dumps({
+            'base': profile.base, 'bucket_bytes': width,
+            'samples': profile.samples, 'outside': profile.outside,
+            'rows': [{'name': n, 'samples': round(s, 2),
+                      'percent': round(pct(s), 2)} for n, s in rows]},
+            indent=2))
+        return
+
+    print(f"{total} samples, {len(profile.counts)} of {profile.buckets} "
+          f"buckets used ({width} bytes from 0x{profile.base:08x}), "
+          f"{profile.outside} outside")
+    print()
+    print(f"{'%':>6} {'samples':>9}  {'address' if args.buckets else 'function'}")
+    for name, samples in rows:
+        print(f"{pct(samples):6.2f} {samples:9.1f}  {name}")
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,355 @@
+/**
+ * @file synth_bench.c
+ * @brief Micro-Benchmarks for the Audio Kernels (Linux host)
+ * @version 1.0.0
+ *
+ * Times the per-sample kernels of lib/audio over a large number of samples
+ * and reports ns/sample and samples/s. Each kernel is run several times and
+ * the best run is reported, so the numbers are stable enough to compare
+ * between commits:
+ *   ./synth_bench --json > before.json
+ *   (change something, rebuild)
+ *   ./synth_bench --json > after.json
+ *   diff before.json after.json
+ *
+ * "One sample" is one call of the kernel, except chord-sample (one call
+ * renders all SYNTH_CHORD_VOICES voices). The checksum of every kernel's
+ * output is reported too: when it changes, the kernel's behaviour changed,
+ * not just its speed.
+ *
+ * The synth engine's private helpers (Generate_Chord_Sample,
+ * Update_Phase_Increment) are reached by including synth.c here, so
+ * synth.c is not linked separately.
+ *
+ * The same kernels are compiled for the target by "./build.sh m0"
+ * (-mcpu=cortex-m0plus -mthumb, BENCH_KERNELS_ONLY), which prints the code
+ * size of each kernel and runs them in the Cortex-M0+ simulator
+ * (m0_bench.c) for cycles per sample.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./synth_bench                    All kernels
+ *   ./synth_bench filter             Only kernels whose name contains "filter"
+ *   ./synth_bench -n 4000000 -r 9    Samples per run, runs per kernel
+ *   ./synth_bench --json             JSON instead of a table
+ */
+
+#include "../../lib/audio/synth.c"
+#include "audio/audio_biquad.h"
+#include "midi/midi_msg.h"
+
+//=============================================================================
+// KERNELS
+//=============================================================================
+// Every kernel processes n samples and returns a checksum of its output,
+// so the compiler cannot drop the work.
+
+#define BENCH_INPUT_SIZE 4096      // Power of two
+#define BENCH_PHASE_INC  118111601 // 440 Hz at 16 kHz
+
+static int16_t bench_input[BENCH_INPUT_SIZE];
+
+// Input for the filter kernels: saw plus a little noise (xorshift)
+static void Bench_Setup(void) {
+    uint32_t x = 2463534242u;
+    for (uint32_t i = 0; i < BENCH_INPUT_SIZE; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        int32_t saw = (int32_t)((i * 64u) & 0xFFFF) - 32768;
+        int32_t s = saw / 2 + (int32_t)(x & 0x3FFF) - 0x2000;
+        bench_input[i] = (int16_t)s;
+    }
+}
+
+static uint32_t Bench_Waveform(uint32_t n, Waveform_t waveform) {
+    uint32_t phase = 0;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        acc += (uint32_t)Audio_GenerateWaveform((uint8_t)(phase >> 24), waveform);
+        phase += BENCH_PHASE_INC;
+    }
+    return acc;
+}
+
+uint32_t Bench_WaveSine(uint32_t n) { return Bench_Waveform(n, WAVE_SINE); }
+uint32_t Bench_WaveSquare(uint32_t n) { return Bench_Waveform(n, WAVE_SQUARE); }
+uint32_t Bench_WaveSawtooth(uint32_t n) { return Bench_Waveform(n, WAVE_SAWTOOTH); }
+uint32_t Bench_WaveTriangle(uint32_t n) { return Bench_Waveform(n, WAVE_TRIANGLE); }
+
+// Retriggered every 4096 samples so all four stages are exercised
+uint32_t Bench_Envelope(uint32_t n) {
+    static const ADSR_Profile_t profile = {480, 9600, 700, 4800};
+    Envelope_t env;
+    Envelope_Init(&env, &profile);
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        if ((i & 0xFFF) == 0) Envelope_NoteOn(&env);
+        if ((i & 0xFFF) == 0xC00) Envelope_NoteOff(&env);
+        Envelope_Process(&env);
+        acc += Envelope_GetAmplitude(&env);
+    }
+    return acc;
+}
+
+uint32_t Bench_LowPass(uint32_t n) {
+    Filter_Reset();
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)Filter_LowPass(bench_input[i & (BENCH_INPUT_SIZE - 1)]);
+    return acc;
+}
+
+uint32_t Bench_LowPassAlpha(uint32_t n) {
+    Filter_Reset();
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)Filter_LowPassAlpha(bench_input[i & (BENCH_INPUT_SIZE - 1)], 192);
+    return acc;
+}
+
+uint32_t Bench_HighPass(uint32_t n) {
+    Filter_Reset();
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)Filter_HighPass(bench_input[i & (BENCH_INPUT_SIZE - 1)]);
+    return acc;
+}
+
+uint32_t Bench_SoftClip(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)Filter_SoftClip(bench_input[i & (BENCH_INPUT_SIZE - 1)], 16000);
+    return acc;
+}
+
+uint32_t Bench_HardClip(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)Filter_HardClip(bench_input[i & (BENCH_INPUT_SIZE - 1)], 20000);
+    return acc;
+}
+
+// Sweeps 55-7000 Hz so every compensation range is hit
+uint32_t Bench_GainFreqComp(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t freq = 55 + ((i >> 4) % 6945);
+        acc += (uint32_t)Filter_GainWithFreqCompensation(
+            bench_input[i & (BENCH_INPUT_SIZE - 1)], 8, freq);
+    }
+    return acc;
+}
+
+uint32_t Bench_Biquad(uint32_t n) {
+    BiquadFilter_t bq;
+    BiquadFilter_Init(&bq);
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += (uint32_t)BiquadFilter_Process(&bq, bench_input[i & (BENCH_INPUT_SIZE - 1)]);
+    return acc;
+}
+
+// Engine state as after Synth_Init(): PIANO, A4 major chord
+uint32_t Bench_ChordSample(uint32_t n) {
+    uint32_t phases[SYNTH_CHORD_VOICES] = {0};
+    uint32_t increments[SYNTH_CHORD_VOICES] = {118111601, 148813169, 176986423};
+    int16_t voices[SYNTH_CHORD_VOICES];
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        Generate_Chord_Sample(&INSTRUMENTS[INSTRUMENT_PIANO], phases, increments,
+                              voices);
+        acc += (uint32_t)(voices[0] + voices[1] + voices[2]);
+    }
+    return acc;
+}
+
+// Walks the note range and every octave shift, chord increments included
+uint32_t Bench_PhaseIncrement(uint32_t n) {
+    chord_mode = CHORD_MAJOR;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        base_frequency_hz = 65 + (i % 1000);
+        current_octave_shift = (int8_t)((int32_t)(i % 25) - 12);
+        Update_Phase_Increment();
+        acc += g_phase_increment + g_chord_increments[2];
+    }
+    chord_mode = CHORD_OFF;
+    current_octave_shift = 0;
+    base_frequency_hz = 440;
+    return acc;
+}
+
+uint32_t Bench_MidiNoteToFreq(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += MIDI_NoteToFreq((uint8_t)(i & 0x7F));
+    return acc;
+}
+
+uint32_t Bench_MidiFreqToNote(uint32_t n) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++)
+        acc += MIDI_FreqToNote((uint16_t)(i % 13000));
+    return acc;
+}
+
+uint32_t Bench_MidiCreate(uint32_t n) {
+    MIDI_Message_t msg;
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        switch (i & 3) {
+            case 0: MIDI_CreateNoteOn(0, (uint8_t)i, 100, &msg); break;
+            case 1: MIDI_CreateNoteOff(0, (uint8_t)i, 64, &msg); break;
+            case 2: MIDI_CreateControlChange(0, MIDI_CC_VOLUME, (uint8_t)i, &msg); break;
+            default: MIDI_CreateProgramChange(0, (uint8_t)i, &msg); break;
+        }
+        acc += msg.status + msg.data1 + msg.data2 + msg.length;
+    }
+    return acc;
+}
+
+//=============================================================================
+// KERNEL TABLE
+//=============================================================================
+// Also read by m0_bench from the target image (name and function pointers)
+
+typedef struct {
+    const char *name;
+    uint32_t (*run)(uint32_t n);
+} BenchKernel_t;
+
+const BenchKernel_t BENCH_KERNELS[] = {
+    {"wave-sine",          Bench_WaveSine},
+    {"wave-square",        Bench_WaveSquare},
+    {"wave-sawtooth",      Bench_WaveSawtooth},
+    {"wave-triangle",      Bench_WaveTriangle},
+    {"envelope",           Bench_Envelope},
+    {"filter-lowpass",     Bench_LowPass},
+    {"filter-lowpass-alpha", Bench_LowPassAlpha},
+    {"filter-highpass",    Bench_HighPass},
+    {"filter-softclip",    Bench_SoftClip},
+    {"filter-hardclip",    Bench_HardClip},
+    {"filter-gain-freqcomp", Bench_GainFreqComp},
+    {"biquad",             Bench_Biquad},
+    {"chord-sample",       Bench_ChordSample},
+    {"phase-increment",    Bench_PhaseIncrement},
+    {"midi-note-to-freq",  Bench_MidiNoteToFreq},
+    {"midi-freq-to-note",  Bench_MidiFreqToNote},
+    {"midi-create",        Bench_MidiCreate},
+};
+const uint32_t BENCH_KERNEL_COUNT = sizeof(BENCH_KERNELS) / sizeof(BENCH_KERNELS[0]);
+
+// Before the first kernel: input buffer and engine state
+void Bench_Init(void) {
+    Bench_Setup();
+    Synth_Init(NULL);
+}
+
+#ifndef BENCH_KERNELS_ONLY
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DEFAULT_SAMPLES  (1u << 22)
+#define DEFAULT_RUNS     5
+
+
+//=============================================================================
+// TIMING
+//=============================================================================
+static double Now_Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Best of runs; the checksum must be the same every run
+static double Bench_Time(const BenchKernel_t *k, uint32_t n, unsigned runs,
+                         uint32_t *checksum) {
+    double best = 0.0;
+    for (unsigned r = 0; r < runs; r++) {
+        double start = Now_Seconds();
+        uint32_t sum = k->run(n);
+        double t = Now_Seconds() - start;
+        if (r > 0 && sum != *checksum) {
+            fprintf(stderr, "%s: checksum differs between runs\n", k->name);
+            exit(1);
+        }
+        *checksum = sum;
+        if (r == 0 || t < best) best = t;
+    }
+    return best;
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [-n samples] [-r runs] [--json] [name-filter]\n",
+            prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    uint32_t samples = DEFAULT_SAMPLES;
+    unsigned runs = DEFAULT_RUNS;
+    const char *filter = NULL;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            samples = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            runs = (unsigned)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (samples == 0 || runs == 0) Usage(argv[0]);
+
+    Bench_Init();
+
+    if (json) {
+        printf("{\n  \"samples\": %u,\n  \"runs\": %u,\n  \"kernels\": [", samples,
+               runs);
+    } else {
+        printf("%u samples, best of %u runs\n\n", samples, runs);
+        printf("%-22s %10s %14s  %s\n", "kernel", "ns/sample", "samples/s",
+               "checksum");
+    }
+
+    bool first = true;
+    for (uint32_t i = 0; i < BENCH_KERNEL_COUNT; i++) {
+        const BenchKernel_t *k = &BENCH_KERNELS[i];
+        if (filter && strstr(k->name, filter) == NULL) continue;
+
+        uint32_t checksum = 0;
+        double t = Bench_Time(k, samples, runs, &checksum);
+        double ns = t * 1e9 / samples;
+        double rate = t > 0 ? samples / t : 0.0;
+
+        if (json) {
+            printf("%s\n    {\"name\": \"%s\", \"ns_per_sample\": %.3f, "
+                   "\"samples_per_s\": %.0f, \"checksum\": \"%08x\"}",
+                   first ? "" : ",", k->name, ns, rate, checksum);
+        } else {
+            printf("%-22s %10.3f %14.0f  %08x\n", k->name, ns, rate, checksum);
+        }
+        first = false;
+    }
+
+    if (json) printf("\n  ]\n}\n");
+    return 0;
+}
+
+#endif /* BENCH_KERNELS_ONLY */
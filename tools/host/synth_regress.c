@@ -0,0 +1,522 @@
+/**
+ * @file synth_regress.c
+ * @brief Golden-Audio Regression Suite (Linux host)
+ * @version 1.0.0
+ *
+ * Renders a fixed set of cases through the synth engine and compares each
+ * one with golden/reference.txt:
+ *   - every entry of INSTRUMENTS[] and PRESETS[]
+ *   - the full Greensleeves sequence (EPIC mode)
+ *   - major/minor chords and every arpeggiator mode
+ *   - the joystick/accelerometer control path
+ *
+ * A case is "exact" when the checksum matches. Otherwise it passes when the
+ * RMS, the long-term spectrum (16 log-spaced bands) and the loudness contour
+ * (250 ms segments) stay within tolerance, and fails when they do not. Each
+ * case also reports host cycles per rendered second.
+ *
+ * The engine uses its integer wavetable sine (no libm hook) and no cycle
+ * counter, so the references are bit-exact on any host.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./synth_regress                  Check all cases (exit 1 on failure)
+ *   ./synth_regress preset           Only cases whose name contains "preset"
+ *   ./synth_regress --update         Rewrite the references
+ *   ./synth_regress --wav /tmp/gold  Also write each render as a WAV file
+ */
+
+#include "synth_script.h"
+#include "output/audio_out.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define REFERENCE_FILE   "golden/reference.txt"
+#define MAX_CASES        32
+#define SCRIPT_CHARS     1024
+
+#define FFT_SIZE         1024
+#define BAND_COUNT       16
+#define BAND_LOW_HZ      40.0
+#define BAND_HIGH_HZ     8000.0
+#define SEGMENT_MS       250
+#define MAX_SEGMENTS     160         // 40 s
+
+#define FLOOR_DB         -100.0
+#define TOL_RMS_DB       0.5
+#define TOL_BAND_DB      1.5         // Bands above BAND_GATE_DB
+#define BAND_GATE_DB     -80.0
+#define TOL_SEGMENT_DB   1.0         // Segments above SEGMENT_GATE_DB
+#define SEGMENT_GATE_DB  -60.0
+
+//=============================================================================
+// TYPES
+//=============================================================================
+typedef struct {
+    char name[40];
+    char script[SCRIPT_CHARS];
+} Case_t;
+
+typedef struct {
+    uint32_t samples;
+    uint32_t checksum;                 ///< FNV-1a over the 16-bit samples
+    double rms_db;
+    double band_db[BAND_COUNT];
+    uint16_t segments;
+    double segment_db[MAX_SEGMENTS];
+} Metrics_t;
+
+typedef struct {
+    char name[40];
+    Metrics_t m;
+} Reference_t;
+
+//=============================================================================
+// CASES
+//=============================================================================
+
+// Same four-chord progression for every instrument and preset
+#define PROGRESSION \
+    "0 harmony 4\n500 harmony 8\n1000 harmony 9\n1500 harmony 7\n" \
+    "2000 note_off\n3000 end\n"
+
+static Case_t cases[MAX_CASES];
+static uint8_t case_count;
+
+static void Add_Case(const char *name, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void Add_Case(const char *name, const char *fmt, ...) {
+    Case_t *c = &cases[case_count++];
+    va_list ap;
+
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    va_start(ap, fmt);
+    vsnprintf(c->script, sizeof(c->script), fmt, ap);
+    va_end(ap);
+}
+
+static void Lowercase(char *dst, const char *src, size_t size) {
+    size_t i;
+    for (i = 0; src[i] && i + 1 < size; i++) {
+        dst[i] = (char)tolower((unsigned char)src[i]);
+    }
+    dst[i] = '\0';
+}
+
+static void Build_Cases(void) {
+    static const char *const ARP_WORDS[ARP_MODE_COUNT] = {
+        "off", "up", "down", "updown", "random"};
+    char name[40], word[16];
+
+    Synth_Init(NULL); // Names come from the bank it loads
+    for (uint8_t i = 0; i < INSTRUMENT_COUNT; i++) {
+        Lowercase(word, INSTRUMENTS[i].name, sizeof(word));
+        snprintf(name, sizeof(name), "instrument-%s", word);
+        Add_Case(name, "0 instrument %s\n" PROGRESSION, word);
+    }
+    for (uint8_t p = 0; p < SYNTH_PRESET_COUNT; p++) {
+        Lowercase(word, PRESETS[p].name, sizeof(word));
+        snprintf(name, sizeof(name), "preset-%s", word);
+        Add_Case(name, "0 preset %u\n" PROGRESSION, p);
+    }
+
+    // 16 steps of 2 s, then back to the first step
+    Add_Case("epic-greensleeves", "0 epic\n33000 end\n");
+
+    Add_Case("chord-major-organ",
+             "0 instrument organ\n0 chord major\n" PROGRESSION);
+    Add_Case("chord-minor-strings",
+             "0 instrument strings\n0 mode minor\n0 chord minor\n" PROGRESSION);
+    for (uint8_t a = ARP_UP; a < ARP_MODE_COUNT; a++) {
+        snprintf(name, sizeof(name), "arp-%s", ARP_WORDS[a]);
+        Add_Case(name, "0 instrument piano\n0 arp %s\n" PROGRESSION,
+                 ARP_WORDS[a]);
+    }
+    // Off the 2000-sample grid of 120 BPM: steps on fractional clocks
+    Add_Case("arp-up-tempo-97",
+             "0 instrument piano\n0 tempo 97\n0 arp up\n" PROGRESSION);
+
+    Add_Case("controls",
+             "0 instrument lead\n"
+             "0 joy 3500 2048\n100 joy 2048 2048\n"        // Key C -> D
+             "500 joy 2048 3500\n600 joy 2048 2048\n"      // Volume up
+             "1000 accel 3000 2849 2048\n"                 // Harmony
+             "1500 accel 3000 3500 2048\n"                 // Octave up
+             "2000 accel 3000 1800 2048\n"                 // Octave down
+             "2500 button s1 long\n"                       // Minor
+             "3000 button s1 double\n"                     // Effects off
+             "3500 note_off\n4500 end\n");
+
+    // Multi-timbral parts alone: bass (ch 2), pad chord (ch 3), lead with
+    // bend (ch 4); the piano (ch 5) fills the pool and steals from the pad
+    Add_Case("parts",
+             "0 play off\n"
+             "0 midi 0x91 36 100\n"
+             "0 midi 0x92 60 80\n0 midi 0x92 64 80\n0 midi 0x92 67 80\n"
+             "500 midi 0x93 72 110\n1000 midi 0x93 74 110\n"
+             "1500 midi 0x83 72 0\n1500 midi 0xE3 0 80\n"
+             "2000 midi 0x92 71 80\n"
+             "2000 midi 0x94 48 90\n2000 midi 0x94 55 90\n"
+             "2500 part 1 volume 60\n2500 midi 0x91 43 100\n"
+             "3000 midi 0xB2 123 0\n3000 midi 0xB4 123 0\n"
+             "3000 midi 0x81 43 0\n3000 midi 0x83 74 0\n"
+             "4000 end\n");
+}
+
+//=============================================================================
+// ANALYSIS
+//=============================================================================
+static double To_Db(double power) {
+    double db = (power > 0.0) ? 10.0 * log10(power) : FLOOR_DB;
+    return db < FLOOR_DB ? FLOOR_DB : db;
+}
+
+// In-place radix-2 FFT
+static void Fft(double *re, double *im, uint16_t n) {
+    for (uint16_t i = 1, j = 0; i < n; i++) {
+        uint16_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            double t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (uint16_t len = 2; len <= n; len <<= 1) {
+        double ang = -2.0 * M_PI / len;
+        for (uint16_t i = 0; i < n; i += len) {
+            for (uint16_t k = 0; k < len / 2; k++) {
+                double wr = cos(ang * k), wi = sin(ang * k);
+                double xr = re[i + k + len / 2] * wr - im[i + k + len / 2] * wi;
+                double xi = re[i + k + len / 2] * wi + im[i + k + len / 2] * wr;
+                re[i + k + len / 2] = re[i + k] - xr;
+                im[i + k + len / 2] = im[i + k] - xi;
+                re[i + k] += xr;
+                im[i + k] += xi;
+            }
+        }
+    }
+}
+
+static void Analyze(const int16_t *pcm, uint32_t n, Metrics_t *m) {
+    static double re[FFT_SIZE], im[FFT_SIZE];
+    double spectrum[FFT_SIZE / 2] = {0};
+    double sum = 0.0;
+    uint32_t hash = 2166136261u;
+
+    memset(m, 0, sizeof(*m));
+    m->samples = n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        double x = pcm[i] / 32768.0;
+        sum += x * x;
+        hash = (hash ^ (uint8_t)pcm[i]) * 16777619u;
+        hash = (hash ^ (uint8_t)((uint16_t)pcm[i] >> 8)) * 16777619u;
+    }
+    m->checksum = hash;
+    m->rms_db = To_Db(n ? sum / n : 0.0);
+
+    // Loudness contour
+    uint32_t seg_len = SYNTH_SAMPLE_RATE_HZ * SEGMENT_MS / 1000;
+    for (uint32_t s = 0; s < n && m->segments < MAX_SEGMENTS; s += seg_len) {
+        uint32_t len = (n - s < seg_len) ? n - s : seg_len;
+        double e = 0.0;
+        for (uint32_t i = 0; i < len; i++) {
+            double x = pcm[s + i] / 32768.0;
+            e += x * x;
+        }
+        m->segment_db[m->segments++] = To_Db(e / len);
+    }
+
+    // Long-term spectrum: Hann frames, power averaged, summed into bands
+    uint32_t frames = 0;
+    for (uint32_t f = 0; f + FFT_SIZE <= n; f += FFT_SIZE, frames++) {
+        for (uint16_t i = 0; i < FFT_SIZE; i++) {
+            double w = 0.5 - 0.5 * cos(2.0 * M_PI * i / (FFT_SIZE - 1));
+            re[i] = pcm[f + i] / 32768.0 * w;
+            im[i] = 0.0;
+        }
+        Fft(re, im, FFT_SIZE);
+        for (uint16_t k = 0; k < FFT_SIZE / 2; k++) {
+            spectrum[k] += re[k] * re[k] + im[k] * im[k];
+        }
+    }
+    double bin_hz = (double)SYNTH_SAMPLE_RATE_HZ / FFT_SIZE;
+    double ratio = pow(BAND_HIGH_HZ / BAND_LOW_HZ, 1.0 / BAND_COUNT);
+    for (uint8_t b = 0; b < BAND_COUNT; b++) {
+        double lo = BAND_LOW_HZ * pow(ratio, b), hi = lo * ratio;
+        double p = 0.0;
+        for (uint16_t k = 1; k < FFT_SIZE / 2; k++) {
+            double hz = k * bin_hz;
+            if (hz >= lo && hz < hi) p += spectrum[k];
+        }
+        // Normalised so a full-scale sine reads about 0 dB in its band
+        m->band_db[b] = To_Db(frames ? p * 8.0 / frames / FFT_SIZE / FFT_SIZE : 0.0);
+    }
+}
+
+/**
+ * @brief Largest deviation from the reference, in units of its tolerance
+ * @return <= 1.0 when within tolerance
+ */
+static double Compare(const Metrics_t *ref, const Metrics_t *m, char *why,
+                      size_t size) {
+    double worst = fabs(m->rms_db - ref->rms_db) / TOL_RMS_DB;
+    snprintf(why, size, "rms %+.2f dB", m->rms_db - ref->rms_db);
+
+    if (m->samples != ref->samples) {
+        snprintf(why, size, "length %u, expected %u", m->samples, ref->samples);
+        return INFINITY;
+    }
+    for (uint8_t b = 0; b < BAND_COUNT; b++) {
+        if (ref->band_db[b] < BAND_GATE_DB && m->band_db[b] < BAND_GATE_DB) continue;
+        double d = fabs(m->band_db[b] - ref->band_db[b]) / TOL_BAND_DB;
+        if (d > worst) {
+            worst = d;
+            snprintf(why, size, "band %u %+.2f dB", b, m->band_db[b] - ref->band_db[b]);
+        }
+    }
+    for (uint16_t s = 0; s < m->segments && s < ref->segments; s++) {
+        if (ref->segment_db[s] < SEGMENT_GATE_DB && m->segment_db[s] < SEGMENT_GATE_DB) {
+            continue;
+        }
+        double d = fabs(m->segment_db[s] - ref->segment_db[s]) / TOL_SEGMENT_DB;
+        if (d > worst) {
+            worst = d;
+            snprintf(why, size, "%u ms %+.2f dB", s * SEGMENT_MS,
+                     m->segment_db[s] - ref->segment_db[s]);
+        }
+    }
+    return worst;
+}
+
+//=============================================================================
+// REFERENCES
+//=============================================================================
+static Reference_t refs[MAX_CASES];
+static uint8_t ref_count;
+
+static void Load_References(const char *path) {
+    FILE *f = fopen(path, "r");
+    char line[4096];
+    Reference_t *r = NULL;
+
+    if (f == NULL) return;
+    while (fgets(line, sizeof(line), f)) {
+        char *p = line;
+        int used;
+
+        if (strncmp(p, "case ", 5) == 0 && ref_count < MAX_CASES) {
+            r = &refs[ref_count++];
+            memset(r, 0, sizeof(*r));
+            sscanf(p + 5, "%39s %u %x %lf", r->name, &r->m.samples,
+                   &r->m.checksum, &r->m.rms_db);
+        } else if (strncmp(p, "bands ", 6) == 0 && r) {
+            p += 6;
+            for (uint8_t b = 0; b < BAND_COUNT; b++, p += used) {
+                if (sscanf(p, "%lf%n", &r->m.band_db[b], &used) != 1) break;
+            }
+        } else if (strncmp(p, "env ", 4) == 0 && r) {
+            p += 4;
+            while (r->m.segments < MAX_SEGMENTS &&
+                   sscanf(p, "%lf%n", &r->m.segment_db[r->m.segments], &used) == 1) {
+                r->m.segments++;
+                p += used;
+            }
+        }
+    }
+    fclose(f);
+}
+
+static Reference_t *Find_Reference(const char *name) {
+    for (uint8_t i = 0; i < ref_count; i++) {
+        if (strcmp(refs[i].name, name) == 0) return &refs[i];
+    }
+    return NULL;
+}
+
+static void Write_Reference(FILE *f, const char *name, const Metrics_t *m) {
+    fprintf(f, "case %s %u %08x %.2f\nbands", name, m->samples, m->checksum,
+            m->rms_db);
+    for (uint8_t b = 0; b < BAND_COUNT; b++) fprintf(f, " %.2f", m->band_db[b]);
+    fprintf(f, "\nenv");
+    for (uint16_t s = 0; s < m->segments; s++) fprintf(f, " %.1f", m->segment_db[s]);
+    fprintf(f, "\n");
+}
+
+//=============================================================================
+// RENDERING
+//=============================================================================
+static uint64_t Host_Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;  // ns
+#endif
+}
+
+/**
+ * @brief Render one case into pcm (malloc'ed)
+ * @return Samples rendered; *cycles = host cycles spent in the engine
+ */
+static uint32_t Render_Case(const Case_t *c, int16_t **pcm, uint64_t *cycles) {
+    static const SynthPlatform_t platform = {NULL, NULL, NULL};
+    Script_t script;
+    ScriptPlayer_t player;
+    uint16_t n;
+
+    Script_LoadText(&script, c->script, c->name);
+    Synth_Init(&platform);
+    ScriptPlayer_Start(&player, &script, 0);
+
+    *pcm = malloc((size_t)player.total * sizeof(int16_t) + SYNTH_BLOCK_SIZE * 2);
+    if (*pcm == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    *cycles = 0;
+    for (;;) {
+        uint64_t t0 = Host_Cycles();
+        n = ScriptPlayer_Render(&player, *pcm + player.rendered);
+        *cycles += Host_Cycles() - t0;
+        if (n == 0) break;
+    }
+    Script_Free(&script);
+    return (uint32_t)player.rendered;
+}
+
+static void Write_Wav(const char *dir, const Case_t *c, const int16_t *pcm,
+                      uint32_t n) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.wav", dir, c->name);
+    const AudioOutConfig_t cfg = {SYNTH_SAMPLE_RATE_HZ, SYNTH_BLOCK_SIZE,
+                                  NULL, NULL, NULL, path};
+    if (!AUDIO_OUT.open(&cfg)) {
+        perror(path);
+        return;
+    }
+    for (uint32_t i = 0; i < n; i += SYNTH_BLOCK_SIZE) {
+        uint32_t len = (n - i < SYNTH_BLOCK_SIZE) ? n - i : SYNTH_BLOCK_SIZE;
+        AUDIO_OUT.submit_block(pcm + i, (uint16_t)len);
+    }
+    AUDIO_OUT.close();
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s [--update] [--ref file] [--wav dir] [filter]\n",
+            prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *ref_path = REFERENCE_FILE;
+    const char *wav_dir = NULL;
+    const char *filter = NULL;
+    bool update = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) {
+            update = true;
+        } else if (strcmp(argv[i], "--ref") == 0 && i + 1 < argc) {
+            ref_path = argv[++i];
+        } else if (strcmp(argv[i], "--wav") == 0 && i + 1 < argc) {
+            wav_dir = argv[++i];
+        } else if (argv[i][0] == '-') {
+            Usage(argv[0]);
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    Build_Cases();
+    Load_References(ref_path);
+
+    FILE *out = NULL;
+    if (update) {
+        out = fopen(ref_path, "w");
+        if (out == NULL) {
+            perror(ref_path);
+            return 1;
+        }
+        fprintf(out, "# Golden-audio references for synth_regress.\n"
+                     "# Regenerate with ./synth_regress --update after an "
+                     "intended change in sound.\n");
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    const char *unit = "Mcyc/s";
+#else
+    const char *unit = "Mns/s";
+#endif
+    printf("%-22s %-8s %8s %10s  %s\n", "case", "result", "rms dB", unit, "detail");
+
+    unsigned exact = 0, close = 0, failed = 0, missing = 0;
+    for (uint8_t i = 0; i < case_count; i++) {
+        const Case_t *c = &cases[i];
+        Reference_t *ref = Find_Reference(c->name);
+        int16_t *pcm;
+        uint64_t cycles;
+        Metrics_t m;
+        char why[64] = "";
+        const char *result;
+
+        bool selected = (filter == NULL || strstr(c->name, filter) != NULL);
+        if (!selected) {
+            // Keep unselected references when rewriting
+            if (out && ref) Write_Reference(out, ref->name, &ref->m);
+            continue;
+        }
+
+        uint32_t n = Render_Case(c, &pcm, &cycles);
+        Analyze(pcm, n, &m);
+        if (wav_dir) Write_Wav(wav_dir, c, pcm, n);
+        free(pcm);
+
+        if (out) {
+            Write_Reference(out, c->name, &m);
+            result = "updated";
+        } else if (ref == NULL) {
+            result = "MISSING";
+            missing++;
+        } else if (ref->m.checksum == m.checksum && ref->m.samples == m.samples) {
+            result = "exact";
+            exact++;
+        } else if (Compare(&ref->m, &m, why, sizeof(why)) <= 1.0) {
+            result = "~tol";
+            close++;
+        } else {
+            result = "FAIL";
+            failed++;
+        }
+
+        double seconds = (double)n / SYNTH_SAMPLE_RATE_HZ;
+        printf("%-22s %-8s %8.2f %10.2f  %s\n", c->name, result, m.rms_db,
+               cycles / seconds / 1e6, why);
+    }
+
+    if (out) {
+        fclose(out);
+        printf("references written to %s\n", ref_path);
+        return 0;
+    }
+    printf("%u exact, %u within tolerance, %u failed, %u missing\n", exact,
+           close, failed, missing);
+    return (failed || missing) ? 1 : 0;
+}
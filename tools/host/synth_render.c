@@ -0,0 +1,123 @@
+/**
+ * @file synth_render.c
+ * @brief Offline Synth Renderer (Linux host)
+ * @version 1.0.0
+ *
+ * Runs the firmware's synth engine (lib/audio/synth.c) on the PC with a stub
+ * platform and renders a timestamped control script to a WAV file, faster
+ * than real time. The WAV file is written by the AUDIO_OUT_WAV backend, so
+ * the samples are exactly what the firmware hands to its output backend.
+ *
+ * Usage:
+ *   ./build.sh
+ *   ./synth_render scripts/demo.txt -o demo.wav
+ *
+ * Options:
+ *   -o <file>   Output WAV (default out.wav)
+ *   -t <ms>     Tail rendered after the last event when there is no "end"
+ *               (default 2000)
+ *
+ * Script format: see synth_script.h.
+ */
+
+#include "synth_script.h"
+#include "output/audio_out.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define DEFAULT_TAIL_MS 2000
+
+//=============================================================================
+// STUB PLATFORM
+//=============================================================================
+
+// Same scale as MATHACL_Sine() in main.c (+/-1024)
+static int16_t Host_Sine(uint32_t phase) {
+    return (int16_t)(sin(phase * (2.0 * M_PI / 4294967296.0)) * 1024.0);
+}
+
+// No cycle counter: the FX budget is never enforced, so renders are
+// deterministic
+static const SynthPlatform_t HOST_PLATFORM = {Host_Sine, NULL, NULL};
+
+//=============================================================================
+// MAIN
+//=============================================================================
+static double Now_Seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void Usage(const char *prog) {
+    fprintf(stderr, "usage: %s <script|-> [-o out.wav] [-t tail_ms]\n", prog);
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *wav_path = "out.wav";
+    uint32_t tail_ms = DEFAULT_TAIL_MS;
+
+    const char *script_path = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            wav_path = argv[++i];
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            tail_ms = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            Usage(argv[0]);
+        } else {
+            script_path = argv[i];
+        }
+    }
+    if (script_path == NULL) Usage(argv[0]);
+
+    Script_t script;
+    Script_LoadFile(&script, script_path);
+
+    Synth_Init(&HOST_PLATFORM);
+    ScriptPlayer_t player;
+    ScriptPlayer_Start(&player, &script, tail_ms);
+
+    const AudioOutConfig_t cfg = {SYNTH_SAMPLE_RATE_HZ, SYNTH_BLOCK_SIZE,
+                                  NULL, NULL, NULL, wav_path};
+    if (!AUDIO_OUT.open(&cfg)) {
+        perror(wav_path);
+        return 1;
+    }
+
+    int16_t mix[SYNTH_BLOCK_SIZE];
+    int32_t peak = 0;
+    uint16_t gr_max = 0;
+    uint16_t n;
+    double start = Now_Seconds();
+
+    while ((n = ScriptPlayer_Render(&player, mix)) > 0) {
+        AUDIO_OUT.submit_block(mix, n);
+
+        for (uint16_t i = 0; i < n; i++) {
+            int32_t a = mix[i] < 0 ? -mix[i] : mix[i];
+            if (a > peak) peak = a;
+        }
+        SynthStatus_t status;
+        Synth_GetStatus(&status);
+        if (status.limiter_gr_db10 > gr_max) gr_max = status.limiter_gr_db10;
+    }
+
+    double wall = Now_Seconds() - start;
+    AUDIO_OUT.close();
+    Script_Free(&script);
+
+    double seconds = (double)player.rendered / SYNTH_SAMPLE_RATE_HZ;
+    printf("%s: %.3f s rendered in %.3f s (%.0fx real time)\n", wav_path,
+           seconds, wall, wall > 0 ? seconds / wall : 0.0);
+    printf("peak %.1f dBFS, limiter max %.1f dB\n",
+           peak ? 20.0 * log10(peak / 32768.0) : -INFINITY, gr_max / 10.0);
+    return 0;
+}
@@ -0,0 +1,372 @@
+/**
+ * @file synth_script.c
+ * @brief Control Script Parser and Player
+ */
+
+#include "synth_script.h"
+#include "midi/midi_clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+//=============================================================================
+// CONFIGURATION
+//=============================================================================
+#define LINE_MAX_CHARS 256
+
+//=============================================================================
+// PARSER
+//=============================================================================
+typedef struct {
+    const char *name;
+    ScriptCommand_t cmd;
+    uint8_t nargs;
+} CommandInfo_t;
+
+static const CommandInfo_t COMMANDS[] = {
+    {"note_on", CMD_NOTE_ON, 0},
+    {"note_off", CMD_NOTE_OFF, 0},
+    {"play", CMD_PLAY, 1},
+    {"key", CMD_KEY, 1},
+    {"mode", CMD_MODE, 1},
+    {"harmony", CMD_HARMONY, 1},
+    {"volume", CMD_VOLUME, 1},
+    {"joy", CMD_JOY, 2},
+    {"accel", CMD_ACCEL, 3},
+    {"button", CMD_BUTTON, 2},
+    {"instrument", CMD_INSTRUMENT, 1},
+    {"preset", CMD_PRESET, 1},
+    {"chord", CMD_CHORD, 1},
+    {"arp", CMD_ARP, 1},
+    {"tempo", CMD_TEMPO, 1},
+    {"effects", CMD_EFFECTS, 1},
+    {"epic", CMD_EPIC, 0},
+    {"midi", CMD_MIDI, 3},
+    {"part", CMD_PART, 3},
+    {"end", CMD_END, 0},
+};
+
+// Word arguments: index in the list is the value
+static const char *const ON_OFF[] = {"off", "on", NULL};
+static const char *const KEYS[] = {"C", "D", "E", "F", "G", "A", "B", NULL};
+static const char *const MODES[] = {"major", "minor", NULL};
+static const char *const BUTTONS[] = {"s1", "s2", "joy", NULL};
+static const char *const PRESSES[] = {"none", "short", "long", "double", NULL};
+static const char *const INSTRUMENT_NAMES[] = {"piano", "organ", "strings",
+                                               "bass", "lead", NULL};
+static const char *const CHORDS[] = {"off", "major", "minor", NULL};
+static const char *const ARPS[] = {"off", "up", "down", "updown", "random",
+                                   NULL};
+static const char *const PART_PARAMS[] = {"channel", "instrument", "volume",
+                                          "pan", "voices", "priority", NULL};
+
+static const char *script_name;
+
+static void Script_Error(unsigned line, const char *msg, const char *arg) {
+    fprintf(stderr, "%s:%u: %s%s%s\n", script_name, line, msg,
+            arg ? ": " : "", arg ? arg : "");
+    exit(1);
+}
+
+static int32_t Parse_Word(const char *tok, const char *const *words,
+                          unsigned line) {
+    for (int32_t i = 0; words[i]; i++) {
+        if (strcasecmp(tok, words[i]) == 0) return i;
+    }
+    Script_Error(line, "unknown value", tok);
+    return 0;
+}
+
+static int32_t Parse_Number(const char *tok, int32_t min, int32_t max,
+                            unsigned line) {
+    char *end;
+    long v = strtol(tok, &end, 0);
+    if (*end != '\0' || v < min || v > max) {
+        Script_Error(line, "bad number", tok);
+    }
+    return (int32_t)v;
+}
+
+static void Parse_Args(ScriptEvent_t *ev, char **tok) {
+    unsigned line = ev->line;
+
+    switch (ev->cmd) {
+    case CMD_PLAY:
+    case CMD_EFFECTS:
+        ev->arg[0] = Parse_Word(tok[0], ON_OFF, line);
+        break;
+    case CMD_KEY:
+        ev->arg[0] = Parse_Word(tok[0], KEYS, line);
+        break;
+    case CMD_MODE:
+        ev->arg[0] = Parse_Word(tok[0], MODES, line);
+        break;
+    case CMD_HARMONY:
+        ev->arg[0] = Parse_Number(tok[0], 0, HARM_COUNT - 1, line);
+        break;
+    case CMD_VOLUME:
+        ev->arg[0] = Parse_Number(tok[0], 0, 100, line);
+        break;
+    case CMD_JOY:
+    case CMD_ACCEL:
+        for (uint8_t i = 0; i < (ev->cmd == CMD_JOY ? 2 : 3); i++) {
+            ev->arg[i] = Parse_Number(tok[i], 0, 4095, line);
+        }
+        break;
+    case CMD_BUTTON:
+        ev->arg[0] = Parse_Word(tok[0], BUTTONS, line);
+        ev->arg[1] = Parse_Word(tok[1], PRESSES, line);
+        break;
+    case CMD_INSTRUMENT:
+        ev->arg[0] = Parse_Word(tok[0], INSTRUMENT_NAMES, line);
+        break;
+    case CMD_PRESET:
+        ev->arg[0] = Parse_Number(tok[0], 0, SYNTH_PRESET_COUNT - 1, line);
+        break;
+    case CMD_CHORD:
+        ev->arg[0] = Parse_Word(tok[0], CHORDS, line);
+        break;
+    case CMD_ARP:
+        ev->arg[0] = Parse_Word(tok[0], ARPS, line);
+        break;
+    case CMD_TEMPO:
+        ev->arg[0] = Parse_Number(tok[0], MIDI_CLOCK_MIN_BPM,
+                                  MIDI_CLOCK_MAX_BPM, line);
+        break;
+    case CMD_MIDI:
+        ev->arg[0] = Parse_Number(tok[0], 0x80, 0xEF, line);
+        ev->arg[1] = Parse_Number(tok[1], 0, 127, line);
+        ev->arg[2] = Parse_Number(tok[2], 0, 127, line);
+        break;
+    case CMD_PART:
+        ev->arg[0] = Parse_Number(tok[0], 0, SYNTH_PART_COUNT - 1, line);
+        ev->arg[1] = Parse_Word(tok[1], PART_PARAMS, line);
+        ev->arg[2] = Parse_Number(tok[2], -64, 127, line);
+        break;
+    default:
+        break;
+    }
+}
+
+static void Script_Parse(Script_t *script, FILE *f, const char *name) {
+    ScriptEvent_t **events = &script->events;
+    char buf[LINE_MAX_CHARS];
+    size_t count = 0, cap = 0;
+    uint32_t last_ms = 0;
+    unsigned line = 0;
+
+    script_name = name;
+    *events = NULL;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        char *tok[6];
+        uint8_t ntok = 0;
+
+        line++;
+        char *hash = strchr(buf, '#');
+        if (hash) *hash = '\0';
+        for (char *t = strtok(buf, " \t\r\n"); t && ntok < 6;
+             t = strtok(NULL, " \t\r\n")) {
+            tok[ntok++] = t;
+        }
+        if (ntok == 0) continue;
+
+        ScriptEvent_t ev = {0};
+        ev.line = line;
+        ev.time_ms = (uint32_t)Parse_Number(tok[0], 0, INT32_MAX, line);
+        if (ev.time_ms < last_ms) {
+            Script_Error(line, "time goes backwards", tok[0]);
+        }
+        last_ms = ev.time_ms;
+
+        if (ntok < 2) Script_Error(line, "missing command", NULL);
+        const CommandInfo_t *info = NULL;
+        for (size_t i = 0; i < sizeof(COMMANDS) / sizeof(COMMANDS[0]); i++) {
+            if (strcmp(tok[1], COMMANDS[i].name) == 0) info = &COMMANDS[i];
+        }
+        if (info == NULL) Script_Error(line, "unknown command", tok[1]);
+        if (ntok - 2 != info->nargs) {
+            Script_Error(line, "wrong number of arguments", tok[1]);
+        }
+        ev.cmd = info->cmd;
+        Parse_Args(&ev, &tok[2]);
+
+        if (count == cap) {
+            cap = cap ? cap * 2 : 64;
+            *events = realloc(*events, cap * sizeof(ScriptEvent_t));
+            if (*events == NULL) {
+                fprintf(stderr, "out of memory\n");
+                exit(1);
+            }
+        }
+        (*events)[count++] = ev;
+    }
+    script->count = count;
+}
+
+//=============================================================================
+// PLAYER
+//=============================================================================
+
+// Same sequence as the firmware main loop
+static void Controls_Update(ScriptPlayer_t *p) {
+    Joystick_Update(&p->joystick, p->joy_raw[0], p->joy_raw[1]);
+    Accel_Update(&p->accel, p->accel_raw[0], p->accel_raw[1], p->accel_raw[2]);
+    Synth_ProcessControls(&p->joystick, &p->accel);
+}
+
+/**
+ * @brief Apply one script event
+ * @return false on "end"
+ */
+static bool Apply_Event(ScriptPlayer_t *p, const ScriptEvent_t *ev) {
+    switch (ev->cmd) {
+    case CMD_NOTE_ON:
+        Synth_NoteOn();
+        break;
+    case CMD_NOTE_OFF:
+        Synth_NoteOff();
+        break;
+    case CMD_PLAY:
+        Synth_SetPlaying(ev->arg[0] != 0);
+        break;
+    case CMD_KEY:
+        Synth_SetKey((MusicalKey_t)ev->arg[0]);
+        break;
+    case CMD_MODE:
+        Synth_SetMode((MusicalMode_t)ev->arg[0]);
+        break;
+    case CMD_HARMONY:
+        Synth_SetHarmony((HarmonicFunction_t)ev->arg[0]);
+        break;
+    case CMD_VOLUME:
+        Synth_SetVolume((uint8_t)ev->arg[0]);
+        break;
+    case CMD_JOY:
+        p->joy_raw[0] = (uint16_t)ev->arg[0];
+        p->joy_raw[1] = (uint16_t)ev->arg[1];
+        Controls_Update(p);
+        break;
+    case CMD_ACCEL:
+        for (uint8_t i = 0; i < 3; i++) p->accel_raw[i] = (int16_t)ev->arg[i];
+        Controls_Update(p);
+        break;
+    case CMD_BUTTON:
+        Synth_Button((SynthButton_t)ev->arg[0], (SynthPress_t)ev->arg[1]);
+        break;
+    case CMD_INSTRUMENT:
+        Synth_SetInstrument((Instrument_t)ev->arg[0]);
+        break;
+    case CMD_PRESET:
+        Synth_SetPreset((uint8_t)ev->arg[0]);
+        break;
+    case CMD_CHORD:
+        Synth_SetChordMode((ChordMode_t)ev->arg[0]);
+        break;
+    case CMD_ARP:
+        Synth_SetArpMode((ArpMode_t)ev->arg[0]);
+        break;
+    case CMD_TEMPO:
+        Synth_SetTempo((uint16_t)ev->arg[0]);
+        break;
+    case CMD_EFFECTS:
+        Synth_SetEffects(ev->arg[0] != 0);
+        break;
+    case CMD_EPIC:
+        Synth_ToggleEpic();
+        break;
+    case CMD_MIDI:
+        // The firmware parses MIDI in the audio context, just before the
+        // block; here the next block is rendered right after the event
+        Synth_MidiMessage((uint8_t)ev->arg[0], (uint8_t)ev->arg[1],
+                          (uint8_t)ev->arg[2]);
+        break;
+    case CMD_PART:
+        Synth_SetPart((uint8_t)ev->arg[0], (SynthPartParam_t)ev->arg[1],
+                      (int16_t)ev->arg[2]);
+        break;
+    case CMD_END:
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================
+// PUBLIC FUNCTIONS
+//=============================================================================
+
+void Script_LoadFile(Script_t *script, const char *path) {
+    FILE *f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    Script_Parse(script, f, path);
+    if (f != stdin) fclose(f);
+}
+
+void Script_LoadText(Script_t *script, const char *text, const char *name) {
+    FILE *f = fmemopen((void *)text, strlen(text), "r");
+
+    if (f == NULL) {
+        perror(name);
+        exit(1);
+    }
+    Script_Parse(script, f, name);
+    fclose(f);
+}
+
+void Script_Free(Script_t *script) {
+    free(script->events);
+    script->events = NULL;
+    script->count = 0;
+}
+
+uint32_t Script_LengthMs(const Script_t *script, uint32_t tail_ms) {
+    for (size_t i = 0; i < script->count; i++) {
+        if (script->events[i].cmd == CMD_END) return script->events[i].time_ms;
+    }
+    return (script->count ? script->events[script->count - 1].time_ms : 0) +
+           tail_ms;
+}
+
+void ScriptPlayer_Start(ScriptPlayer_t *player, const Script_t *script,
+                        uint32_t tail_ms) {
+    memset(player, 0, sizeof(*player));
+    player->script = script;
+    player->total = (uint64_t)Script_LengthMs(script, tail_ms) *
+                    SYNTH_SAMPLE_RATE_HZ / 1000;
+
+    // Controls at rest; the first accelerometer reading only latches
+    player->joy_raw[0] = player->joy_raw[1] = 2048;
+    player->accel_raw[0] = 2048;
+    player->accel_raw[1] = 2849;
+    player->accel_raw[2] = 2048;
+    Joystick_Init(&player->joystick, 100);
+    Accel_Init(&player->accel, 100);
+    Accel_Update(&player->accel, player->accel_raw[0], player->accel_raw[1],
+                 player->accel_raw[2]);
+}
+
+uint16_t ScriptPlayer_Render(ScriptPlayer_t *player, int16_t *mix) {
+    const Script_t *s = player->script;
+
+    // Apply everything due at or before this block
+    uint64_t now_ms = player->rendered * 1000 / SYNTH_SAMPLE_RATE_HZ;
+    while (player->next < s->count && s->events[player->next].time_ms <= now_ms) {
+        if (!Apply_Event(player, &s->events[player->next++])) {
+            player->total = player->rendered;
+        }
+    }
+    if (player->rendered >= player->total) return 0;
+
+    uint16_t n = SYNTH_BLOCK_SIZE;
+    if (player->total - player->rendered < n) {
+        n = (uint16_t)(player->total - player->rendered);
+    }
+    Synth_RenderBlock(mix, n);
+    player->rendered += n;
+    return n;
+}
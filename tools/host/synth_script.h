@@ -0,0 +1,137 @@
+/**
+ * @file synth_script.h
+ * @brief Control Scripts for the Host Synth Tools
+ * @version 1.0.0
+ *
+ * Parses timestamped control scripts and plays them into the synth engine
+ * block by block. Shared by synth_render (script -> WAV) and synth_regress
+ * (golden-audio regression).
+ *
+ * Script: one event per line, "<time_ms> <command> [args]". '#' starts a
+ * comment. Times must not go backwards. Events are applied at the next block
+ * boundary (2 ms), like the firmware applies controls between blocks.
+ *
+ *   note_on | note_off             Envelope gate (release keeps playing)
+ *   play on|off                    Play/stop (S2 short press)
+ *   key C|D|E|F|G|A|B
+ *   mode major|minor
+ *   harmony <0-23>                 Harmonic function (ACCEL_X position)
+ *   volume <0-100>
+ *   joy <x> <y>                    Raw 12-bit joystick ADC values
+ *   accel <x> <y> <z>              Raw 12-bit accelerometer ADC values
+ *   button s1|s2|joy short|long|double
+ *   instrument piano|organ|strings|bass|lead
+ *   preset <0-2>
+ *   chord off|major|minor
+ *   arp off|up|down|updown|random
+ *   tempo <30-300>                 BPM (arpeggiator sixteenths, epic bars)
+ *   effects on|off
+ *   epic                           Toggle the Greensleeves sequence
+ *   midi <status> <data1> <data2>  Channel message (0x.. accepted), as if
+ *                                  received on the MIDI input
+ *   part <n> channel|instrument|volume|pan|voices|priority <value>
+ *                                  Multi-timbral part setting (channel is
+ *                                  0-15 or -1, instrument 0-4)
+ *   end                            Stop rendering here
+ *
+ * Usage:
+ *   Script_t script;
+ *   Script_LoadFile(&script, "scripts/demo.txt");
+ *
+ *   Synth_Init(&platform);
+ *   ScriptPlayer_t player;
+ *   ScriptPlayer_Start(&player, &script, 2000);
+ *   while ((n = ScriptPlayer_Render(&player, mix)) > 0) { ... }
+ *   Script_Free(&script);
+ */
+
+#ifndef SYNTH_SCRIPT_H
+#define SYNTH_SCRIPT_H
+
+#include "audio/synth.h"
+#include <stddef.h>
+
+//=============================================================================
+// PUBLIC TYPES
+//=============================================================================
+typedef enum {
+    CMD_NOTE_ON = 0,
+    CMD_NOTE_OFF,
+    CMD_PLAY,
+    CMD_KEY,
+    CMD_MODE,
+    CMD_HARMONY,
+    CMD_VOLUME,
+    CMD_JOY,
+    CMD_ACCEL,
+    CMD_BUTTON,
+    CMD_INSTRUMENT,
+    CMD_PRESET,
+    CMD_CHORD,
+    CMD_ARP,
+    CMD_TEMPO,
+    CMD_EFFECTS,
+    CMD_EPIC,
+    CMD_MIDI,
+    CMD_PART,
+    CMD_END
+} ScriptCommand_t;
+
+typedef struct {
+    uint32_t time_ms;
+    ScriptCommand_t cmd;
+    int32_t arg[3];
+    unsigned line;             ///< Source line (for messages)
+} ScriptEvent_t;
+
+typedef struct {
+    ScriptEvent_t *events;
+    size_t count;
+} Script_t;
+
+typedef struct {
+    const Script_t *script;
+    size_t next;               ///< Next event to apply
+    uint64_t rendered;         ///< Samples so far
+    uint64_t total;            ///< Samples to render
+    Joystick_t joystick;
+    Accelerometer_t accel;
+    uint16_t joy_raw[2];
+    int16_t accel_raw[3];
+} ScriptPlayer_t;
+
+//=============================================================================
+// PUBLIC API
+//=============================================================================
+
+/**
+ * @brief Parse a script file ("-" = stdin); exits with a message on errors
+ */
+void Script_LoadFile(Script_t *script, const char *path);
+
+/**
+ * @brief Parse a script held in memory; exits with a message on errors
+ * @param name Used in error messages
+ */
+void Script_LoadText(Script_t *script, const char *text, const char *name);
+
+void Script_Free(Script_t *script);
+
+/**
+ * @brief Length in ms: the "end" event, or the last event plus tail_ms
+ */
+uint32_t Script_LengthMs(const Script_t *script, uint32_t tail_ms);
+
+/**
+ * @brief Start playing a script into the engine (call after Synth_Init)
+ */
+void ScriptPlayer_Start(ScriptPlayer_t *player, const Script_t *script,
+                        uint32_t tail_ms);
+
+/**
+ * @brief Apply due events and render the next block
+ * @return Samples rendered (0 = finished)
+ */
+uint16_t ScriptPlayer_Render(ScriptPlayer_t *player, int16_t *mix);
+
+#endif /* SYNTH_SCRIPT_H */
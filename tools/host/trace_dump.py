@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+"""
+Event timeline from the trace ring (lib/perf/trace.h)
+
+Reads a raw capture of UART_AUDIO (MIDI with the trace's SysEx frames
+mixed in) and prints every record in order. Timestamps are TIMG12 cycles,
+which wrap every 53 s; they are unwrapped here, so keep the capture
+running (the display frames alone give a record every fraction of a
+second).
+
+Usage:
+    python uart_audio_player.py --midi --record capture.bin
+    python tools/host/trace_dump.py capture.bin
+    python tools/host/trace_dump.py capture.bin --events NOTE_ON,NOTE_OFF
+    python tools/host/trace_dump.py capture.bin --notes   # Unmatched notes
+
+Options:
+    --mclk HZ       Timestamp clock (80 MHz)
+    --events LIST   Only these events (EVENTS below, comma separated)
+    --notes         Check that every NOTE_ON is followed by a NOTE_OFF
+    --json          JSON instead of a table
+"""
+
+import argparse
+import json
+import sys
+
+# SysEx framing (lib/midi/midi_msg.h, lib/perf/trace.h)
+SYSEX_START = 0xF0
+SYSEX_END = 0xF7
+SYSEX_ID_NONCOMMERCIAL = 0x7D
+REPORT_EVENTS = 0x07
+RECORD_BYTES = 11
+
+# TraceEventId_t
+EVENTS = {
+    1: 'NOTE_ON',
+    2: 'NOTE_OFF',
+    3: 'ALL_NOTES_OFF',
+    4: 'ENV_STATE',
+    5: 'HARMONY',
+    6: 'BUTTON',
+    7: 'UNDERRUN',
+    8: 'DISPLAY_FRAME',
+}
+ENV_STATES = ['IDLE', 'ATTACK', 'DECAY', 'SUSTAIN', 'RELEASE']
+BUTTONS = ['S1', 'S2', 'JOY_SEL']
+PRESSES = ['none', 'short', 'long', 'double']
+
+
+# ============================================================================
+# CAPTURE
+# ============================================================================
+def unpack7(data, pos, nbytes):
+    """nbytes of 7-bit payload, LSB first"""
+    value = 0
+    for i in range(nbytes):
+        value |= (data[pos + i] & 0x7F) << (7 * i)
+    return value, pos + nbytes
+
+
+def sysex_frames(data):
+    """Yield the payload after F0 7D of every complete SysEx frame"""
+    pos = 0
+    while True:
+        start = data.find(bytes([SYSEX_START]), pos)
+        if start < 0:
+            return
+        end = data.find(bytes([SYSEX_END]), start + 1)
+        if end < 0:
+            return
+        frame = data[start + 1:end]
+        # A status byte inside means the frame was cut off; resync there
+        cut = next((i for i, b in enumerate(frame) if b & 0x80), None)
+        if cut is not None:
+            pos = start + 1 + cut
+            continue
+        if len(frame) >= 2 and frame[0] == SYSEX_ID_NONCOMMERCIAL:
+            yield frame[1:]
+        pos = end + 1
+
+
+def parse_trace(data):
+    """(records, dropped): records as dicts with unwrapped 'cycles'"""
+    records = []
+    dropped = 0
+    epoch = 0
+    last = None
+    for frame in sysex_frames(data):
+        if (frame[0] != REPORT_EVENTS or len(frame) < 4 + RECORD_BYTES
+                or (len(frame) - 4) % RECORD_BYTES):
+            continue
+        dropped, pos = unpack7(frame, 1, 3)
+        while pos < len(frame):
+            time, pos = unpack7(frame, pos, 5)
+            event, pos = frame[pos], pos + 1
+            args, pos = unpack7(frame, pos, 5)
+            if last is not None and time < last:
+                epoch += 1 << 32
+            last = time
+            records.append({'cycles': epoch + time,
+                            'event': EVENTS.get(event, f'EVENT_{event}'),
+                            'a': (args >> 16) & 0xFF, 'b': args & 0xFFFF})
+    return records, dropped
+
+
+def describe(r):
+    """Arguments in words"""
+    event, a, b = r['event'], r['a'], r['b']
+    if event == 'NOTE_ON':
+        return f"note {a} velocity {b}"
+    if event == 'NOTE_OFF':
+        return f"note {a}"
+    if event == 'ENV_STATE':
+        return ENV_STATES[a] if a < len(ENV_STATES) else str(a)
+    if event == 'HARMONY':
+        return f"function {a}, {b} Hz"
+    if event == 'BUTTON':
+        button = BUTTONS[a] if a < len(BUTTONS) else str(a)
+        press = PRESSES[b] if b < len(PRESSES) else str(b)
+        return f"{button} {press}"
+    if event == 'UNDERRUN':
+        return f"{b} blocks dropped"
+    if event == 'DISPLAY_FRAME':
+        return f"{'load page' if a else 'synth page'}, {b} us"
+    return f"a={a} b={b}" if (a or b) else ''
+
+
+def check_notes(records):
+    """NOTE_ON without a NOTE_OFF (or ALL_NOTES_OFF) for the same note"""
+    sounding = {}
+    for r in records:
+        if r['event'] == 'NOTE_ON':
+            if r['a'] in sounding:
+                yield r, 'retriggered while on'
+            sounding[r['a']] = r
+        elif r['event'] == 'NOTE_OFF':
+            if sounding.pop(r['a'], None) is None:
+                yield r, 'off without on'
+        elif r['event'] == 'ALL_NOTES_OFF':
+            sounding.clear()
+    for r in sounding.values():
+        yield r, 'still on at the end of the capture'
+
+
+# ============================================================================
+# MAIN
+# ============================================================================
+def main():
+    parser = argparse.ArgumentParser(description='Print a trace capture')
+    parser.add_argument('capture', help='Raw UART capture with the trace')
+    parser.add_argument('--mclk', type=int, default=80000000)
+    parser.add_argument('--events', help='Comma separated event names')
+    parser.add_argument('--notes', action='store_true')
+    parser.add_argument('--json', action='store_true')
+    args = parser.parse_args()
+
+    with open(args.capture, 'rb') as f:
+        records, dropped = parse_trace(f.read())
+    if not records:
+        sys.exit(f"{args.capture}: no trace records")
+
+    origin = records[0]['cycles']
+    for r in records:
+        r['ms'] = round(1000.0 * (r['cycles'] - origin) / args.mclk, 3)
+
+    if args.notes:
+        problems = list(check_notes(records))
+        for r, what in problems:
+            print(f"{r['ms']:12.3f} ms  note {r['a']}: {what}")
+        if not problems:
+            print('all notes matched')
+        sys.exit(1 if problems else 0)
+
+    if args.events:
+        wanted = {e.strip().upper() for e in args.events.split(',')}
+        records = [r for r in records if r['event'] in wanted]
+
+    if args.json:
+        print(json.dumps({'mclk_hz': args.mclk, 'dropped': dropped,
+                          'records': records}, indent=2))
+        return
+
+    print(f"{len(records)} records, {dropped} dropped by the firmware")
+    print()
+    previous = None
+    for r in records:
+        delta = '' if previous is None else f"+{r['ms'] - previous:.3f}"
+        previous = r['ms']
+        print(f"{r['ms']:12.3f} ms {delta:>11}  {r['event']:<14} {describe(r)}")
+
+
+if __name__ == '__main__':
+    main()
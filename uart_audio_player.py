@@ -7,6 +7,15 @@ Usage:
     python auto_receiver.py         # Auto-detect
     python auto_receiver.py --midi  # Force MIDI mode
     python auto_receiver.py --audio # Force RAW audio mode
+    python auto_receiver.py --midi --record capture.bin
+                                    # Also save the raw bytes (profiler
+                                    # dumps: tools/host/prof_symbolize.py,
+                                    # cycle zones: tools/host/perf_report.py,
+                                    # event trace: tools/host/trace_dump.py)
+    python auto_receiver.py --midi --send bank.syx
+                                    # Load a sound bank (tools/host/bank_tool)
+    python auto_receiver.py --midi --bank-dump dump.syx
+                                    # Save the synth's bank
 """
 
 import serial
@@ -15,6 +24,7 @@ import numpy as np
 import sys
 import struct
 import argparse
+import time
 
 # Configuration
 BAUD_RATE = 921600
@@ -25,6 +35,100 @@ MIDI_NOTE_OFF = 0x80
 MIDI_NOTE_ON = 0x90
 MIDI_CONTROL_CHANGE = 0xB0
 MIDI_PROGRAM_CHANGE = 0xC0
+MIDI_SYSEX_START = 0xF0
+MIDI_SYSEX_END = 0xF7
+
+# Firmware telemetry (SysEx, non-commercial ID 0x7D; see Telemetry_Send in main.c)
+SYSEX_ID_NONCOMMERCIAL = 0x7D
+TELEMETRY_ISR_LOAD = 0x01
+TELEMETRY_PART_LOAD = 0x08
+PROFILER_REPORT_END = 0x04
+ISR_LOAD_FIELDS = ['load_pct10', 'min', 'avg', 'max', 'budget',
+                   'overruns', 'underruns', 'svc_max']
+PART_LOAD_FIELDS = ['load_pct10', 'avg', 'max', 'voices']
+
+# Sound bank frames (lib/audio/synth_bank.h)
+BANK_SYSEX_REQUEST = 0x10
+BANK_SYSEX_INSTRUMENT = 0x11
+BANK_SYSEX_PRESET = 0x12
+BANK_SYSEX_COMMAND = 0x13
+BANK_SYSEX_REPLY = 0x14
+BANK_STATUS = ['ok', 'bad frame', 'value out of range', 'other version',
+               'bad CRC', 'flash write failed']
+BANK_FRAME_NAMES = {BANK_SYSEX_REQUEST: 'dump', BANK_SYSEX_INSTRUMENT: 'instrument',
+                    BANK_SYSEX_PRESET: 'preset', BANK_SYSEX_COMMAND: 'store/factory'}
+BANK_SEND_GAP_S = 0.003  # The MIDI input ring holds 5.5 ms at 921600 baud
+
+def unpack_u21(payload):
+    return [payload[i] | (payload[i + 1] << 7) | (payload[i + 2] << 14)
+            for i in range(0, len(payload) - 2, 3)]
+
+def decode_telemetry(frame):
+    """Decode F0 7D <id> <payload> F7 (21-bit values as 3 x 7 bits, LSB first)"""
+    if len(frame) < 4 or frame[1] != SYSEX_ID_NONCOMMERCIAL:
+        return None
+    if frame[2] != TELEMETRY_ISR_LOAD:
+        return None
+    payload = frame[3:-1]
+    if len(payload) != 3 * len(ISR_LOAD_FIELDS):
+        return None
+    return dict(zip(ISR_LOAD_FIELDS, unpack_u21(payload)))
+
+def decode_part_load(frame):
+    """Decode F0 7D 08 <count> <load avg max voices>... F7, one dict per part"""
+    if (len(frame) < 5 or frame[1] != SYSEX_ID_NONCOMMERCIAL
+            or frame[2] != TELEMETRY_PART_LOAD):
+        return None
+    count, payload = frame[3], frame[4:-1]
+    if len(payload) != count * 3 * len(PART_LOAD_FIELDS):
+        return None
+    values = unpack_u21(payload)
+    n = len(PART_LOAD_FIELDS)
+    return [dict(zip(PART_LOAD_FIELDS, values[i:i + n]))
+            for i in range(0, len(values), n)]
+
+def format_part_load(parts):
+    return "  ".join(f"part {i + 1} {p['load_pct10'] / 10:.1f}% "
+                     f"({p['voices']} v, {p['avg']}/{p['max']} cyc)"
+                     for i, p in enumerate(parts))
+
+def split_sysex(data):
+    """Whole F0 ... F7 frames in a byte string"""
+    frames, start = [], data.find(MIDI_SYSEX_START)
+    while start >= 0:
+        end = data.find(MIDI_SYSEX_END, start)
+        if end < 0:
+            break
+        frames.append(data[start:end + 1])
+        start = data.find(MIDI_SYSEX_START, end)
+    return frames
+
+def decode_bank_reply(frame):
+    """Decode F0 7D 14 <id> <status> F7 into (id, status text)"""
+    if (len(frame) != 6 or frame[1] != SYSEX_ID_NONCOMMERCIAL
+            or frame[2] != BANK_SYSEX_REPLY):
+        return None
+    status = frame[4]
+    return frame[3], (BANK_STATUS[status] if status < len(BANK_STATUS)
+                      else f"status {status}")
+
+def is_bank_record(frame):
+    return (len(frame) > 3 and frame[1] == SYSEX_ID_NONCOMMERCIAL
+            and frame[2] in (BANK_SYSEX_INSTRUMENT, BANK_SYSEX_PRESET))
+
+def send_sysex(ser, data):
+    """Send the frames of a .syx file, spaced so the input ring keeps up"""
+    frames = split_sysex(data)
+    for frame in frames:
+        ser.write(frame)
+        time.sleep(BANK_SEND_GAP_S)
+    return len(frames)
+
+def format_isr_load(t):
+    return (f"CPU {t['load_pct10'] / 10:5.1f}%  render min/avg/max "
+            f"{t['min']}/{t['avg']}/{t['max']} of {t['budget']} cyc  "
+            f"svc max {t['svc_max']}  overruns {t['overruns']}  "
+            f"underruns {t['underruns']}")
 
 def is_midi_byte(byte):
     """Check if byte looks like a MIDI status byte"""
@@ -291,32 +395,56 @@ class MIDISynthesizer:
         return np.clip(output * 32767, -32768, 32767).astype(np.int16)
 
 class MIDIReceiver:
-    def __init__(self):
+    def __init__(self, record=None, bank_dump=None):
         self.synth = MIDISynthesizer()
+        self.record = record
+        self.bank_dump = bank_dump
+        self.running_status = None
         
     def parse_midi(self, data_buffer):
+        """(message, bytes consumed); consumed 0 = wait for more bytes.
+        The firmware uses running status: a message may start with a data
+        byte and reuse the last status."""
         if len(data_buffer) == 0:
             return None, 0
-        
+
         status = data_buffer[0]
-        if status >= 0x80 and status <= 0xEF:
-            message_type = status & 0xF0
-            channel = status & 0x0F
-            
-            if message_type in [MIDI_NOTE_OFF, MIDI_NOTE_ON, MIDI_CONTROL_CHANGE]:
-                if len(data_buffer) >= 3:
-                    return {
-                        'type': 'note_on' if message_type == MIDI_NOTE_ON else 
-                                ('note_off' if message_type == MIDI_NOTE_OFF else 'control_change'),
-                        'channel': channel,
-                        'data1': data_buffer[1],
-                        'data2': data_buffer[2]
-                    }, 3
-            elif message_type == MIDI_PROGRAM_CHANGE:
-                if len(data_buffer) >= 2:
-                    return {'type': 'program_change', 'channel': channel, 'program': data_buffer[1]}, 2
-        return None, 0
-    
+        pos = 1
+        if status < 0x80:
+            if self.running_status is None:
+                return None, 1  # No status yet: skip the byte
+            status, pos = self.running_status, 0
+        elif status >= 0xF8:
+            return None, 1  # Real-time (clock): running status holds
+        elif status > 0xEF:
+            self.running_status = None  # System messages cancel it
+            return None, 1
+
+        message_type = status & 0xF0
+        channel = status & 0x0F
+        length = 2 if message_type in (MIDI_PROGRAM_CHANGE, 0xD0) else 3
+        if len(data_buffer) < pos + length - 1:
+            return None, 0
+        data = data_buffer[pos:pos + length - 1]
+        if any(b & 0x80 for b in data):
+            self.running_status = None  # Cut off by a new status
+            return None, max(pos, 1)
+        self.running_status = status
+
+        if message_type == MIDI_NOTE_ON:
+            return {'type': 'note_on', 'channel': channel,
+                    'data1': data[0], 'data2': data[1]}, pos + 2
+        if message_type == MIDI_NOTE_OFF:
+            return {'type': 'note_off', 'channel': channel,
+                    'data1': data[0], 'data2': data[1]}, pos + 2
+        if message_type == MIDI_CONTROL_CHANGE:
+            return {'type': 'control_change', 'channel': channel,
+                    'data1': data[0], 'data2': data[1]}, pos + 2
+        if message_type == MIDI_PROGRAM_CHANGE:
+            return {'type': 'program_change', 'channel': channel,
+                    'program': data[0]}, pos + 1
+        return None, pos + length - 1  # Aftertouch, pitch bend: ignored
+
     def audio_callback(self, outdata, frames, time_info, status):
         audio = self.synth.generate(frames)
         outdata[:] = audio.reshape(-1, 1)
@@ -341,22 +469,55 @@ class MIDIReceiver:
                 if ser.in_waiting > 0:
                     data = ser.read(ser.in_waiting)
                     midi_buffer.extend(data)
+                    if self.record:
+                        self.record.write(data)
                 
-                while len(midi_buffer) >= 3:
+                while midi_buffer and midi_buffer[0] == MIDI_SYSEX_START:
+                    end = midi_buffer.find(MIDI_SYSEX_END)
+                    if end < 0:
+                        break  # Wait for the rest of the frame
+                    frame = midi_buffer[:end + 1]
+                    telemetry = decode_telemetry(frame)
+                    parts = decode_part_load(frame)
+                    reply = decode_bank_reply(frame)
+                    if is_bank_record(frame):
+                        if self.bank_dump:
+                            self.bank_dump.write(frame)
+                    elif reply:
+                        name = BANK_FRAME_NAMES.get(reply[0], f"0x{reply[0]:02X}")
+                        print(f"\n🎛️  Bank {name}: {reply[1]}" +
+                              (f" (saved in {self.bank_dump.name})"
+                               if self.bank_dump and reply[0] == BANK_SYSEX_REQUEST
+                               else ""))
+                    elif telemetry:
+                        print(f"\n📊 {format_isr_load(telemetry)}")
+                    elif parts:
+                        print(f"   {format_part_load(parts)}")
+                    elif (len(frame) > 3 and frame[1] == SYSEX_ID_NONCOMMERCIAL
+                          and frame[2] == PROFILER_REPORT_END):
+                        print("\n📈 Profiler dump received" +
+                              (f" (saved in {self.record.name})" if self.record
+                               else " (use --record to keep it)"))
+                    midi_buffer = midi_buffer[end + 1:]
+                    self.running_status = None
+
+                while midi_buffer and midi_buffer[0] != MIDI_SYSEX_START:
                     msg, consumed = self.parse_midi(midi_buffer)
-                    if msg:
-                        if msg['type'] == 'note_on':
-                            self.synth.note_on(msg['data1'], msg['data2'])
+                    if consumed == 0:
+                        break  # Wait for the rest of the message
+                    midi_buffer = midi_buffer[consumed:]
+                    if not msg:
+                        continue
+                    if msg['type'] == 'note_on':
+                        self.synth.note_on(msg['data1'], msg['data2'])
+                        if msg['data2']:
                             note_count += 1
                             sys.stdout.write(f"\r🎹 Notes: {note_count:6d}   ")
                             sys.stdout.flush()
-                        elif msg['type'] == 'note_off':
-                            self.synth.note_off(msg['data1'])
-                        elif msg['type'] == 'control_change':
-                            self.synth.control_change(msg['data1'], msg['data2'])
-                        midi_buffer = midi_buffer[consumed:]
-                    else:
-                        midi_buffer = midi_buffer[1:]
+                    elif msg['type'] == 'note_off':
+                        self.synth.note_off(msg['data1'])
+                    elif msg['type'] == 'control_change':
+                        self.synth.control_change(msg['data1'], msg['data2'])
                 
                 sd.sleep(1)
         finally:
@@ -371,6 +532,12 @@ def main():
     parser = argparse.ArgumentParser(description='MSPM0 UART Receiver')
     parser.add_argument('--midi', action='store_true', help='Force MIDI mode')
     parser.add_argument('--audio', action='store_true', help='Force RAW audio mode')
+    parser.add_argument('--record', metavar='FILE',
+                        help='Save the raw MIDI stream (profiler dumps)')
+    parser.add_argument('--send', metavar='FILE',
+                        help='Send a .syx file first (MIDI mode; sound banks)')
+    parser.add_argument('--bank-dump', metavar='FILE',
+                        help='Request the sound bank and save it as .syx')
     args = parser.parse_args()
     
     port = find_serial_port()
@@ -400,8 +567,23 @@ def main():
         print("\n🎵 Press Ctrl+C to stop\n")
         
         if protocol == "midi":
-            receiver = MIDIReceiver()
-            receiver.run(ser)
+            record = open(args.record, 'wb') if args.record else None
+            bank_dump = open(args.bank_dump, 'wb') if args.bank_dump else None
+            try:
+                if args.send:
+                    with open(args.send, 'rb') as f:
+                        count = send_sysex(ser, f.read())
+                    print(f"📤 Sent {count} frames from {args.send}")
+                if bank_dump:
+                    ser.write(bytes([MIDI_SYSEX_START, SYSEX_ID_NONCOMMERCIAL,
+                                     BANK_SYSEX_REQUEST, MIDI_SYSEX_END]))
+                receiver = MIDIReceiver(record, bank_dump)
+                receiver.run(ser)
+            finally:
+                if record:
+                    record.close()
+                if bank_dump:
+                    bank_dump.close()
         else:
             receiver = AudioReceiver()
             receiver.run(ser)